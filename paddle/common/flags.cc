@@ -374,6 +374,47 @@ PHI_DEFINE_EXPORTED_bool(
 PHI_DEFINE_EXPORTED_int32(communicator_send_queue_size,
                           20,
                           "queue size to recv gradient before send");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_communicator_sparse_cache_capacity
+ * Since Version: 3.1
+ * Value Range: int64, default=0
+ * Example: FLAGS_communicator_sparse_cache_capacity=1000000
+ * Note: The number of pulled sparse values of a table that the communicator
+ *       of a worker caches, so that the frequent keys are not pulled from the
+ *       servers in every batch. The cache is disabled if it is 0.
+ */
+PHI_DEFINE_EXPORTED_int64(communicator_sparse_cache_capacity,
+                          0,
+                          "max number of cached sparse values per table");
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_communicator_sparse_cache_policy
+ * Since Version: 3.1
+ * Value Range: string, default=clock
+ * Example: FLAGS_communicator_sparse_cache_policy=lfu
+ * Note: Eviction policy of the sparse value cache of the communicator, clock
+ *       keeps the values used since the clock hand last passed, lfu keeps the
+ *       values used most often recently.
+ */
+PHI_DEFINE_EXPORTED_string(communicator_sparse_cache_policy,
+                           "clock",
+                           "eviction policy of the sparse value cache");
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_communicator_sparse_cache_max_staleness
+ * Since Version: 3.1
+ * Value Range: int32, default=1
+ * Example: FLAGS_communicator_sparse_cache_max_staleness=2
+ * Note: The number of steps a cached sparse value is still served after the
+ *       step it is pulled in, a step being a pull of the table. The keys
+ *       pushed by the worker are pulled again in the next step anyway. With
+ *       0 the keys are pulled again in every step.
+ */
+PHI_DEFINE_EXPORTED_int32(communicator_sparse_cache_max_staleness,
+                          1,
+                          "steps a cached sparse value lags behind at most");
 #endif
 
 /**
@@ -483,6 +524,76 @@ PHI_DEFINE_EXPORTED_string(
     "on the same GPU card but may lead to more memory fragmentation "
     "(i.e., maximum batch size of models may be smaller).");
 
+/**
+ * Allocator related FLAG
+ * Name: FLAGS_cpu_allocator_strategy
+ * Since Version: 3.1
+ * Value Range: string, {default, size_class}, default=default
+ * Example: FLAGS_cpu_allocator_strategy=size_class
+ * Note: For selecting the allocator of CPUPlace. default allocates every CPU
+ * tensor from the system allocator. size_class serves small tensors from
+ * per-size-class bins with per-thread caches, and large tensors from an
+ * auto-growth allocator.
+ */
+PHI_DEFINE_EXPORTED_string(
+    cpu_allocator_strategy,
+    "default",
+    "The allocation strategy of CPUPlace, enum in [default, size_class]. "
+    "default means allocating from the system allocator directly. "
+    "size_class means the size-class segregated allocator with per-thread "
+    "caches, which is faster for many small tensors allocated and freed by "
+    "multiple threads.");
+
+/**
+ * Allocator related FLAG
+ * Name: FLAGS_cpu_huge_page
+ * Since Version: 3.1
+ * Value Range: string, {none, transparent, explicit}, default=none
+ * Example: FLAGS_cpu_huge_page=transparent
+ * Note: Back the CPU buffers not smaller than one huge page with huge pages,
+ * to reduce TLB misses of big embeddings and activations. transparent uses
+ * madvise(MADV_HUGEPAGE), explicit uses MAP_HUGETLB and falls back to
+ * transparent when the huge page pool is exhausted. Only works on Linux.
+ */
+PHI_DEFINE_EXPORTED_string(
+    cpu_huge_page,
+    "none",
+    "The huge page mode of CPUPlace, enum in [none, transparent, explicit].");
+
+/**
+ * Allocator related FLAG
+ * Name: FLAGS_cpu_numa_node
+ * Since Version: 3.1
+ * Value Range: int32, default=-1
+ * Example: FLAGS_cpu_numa_node=0
+ * Note: The NUMA node that the CPU memory prefers. -1 means no binding, and
+ * the pages are placed on the node of the thread touching them first. The
+ * threads of a thread pool can override it by NumaNodeGuard. The reserved
+ * size of each node is reported by the HostNumaReserved memory stat. Only
+ * works on Linux.
+ */
+PHI_DEFINE_EXPORTED_int32(cpu_numa_node,
+                          -1,
+                          "The NUMA node that the CPU memory prefers, -1 "
+                          "means placing pages by first touch.");
+
+/**
+ * Allocator related FLAG
+ * Name: FLAGS_cpu_thread_pool_numa_node
+ * Since Version: 3.1
+ * Value Range: int32, default=-1
+ * Example: FLAGS_cpu_thread_pool_numa_node=1
+ * Note: The NUMA node that the CPU memory allocated by the host threads of
+ * the executor and by the intra-op threads of the cpu kernels prefers, set
+ * by NumaNodeGuard when the threads start. -1 means following
+ * FLAGS_cpu_numa_node. Only works on Linux.
+ */
+PHI_DEFINE_EXPORTED_int32(cpu_thread_pool_numa_node,
+                          -1,
+                          "The NUMA node that the CPU memory of the executor "
+                          "and intra-op threads prefers, -1 means following "
+                          "FLAGS_cpu_numa_node.");
+
 /**
  * Memory related FLAG
  * Name: FLAGS_fraction_of_cpu_memory_to_use
@@ -914,6 +1025,24 @@ PHI_DEFINE_EXPORTED_bool(graph_metapath_split_opt,
                          "It controls whether load graph node and edge with "
                          "multi threads parallelly.");
 
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_graph_freeze_after_load
+ * Since Version: 3.1
+ * Value Range: bool, default=false
+ * Example: FLAGS_graph_freeze_after_load=true
+ * Note: Control whether the shards of a cpu graph table are frozen into
+ *       read only csr storage, the edges after load_edges and the nodes after
+ *       all the node types are loaded by parse_node_and_load or
+ *       load_node_and_edge_file. It takes much less memory and samples
+ *       faster, but nodes can not be added or found as Node objects
+ *       afterwards.
+ */
+PHI_DEFINE_EXPORTED_bool(graph_freeze_after_load,
+                         false,
+                         "It controls whether freeze the cpu graph table "
+                         "into csr storage after loading.");
+
 /**
  * Distributed related FLAG
  * Name: FLAGS_graph_get_neighbor_id
@@ -1162,6 +1291,37 @@ PHI_DEFINE_EXPORTED_uint64(executor_log_deps_every_microseconds,
                            0,
                            "Enable new executor log deps every n microseconds");
 
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_locality_aware_schedule
+ * Since Version: 3.1
+ * Value Range: bool, default=false
+ * Example: FLAGS_new_executor_locality_aware_schedule=true would make the
+ * multi-thread pir interpreter keep running the highest-priority ready
+ * successor inline, and dispatch the other ready successors in one batch to
+ * the worker threads suggested by their producer-consumer affinity.
+ */
+PHI_DEFINE_EXPORTED_bool(
+    new_executor_locality_aware_schedule,
+    false,
+    "Enable locality-aware batch scheduling in the multi-thread pir "
+    "interpreter");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_critical_path_schedule
+ * Since Version: 3.1
+ * Value Range: bool, default=false
+ * Example: FLAGS_new_executor_critical_path_schedule=true would make the pir
+ * interpreter time every instruction in its first run, and from then on
+ * schedule ready instructions by the length of their longest remaining path
+ * to the end of the program.
+ */
+PHI_DEFINE_EXPORTED_bool(new_executor_critical_path_schedule,
+                         false,
+                         "Enable critical-path priority scheduling in the pir "
+                         "interpreter");
+
 PD_DEFINE_int32(record_pool_max_size,
                 2000000,
                 "SlotRecordDataset slot record pool max size");
@@ -1261,6 +1421,60 @@ PHI_DEFINE_EXPORTED_bool(multi_node_sample_use_gpu_table,
 PHI_DEFINE_EXPORTED_bool(nccl_blocking_wait, false, "nccl blocking wait");
 #endif
 
+/**
+ * ProcessGroupGloo related FLAG
+ * Name: gloo_async_allreduce
+ * Since Version: 3.1
+ * Value Range: bool, default=true
+ * Example:
+ * Note: The fused gradient allreduce of DataParallel on cpu runs on the
+ * worker thread of ProcessGroupGloo as each group gets ready, overlapped
+ * with the rest of backward.
+ */
+PHI_DEFINE_EXPORTED_bool(gloo_async_allreduce,
+                         true,
+                         "Run the gradient allreduce of DataParallel with "
+                         "gloo asynchronously during backward.");
+
+/**
+ * DataParallel related FLAG
+ * Name: cpu_grad_compression
+ * Since Version: 3.1
+ * Value Range: string, {"", "topk", "powersgd"}, default=""
+ * Example: FLAGS_cpu_grad_compression="topk"
+ * Note: Compress the float32 gradient allreduce of DataParallel on cpu, with
+ * error feedback. topk sends FLAGS_cpu_grad_compression_topk_ratio of the
+ * gradients of each group, powersgd sends rank
+ * FLAGS_cpu_grad_compression_powersgd_rank factors of the gradient matrices.
+ * The flags are read when DataParallel is created.
+ */
+PHI_DEFINE_EXPORTED_string(cpu_grad_compression,
+                           "",
+                           "The gradient compression of DataParallel on cpu, "
+                           "topk or powersgd, empty to disable.");
+PHI_DEFINE_EXPORTED_double(cpu_grad_compression_topk_ratio,
+                           0.01,
+                           "The ratio of the gradients sent by top-k "
+                           "gradient compression.");
+PHI_DEFINE_EXPORTED_int32(cpu_grad_compression_powersgd_rank,
+                          4,
+                          "The rank of PowerSGD gradient compression.");
+
+/**
+ * ProcessGroupGloo related FLAG
+ * Name: gloo_shm_allreduce
+ * Since Version: 3.1
+ * Value Range: bool, default=true
+ * Example:
+ * Note: When all the ranks of a gloo group are on one host, allreduce of
+ * float32, float64, int32 and int64 with sum, max, min or prod goes through
+ * shared memory instead of the network stack.
+ */
+PHI_DEFINE_EXPORTED_bool(gloo_shm_allreduce,
+                         true,
+                         "Allreduce through shared memory when all the ranks "
+                         "of a gloo group are on one host.");
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 PHI_DEFINE_EXPORTED_bool(benchmark_nccl,
                          false,
@@ -0,0 +1,317 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/collective/gradient_compressor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <random>
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+
+COMMON_DECLARE_double(cpu_grad_compression_topk_ratio);
+COMMON_DECLARE_int32(cpu_grad_compression_powersgd_rank);
+
+namespace paddle {
+namespace distributed {
+
+namespace {
+
+// the same on all ranks, so that the first Q is the same
+const uint32_t kPowerSGDSeed = 2025;
+
+// A gradient of a group compressed by PowerSGD, as a rows x cols matrix at
+// offset of the group and at p_offset and q_offset of the factors.
+struct LowRankMatrix {
+  int64_t offset;
+  int64_t rows;
+  int64_t cols;
+  int64_t p_offset;
+  int64_t q_offset;
+};
+
+// Gram-Schmidt on the columns of the rows x rank matrix p.
+void Orthogonalize(float* p, int64_t rows, int rank) {
+  for (int c = 0; c < rank; ++c) {
+    for (int prev = 0; prev < c; ++prev) {
+      double dot = 0;
+      for (int64_t i = 0; i < rows; ++i) {
+        dot += p[i * rank + c] * p[i * rank + prev];
+      }
+      for (int64_t i = 0; i < rows; ++i) {
+        p[i * rank + c] -= dot * p[i * rank + prev];
+      }
+    }
+    double norm = 0;
+    for (int64_t i = 0; i < rows; ++i) {
+      norm += p[i * rank + c] * p[i * rank + c];
+    }
+    float scale = 1.0 / std::max(std::sqrt(norm), 1e-8);
+    for (int64_t i = 0; i < rows; ++i) {
+      p[i * rank + c] *= scale;
+    }
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<GradientCompressor> GradientCompressor::Create(
+    const std::string& name, ProcessGroup* process_group) {
+  if (name.empty()) {
+    return nullptr;
+  } else if (name == "topk") {
+    return std::make_unique<TopKCompressor>(
+        process_group, FLAGS_cpu_grad_compression_topk_ratio);
+  } else if (name == "powersgd") {
+    return std::make_unique<PowerSGDCompressor>(
+        process_group, FLAGS_cpu_grad_compression_powersgd_rank);
+  }
+  PADDLE_THROW(common::errors::InvalidArgument(
+      "Unknown gradient compression %s, should be topk or powersgd.", name));
+}
+
+std::vector<float>& GradientCompressor::Residual(size_t group_id,
+                                                 size_t size) {
+  auto& residual = residuals_[group_id];
+  if (residual.size() != size) {
+    residual.assign(size, 0);
+  }
+  return residual;
+}
+
+phi::DenseTensor GradientCompressor::NewTensor(int64_t numel) {
+  phi::DenseTensor tensor;
+  tensor.Resize({numel});
+  phi::DeviceContextPool::Instance().Get(phi::CPUPlace())->Alloc<float>(
+      &tensor);
+  return tensor;
+}
+
+TopKCompressor::TopKCompressor(ProcessGroup* process_group, double ratio)
+    : GradientCompressor(process_group), ratio_(ratio) {
+  PADDLE_ENFORCE_EQ(
+      ratio > 0 && ratio <= 1,
+      true,
+      common::errors::InvalidArgument(
+          "The top-k ratio of gradient compression should be in (0, 1], "
+          "but got %f.",
+          ratio));
+}
+
+std::shared_ptr<ProcessGroup::Task> TopKCompressor::AllReduce(
+    size_t group_id,
+    phi::DenseTensor* contents,
+    const std::vector<phi::DenseTensor>& grads UNUSED) {
+  int64_t numel = contents->numel();
+  PADDLE_ENFORCE_LE(numel,
+                    std::numeric_limits<uint32_t>::max(),
+                    common::errors::InvalidArgument(
+                        "The group of top-k gradient compression should have "
+                        "at most 2^32 - 1 elements, but got %d.",
+                        numel));
+  float* data = contents->data<float>();
+  auto& residual = Residual(group_id, numel);
+  for (int64_t i = 0; i < numel; ++i) {
+    residual[i] += data[i];
+  }
+
+  // the same k on all ranks
+  int64_t k = std::min<int64_t>(
+      numel, std::max<int64_t>(1, std::ceil(numel * ratio_)));
+  std::vector<uint32_t> indices(numel);
+  std::iota(indices.begin(), indices.end(), 0);
+  if (k < numel) {
+    std::nth_element(indices.begin(),
+                     indices.begin() + k,
+                     indices.end(),
+                     [&residual](uint32_t a, uint32_t b) {
+                       return std::abs(residual[a]) > std::abs(residual[b]);
+                     });
+  }
+
+  // k indices as the bits of floats, then k values
+  phi::DenseTensor send = NewTensor(2 * k);
+  float* send_data = send.data<float>();
+  for (int64_t j = 0; j < k; ++j) {
+    uint32_t index = indices[j];
+    memcpy(send_data + j, &index, sizeof(uint32_t));
+    send_data[k + j] = residual[index];
+    residual[index] = 0;
+  }
+  int nranks = process_group_->GetSize();
+  phi::DenseTensor recv = NewTensor(2 * k * nranks);
+  auto task =
+      process_group_->AllGather(&recv, send, 0, send.numel(), /*sync_op*/ true);
+  task->Wait();
+
+  memset(data, 0, numel * sizeof(float));
+  const float* recv_data = recv.data<float>();
+  for (int r = 0; r < nranks; ++r) {
+    const float* rank_data = recv_data + 2 * k * r;
+    for (int64_t j = 0; j < k; ++j) {
+      uint32_t index = 0;
+      memcpy(&index, rank_data + j, sizeof(uint32_t));
+      data[index] += rank_data[k + j];
+    }
+  }
+  return task;
+}
+
+PowerSGDCompressor::PowerSGDCompressor(ProcessGroup* process_group, int rank)
+    : GradientCompressor(process_group), rank_(rank) {
+  PADDLE_ENFORCE_GT(rank,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The rank of PowerSGD gradient compression should be "
+                        "greater than 0, but got %d.",
+                        rank));
+}
+
+std::shared_ptr<ProcessGroup::Task> PowerSGDCompressor::AllReduce(
+    size_t group_id,
+    phi::DenseTensor* contents,
+    const std::vector<phi::DenseTensor>& grads) {
+  float* data = contents->data<float>();
+  std::vector<LowRankMatrix> matrices;
+  // offset and numel of the gradients sent as they are
+  std::vector<std::pair<int64_t, int64_t>> raw_grads;
+  int64_t offset = 0;
+  int64_t p_size = 0;
+  int64_t q_size = 0;
+  int64_t raw_size = 0;
+  for (auto& grad : grads) {
+    int64_t numel = grad.numel();
+    int64_t rows = grad.dims().size() >= 2 ? grad.dims()[0] : 1;
+    int64_t cols = rows > 0 ? numel / rows : 0;
+    if (rows > rank_ && cols > rank_) {
+      matrices.push_back({offset, rows, cols, p_size, q_size});
+      p_size += rows * rank_;
+      q_size += cols * rank_;
+    } else {
+      raw_grads.emplace_back(offset, numel);
+      raw_size += numel;
+    }
+    offset += numel;
+  }
+  PADDLE_ENFORCE_EQ(offset,
+                    contents->numel(),
+                    common::errors::InvalidArgument(
+                        "The gradients of group %d have %d elements, but the "
+                        "group has %d.",
+                        group_id,
+                        offset,
+                        contents->numel()));
+
+  auto& q = qs_[group_id];
+  if (static_cast<int64_t>(q.size()) != q_size) {
+    std::mt19937 rng(kPowerSGDSeed);
+    std::normal_distribution<float> distrib(0, 1);
+    q.resize(q_size);
+    for (auto& x : q) {
+      x = distrib(rng);
+    }
+  }
+  // the matrices with the error feedback
+  auto& residual = Residual(group_id, contents->numel());
+  for (auto& matrix : matrices) {
+    int64_t end = matrix.offset + matrix.rows * matrix.cols;
+    for (int64_t i = matrix.offset; i < end; ++i) {
+      residual[i] += data[i];
+    }
+  }
+
+  auto* dev_ctx = static_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  auto blas = phi::funcs::GetBlas<phi::CPUContext, float>(*dev_ctx);
+  AllreduceOptions opts;
+  opts.reduce_op = ReduceOp::SUM;
+
+  // P = M Q, with the raw gradients
+  phi::DenseTensor p_tensor = NewTensor(p_size + raw_size);
+  float* p = p_tensor.data<float>();
+  for (auto& matrix : matrices) {
+    blas.GEMM(CblasNoTrans,
+              CblasNoTrans,
+              matrix.rows,
+              rank_,
+              matrix.cols,
+              1.0f,
+              residual.data() + matrix.offset,
+              q.data() + matrix.q_offset,
+              0.0f,
+              p + matrix.p_offset);
+  }
+  float* raw = p + p_size;
+  for (auto& raw_grad : raw_grads) {
+    memcpy(raw, data + raw_grad.first, raw_grad.second * sizeof(float));
+    raw += raw_grad.second;
+  }
+  auto task = process_group_->AllReduce(&p_tensor, p_tensor, opts, true);
+  task->Wait();
+  raw = p + p_size;
+  for (auto& raw_grad : raw_grads) {
+    memcpy(data + raw_grad.first, raw, raw_grad.second * sizeof(float));
+    raw += raw_grad.second;
+  }
+  if (matrices.empty()) {
+    return task;
+  }
+
+  // Q = M^T P with the orthogonal P
+  phi::DenseTensor q_tensor = NewTensor(q_size);
+  for (auto& matrix : matrices) {
+    Orthogonalize(p + matrix.p_offset, matrix.rows, rank_);
+    blas.GEMM(CblasTrans,
+              CblasNoTrans,
+              matrix.cols,
+              rank_,
+              matrix.rows,
+              1.0f,
+              residual.data() + matrix.offset,
+              p + matrix.p_offset,
+              0.0f,
+              q_tensor.data<float>() + matrix.q_offset);
+  }
+  task = process_group_->AllReduce(&q_tensor, q_tensor, opts, true);
+  task->Wait();
+  memcpy(q.data(), q_tensor.data<float>(), q_size * sizeof(float));
+
+  // M ~ P Q^T, the rest is kept
+  for (auto& matrix : matrices) {
+    float* approx = data + matrix.offset;
+    blas.GEMM(CblasNoTrans,
+              CblasTrans,
+              matrix.rows,
+              matrix.cols,
+              rank_,
+              1.0f,
+              p + matrix.p_offset,
+              q.data() + matrix.q_offset,
+              0.0f,
+              approx);
+    for (int64_t i = 0; i < matrix.rows * matrix.cols; ++i) {
+      residual[matrix.offset + i] -= approx[i];
+    }
+  }
+  return task;
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,100 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/fluid/distributed/collective/process_group.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace paddle {
+namespace distributed {
+
+/**
+ * Compressed allreduce of the fused float32 gradients of a group on cpu.
+ *
+ * The part of the gradients that is not sent in a step is kept as error
+ * feedback and added to the gradients of the group in the next step, so that
+ * every gradient is applied eventually.
+ */
+class GradientCompressor {
+ public:
+  virtual ~GradientCompressor() = default;
+
+  /**
+   * topk or powersgd with the options of the flags, nullptr for an empty
+   * name.
+   */
+  static std::unique_ptr<GradientCompressor> Create(
+      const std::string& name, ProcessGroup* process_group);
+
+  /**
+   * Sum contents, the fused gradients of the group, over the ranks in place.
+   * grads are the gradients in contents, in order.
+   */
+  virtual std::shared_ptr<ProcessGroup::Task> AllReduce(
+      size_t group_id,
+      phi::DenseTensor* contents,
+      const std::vector<phi::DenseTensor>& grads) = 0;
+
+ protected:
+  explicit GradientCompressor(ProcessGroup* process_group)
+      : process_group_(process_group) {}
+
+  // the error feedback of a group, reset if the size of the group changes
+  std::vector<float>& Residual(size_t group_id, size_t size);
+  phi::DenseTensor NewTensor(int64_t numel);
+
+  ProcessGroup* process_group_;
+  std::unordered_map<size_t, std::vector<float>> residuals_;
+};
+
+// Sends the ratio of the gradients of the largest magnitude, as indices and
+// values gathered from all ranks.
+class TopKCompressor : public GradientCompressor {
+ public:
+  TopKCompressor(ProcessGroup* process_group, double ratio);
+
+  std::shared_ptr<ProcessGroup::Task> AllReduce(
+      size_t group_id,
+      phi::DenseTensor* contents,
+      const std::vector<phi::DenseTensor>& grads) override;
+
+ private:
+  double ratio_;
+};
+
+// PowerSGD, sends the rank r factors P and Q of the gradients that are
+// matrices larger than r in both dimensions, with one power iteration per
+// step from the Q of the last step. The other gradients are sent as they are.
+class PowerSGDCompressor : public GradientCompressor {
+ public:
+  PowerSGDCompressor(ProcessGroup* process_group, int rank);
+
+  std::shared_ptr<ProcessGroup::Task> AllReduce(
+      size_t group_id,
+      phi::DenseTensor* contents,
+      const std::vector<phi::DenseTensor>& grads) override;
+
+ private:
+  int rank_;
+  std::unordered_map<size_t, std::vector<float>> qs_;
+};
+
+}  // namespace distributed
+}  // namespace paddle
@@ -27,11 +27,14 @@
 #include <gloo/reduce.h>
 
 #include "glog/logging.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/collective/common.h"
 #include "paddle/fluid/distributed/collective/process_group_gloo.h"
 #include "paddle/phi/core/distributed/comm_context_manager.h"
 #include "paddle/phi/core/enforce.h"
 
+COMMON_DECLARE_bool(gloo_shm_allreduce);
+
 namespace paddle::distributed {
 
 #ifdef _WIN32
@@ -152,6 +155,41 @@ ProcessGroupGloo::GlooTask::GlooTask(
     int rank, const std::vector<phi::DenseTensor>& inputs, CommType comm_type)
     : ProcessGroup::Task(rank, inputs, comm_type) {}
 
+bool ProcessGroupGloo::GlooTask::Wait(std::chrono::milliseconds timeout) {
+  if (!async_) {
+    return true;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (timeout == kWaitTimeout) {
+    cv_.wait(lock, [&] { return is_completed_; });
+  } else {
+    cv_.wait_for(lock, timeout, [&] { return is_completed_; });
+    PADDLE_ENFORCE_EQ(
+        is_completed_,
+        true,
+        common::errors::InvalidArgument("Gloo operation timeout! "));
+  }
+  if (exception_) {
+    std::rethrow_exception(exception_);
+  }
+  return true;
+}
+
+bool ProcessGroupGloo::GlooTask::IsCompleted() {
+  if (!async_) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  return is_completed_;
+}
+
+void ProcessGroupGloo::GlooTask::Finish(std::exception_ptr exception) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  is_completed_ = true;
+  exception_ = exception;
+  cv_.notify_all();
+}
+
 ProcessGroupGloo::ProcessGroupGloo(
     const std::shared_ptr<phi::distributed::Store>& store,
     int rank,
@@ -163,6 +201,91 @@ ProcessGroupGloo::ProcessGroupGloo(
       _store(new GlooStore(store)) {
   _context = std::make_shared<gloo::rendezvous::Context>(rank, world_size);
   _context->connectFullMesh(*_store, options->device);
+#ifndef _WIN32
+  if (FLAGS_gloo_shm_allreduce && world_size > 1) {
+    InitShmAllReducer(store);
+  }
+#endif
+}
+
+#ifndef _WIN32
+void ProcessGroupGloo::InitShmAllReducer(
+    const std::shared_ptr<phi::distributed::Store>& store) {
+  std::string prefix = "gloo_shm_allreduce/" + std::to_string(gid_) + "/";
+  size_t size = phi::distributed::ShmAllReducer::MemorySize(size_);
+  std::unique_ptr<phi::distributed::ShmSegment> segment;
+  // whether rank 0 has created the segment, and its name
+  if (rank_ == 0) {
+    segment = phi::distributed::ShmSegment::Create(size);
+    std::vector<uint8_t> value{static_cast<uint8_t>(segment != nullptr)};
+    if (segment != nullptr) {
+      value.insert(value.end(), segment->name().begin(), segment->name().end());
+    }
+    store->set(prefix + "name", value);
+  }
+  auto value = store->get(prefix + "name");
+  if (rank_ != 0 && value[0]) {
+    segment = phi::distributed::ShmSegment::Open(
+        std::string(value.begin() + 1, value.end()), size);
+  }
+  store->set(prefix + std::to_string(rank_),
+             std::vector<uint8_t>{static_cast<uint8_t>(segment != nullptr)});
+  bool all_mapped = true;
+  for (int i = 0; i < size_; ++i) {
+    all_mapped = store->get(prefix + std::to_string(i))[0] && all_mapped;
+  }
+  if (segment != nullptr && rank_ == 0) {
+    segment->Unlink();
+  }
+  if (all_mapped) {
+    _shm_allreducer = std::make_unique<phi::distributed::ShmAllReducer>(
+        std::move(segment), rank_, size_);
+  }
+  VLOG(3) << "ProcessGroupGloo " << gid_ << " allreduce through "
+          << (all_mapped ? "shared memory" : "gloo");
+}
+#endif
+
+ProcessGroupGloo::~ProcessGroupGloo() {
+  {
+    std::lock_guard<std::mutex> lock(_queue_mutex);
+    _stop = true;
+  }
+  _queue_cv.notify_all();
+  if (_worker.joinable()) {
+    _worker.join();
+  }
+}
+
+void ProcessGroupGloo::Enqueue(std::shared_ptr<GlooTask> task) {
+  task->async_ = true;
+  std::lock_guard<std::mutex> lock(_queue_mutex);
+  if (!_worker.joinable()) {
+    _worker = std::thread(&ProcessGroupGloo::WorkLoop, this);
+  }
+  _queue.push_back(std::move(task));
+  _queue_cv.notify_one();
+}
+
+void ProcessGroupGloo::WorkLoop() {
+  std::unique_lock<std::mutex> lock(_queue_mutex);
+  while (true) {
+    // the tasks enqueued are run before stop
+    _queue_cv.wait(lock, [&] { return _stop || !_queue.empty(); });
+    if (_queue.empty()) {
+      return;
+    }
+    auto task = std::move(_queue.front());
+    _queue.pop_front();
+    lock.unlock();
+    try {
+      task->Run();
+      task->Finish(nullptr);
+    } catch (...) {
+      task->Finish(std::current_exception());
+    }
+    lock.lock();
+  }
 }
 
 class BroadcastGlooTask : public ProcessGroupGloo::GlooTask {
@@ -350,6 +473,36 @@ class AllreduceGlooTask : public ProcessGroupGloo::GlooTask {
   }
 };
 
+#ifndef _WIN32
+class ShmAllreduceGlooTask : public ProcessGroupGloo::GlooTask {
+ public:
+  ShmAllreduceGlooTask(int rank,
+                       phi::distributed::ShmAllReducer* shm_allreducer,
+                       std::vector<phi::DenseTensor>& inputs,   // NOLINT
+                       std::vector<phi::DenseTensor>& outputs,  // NOLINT
+                       ReduceOp reduce_op)
+      : ProcessGroupGloo::GlooTask(rank, inputs, CommType::ALLREDUCE),
+        _shm_allreducer(shm_allreducer),
+        _inputs(inputs),
+        _outputs(outputs),
+        _reduce_op(reduce_op) {}
+
+  void Run() override {
+    _shm_allreducer->AllReduce(_outputs[0].data(),
+                               _inputs[0].data(),
+                               _inputs[0].numel(),
+                               _inputs[0].dtype(),
+                               _reduce_op);
+  }
+
+ private:
+  phi::distributed::ShmAllReducer* _shm_allreducer;
+  std::vector<phi::DenseTensor> _inputs;
+  std::vector<phi::DenseTensor> _outputs;
+  const ReduceOp _reduce_op;
+};
+#endif
+
 std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllReduce(
     phi::DenseTensor* out_tensor,
     const phi::DenseTensor& in_tensor,
@@ -377,10 +530,31 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupGloo::AllReduce(
 
   auto tag = next_tag();
   std::shared_ptr<GlooTask> task;
+#ifndef _WIN32
+  if (_shm_allreducer != nullptr && inputs.size() == 1 &&
+      outputs.size() == 1 && inputs[0].numel() == outputs[0].numel() &&
+      phi::distributed::ShmAllReducer::IsSupported(inputs[0].dtype(),
+                                                   opts.reduce_op)) {
+    task = std::make_shared<ShmAllreduceGlooTask>(
+        rank_, _shm_allreducer.get(), inputs, outputs, opts.reduce_op);
+    // the worker thread keeps the shared memory allreduce in the order of
+    // the calls, the same on all the ranks
+    Enqueue(task);
+    if (sync_op) {
+      task->Wait();
+    }
+    return task;
+  }
+#endif
   auto comm_context = this->GetCommContext();
   task = std::make_shared<AllreduceGlooTask>(
       rank_, comm_context, inputs, outputs, opts.reduce_op, tag);
-  task->Run();
+  if (sync_op) {
+    task->Run();
+  } else {
+    // the tag keeps it apart from the collectives run meanwhile
+    Enqueue(task);
+  }
   return task;
 }
 
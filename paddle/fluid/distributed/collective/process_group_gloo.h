@@ -14,14 +14,19 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <future>
 #include <memory>
 #include <mutex>
+#include <thread>
 
 #include "paddle/fluid/distributed/collective/process_group.h"
 #include "paddle/fluid/distributed/collective/process_group_without_stream.h"
 #include "paddle/phi/backends/context_pool.h"
 #include "paddle/phi/core/distributed/gloo_comm_context.h"
+#include "paddle/phi/core/distributed/shm_transport.h"
 #include "paddle/phi/core/distributed/store/store.h"
 #include "paddle/phi/core/distributed/store/tcp_store.h"
 
@@ -40,12 +45,20 @@ class ProcessGroupGloo : public ProcessGroupWithoutStream {
     ~GlooTask() = default;
 
     virtual void Run() = 0;
-    bool Wait(std::chrono::milliseconds timeout) override { return true; }
-    bool IsCompleted() override { return true; }
-    void Synchronize() override {}
+    bool Wait(std::chrono::milliseconds timeout = kWaitTimeout) override;
+    bool IsCompleted() override;
+    void Synchronize() override { Wait(); }
 
    protected:
     friend class ProcessGroupGloo;
+
+   private:
+    void Finish(std::exception_ptr exception);
+
+    // run by the worker thread of the process group, not by the caller
+    bool async_{false};
+    std::condition_variable cv_;
+    std::exception_ptr exception_;
   };
 
   class GlooStore : public ::gloo::rendezvous::Store {
@@ -89,7 +102,7 @@ class ProcessGroupGloo : public ProcessGroupWithoutStream {
       int world_size,
       int gid);
 
-  ~ProcessGroupGloo() = default;
+  ~ProcessGroupGloo();
 
   std::shared_ptr<ProcessGroup::Task> AllGather(
       phi::DenseTensor* out_tensor,
@@ -213,9 +226,31 @@ class ProcessGroupGloo : public ProcessGroupWithoutStream {
   static std::shared_ptr<::gloo::transport::Device> createDefaultDevice();
 
  private:
+  // Run the task by the worker thread in the order of the calls, so that the
+  // caller goes on while it communicates.
+  void Enqueue(std::shared_ptr<GlooTask> task);
+  void WorkLoop();
+
+#ifndef _WIN32
+  // Allreduce through shared memory if all the ranks map the segment created
+  // by rank 0, which they can only on the same host.
+  void InitShmAllReducer(const std::shared_ptr<phi::distributed::Store>& store);
+#endif
+
   uint32_t _tag;
   std::shared_ptr<gloo::rendezvous::Context> _context;
   std::shared_ptr<::gloo::rendezvous::Store> _store;
+
+  std::mutex _queue_mutex;
+  std::condition_variable _queue_cv;
+  std::deque<std::shared_ptr<GlooTask>> _queue;
+  bool _stop{false};
+  std::thread _worker;
+
+#ifndef _WIN32
+  // run by the worker thread only, in the order of the calls
+  std::unique_ptr<phi::distributed::ShmAllReducer> _shm_allreducer;
+#endif
 };
 
 }  // namespace distributed
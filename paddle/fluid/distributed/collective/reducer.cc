@@ -21,6 +21,8 @@
 
 PD_DECLARE_bool(use_stream_safe_cuda_allocator);
 COMMON_DECLARE_string(allocator_strategy);
+COMMON_DECLARE_bool(gloo_async_allreduce);
+COMMON_DECLARE_string(cpu_grad_compression);
 
 namespace paddle {
 namespace distributed {
@@ -505,6 +507,11 @@ EagerReducer::EagerReducer(
   // initialize groups
   InitializeGroups(group_indices);
 
+  if (phi::is_cpu_place(inner_place_)) {
+    compressor_ = GradientCompressor::Create(FLAGS_cpu_grad_compression,
+                                             process_group_.get());
+  }
+
   for (size_t global_var_index = 0; global_var_index < tensors_.size();
        ++global_var_index) {
     auto tensor = tensors_[global_var_index];
@@ -1067,8 +1074,10 @@ void EagerReducer::FinalizeBackward() {
   grad_need_hooks_ = false;
   for (auto &group : groups_) {
     if (!group.is_sparse_) {
+      // the groups are split as they finish, while the later ones are
+      // still communicated
       group.task->Synchronize();
-      if (!IsStreamSafeAllocator()) {
+      if (!IsStreamSafeAllocator() || group.is_async_) {
         auto *default_ctx =
             phi::DeviceContextPool::Instance().Get(inner_place_);
         group.SplitTensors(*default_ctx);
@@ -1108,11 +1117,25 @@ void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
   for (auto &t : reduce_tensors) {
     in_out.push_back(*std::dynamic_pointer_cast<phi::DenseTensor>(t.impl()));
   }
-  group->task = process_group_->AllReduce(in_out, in_out, opts);
+  // on cpu with gloo backward goes on while the group is communicated, and
+  // the group is split in FinalizeBackward
+  group->is_async_ = phi::is_cpu_place(inner_place_) &&
+                     FLAGS_gloo_async_allreduce &&
+                     process_group_->GetBackendName() == "GLOO";
+  if (compressor_ != nullptr && group->dtype_ == phi::DataType::FLOAT32) {
+    group->is_async_ = false;
+    group->task = compressor_->AllReduce(curr_group_index,
+                                         in_out.data(),
+                                         group->dense_tensors_);
+  } else if (group->is_async_) {
+    group->task = process_group_->AllReduce(in_out, in_out, opts, false);
+  } else {
+    group->task = process_group_->AllReduce(in_out, in_out, opts);
+  }
 
   auto *context = process_group_->GetDeviceContext(inner_place_);
 
-  if (IsStreamSafeAllocator()) {
+  if (IsStreamSafeAllocator() && !group->is_async_) {
     // NOTE(shenliang03): The best_fit allocator strategy is multi-stream
     // insecure. In the Split operator, additional memory will be applied for
     // calculation, and if it is asynchronous, an illegal memory access may be
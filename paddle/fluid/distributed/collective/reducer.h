@@ -17,6 +17,7 @@
 #include <map>
 #include <vector>
 
+#include "paddle/fluid/distributed/collective/gradient_compressor.h"
 #include "paddle/fluid/distributed/collective/process_group.h"
 #include "paddle/fluid/eager/accumulation/accumulation_node.h"
 #include "paddle/fluid/eager/api/utils/hook_utils.h"
@@ -49,6 +50,8 @@ class EagerGroup {
   Tensor dense_contents_;
   Tensor sparse_contents_;
   bool is_sparse_ = false;
+  // allreduced by the worker thread of the process group
+  bool is_async_ = false;
 
   // for concat kernel
   std::vector<phi::DenseTensor> dense_tensors_;
@@ -139,6 +142,9 @@ class EagerReducer {
   bool find_unused_vars_once_{true};
   bool groups_need_finalize_{false};
   Tensor global_used_vars_;
+
+  // FLAGS_cpu_grad_compression on cpu, nullptr if not set
+  std::unique_ptr<GradientCompressor> compressor_;
 };
 
 }  //  namespace distributed
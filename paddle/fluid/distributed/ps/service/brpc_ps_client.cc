@@ -79,6 +79,11 @@ PD_DEFINE_int32(pserver_sparse_table_shard_num,
                 1000,
                 "sparse table shard for save & load");
 
+PD_DEFINE_bool(pserver_shm_transport,
+               true,
+               "sparse pull and push to the pservers on the same host through "
+               "shared memory");
+
 inline size_t get_sparse_shard(uint32_t shard_num,
                                uint32_t server_num,
                                uint64_t key) {
@@ -326,6 +331,7 @@ int32_t BrpcPsClient::Initialize() {
     }
     os << server_ip_port << ",";
   }
+  InitializeShmChannels();
   // 启动client探听接口, 并相互建立连接
   StartClientService();
 
@@ -342,6 +348,16 @@ int32_t BrpcPsClient::Initialize() {
       _push_sparse_task_queue_map[table_id] =
           ::paddle::framework::MakeChannel<SparseAsyncTask *>();
       _push_sparse_merge_count_map[table_id] = 0;
+      const auto &codec_param =
+          worker_param.downpour_table_param(i).wire_codec();
+      if (codec_param.enable()) {
+        auto codec =
+            SparseWireCodec::ParseValueCodec(codec_param.value_codec());
+        _pull_sparse_codec_map[table_id] =
+            SparseWireCodec(codec, codec_param.pull_raw_dim());
+        _push_sparse_codec_map[table_id] =
+            SparseWireCodec(codec, codec_param.push_raw_dim());
+      }
     }
   }
 
@@ -719,6 +735,38 @@ void BrpcPsClient::PrintQueueSizeThread() {
   }
 }
 
+void BrpcPsClient::InitializeShmChannels() {
+  _shm_channels.resize(_server_channels.size());
+  if (!FLAGS_pserver_shm_transport) {
+    return;
+  }
+  for (size_t i = 0; i < _server_channels.size(); ++i) {
+    auto channel = ShmRpcChannel::Create();
+    if (channel == nullptr) {
+      return;
+    }
+    // the server maps the segment only if it is on this host
+    brpc::Controller cntl;
+    PsRequestMessage request;
+    PsResponseMessage response;
+    request.set_cmd_id(PS_SHM_CONNECT);
+    request.set_table_id(0);
+    request.set_client_id(_client_id);
+    request.add_params(channel->name());
+    PsService_Stub rpc_stub(GetCmdChannel(i));
+    rpc_stub.service(&cntl, &request, &response, nullptr);
+    if (cntl.Failed() || response.err_code() != 0) {
+      VLOG(1) << "BrpcPsClient connects to server " << i << " by brpc: "
+              << (cntl.Failed() ? cntl.ErrorText() : response.err_msg());
+      continue;
+    }
+    VLOG(0) << "BrpcPsClient connects to server " << i
+            << " through shared memory " << channel->name();
+    channel->Start();
+    _shm_channels[i] = std::move(channel);
+  }
+}
+
 void BrpcPsClient::FinalizeWorker() {
   Flush();
   VLOG(0) << "BrpcPsClient::FinalizeWorker begin join thread";
@@ -1167,11 +1215,19 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
   auto *accessor = GetTableAccessor(table_id);
 
   size_t value_size = accessor->GetAccessorInfo().select_size;
+  auto codec_iter = _pull_sparse_codec_map.find(table_id);
+  bool use_codec = codec_iter != _pull_sparse_codec_map.end();
+  SparseWireCodec codec = use_codec ? codec_iter->second : SparseWireCodec();
 
   DownpourBrpcClosure *closure = new DownpourBrpcClosure(
-      request_call_num, [shard_sorted_kvs, value_size](void *done) {
+      request_call_num,
+      [shard_sorted_kvs, value_size, use_codec, codec](void *done) {
         int ret = 0;
         auto *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
+        size_t value_dim = value_size / sizeof(float);
+        size_t row_size =
+            use_codec ? codec.EncodedRowSize(value_dim) : value_size;
+        std::vector<char> row(row_size);
         for (size_t i = 0; i < shard_sorted_kvs->size(); ++i) {
           if (closure->check_response(i, PS_PULL_SPARSE_TABLE) != 0) {
             ret = -1;
@@ -1192,13 +1248,16 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
             } else {
               last_key = kv_pair.first;
               last_value_data = kv_pair.second;
-              if (value_size !=
-                  io_buffer_itr.copy_and_forward(
-                      reinterpret_cast<void *>(last_value_data), value_size)) {
+              void *dst = use_codec ? row.data()
+                                    : reinterpret_cast<void *>(last_value_data);
+              if (row_size != io_buffer_itr.copy_and_forward(dst, row_size)) {
                 LOG(WARNING) << "res data is lack or not in format";
                 ret = -1;
                 break;
               }
+              if (use_codec) {
+                codec.DecodeRow(row.data(), value_dim, last_value_data);
+              }
             }
           }
         }
@@ -1224,15 +1283,16 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
     auto &request_buffer = closure->cntl(i)->request_attachment();
 
     request_buffer.append(reinterpret_cast<void *>(&is_training), sizeof(bool));
+    std::vector<uint64_t> request_keys;
     std::vector<uint32_t> keys_counter;
+    request_keys.reserve(sorted_kv_size);
     keys_counter.reserve(sorted_kv_size);
 
     for (size_t kv_idx = 0; kv_idx < sorted_kv_size; ++kv_idx) {
       ++kv_request_count;
       uint32_t keys = 1;
       last_key = sorted_kvs[kv_idx].first;
-      request_buffer.append(reinterpret_cast<void *>(&last_key),
-                            sizeof(uint64_t));
+      request_keys.push_back(last_key);
       while (kv_idx < sorted_kv_size - 1 &&
              last_key == sorted_kvs[kv_idx + 1].first) {
         ++kv_idx;
@@ -1241,8 +1301,19 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
       keys_counter.push_back(keys);
     }
 
-    request_buffer.append(reinterpret_cast<void *>(keys_counter.data()),
-                          sizeof(uint32_t) * keys_counter.size());
+    if (use_codec) {
+      std::string encoded;
+      SparseWireCodec::EncodeKeys(
+          request_keys.data(), request_keys.size(), &encoded);
+      SparseWireCodec::EncodeCounts(
+          keys_counter.data(), keys_counter.size(), &encoded);
+      request_buffer.append(encoded);
+    } else {
+      request_buffer.append(reinterpret_cast<void *>(request_keys.data()),
+                            sizeof(uint64_t) * request_keys.size());
+      request_buffer.append(reinterpret_cast<void *>(keys_counter.data()),
+                            sizeof(uint32_t) * keys_counter.size());
+    }
 
     if (kv_request_count == 0) {
       closure->Run();
@@ -1252,6 +1323,9 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
       closure->request(i)->set_client_id(_client_id);
       closure->request(i)->add_params((char *)&kv_request_count,  // NOLINT
                                       sizeof(uint32_t));
+      if (use_codec) {
+        closure->request(i)->add_params(codec.Header());
+      }
       PsService_Stub rpc_stub(GetCmdChannel(i));
       closure->cntl(i)->set_log_id(butil::gettimeofday_ms());
       rpc_stub.service(
@@ -1858,19 +1932,43 @@ int BrpcPsClient::PushSparseAsyncShardPush(
                            sizeof(uint32_t));  // NOLINT
   auto *push_data = push_request->mutable_data();
   int update_size = accessor->GetAccessorInfo().update_size;
-  push_data->resize(merged_kv_count * (sizeof(uint64_t) + update_size));
-  char *push_data_ptr = const_cast<char *>(push_data->data());
-  memcpy(push_data_ptr,
-         merged_key_list.data(),
-         merged_kv_count * sizeof(uint64_t));
-  push_data_ptr += merged_kv_count * sizeof(uint64_t);
-  for (size_t i = 0; i < merged_kv_count; ++i) {
-    const char *task_data_ptr = merged_value_list[i].data();
-
+  auto codec_iter = _push_sparse_codec_map.find(table_id);
+  if (codec_iter != _push_sparse_codec_map.end()) {
+    /*
+    Push Content:
+    |---keysVarint---|---encodedValuesData---|
+    */
+    const auto &codec = codec_iter->second;
+    push_request->add_params(codec.Header());
+    size_t update_dim = update_size / sizeof(float);
+    size_t row_size = codec.EncodedRowSize(update_dim);
+    SparseWireCodec::EncodeKeys(
+        merged_key_list.data(), merged_kv_count, push_data);
+    size_t key_bytes = push_data->size();
+    push_data->resize(key_bytes + merged_kv_count * row_size);
+    char *push_data_ptr = const_cast<char *>(push_data->data()) + key_bytes;
+    for (size_t i = 0; i < merged_kv_count; ++i) {
+      codec.EncodeRow(
+          reinterpret_cast<const float *>(merged_value_list[i].data()),
+          update_dim,
+          push_data_ptr);
+      push_data_ptr += row_size;
+    }
+  } else {
+    push_data->resize(merged_kv_count * (sizeof(uint64_t) + update_size));
+    char *push_data_ptr = const_cast<char *>(push_data->data());
     memcpy(push_data_ptr,
-           (float *)(task_data_ptr),  // NOLINT
-           update_size);
-    push_data_ptr += update_size;
+           merged_key_list.data(),
+           merged_kv_count * sizeof(uint64_t));
+    push_data_ptr += merged_kv_count * sizeof(uint64_t);
+    for (size_t i = 0; i < merged_kv_count; ++i) {
+      const char *task_data_ptr = merged_value_list[i].data();
+
+      memcpy(push_data_ptr,
+             (float *)(task_data_ptr),  // NOLINT
+             update_size);
+      push_data_ptr += update_size;
+    }
   }
   PsService_Stub rpc_stub(GetSparseChannel(shard_idx));
   closure->cntl(shard_idx)->set_request_compress_type(
@@ -27,6 +27,8 @@
 #include "paddle/fluid/distributed/ps/service/brpc_utils.h"
 #include "paddle/fluid/distributed/ps/service/ps_client.h"
 #include "paddle/fluid/distributed/ps/service/sendrecv.pb.h"
+#include "paddle/fluid/distributed/ps/service/shm_rpc_channel.h"
+#include "paddle/fluid/distributed/ps/service/sparse_wire_codec.h"
 #include "paddle/fluid/framework/channel.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/scope.h"
@@ -320,7 +322,11 @@ class BrpcPsClient : public PSClient {
 
  protected:
   virtual size_t GetServerNums() { return _server_channels.size(); }
-  inline brpc::Channel *GetSparseChannel(size_t server_id) {
+  inline ::google::protobuf::RpcChannel *GetSparseChannel(size_t server_id) {
+    if (server_id < _shm_channels.size() &&
+        _shm_channels[server_id] != nullptr) {
+      return _shm_channels[server_id].get();
+    }
     return _server_channels[server_id][0].get();
   }
   inline brpc::Channel *GetDenseChannel(size_t server_id) {
@@ -330,6 +336,8 @@ class BrpcPsClient : public PSClient {
     return _server_channels[server_id][2].get();
   }
   int32_t Initialize() override;
+  // The sparse channels to the servers on this host use shared memory.
+  void InitializeShmChannels();
 
   // for fl
  public:
@@ -368,6 +376,9 @@ class BrpcPsClient : public PSClient {
   std::unordered_map<uint32_t, paddle::framework::Channel<SparseAsyncTask *>>
       _push_sparse_task_queue_map;
   std::unordered_map<uint32_t, uint32_t> _push_sparse_merge_count_map;
+  // wire codec of the sparse tables with TableParameter.wire_codec enabled
+  std::unordered_map<uint32_t, SparseWireCodec> _pull_sparse_codec_map;
+  std::unordered_map<uint32_t, SparseWireCodec> _push_sparse_codec_map;
 
   std::thread _print_thread;
 
@@ -392,6 +403,8 @@ class BrpcPsClient : public PSClient {
       _client_channels;  // client2client
   std::vector<std::array<std::shared_ptr<brpc::Channel>, 3>>
       _server_channels;  // client2server
+  std::vector<std::unique_ptr<ShmRpcChannel>>
+      _shm_channels;  // client2server on the same host
   std::vector<std::array<std::shared_ptr<brpc::Channel>, 1>>
       _coordinator_channels;  // client2coordinator
   std::future<int32_t> PushDenseRawGradient(int table_id,
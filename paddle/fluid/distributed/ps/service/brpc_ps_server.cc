@@ -14,10 +14,12 @@
 
 #include "paddle/fluid/distributed/ps/service/brpc_ps_server.h"
 
+#include <algorithm>
 #include <thread>  // NOLINT
 
 #include "butil/object_pool.h"
 #include "paddle/fluid/distributed/common/cost_timer.h"
+#include "paddle/fluid/distributed/ps/service/sparse_wire_codec.h"
 #include "paddle/fluid/distributed/ps/table/depends/sparse_utils.h"
 #include "paddle/fluid/distributed/ps/table/table.h"
 #include "paddle/fluid/framework/archive.h"
@@ -221,6 +223,7 @@ int32_t BrpcPsService::Initialize() {
   _service_handler_map[PS_REVERT] = &BrpcPsService::Revert;
   _service_handler_map[PS_CHECK_SAVE_PRE_PATCH_DONE] =
       &BrpcPsService::CheckSavePrePatchDone;
+  _service_handler_map[PS_SHM_CONNECT] = &BrpcPsService::ShmConnect;
 
   auto &profiler = CostProfiler::instance();
   profiler.register_profiler("pserver_server_pull_dense");
@@ -535,7 +538,37 @@ int32_t BrpcPsService::PullSparse(Table *table,
 
   auto value = PullSparseValue(num, dim);
 
-  value.DeserializeFromBytes(const_cast<void *>(data));
+  SparseWireCodec codec;
+  bool use_codec = request.params_size() >= 2;
+  if (use_codec) {
+    /*
+    |---isTraining---|---keysVarint---|---frequenciesVarint---|
+    */
+    if (!SparseWireCodec::ParseHeader(request.params(1), &codec)) {
+      set_response_code(response, -1, "unknown sparse wire codec");
+      return 0;
+    }
+    thread_local std::vector<uint64_t> keys;
+    thread_local std::vector<uint32_t> frequencies;
+    keys.resize(num);
+    frequencies.resize(num);
+    const char *begin = reinterpret_cast<const char *>(data);
+    const char *end = begin + req_buffer_size;
+    const char *pos = SparseWireCodec::DecodeKeys(
+        begin + sizeof(bool), end, num, keys.data());
+    if (pos != nullptr) {
+      pos = SparseWireCodec::DecodeCounts(pos, end, num, frequencies.data());
+    }
+    if (pos == nullptr) {
+      set_response_code(response, -1, "req attachment is not in format");
+      return 0;
+    }
+    value.is_training_ = *reinterpret_cast<const bool *>(begin);
+    value.feasigns_ = keys.data();
+    value.frequencies_ = frequencies.data();
+  } else {
+    value.DeserializeFromBytes(const_cast<void *>(data));
+  }
 
   auto res_data = butil::get_object<std::vector<float>>();
   res_data->resize(num * dim);
@@ -546,8 +579,19 @@ int32_t BrpcPsService::PullSparse(Table *table,
   table->Pull(table_context);
   // table->PullSparse(res_data->data(), value);
 
-  cntl->response_attachment().append(reinterpret_cast<char *>(res_data->data()),
-                                     res_data->size() * sizeof(float));
+  if (use_codec) {
+    size_t row_size = codec.EncodedRowSize(dim);
+    thread_local std::string encoded;
+    encoded.resize(num * row_size);
+    for (uint32_t i = 0; i < num; ++i) {
+      codec.EncodeRow(res_data->data() + i * dim, dim, &encoded[i * row_size]);
+    }
+    cntl->response_attachment().append(encoded.data(), encoded.size());
+  } else {
+    cntl->response_attachment().append(
+        reinterpret_cast<char *>(res_data->data()),
+        res_data->size() * sizeof(float));
+  }
   butil::return_object(res_data);
   return 0;
 }
@@ -585,6 +629,35 @@ int32_t BrpcPsService::PushSparse(Table *table,
   table_context.push_context.values =
       (const float *)(push_data.data() + sizeof(uint64_t) * num);
   table_context.num = num;
+  if (request.params_size() >= 2) {
+    /*
+    Push Content:
+    |---keysVarint---|---encodedValuesData---|
+    */
+    SparseWireCodec codec;
+    if (!SparseWireCodec::ParseHeader(request.params(1), &codec)) {
+      set_response_code(response, -1, "unknown sparse wire codec");
+      return 0;
+    }
+    auto dim = table->GetValueAccessor()->GetAccessorInfo().update_dim;
+    size_t row_size = codec.EncodedRowSize(dim);
+    thread_local std::vector<uint64_t> keys;
+    thread_local std::vector<float> values;
+    keys.resize(num);
+    values.resize(num * dim);
+    const char *end = push_data.data() + push_data.size();
+    const char *pos =
+        SparseWireCodec::DecodeKeys(push_data.data(), end, num, keys.data());
+    if (pos == nullptr || static_cast<size_t>(end - pos) != num * row_size) {
+      set_response_code(response, -1, "push sparse data is not in format");
+      return 0;
+    }
+    for (uint32_t i = 0; i < num; ++i) {
+      codec.DecodeRow(pos + i * row_size, dim, values.data() + i * dim);
+    }
+    table_context.push_context.keys = keys.data();
+    table_context.push_context.values = values.data();
+  }
   // const uint64_t *keys = (const uint64_t *)push_data.data();
   // const float *values = (const float *)(push_data.data() + sizeof(uint64_t) *
   // num);
@@ -798,6 +871,38 @@ int32_t BrpcPsService::CheckSavePrePatchDone(Table *table,
   return 0;
 }
 
+int32_t BrpcPsService::ShmConnect(Table *table,
+                                  const PsRequestMessage &request,
+                                  PsResponseMessage &response,
+                                  brpc::Controller *cntl) {
+  if (request.params_size() < 1) {
+    set_response_code(response,
+                      -1,
+                      "PsRequestMessage.params is required at least 1 for "
+                      "the name of shared memory");
+    return 0;
+  }
+  auto shm_server = ShmRpcServer::Create(request.params(0), this);
+  if (shm_server == nullptr) {
+    // the client is on another host
+    set_response_code(response, -1, "shared memory not found");
+    return 0;
+  }
+  VLOG(1) << "pserver serves client " << request.client_id()
+          << " through shared memory " << request.params(0);
+  std::lock_guard<std::mutex> lock(_shm_mutex);
+  // drop the servers of the clients that have gone
+  _shm_servers.erase(
+      std::remove_if(_shm_servers.begin(),
+                     _shm_servers.end(),
+                     [](const std::unique_ptr<ShmRpcServer> &server) {
+                       return server->IsClosed();
+                     }),
+      _shm_servers.end());
+  _shm_servers.push_back(std::move(shm_server));
+  return 0;
+}
+
 int32_t BrpcPsService::ShrinkTable(Table *table,
                                    const PsRequestMessage &request,
                                    PsResponseMessage &response,
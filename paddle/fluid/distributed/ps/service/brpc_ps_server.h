@@ -19,6 +19,7 @@
 #include "brpc/server.h"
 #include "paddle/fluid/distributed/ps/service/brpc_utils.h"
 #include "paddle/fluid/distributed/ps/service/server.h"
+#include "paddle/fluid/distributed/ps/service/shm_rpc_channel.h"
 
 namespace brpc {
 class Controller;
@@ -197,11 +198,19 @@ class BrpcPsService : public PsBaseService {
                                 PsResponseMessage &response,  // NOLINT
                                 brpc::Controller *cntl);
 
+  int32_t ShmConnect(Table *table,
+                     const PsRequestMessage &request,
+                     PsResponseMessage &response,  // NOLINT
+                     brpc::Controller *cntl);
+
   bool _is_initialize_shard_info;
   std::mutex _initialize_shard_mutex;
   std::unordered_map<int32_t, serviceHandlerFunc> _service_handler_map;
   std::unordered_map<int32_t, serviceHandlerFunc> _msg_handler_map;
   std::vector<float> _ori_values;
+  // the calls of the clients on this host through shared memory
+  std::mutex _shm_mutex;
+  std::vector<std::unique_ptr<ShmRpcServer>> _shm_servers;
 };
 
 class DownpourPServerBrpcClosure : public PServerClosure {
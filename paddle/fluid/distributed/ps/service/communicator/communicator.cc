@@ -23,6 +23,10 @@ limitations under the License. */
 #include "paddle/phi/core/platform/profiler.h"
 #include "paddle/utils/string/string_helper.h"
 
+COMMON_DECLARE_int64(communicator_sparse_cache_capacity);
+COMMON_DECLARE_string(communicator_sparse_cache_policy);
+COMMON_DECLARE_int32(communicator_sparse_cache_max_staleness);
+
 #define LEARNING_RATE_DECAY_COUNTER "@LR_DECAY_COUNTER@"
 #define STEP_COUNTER "@PS_STEP_COUNTER@"
 
@@ -611,6 +615,10 @@ void AsyncCommunicator::PullSparseToTensorSync(
   float *output_data = nullptr;
   size_t output_index = -1;
   size_t output_len = 0;
+  SparseValueCache *cache = GetSparseCache(table_id, fea_dim);
+  if (cache != nullptr) {
+    cache->AdvanceStep();
+  }
   for (auto tensor : *inputs) {
     const int64_t *ids = tensor->data<int64_t>();
     size_t len = tensor->numel();
@@ -647,10 +655,17 @@ void AsyncCommunicator::PullSparseToTensorSync(
                sizeof(float) * fea_dim);
         continue;
       }
+      if (cache != nullptr &&
+          cache->Lookup(real_id, output_data + output_len)) {
+        continue;
+      }
       fea_keys.push_back(real_id);
       pull_result_ptr.push_back(output_data + output_len);
     }
   }
+  if (fea_keys.empty()) {
+    return;
+  }
   auto status = _worker_ptr->PullSparse(pull_result_ptr.data(),
                                         table_id,
                                         fea_keys.data(),
@@ -661,9 +676,49 @@ void AsyncCommunicator::PullSparseToTensorSync(
   if (ret != 0) {
     LOG(ERROR) << "fleet pull sparse failed, status[" << ret << "]";
     sleep(sleep_seconds_before_fail_exit_);
+  } else if (cache != nullptr) {
+    for (size_t i = 0; i < fea_keys.size(); ++i) {
+      cache->Insert(fea_keys[i], pull_result_ptr[i]);
+    }
   }
 }
 
+SparseValueCache *AsyncCommunicator::GetSparseCache(const uint64_t table_id,
+                                                    int fea_dim) {
+  if (FLAGS_communicator_sparse_cache_capacity <= 0) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(sparse_cache_mutex_);
+  auto &cache = sparse_caches_[table_id];
+  if (cache == nullptr) {
+    cache = std::make_unique<SparseValueCache>(
+        FLAGS_communicator_sparse_cache_capacity,
+        fea_dim,
+        SparseValueCache::ParsePolicy(FLAGS_communicator_sparse_cache_policy),
+        FLAGS_communicator_sparse_cache_max_staleness);
+  }
+  PADDLE_ENFORCE_EQ(
+      cache->dim(),
+      fea_dim,
+      common::errors::InvalidArgument(
+          "The fea_dim of the sparse cache of table %d is %d, but got %d.",
+          table_id,
+          cache->dim(),
+          fea_dim));
+  return cache.get();
+}
+
+SparseValueCache *AsyncCommunicator::FindSparseCache(const uint64_t table_id) {
+  std::lock_guard<std::mutex> lock(sparse_cache_mutex_);
+  auto iter = sparse_caches_.find(table_id);
+  return iter == sparse_caches_.end() ? nullptr : iter->second.get();
+}
+
+SparseCacheStat AsyncCommunicator::GetSparseCacheStat(const uint64_t table_id) {
+  SparseValueCache *cache = FindSparseCache(table_id);
+  return cache == nullptr ? SparseCacheStat() : cache->GetStat();
+}
+
 void AsyncCommunicator::PushSparseFromTensorAsync(
     const uint64_t table_id,
     int fea_dim,
@@ -820,6 +875,10 @@ void AsyncCommunicator::PushSparseFromTensorAsync(
                                         push_keys.data(),
                                         (const float **)push_g_vec.data(),
                                         push_keys.size());
+  SparseValueCache *cache = FindSparseCache(table_id);
+  if (cache != nullptr) {
+    cache->Invalidate(push_keys.data(), push_keys.size());
+  }
 }
 
 void HalfAsyncCommunicator::MainThread() {
@@ -905,6 +964,15 @@ void AsyncCommunicator::Stop() {
       main_thread_.reset(nullptr);
     }
   }
+  std::lock_guard<std::mutex> lock(sparse_cache_mutex_);
+  for (auto &iter : sparse_caches_) {
+    auto stat = iter.second->GetStat();
+    VLOG(0) << "sparse cache of table " << iter.first
+            << " hit rate: " << stat.HitRate() << ", hits: " << stat.hits
+            << ", stale misses: " << stat.stale_misses
+            << ", evictions: " << stat.evictions
+            << ", bytes saved: " << stat.bytes_saved;
+  }
   VLOG(1) << "Communicator stop done";
 }
 
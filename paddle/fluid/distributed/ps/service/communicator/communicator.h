@@ -31,6 +31,7 @@ limitations under the License. */
 
 #include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/ps/service/communicator/communicator_common.h"
+#include "paddle/fluid/distributed/ps/service/communicator/sparse_value_cache.h"
 #include "paddle/fluid/distributed/ps/service/coordinator_client.h"
 #include "paddle/fluid/distributed/ps/service/ps_client.h"
 #include "paddle/fluid/framework/channel.h"
@@ -495,7 +496,18 @@ class AsyncCommunicator : public Communicator {
                                  const phi::DenseTensor *clicks,
                                  std::vector<phi::DenseTensor *> *outputs);
 
+  // hits of the sparse value cache of the table, all zero if not cached
+  SparseCacheStat GetSparseCacheStat(const uint64_t table_id);
+
  protected:
+  // nullptr if FLAGS_communicator_sparse_cache_capacity is 0
+  SparseValueCache *GetSparseCache(const uint64_t table_id, int fea_dim);
+  SparseValueCache *FindSparseCache(const uint64_t table_id);
+
+  std::mutex sparse_cache_mutex_;
+  std::unordered_map<uint64_t, std::unique_ptr<SparseValueCache>>
+      sparse_caches_;
+
   std::unordered_map<std::string,
                      std::shared_ptr<BlockingQueue<std::shared_ptr<Variable>>>>
       send_varname_to_queue_;
@@ -0,0 +1,157 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/service/communicator/sparse_value_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "paddle/common/enforce.h"
+
+namespace paddle::distributed {
+
+SparseValueCache::SparseValueCache(size_t capacity,
+                                   int dim,
+                                   SparseCachePolicy policy,
+                                   int max_staleness,
+                                   int shard_num)
+    : dim_(dim),
+      max_staleness_(max_staleness),
+      shards_(shard_num) {
+  PADDLE_ENFORCE_GT(shard_num,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The shard num of SparseValueCache should be greater "
+                        "than 0, but got %d.",
+                        shard_num));
+  PADDLE_ENFORCE_GT(dim,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The dim of SparseValueCache should be greater than "
+                        "0, but got %d.",
+                        dim));
+  shard_capacity_ = std::max<size_t>(capacity / shard_num, 1);
+  max_counter_ = policy == SparseCachePolicy::kLfu ? 15 : 1;
+}
+
+SparseCachePolicy SparseValueCache::ParsePolicy(const std::string &name) {
+  if (name == "clock") {
+    return SparseCachePolicy::kClock;
+  } else if (name == "lfu") {
+    return SparseCachePolicy::kLfu;
+  }
+  PADDLE_THROW(common::errors::InvalidArgument(
+      "Unknown sparse cache policy %s, should be clock or lfu.", name));
+}
+
+size_t SparseValueCache::size() const {
+  size_t size = 0;
+  for (auto &shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    size += shard.keys.size();
+  }
+  return size;
+}
+
+bool SparseValueCache::Lookup(uint64_t key, float *value) {
+  Shard &shard = GetShard(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto iter = shard.index.find(key);
+  if (iter == shard.index.end()) {
+    ++shard.stat.misses;
+    return false;
+  }
+  uint32_t pos = iter->second;
+  int64_t pulled_step = shard.pulled_steps[pos];
+  if (pulled_step == kInvalid || step_ - pulled_step > max_staleness_) {
+    ++shard.stat.misses;
+    ++shard.stat.stale_misses;
+    return false;
+  }
+  if (shard.counters[pos] < max_counter_) {
+    ++shard.counters[pos];
+  }
+  memcpy(value, shard.values.data() + pos * dim_, dim_ * sizeof(float));
+  ++shard.stat.hits;
+  shard.stat.bytes_saved += sizeof(uint64_t) + dim_ * sizeof(float);
+  return true;
+}
+
+uint32_t SparseValueCache::Evict(Shard *shard) {
+  // a value that was used since the hand last passed is passed again
+  while (shard->counters[shard->hand] > 0) {
+    --shard->counters[shard->hand];
+    shard->hand = (shard->hand + 1) % shard->keys.size();
+  }
+  uint32_t pos = shard->hand;
+  shard->hand = (shard->hand + 1) % shard->keys.size();
+  shard->index.erase(shard->keys[pos]);
+  ++shard->stat.evictions;
+  return pos;
+}
+
+void SparseValueCache::Insert(uint64_t key, const float *value) {
+  Shard &shard = GetShard(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  uint32_t pos = 0;
+  auto iter = shard.index.find(key);
+  if (iter != shard.index.end()) {
+    pos = iter->second;
+  } else if (shard.keys.size() < shard_capacity_) {
+    pos = shard.keys.size();
+    shard.keys.push_back(key);
+    shard.counters.push_back(0);
+    shard.pulled_steps.push_back(0);
+    shard.values.resize(shard.values.size() + dim_);
+    shard.index.emplace(key, pos);
+  } else {
+    pos = Evict(&shard);
+    shard.keys[pos] = key;
+    shard.counters[pos] = 0;
+    shard.index.emplace(key, pos);
+  }
+  if (shard.counters[pos] < max_counter_) {
+    ++shard.counters[pos];
+  }
+  shard.pulled_steps[pos] = step_;
+  memcpy(shard.values.data() + pos * dim_, value, dim_ * sizeof(float));
+}
+
+void SparseValueCache::Invalidate(const uint64_t *keys, size_t num) {
+  for (size_t i = 0; i < num; ++i) {
+    Shard &shard = GetShard(keys[i]);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iter = shard.index.find(keys[i]);
+    if (iter != shard.index.end()) {
+      // the first to go when the hand passes
+      shard.pulled_steps[iter->second] = kInvalid;
+      shard.counters[iter->second] = 0;
+    }
+  }
+}
+
+SparseCacheStat SparseValueCache::GetStat() const {
+  SparseCacheStat stat;
+  for (auto &shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    stat.hits += shard.stat.hits;
+    stat.misses += shard.stat.misses;
+    stat.stale_misses += shard.stat.stale_misses;
+    stat.evictions += shard.stat.evictions;
+    stat.bytes_saved += shard.stat.bytes_saved;
+  }
+  return stat;
+}
+
+}  // namespace paddle::distributed
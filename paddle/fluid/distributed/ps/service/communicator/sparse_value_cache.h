@@ -0,0 +1,113 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace paddle {
+namespace distributed {
+
+enum class SparseCachePolicy {
+  kClock,  // second chance, one reference bit per value
+  kLfu,    // frequency counters that age as the clock hand passes
+};
+
+struct SparseCacheStat {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t stale_misses = 0;
+  uint64_t evictions = 0;
+  // bytes of keys and values not pulled from the servers
+  uint64_t bytes_saved = 0;
+
+  double HitRate() const {
+    uint64_t total = hits + misses;
+    return total == 0 ? 0 : static_cast<double>(hits) / total;
+  }
+};
+
+/**
+ * Bounded cache of the pulled values of a sparse table on a worker.
+ *
+ * The values are split into shards by key, each with its own lock and at
+ * most capacity / shard_num values that are evicted by a clock hand. The
+ * cache counts steps, one per pull of the table. A value is served until
+ * max_staleness more steps begin after the step it was pulled in, whether
+ * its key is pushed or not, so that it misses the updates of at most
+ * max_staleness steps from any worker. The keys pushed by this worker are
+ * invalidated, so that it sees its own updates in the next step. With
+ * max_staleness 0 every step pulls its keys again.
+ */
+class SparseValueCache {
+ public:
+  SparseValueCache(size_t capacity,
+                   int dim,
+                   SparseCachePolicy policy,
+                   int max_staleness,
+                   int shard_num = 16);
+
+  /** clock or lfu. */
+  static SparseCachePolicy ParsePolicy(const std::string &name);
+
+  int dim() const { return dim_; }
+  size_t size() const;
+
+  /** Copy the value of key to value, false if not cached or too stale. */
+  bool Lookup(uint64_t key, float *value);
+  /** Cache the value of key pulled in the current step. */
+  void Insert(uint64_t key, const float *value);
+  /** Drop the values of the keys just pushed, until they are pulled again. */
+  void Invalidate(const uint64_t *keys, size_t num);
+  /** Begin the next step, before its lookups. */
+  void AdvanceStep() { ++step_; }
+
+  SparseCacheStat GetStat() const;
+
+ private:
+  static constexpr int64_t kInvalid = -1;
+
+  struct Shard {
+    mutable std::mutex mutex;
+    std::unordered_map<uint64_t, uint32_t> index;
+    std::vector<uint64_t> keys;
+    std::vector<uint8_t> counters;
+    // the step that the value was pulled in, kInvalid once pushed
+    std::vector<int64_t> pulled_steps;
+    std::vector<float> values;
+    size_t hand = 0;
+    SparseCacheStat stat;
+  };
+
+  Shard &GetShard(uint64_t key) {
+    return shards_[(key * 0x9E3779B97F4A7C15ULL >> 32) % shards_.size()];
+  }
+  uint32_t Evict(Shard *shard);
+
+  size_t shard_capacity_;
+  int dim_;
+  int max_staleness_;
+  uint8_t max_counter_;
+  std::atomic<int64_t> step_{0};
+  std::vector<Shard> shards_;
+};
+
+}  // namespace distributed
+}  // namespace paddle
@@ -224,6 +224,35 @@ int32_t PsLocalClient::Initialize() {
   return done();
 }
 
+::std::future<int32_t> PsLocalClient::PullSparse(float** select_values,
+                                                 size_t table_id,
+                                                 const uint64_t* keys,
+                                                 size_t num,
+                                                 bool is_training) {
+  auto* accessor = GetTableAccessor(table_id);
+  auto* table_ptr = GetTable(table_id);
+  size_t select_dim = accessor->GetAccessorInfo().select_dim;
+
+  std::vector<uint64_t> pull_keys(keys, keys + num);
+  std::vector<uint32_t> frequencies(num, 1);
+  std::vector<float> values(num * select_dim);
+  PullSparseValue pull_value(pull_keys, frequencies, select_dim);
+  pull_value.is_training_ = is_training;
+
+  TableContext table_context;
+  table_context.value_type = Sparse;
+  table_context.pull_context.pull_value = pull_value;
+  table_context.pull_context.values = values.data();
+  table_ptr->Pull(table_context);
+
+  for (size_t i = 0; i < num; ++i) {
+    memcpy(select_values[i],
+           values.data() + i * select_dim,
+           select_dim * sizeof(float));
+  }
+  return done();
+}
+
 ::std::future<int32_t> PsLocalClient::PullSparsePtr(
     int shard_id,
     char** select_values,
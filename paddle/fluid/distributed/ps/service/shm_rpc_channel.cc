@@ -0,0 +1,461 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/service/shm_rpc_channel.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <vector>
+
+#include "brpc/controller.h"
+#include "bthread/bthread.h"
+#include "butil/iobuf.h"
+#include "glog/logging.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace paddle::distributed {
+
+namespace {
+
+using phi::distributed::ShmRing;
+using phi::distributed::ShmSegment;
+
+// bytes of each of the two rings of a channel
+constexpr size_t kRingCapacity = 4 << 20;
+
+// followed by message_size bytes of the message, or of the error text of a
+// failed call, and attachment_size bytes of the attachment
+struct ShmRpcHeader {
+  uint64_t call_id;
+  int32_t method_index;
+  int32_t error_code;
+  uint64_t message_size;
+  uint64_t attachment_size;
+};
+
+size_t SegmentSize() { return 2 * ShmRing::MemorySize(kRingCapacity); }
+
+void *RingBase(const ShmSegment &segment, bool is_response) {
+  return static_cast<char *>(segment.data()) +
+         (is_response ? ShmRing::MemorySize(kRingCapacity) : 0);
+}
+
+void WriteCall(ShmRing *ring,
+               const ShmRpcHeader &header,
+               const std::string &message,
+               const butil::IOBuf &attachment) {
+  ring->Write(&header, sizeof(header));
+  ring->Write(message.data(), message.size());
+  // from the blocks of the attachment, without joining them
+  for (size_t i = 0; i < attachment.backing_block_num(); ++i) {
+    auto block = attachment.backing_block(i);
+    ring->Write(block.data(), block.size());
+  }
+}
+
+void ReadAttachment(ShmRing *ring, size_t size, butil::IOBuf *attachment) {
+  if (size == 0) {
+    return;
+  }
+  // the block is handed to the IOBuf as it is
+  std::unique_ptr<char, decltype(&free)> data(
+      static_cast<char *>(malloc(size)), &free);
+  ring->Read(data.get(), size);
+  attachment->append_user_data(data.release(), size, &free);
+}
+
+void *RunClosure(void *arg) {
+  static_cast<google::protobuf::Closure *>(arg)->Run();
+  return nullptr;
+}
+
+// as brpc does, out of the thread of the ring
+void RunDone(google::protobuf::Closure *done) {
+  bthread_t tid;
+  if (bthread_start_background(&tid, nullptr, RunClosure, done) != 0) {
+    done->Run();
+  }
+}
+
+class SyncClosure : public google::protobuf::Closure {
+ public:
+  void Run() override {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _done = true;
+    _cv.notify_all();
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [this] { return _done; });
+  }
+
+ private:
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  bool _done = false;
+};
+
+}  // namespace
+
+std::unique_ptr<ShmRpcChannel> ShmRpcChannel::Create() {
+  auto segment = ShmSegment::Create(SegmentSize());
+  if (segment == nullptr) {
+    return nullptr;
+  }
+  return std::unique_ptr<ShmRpcChannel>(new ShmRpcChannel(std::move(segment)));
+}
+
+ShmRpcChannel::ShmRpcChannel(std::unique_ptr<ShmSegment> segment)
+    : _segment(std::move(segment)) {
+  _requests = std::make_unique<ShmRing>(
+      RingBase(*_segment, false), kRingCapacity, /*is_writer*/ true);
+  _responses = std::make_unique<ShmRing>(
+      RingBase(*_segment, true), kRingCapacity, /*is_writer*/ false);
+}
+
+ShmRpcChannel::~ShmRpcChannel() {
+  _requests->Close();
+  _responses->Close();
+  if (_receiver.joinable()) {
+    _receiver.join();
+  }
+  FailCalls("ShmRpcChannel is destroyed");
+  if (_timer.joinable()) {
+    _timer.join();
+  }
+}
+
+void ShmRpcChannel::Start() {
+  // mapped by both sides, nothing is left in /dev/shm if one of them crashes
+  _segment->Unlink();
+  _receiver = std::thread(&ShmRpcChannel::ReceiveLoop, this);
+  _timer = std::thread(&ShmRpcChannel::TimeoutLoop, this);
+}
+
+void ShmRpcChannel::CallMethod(
+    const google::protobuf::MethodDescriptor *method,
+    google::protobuf::RpcController *controller,
+    const google::protobuf::Message *request,
+    google::protobuf::Message *response,
+    google::protobuf::Closure *done) {
+  auto *cntl = static_cast<brpc::Controller *>(controller);
+  std::unique_ptr<SyncClosure> sync_done;
+  if (done == nullptr) {
+    sync_done = std::make_unique<SyncClosure>();
+    done = sync_done.get();
+  }
+
+  ShmRpcHeader header;
+  std::string message;
+  request->SerializeToString(&message);
+  header.method_index = method->index();
+  header.error_code = 0;
+  header.message_size = message.size();
+  header.attachment_size = cntl->request_attachment().size();
+  auto deadline = std::chrono::steady_clock::time_point::max();
+  if (cntl->timeout_ms() > 0) {
+    deadline = std::chrono::steady_clock::now() +
+               std::chrono::milliseconds(cntl->timeout_ms());
+  }
+  bool registered = false;
+  {
+    std::lock_guard<std::mutex> lock(_calls_mutex);
+    if (!_failed) {
+      header.call_id = _next_call_id++;
+      _calls[header.call_id] = Call{cntl, response, done, deadline, false};
+      registered = true;
+    }
+  }
+  if (!registered) {
+    cntl->SetFailed(EHOSTDOWN, "ShmRpcChannel %s failed", name().c_str());
+    done->Run();
+  } else {
+    if (cntl->timeout_ms() > 0) {
+      _calls_cv.notify_one();
+    }
+    try {
+      {
+        std::lock_guard<std::mutex> lock(_write_mutex);
+        WriteCall(
+            _requests.get(), header, message, cntl->request_attachment());
+      }
+      std::lock_guard<std::mutex> lock(_calls_mutex);
+      auto it = _calls.find(header.call_id);
+      if (it != _calls.end()) {
+        it->second.written = true;
+        if (it->second.deadline !=
+            std::chrono::steady_clock::time_point::max()) {
+          _calls_cv.notify_one();
+        }
+      }
+    } catch (const std::exception &e) {
+      // the stream is broken in the middle of a call
+      FailCalls(e.what());
+    }
+  }
+  if (sync_done != nullptr) {
+    sync_done->Wait();
+  }
+}
+
+void ShmRpcChannel::ReceiveLoop() {
+  try {
+    while (true) {
+      ShmRpcHeader header;
+      _responses->Read(&header, sizeof(header));
+      std::string message(header.message_size, '\0');
+      _responses->Read(&message[0], message.size());
+      butil::IOBuf attachment;
+      ReadAttachment(_responses.get(), header.attachment_size, &attachment);
+      Call call;
+      {
+        std::lock_guard<std::mutex> lock(_calls_mutex);
+        auto it = _calls.find(header.call_id);
+        if (it == _calls.end()) {
+          PADDLE_ENFORCE_LT(header.call_id,
+                            _next_call_id,
+                            common::errors::NotFound(
+                                "Response of unknown call %d.",
+                                header.call_id));
+          VLOG(3) << "ShmRpcChannel " << name()
+                  << " drops the response of timed out call "
+                  << header.call_id;
+          continue;
+        }
+        call = it->second;
+        _calls.erase(it);
+      }
+      call.cntl->response_attachment().swap(attachment);
+      if (header.error_code != 0) {
+        call.cntl->SetFailed(header.error_code, "%s", message.c_str());
+      } else if (!call.response->ParseFromString(message)) {
+        call.cntl->SetFailed(brpc::ERESPONSE, "Fail to parse response");
+      }
+      RunDone(call.done);
+    }
+  } catch (const std::exception &e) {
+    VLOG(1) << "ShmRpcChannel " << name() << " stops receiving: " << e.what();
+    FailCalls(e.what());
+  }
+}
+
+void ShmRpcChannel::TimeoutLoop() {
+  using Clock = std::chrono::steady_clock;
+  std::unique_lock<std::mutex> lock(_calls_mutex);
+  while (!_failed) {
+    auto now = Clock::now();
+    auto next = Clock::time_point::max();
+    std::vector<Call> expired;
+    bool blocked = false;
+    for (auto it = _calls.begin(); it != _calls.end();) {
+      if (it->second.deadline > now) {
+        next = std::min(next, it->second.deadline);
+        ++it;
+      } else if (it->second.written) {
+        expired.push_back(it->second);
+        it = _calls.erase(it);
+      } else {
+        blocked = true;
+        ++it;
+      }
+    }
+    if (blocked) {
+      // the server does not even read the request, so the writer can only
+      // be stopped by closing the ring, which fails all the calls
+      lock.unlock();
+      LOG(WARNING) << "ShmRpcChannel " << name()
+                   << " times out writing a request";
+      _requests->Close();
+      lock.lock();
+      _calls_cv.wait(lock, [this] { return _failed; });
+      break;
+    }
+    if (!expired.empty()) {
+      lock.unlock();
+      for (auto &call : expired) {
+        call.cntl->SetFailed(brpc::ERPCTIMEDOUT,
+                             "ShmRpcChannel %s timed out",
+                             name().c_str());
+        RunDone(call.done);
+      }
+      lock.lock();
+      continue;
+    }
+    if (next == Clock::time_point::max()) {
+      _calls_cv.wait(lock);
+    } else {
+      _calls_cv.wait_until(lock, next);
+    }
+  }
+}
+
+void ShmRpcChannel::FailCalls(const std::string &reason) {
+  std::unordered_map<uint64_t, Call> calls;
+  {
+    std::lock_guard<std::mutex> lock(_calls_mutex);
+    _failed = true;
+    calls.swap(_calls);
+  }
+  _calls_cv.notify_all();
+  _requests->Close();
+  _responses->Close();
+  for (auto &item : calls) {
+    item.second.cntl->SetFailed(EHOSTDOWN, "%s", reason.c_str());
+    RunDone(item.second.done);
+  }
+}
+
+struct ShmRpcServer::Connection {
+  std::unique_ptr<ShmSegment> segment;
+  std::unique_ptr<ShmRing> requests;
+  std::unique_ptr<ShmRing> responses;
+  std::mutex write_mutex;
+  google::protobuf::Service *service;
+};
+
+// Writes the response of a call when the service is done with it.
+class ShmRpcServer::ResponseClosure : public google::protobuf::Closure {
+ public:
+  ResponseClosure(std::shared_ptr<Connection> connection,
+                  uint64_t call_id,
+                  const google::protobuf::MethodDescriptor *method)
+      : connection(std::move(connection)), call_id(call_id), method(method) {
+    auto *service = this->connection->service;
+    request.reset(service->GetRequestPrototype(method).New());
+    response.reset(service->GetResponsePrototype(method).New());
+  }
+
+  void Run() override {
+    ShmRpcHeader header;
+    header.call_id = call_id;
+    header.method_index = method->index();
+    header.error_code = 0;
+    header.attachment_size = 0;
+    std::string message;
+    butil::IOBuf empty;
+    if (cntl.Failed()) {
+      header.error_code = cntl.ErrorCode();
+      message = cntl.ErrorText();
+    } else {
+      response->SerializeToString(&message);
+      header.attachment_size = cntl.response_attachment().size();
+    }
+    header.message_size = message.size();
+    try {
+      std::lock_guard<std::mutex> lock(connection->write_mutex);
+      WriteCall(connection->responses.get(),
+                header,
+                message,
+                cntl.Failed() ? empty : cntl.response_attachment());
+    } catch (const std::exception &e) {
+      VLOG(1) << "ShmRpcServer " << connection->segment->name()
+              << " drops the response of call " << call_id << ": "
+              << e.what();
+    }
+    delete this;
+  }
+
+  std::shared_ptr<Connection> connection;
+  uint64_t call_id;
+  const google::protobuf::MethodDescriptor *method;
+  brpc::Controller cntl;
+  std::unique_ptr<google::protobuf::Message> request;
+  std::unique_ptr<google::protobuf::Message> response;
+};
+
+std::unique_ptr<ShmRpcServer> ShmRpcServer::Create(
+    const std::string &name, google::protobuf::Service *service) {
+  auto segment = ShmSegment::Open(name, SegmentSize());
+  if (segment == nullptr) {
+    return nullptr;
+  }
+  return std::unique_ptr<ShmRpcServer>(
+      new ShmRpcServer(std::move(segment), service));
+}
+
+ShmRpcServer::ShmRpcServer(std::unique_ptr<ShmSegment> segment,
+                           google::protobuf::Service *service)
+    : _connection(std::make_shared<Connection>()) {
+  _connection->requests = std::make_unique<ShmRing>(
+      RingBase(*segment, false), kRingCapacity, /*is_writer*/ false);
+  _connection->responses = std::make_unique<ShmRing>(
+      RingBase(*segment, true), kRingCapacity, /*is_writer*/ true);
+  _connection->segment = std::move(segment);
+  _connection->service = service;
+  _server = std::thread(&ShmRpcServer::ServeLoop, this);
+}
+
+ShmRpcServer::~ShmRpcServer() {
+  _connection->requests->Close();
+  _connection->responses->Close();
+  _server.join();
+}
+
+bool ShmRpcServer::IsClosed() const {
+  // closed by the client, or by ServeLoop when it stops
+  return _connection->responses->IsClosed();
+}
+
+void *ShmRpcServer::Serve(void *args) {
+  auto *done = static_cast<ResponseClosure *>(args);
+  done->connection->service->CallMethod(done->method,
+                                        &done->cntl,
+                                        done->request.get(),
+                                        done->response.get(),
+                                        done);
+  return nullptr;
+}
+
+void ShmRpcServer::ServeLoop() {
+  auto *requests = _connection->requests.get();
+  const auto *descriptor = _connection->service->GetDescriptor();
+  try {
+    while (true) {
+      ShmRpcHeader header;
+      requests->Read(&header, sizeof(header));
+      std::string message(header.message_size, '\0');
+      requests->Read(&message[0], message.size());
+      PADDLE_ENFORCE_LT(
+          header.method_index,
+          descriptor->method_count(),
+          common::errors::OutOfRange("Unknown method %d of service %s.",
+                                     header.method_index,
+                                     descriptor->full_name()));
+      const auto *method = descriptor->method(header.method_index);
+      std::unique_ptr<ResponseClosure> done(
+          new ResponseClosure(_connection, header.call_id, method));
+      ReadAttachment(
+          requests, header.attachment_size, &done->cntl.request_attachment());
+      if (!done->request->ParseFromString(message)) {
+        done->cntl.SetFailed(brpc::EREQUEST, "Fail to parse request");
+        done.release()->Run();
+        continue;
+      }
+      // the calls run concurrently, as in brpc::Server
+      bthread_t tid;
+      if (bthread_start_background(&tid, nullptr, Serve, done.get()) != 0) {
+        Serve(done.get());
+      }
+      done.release();
+    }
+  } catch (const std::exception &e) {
+    VLOG(1) << "ShmRpcServer " << _connection->segment->name()
+            << " stops serving: " << e.what();
+  }
+  _connection->responses->Close();
+}
+
+}  // namespace paddle::distributed
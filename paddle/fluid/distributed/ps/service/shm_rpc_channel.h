@@ -0,0 +1,127 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <google/protobuf/service.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "paddle/phi/core/distributed/shm_transport.h"
+
+namespace brpc {
+class Controller;
+}  // namespace brpc
+
+namespace paddle {
+namespace distributed {
+
+/*
+ * Calls of a protobuf service between the processes on one host, through a
+ * pair of rings in a shared memory segment: the requests from the client to
+ * the server and the responses back. A call is a header, the message and
+ * the attachment of its brpc::Controller, so the sparse keys and values in
+ * the attachments are copied in and out of the ring once, without the
+ * network stack.
+ *
+ * The client creates the segment and sends its name to the server by some
+ * other channel, the server maps it with ShmRpcServer, which it can only do
+ * on the same host. The done closures run in bthreads as in brpc. A call
+ * fails when the timeout of its controller passes, and all of them fail when
+ * the other process exits.
+ */
+class ShmRpcChannel : public google::protobuf::RpcChannel {
+ public:
+  // nullptr if the shared memory of the host has no space for the segment
+  static std::unique_ptr<ShmRpcChannel> Create();
+
+  ~ShmRpcChannel() override;
+
+  const std::string &name() const { return _segment->name(); }
+
+  // Start to receive the responses once the server has mapped the segment.
+  void Start();
+
+  void CallMethod(const google::protobuf::MethodDescriptor *method,
+                  google::protobuf::RpcController *controller,
+                  const google::protobuf::Message *request,
+                  google::protobuf::Message *response,
+                  google::protobuf::Closure *done) override;
+
+ private:
+  struct Call {
+    brpc::Controller *cntl;
+    google::protobuf::Message *response;
+    google::protobuf::Closure *done;
+    std::chrono::steady_clock::time_point deadline;
+    // whether the request is all in the ring, the call can only time out
+    // alone then, as the attachment is no longer read
+    bool written;
+  };
+
+  explicit ShmRpcChannel(std::unique_ptr<phi::distributed::ShmSegment> segment);
+
+  void ReceiveLoop();
+  void TimeoutLoop();
+  void FailCalls(const std::string &reason);
+
+  std::unique_ptr<phi::distributed::ShmSegment> _segment;
+  std::unique_ptr<phi::distributed::ShmRing> _requests;
+  std::unique_ptr<phi::distributed::ShmRing> _responses;
+  std::mutex _write_mutex;
+  std::mutex _calls_mutex;
+  // notified when a call with a deadline is added and when the channel fails
+  std::condition_variable _calls_cv;
+  std::unordered_map<uint64_t, Call> _calls;
+  uint64_t _next_call_id = 0;
+  bool _failed = false;
+  std::thread _receiver;
+  std::thread _timer;
+};
+
+// Serves the calls of a ShmRpcChannel with a service, each in a bthread.
+class ShmRpcServer {
+ public:
+  // nullptr if there is no segment of the name on this host
+  static std::unique_ptr<ShmRpcServer> Create(
+      const std::string &name, google::protobuf::Service *service);
+
+  ~ShmRpcServer();
+
+  // Whether the server has stopped, as when the client exits.
+  bool IsClosed() const;
+
+ private:
+  struct Connection;
+  class ResponseClosure;
+
+  ShmRpcServer(std::unique_ptr<phi::distributed::ShmSegment> segment,
+               google::protobuf::Service *service);
+
+  void ServeLoop();
+  static void *Serve(void *args);
+
+  std::shared_ptr<Connection> _connection;
+  std::thread _server;
+};
+
+}  // namespace distributed
+}  // namespace paddle
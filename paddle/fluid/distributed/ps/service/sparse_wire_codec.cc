@@ -0,0 +1,245 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/service/sparse_wire_codec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "paddle/common/enforce.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+
+namespace paddle::distributed {
+
+namespace {
+
+const uint32_t kHeaderMagic = 0x53574331;  // "SWC1"
+
+inline void AppendVarint(uint64_t value, std::string *out) {
+  char buf[10];
+  int len = 0;
+  while (value >= 0x80) {
+    buf[len++] = static_cast<char>(value | 0x80);
+    value >>= 7;
+  }
+  buf[len++] = static_cast<char>(value);
+  out->append(buf, len);
+}
+
+inline const char *ReadVarint(const char *begin,
+                              const char *end,
+                              uint64_t *value) {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64 && begin < end; shift += 7) {
+    uint64_t byte = static_cast<uint8_t>(*begin++);
+    result |= (byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      *value = result;
+      return begin;
+    }
+  }
+  return nullptr;
+}
+
+template <typename T>
+void EncodeHalf(const float *row, size_t num, char *out) {
+  for (size_t i = 0; i < num; ++i) {
+    T value(row[i]);
+    memcpy(out + i * sizeof(T), &value, sizeof(T));
+  }
+}
+
+template <typename T>
+void DecodeHalf(const char *in, size_t num, float *row) {
+  for (size_t i = 0; i < num; ++i) {
+    T value;
+    memcpy(&value, in + i * sizeof(T), sizeof(T));
+    row[i] = static_cast<float>(value);
+  }
+}
+
+}  // namespace
+
+SparseValueCodec SparseWireCodec::ParseValueCodec(const std::string &name) {
+  if (name == "fp32") {
+    return SparseValueCodec::kFp32;
+  } else if (name == "fp16") {
+    return SparseValueCodec::kFp16;
+  } else if (name == "bf16") {
+    return SparseValueCodec::kBf16;
+  } else if (name == "int8") {
+    return SparseValueCodec::kInt8;
+  }
+  PADDLE_THROW(common::errors::InvalidArgument(
+      "Unknown sparse wire value codec %s, should be one of fp32, fp16, "
+      "bf16 and int8.",
+      name));
+}
+
+std::string SparseWireCodec::Header() const {
+  uint32_t header[3] = {
+      kHeaderMagic, static_cast<uint32_t>(codec_), raw_dim_};
+  return std::string(reinterpret_cast<const char *>(header), sizeof(header));
+}
+
+bool SparseWireCodec::ParseHeader(const std::string &header,
+                                  SparseWireCodec *codec) {
+  uint32_t fields[3];
+  if (header.size() != sizeof(fields)) {
+    return false;
+  }
+  memcpy(fields, header.data(), sizeof(fields));
+  if (fields[0] != kHeaderMagic ||
+      fields[1] > static_cast<uint32_t>(SparseValueCodec::kInt8)) {
+    return false;
+  }
+  codec->codec_ = static_cast<SparseValueCodec>(fields[1]);
+  codec->raw_dim_ = fields[2];
+  return true;
+}
+
+void SparseWireCodec::EncodeKeys(const uint64_t *keys,
+                                 size_t num,
+                                 std::string *out) {
+  uint64_t last = 0;
+  for (size_t i = 0; i < num; ++i) {
+    // zigzag keeps the delta small if keys are not sorted
+    int64_t delta = static_cast<int64_t>(keys[i] - last);
+    AppendVarint((static_cast<uint64_t>(delta) << 1) ^
+                     static_cast<uint64_t>(delta >> 63),
+                 out);
+    last = keys[i];
+  }
+}
+
+const char *SparseWireCodec::DecodeKeys(const char *begin,
+                                        const char *end,
+                                        size_t num,
+                                        uint64_t *keys) {
+  uint64_t last = 0;
+  for (size_t i = 0; i < num; ++i) {
+    uint64_t zigzag = 0;
+    begin = ReadVarint(begin, end, &zigzag);
+    if (begin == nullptr) {
+      return nullptr;
+    }
+    last += (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+    keys[i] = last;
+  }
+  return begin;
+}
+
+void SparseWireCodec::EncodeCounts(const uint32_t *counts,
+                                   size_t num,
+                                   std::string *out) {
+  for (size_t i = 0; i < num; ++i) {
+    AppendVarint(counts[i], out);
+  }
+}
+
+const char *SparseWireCodec::DecodeCounts(const char *begin,
+                                          const char *end,
+                                          size_t num,
+                                          uint32_t *counts) {
+  for (size_t i = 0; i < num; ++i) {
+    uint64_t count = 0;
+    begin = ReadVarint(begin, end, &count);
+    if (begin == nullptr) {
+      return nullptr;
+    }
+    counts[i] = static_cast<uint32_t>(count);
+  }
+  return begin;
+}
+
+size_t SparseWireCodec::EncodedRowSize(size_t dim) const {
+  size_t raw_dim = std::min<size_t>(raw_dim_, dim);
+  size_t coded_dim = dim - raw_dim;
+  switch (codec_) {
+    case SparseValueCodec::kFp16:
+    case SparseValueCodec::kBf16:
+      return raw_dim * sizeof(float) + coded_dim * sizeof(uint16_t);
+    case SparseValueCodec::kInt8:
+      return raw_dim * sizeof(float) +
+             (coded_dim > 0 ? sizeof(float) + coded_dim : 0);
+    default:
+      return dim * sizeof(float);
+  }
+}
+
+void SparseWireCodec::EncodeRow(const float *row,
+                                size_t dim,
+                                char *out) const {
+  size_t raw_dim = std::min<size_t>(raw_dim_, dim);
+  if (codec_ == SparseValueCodec::kFp32) {
+    raw_dim = dim;
+  }
+  memcpy(out, row, raw_dim * sizeof(float));
+  out += raw_dim * sizeof(float);
+  row += raw_dim;
+  size_t coded_dim = dim - raw_dim;
+  if (coded_dim == 0) {
+    return;
+  }
+  if (codec_ == SparseValueCodec::kFp16) {
+    EncodeHalf<phi::dtype::float16>(row, coded_dim, out);
+  } else if (codec_ == SparseValueCodec::kBf16) {
+    EncodeHalf<phi::dtype::bfloat16>(row, coded_dim, out);
+  } else {
+    float max_abs = 0;
+    for (size_t i = 0; i < coded_dim; ++i) {
+      max_abs = std::max(max_abs, std::fabs(row[i]));
+    }
+    float scale = max_abs / 127;
+    memcpy(out, &scale, sizeof(float));
+    out += sizeof(float);
+    float inv_scale = scale > 0 ? 1 / scale : 0;
+    for (size_t i = 0; i < coded_dim; ++i) {
+      float q = std::round(row[i] * inv_scale);
+      out[i] = static_cast<int8_t>(std::max(-127.0f, std::min(127.0f, q)));
+    }
+  }
+}
+
+void SparseWireCodec::DecodeRow(const char *in,
+                                size_t dim,
+                                float *row) const {
+  size_t raw_dim = std::min<size_t>(raw_dim_, dim);
+  if (codec_ == SparseValueCodec::kFp32) {
+    raw_dim = dim;
+  }
+  memcpy(row, in, raw_dim * sizeof(float));
+  in += raw_dim * sizeof(float);
+  row += raw_dim;
+  size_t coded_dim = dim - raw_dim;
+  if (coded_dim == 0) {
+    return;
+  }
+  if (codec_ == SparseValueCodec::kFp16) {
+    DecodeHalf<phi::dtype::float16>(in, coded_dim, row);
+  } else if (codec_ == SparseValueCodec::kBf16) {
+    DecodeHalf<phi::dtype::bfloat16>(in, coded_dim, row);
+  } else {
+    float scale = 0;
+    memcpy(&scale, in, sizeof(float));
+    in += sizeof(float);
+    for (size_t i = 0; i < coded_dim; ++i) {
+      row[i] = static_cast<int8_t>(in[i]) * scale;
+    }
+  }
+}
+
+}  // namespace paddle::distributed
@@ -0,0 +1,89 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace paddle {
+namespace distributed {
+
+enum class SparseValueCodec : uint32_t {
+  kFp32 = 0,
+  kFp16 = 1,
+  kBf16 = 2,
+  kInt8 = 3,
+};
+
+/**
+ * Compact wire format of the sparse pull and push requests.
+ *
+ * Keys are sent as zigzag varints of the delta to the previous key, which
+ * takes one or two bytes per key for the sorted keys of a shard. Each value
+ * row keeps its first raw_dim dims, such as slot, show and click, in fp32
+ * and encodes the rest in fp16, bf16 or int8 with a per row fp32 scale, so
+ * that all rows of a request are of the same size.
+ *
+ * The codec of a table is set by TableParameter.wire_codec and sent with
+ * each request as its second param, requests without it are raw.
+ */
+class SparseWireCodec {
+ public:
+  SparseWireCodec() {}
+  SparseWireCodec(SparseValueCodec codec, uint32_t raw_dim)
+      : codec_(codec), raw_dim_(raw_dim) {}
+
+  /** fp32, fp16, bf16 or int8. */
+  static SparseValueCodec ParseValueCodec(const std::string &name);
+
+  SparseValueCodec codec() const { return codec_; }
+  uint32_t raw_dim() const { return raw_dim_; }
+
+  /** The request param that describes the codec. */
+  std::string Header() const;
+  /** Returns false if header is not one of Header(). */
+  static bool ParseHeader(const std::string &header, SparseWireCodec *codec);
+
+  /** Append the delta varints of num keys to out. */
+  static void EncodeKeys(const uint64_t *keys, size_t num, std::string *out);
+  /** Decode num keys from [begin, end), returns the end of the keys or
+   * nullptr if the bytes are not enough or not in format. */
+  static const char *DecodeKeys(const char *begin,
+                                const char *end,
+                                size_t num,
+                                uint64_t *keys);
+  /** Append the varints of num counts to out. */
+  static void EncodeCounts(const uint32_t *counts,
+                           size_t num,
+                           std::string *out);
+  static const char *DecodeCounts(const char *begin,
+                                  const char *end,
+                                  size_t num,
+                                  uint32_t *counts);
+
+  /** Bytes of an encoded row of dim floats. */
+  size_t EncodedRowSize(size_t dim) const;
+  /** Encode a row of dim floats to EncodedRowSize(dim) bytes at out. */
+  void EncodeRow(const float *row, size_t dim, char *out) const;
+  void DecodeRow(const char *in, size_t dim, float *row) const;
+
+ private:
+  SparseValueCodec codec_ = SparseValueCodec::kFp32;
+  uint32_t raw_dim_ = 0;
+};
+
+}  // namespace distributed
+}  // namespace paddle
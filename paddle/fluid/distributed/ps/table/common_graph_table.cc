@@ -42,6 +42,7 @@ COMMON_DECLARE_int32(gpugraph_storage_mode);
 COMMON_DECLARE_uint64(gpugraph_slot_feasign_max_num);
 COMMON_DECLARE_bool(graph_metapath_split_opt);
 COMMON_DECLARE_double(graph_neighbor_size_percent);
+COMMON_DECLARE_bool(graph_freeze_after_load);
 
 PHI_DEFINE_EXPORTED_bool(graph_edges_split_only_by_src_id,
                          false,
@@ -1694,6 +1695,10 @@ void GraphTable::clear_graph() {
 }
 
 std::vector<Node *> GraphShard::get_batch(int start, int end, int step) {
+  PADDLE_ENFORCE_EQ(is_frozen(),
+                    false,
+                    common::errors::PreconditionNotMet(
+                        "Can not get nodes of a frozen shard."));
   if (start < 0) start = 0;
   std::vector<Node *> res;
   for (int pos = start; pos < std::min(end, static_cast<int>(bucket.size()));
@@ -1703,7 +1708,9 @@ std::vector<Node *> GraphShard::get_batch(int start, int end, int step) {
   return res;
 }
 
-size_t GraphShard::get_size() { return bucket.size(); }
+size_t GraphShard::get_size() {
+  return is_frozen() ? csr->size() : bucket.size();
+}
 
 int32_t GraphTable::add_comm_edge(int idx, uint64_t src_id, uint64_t dst_id) {
   size_t src_shard_id = src_id % shard_num;
@@ -1777,11 +1784,28 @@ void GraphShard::clear() {
   }
   bucket.clear();
   node_location.clear();
+  csr.reset();
 }
 
 GraphShard::~GraphShard() { clear(); }
 
+void GraphShard::freeze() {
+  if (is_frozen()) {
+    return;
+  }
+  auto frozen = std::make_unique<CsrGraphShard>();
+  frozen->Build(bucket);
+  clear();
+  std::vector<Node *>().swap(bucket);
+  std::unordered_map<uint64_t, int>().swap(node_location);
+  csr = std::move(frozen);
+}
+
 void GraphShard::delete_node(uint64_t id) {
+  PADDLE_ENFORCE_EQ(is_frozen(),
+                    false,
+                    common::errors::PreconditionNotMet(
+                        "Can not delete node %d of a frozen shard.", id));
   auto iter = node_location.find(id);
   if (iter == node_location.end()) return;
   int pos = iter->second;
@@ -1794,6 +1818,10 @@ void GraphShard::delete_node(uint64_t id) {
   bucket.pop_back();
 }
 GraphNode *GraphShard::add_graph_node(uint64_t id) {
+  PADDLE_ENFORCE_EQ(is_frozen(),
+                    false,
+                    common::errors::PreconditionNotMet(
+                        "Can not add node %d to a frozen shard.", id));
   if (node_location.find(id) == node_location.end()) {
     node_location[id] = bucket.size();
     bucket.push_back(new GraphNode(id));
@@ -1803,6 +1831,10 @@ GraphNode *GraphShard::add_graph_node(uint64_t id) {
 
 GraphNode *GraphShard::add_graph_node(Node *node) {
   auto id = node->get_id();
+  PADDLE_ENFORCE_EQ(is_frozen(),
+                    false,
+                    common::errors::PreconditionNotMet(
+                        "Can not add node %d to a frozen shard.", id));
   if (node_location.find(id) == node_location.end()) {
     node_location[id] = bucket.size();
     bucket.push_back(node);
@@ -1813,6 +1845,10 @@ GraphNode *GraphShard::add_graph_node(Node *node) {
 FeatureNode *GraphShard::add_feature_node(uint64_t id,
                                           bool is_overlap,
                                           int float_fea_num) {
+  PADDLE_ENFORCE_EQ(is_frozen(),
+                    false,
+                    common::errors::PreconditionNotMet(
+                        "Can not add node %d to a frozen shard.", id));
   if (node_location.find(id) == node_location.end()) {
     node_location[id] = bucket.size();
     if (float_fea_num > 0) {
@@ -1833,6 +1869,12 @@ void GraphShard::add_neighbor(uint64_t id, uint64_t dst_id, float weight) {
 }
 
 Node *GraphShard::find_node(uint64_t id) {
+  PADDLE_ENFORCE_EQ(
+      is_frozen(),
+      false,
+      common::errors::PreconditionNotMet(
+          "Can not find node %d in a frozen shard, use get_csr() instead.",
+          id));
   auto iter = node_location.find(id);
   return iter == node_location.end() ? nullptr : bucket[iter->second];
 }
@@ -2071,6 +2113,7 @@ int32_t GraphTable::parse_node_and_load(std::string ntype2files,
     graph_partition(false);
   }
 #endif
+  freeze_node_shards(load_slot);
   VLOG(0) << " end load nodes, nodes now storage in CPU Memory";
   return 0;
 }
@@ -2248,6 +2291,7 @@ int32_t GraphTable::load_node_and_edge_file(
     VLOG(0) << "Fail to load node_and_edge_file";
     return -1;
   }
+  freeze_node_shards(true);
   return 0;
 }
 
@@ -2494,6 +2538,10 @@ int32_t GraphTable::load_nodes(const std::string &path,
 
 int32_t GraphTable::build_sampler(int idx, std::string sample_type) {
   for (auto &shard : edge_shards[idx]) {
+    if (shard->is_frozen()) {
+      shard->csr->set_weighted_sample(sample_type == "weighted");
+      continue;
+    }
     auto bucket = shard->get_bucket();
     for (auto item : bucket) {
       item->build_sampler(sample_type);
@@ -2652,19 +2700,54 @@ std::pair<uint64_t, uint64_t> GraphTable::load_edges(
     // this optimization is only performed in load_edges function.
     VLOG(0) << "run in gpugraph mode!";
   } else {
-    std::string sample_type = "random";
-    VLOG(0) << "build sampler ... ";
-    for (auto &shard : edge_shards[idx]) {
-      auto bucket = shard->get_bucket();
-      for (auto item : bucket) {
-        item->build_sampler(sample_type);
-      }
+    std::string sample_type = use_weight ? "weighted" : "random";
+    VLOG(0) << "build " << sample_type << " sampler ... ";
+    if (FLAGS_graph_freeze_after_load) {
+      freeze_graph(GraphTableType::EDGE_TABLE, idx);
     }
+    build_sampler(idx, sample_type);
   }
 
   return {count, valid_count};
 }
 
+int32_t GraphTable::freeze_graph(GraphTableType table_type, int idx) {
+  auto &shards =
+      table_type == GraphTableType::EDGE_TABLE      ? edge_shards[idx]
+      : table_type == GraphTableType::FEATURE_TABLE ? feature_shards[idx]
+                                                    : node_shards[idx];
+  std::vector<std::future<int>> tasks;
+  for (auto &shard : shards) {
+    tasks.push_back(load_node_edge_task_pool->enqueue([&shard]() -> int {
+      shard->freeze();
+      return 0;
+    }));
+  }
+  for (auto &task : tasks) task.get();
+  size_t node_num = 0, edge_num = 0, memory_size = 0;
+  for (auto &shard : shards) {
+    node_num += shard->csr->size();
+    edge_num += shard->csr->all_neighbors().size();
+    memory_size += shard->csr->memory_size();
+  }
+  VLOG(0) << "freeze " << node_num << " nodes and " << edge_num
+          << " edges of table type " << static_cast<int>(table_type)
+          << " idx " << idx << " into " << memory_size << " bytes";
+  return 0;
+}
+
+void GraphTable::freeze_node_shards(bool load_slot) {
+  if (!FLAGS_graph_freeze_after_load || !build_sampler_on_cpu) {
+    return;
+  }
+  auto table_type =
+      load_slot ? GraphTableType::FEATURE_TABLE : GraphTableType::NODE_TABLE;
+  auto &shards = load_slot ? feature_shards : node_shards;
+  for (size_t i = 0; i < shards.size(); ++i) {
+    freeze_graph(table_type, i);
+  }
+}
+
 Node *GraphTable::find_node(GraphTableType table_type, uint64_t id) {
   size_t shard_id = id % shard_num;
   if (shard_id >= shard_end || shard_id < shard_start) {
@@ -2704,6 +2787,20 @@ Node *GraphTable::find_node(GraphTableType table_type, int idx, uint64_t id) {
   Node *node = search_shards[index]->find_node(id);
   return node;
 }
+
+GraphShard *GraphTable::find_shard(GraphTableType table_type,
+                                   int idx,
+                                   uint64_t id) {
+  size_t shard_id = id % shard_num;
+  if (shard_id >= shard_end || shard_id < shard_start) {
+    return nullptr;
+  }
+  auto &search_shards =
+      table_type == GraphTableType::EDGE_TABLE      ? edge_shards[idx]
+      : table_type == GraphTableType::FEATURE_TABLE ? feature_shards[idx]
+                                                    : node_shards[idx];
+  return search_shards[shard_id - shard_start];
+}
 uint32_t GraphTable::get_thread_pool_index(uint64_t node_id) {
   return node_id % shard_num % shard_num_per_server % task_pool_size_;
 }
@@ -2826,6 +2923,7 @@ int32_t GraphTable::random_sample_neighbors(
       size_t index = 0;
       std::vector<SampleResult> sample_res;
       std::vector<SampleKey> sample_keys;
+      std::vector<int> csr_res;
       auto &rng = _shards_task_rng_pool[i];
       for (size_t k = 0; k < id_list[i].size(); k++) {
         if (index < r.size() &&
@@ -2836,9 +2934,46 @@ int32_t GraphTable::random_sample_neighbors(
           index++;
         } else {
           node_id = id_list[i][k].node_key;
-          Node *node = find_node(GraphTableType::EDGE_TABLE, idx, node_id);
           int idy = seq_id[i][k];
           int &actual_size = actual_sizes[idy];
+          GraphShard *shard =
+              find_shard(GraphTableType::EDGE_TABLE, idx, node_id);
+          if (shard != nullptr && shard->is_frozen()) {
+            const CsrGraphShard *csr = shard->get_csr();
+            int64_t pos = csr->find(node_id);
+            if (pos < 0) {
+              actual_size = 0;
+              continue;
+            }
+            csr->sample_k(pos, sample_size, rng, &csr_res);
+            actual_size = csr_res.size() *
+                          (need_weight ? (Node::id_size + Node::weight_size)
+                                       : Node::id_size);
+            char *buffer_addr = new char[actual_size];
+            if (response == LRUResponse::ok) {
+              sample_keys.emplace_back(idx, node_id, sample_size, need_weight);
+              sample_res.emplace_back(actual_size, buffer_addr);
+              buffers[idy] = sample_res.back().buffer;
+            } else {
+              buffers[idy].reset(buffer_addr, char_del);
+            }
+            const uint64_t *neighbors = csr->neighbors(pos);
+            for (int x : csr_res) {
+              memcpy(buffer_addr, neighbors + x, Node::id_size);
+              buffer_addr += Node::id_size;
+              if (need_weight) {
+#if defined(PADDLE_WITH_HETERPS) && defined(PADDLE_WITH_PSCORE)
+                float weight = csr->neighbor_weight(pos, x);
+#else
+                float weight = 1.0;
+#endif
+                memcpy(buffer_addr, &weight, Node::weight_size);
+                buffer_addr += Node::weight_size;
+              }
+            }
+            continue;
+          }
+          Node *node = find_node(GraphTableType::EDGE_TABLE, idx, node_id);
           if (node == nullptr) {
 #ifdef PADDLE_WITH_HETERPS
             if (search_level == 2) {
@@ -2965,6 +3100,23 @@ int32_t GraphTable::get_node_feat(int idx,
     uint64_t node_id = node_ids[idy];
     tasks.push_back(_shards_task_pool[get_thread_pool_index(node_id)]->enqueue(
         [&, idx, idy, node_id]() -> int {
+          GraphShard *shard =
+              find_shard(GraphTableType::FEATURE_TABLE, idx, node_id);
+          if (shard != nullptr && shard->is_frozen()) {
+            int64_t pos = shard->get_csr()->find(node_id);
+            if (pos < 0) {
+              return 0;
+            }
+            for (size_t feat_idx = 0; feat_idx < feature_names.size();
+                 ++feat_idx) {
+              auto iter = feat_id_map[idx].find(feature_names[feat_idx]);
+              if (iter != feat_id_map[idx].end()) {
+                res[feat_idx][idy] =
+                    shard->get_csr()->get_feature(pos, iter->second);
+              }
+            }
+            return 0;
+          }
           Node *node = find_node(GraphTableType::FEATURE_TABLE, idx, node_id);
 
           if (node == nullptr) {
@@ -42,6 +42,7 @@
 #include "paddle/fluid/distributed/ps/table/accessor.h"
 #include "paddle/fluid/distributed/ps/table/common_table.h"
 #include "paddle/fluid/distributed/ps/table/graph/class_macro.h"
+#include "paddle/fluid/distributed/ps/table/graph/graph_csr.h"
 #include "paddle/fluid/distributed/ps/table/graph/graph_node.h"
 #include "paddle/fluid/distributed/ps/thirdparty/round_robin.h"
 #include "paddle/phi/core/utils/rw_lock.h"
@@ -61,20 +62,21 @@ class GraphShard {
   std::vector<Node *> &get_bucket() { return bucket; }
   std::vector<Node *> get_batch(int start, int end, int step);
   void get_ids_by_range(int start, int end, std::vector<uint64_t> *res) {
+    int size = get_size();
     res->reserve(res->size() + end - start);
-    for (int i = start; i < end && i < static_cast<int>(bucket.size()); i++) {
-      res->emplace_back(bucket[i]->get_id());
+    for (int i = start; i < end && i < size; i++) {
+      res->emplace_back(is_frozen() ? csr->id(i) : bucket[i]->get_id());
     }
   }
   size_t get_all_id(std::vector<std::vector<uint64_t>> *shard_keys,
                     int slice_num) {
-    int bucket_num = bucket.size();
+    int bucket_num = get_size();
     shard_keys->resize(slice_num);
     for (int i = 0; i < slice_num; ++i) {
       (*shard_keys)[i].reserve(bucket_num / slice_num);
     }
     for (int i = 0; i < bucket_num; i++) {
-      uint64_t k = bucket[i]->get_id();
+      uint64_t k = is_frozen() ? csr->id(i) : bucket[i]->get_id();
       (*shard_keys)[k % slice_num].emplace_back(k);
     }
     return bucket_num;
@@ -82,6 +84,9 @@ class GraphShard {
   size_t get_all_neighbor_id(std::vector<std::vector<uint64_t>> *total_res,
                              int slice_num) {
     std::vector<uint64_t> keys;
+    if (is_frozen()) {
+      keys = csr->all_neighbors();
+    }
     for (size_t i = 0; i < bucket.size(); i++) {
       size_t neighbor_size = bucket[i]->get_neighbor_size();
       size_t n = keys.size();
@@ -95,6 +100,9 @@ class GraphShard {
   size_t get_all_feature_ids(std::vector<std::vector<uint64_t>> *total_res,
                              int slice_num) {
     std::vector<uint64_t> keys;
+    for (size_t i = 0; is_frozen() && i < csr->size(); i++) {
+      csr->get_feature_ids(i, &keys);
+    }
     for (size_t i = 0; i < bucket.size(); i++) {
       bucket[i]->get_feature_ids(&keys);
     }
@@ -134,6 +142,12 @@ class GraphShard {
     return node_location;
   }
 
+  // Move the nodes into a CsrGraphShard and release them, after which the
+  // shard is read only, find_node() throws and the bucket is empty.
+  void freeze();
+  bool is_frozen() const { return csr != nullptr; }
+  const CsrGraphShard *get_csr() const { return csr.get(); }
+
   void shrink_to_fit() {
     bucket.shrink_to_fit();
     for (size_t i = 0; i < bucket.size(); i++) {
@@ -142,6 +156,10 @@ class GraphShard {
   }
 
   void merge_shard(GraphShard *&shard) {  // NOLINT
+    PADDLE_ENFORCE_EQ(
+        is_frozen() || shard->is_frozen(),
+        false,
+        common::errors::PreconditionNotMet("Can not merge frozen shards."));
     bucket.reserve(bucket.size() + shard->bucket.size());
     for (size_t i = 0; i < shard->bucket.size(); i++) {
       auto node_id = shard->bucket[i]->get_id();
@@ -159,6 +177,7 @@ class GraphShard {
  public:
   std::unordered_map<uint64_t, int> node_location;
   std::vector<Node *> bucket;
+  std::unique_ptr<CsrGraphShard> csr;
 };
 
 enum LRUResponse { ok = 0, blocked = 1, err = 2 };
@@ -638,6 +657,8 @@ class GraphTable : public Table {
   int32_t get_server_index_by_id(uint64_t id);
   Node *find_node(GraphTableType table_type, int idx, uint64_t id);
   Node *find_node(GraphTableType table_type, uint64_t id);
+  // The local shard of id, nullptr if id belongs to another server.
+  GraphShard *find_shard(GraphTableType table_type, int idx, uint64_t id);
   // query all ids rank
   void query_all_ids_rank(const size_t &total,
                           const uint64_t *ids,
@@ -770,6 +791,11 @@ class GraphTable : public Table {
 #endif
   virtual int32_t add_comm_edge(int idx, uint64_t src_id, uint64_t dst_id);
   virtual int32_t build_sampler(int idx, std::string sample_type = "random");
+  // Freeze the shards of idx into csr storage, see GraphShard::freeze().
+  int32_t freeze_graph(GraphTableType table_type, int idx);
+  // Freeze the node or feature shards of every node type if
+  // FLAGS_graph_freeze_after_load, once all of them are loaded and fixed.
+  void freeze_node_shards(bool load_slot);
   void set_slot_feature_separator(const std::string &ch);
   void set_feature_separator(const std::string &ch);
 
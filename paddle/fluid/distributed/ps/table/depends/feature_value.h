@@ -14,12 +14,17 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
 #include <vector>
 
-#include <mct/hash-map.hpp>
-
 #include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/common/chunk_allocator.h"
+#include "paddle/fluid/distributed/ps/table/depends/swiss_hash_map.h"
+#include "paddle/phi/core/memory/allocation/spin_lock.h"
 
 namespace paddle {
 namespace distributed {
@@ -28,24 +33,203 @@ static const int CTR_SPARSE_SHARD_BUCKET_NUM_BITS = 6;
 static const size_t CTR_SPARSE_SHARD_BUCKET_NUM =
     static_cast<size_t>(1) << CTR_SPARSE_SHARD_BUCKET_NUM_BITS;
 
+// Storage of the float arrays of the FixedFeatureValues in one bucket of a
+// SparseTableShard. Arrays are carved from slabs one after another, so the
+// values of a bucket are packed together without any per-value malloc header.
+// A released array goes to the free list of its size and is reused by the
+// next value of the same size, the sizes being the dims of the accessor (two
+// of them for CtrDymfAccessor, with and without the embedx part).
+class FeatureValueArena {
+ public:
+  FeatureValueArena() = default;
+  FeatureValueArena(const FeatureValueArena&) = delete;
+  FeatureValueArena& operator=(const FeatureValueArena&) = delete;
+  ~FeatureValueArena() {
+    for (auto* slab : _slabs) {
+      free(slab);  // NOLINT
+    }
+  }
+
+  float* acquire(size_t size) {
+    size_t stride = stride_of(size);
+    std::lock_guard<paddle::memory::SpinLock> guard(_lock);
+    FreeList& free_list = free_list_of(stride);
+    if (free_list.head != nullptr) {
+      FreeNode* node = free_list.head;
+      free_list.head = node->next;
+      return reinterpret_cast<float*>(node);
+    }
+    if (_slab_left < stride) {
+      create_new_slab(stride);
+    }
+    float* data = _slab_cursor;
+    _slab_cursor += stride;
+    _slab_left -= stride;
+    return data;
+  }
+
+  void release(float* data, size_t size) {
+    FreeNode* node = reinterpret_cast<FreeNode*>(data);
+    std::lock_guard<paddle::memory::SpinLock> guard(_lock);
+    FreeList& free_list = free_list_of(stride_of(size));
+    node->next = free_list.head;
+    free_list.head = node;
+  }
+
+  // bytes of all slabs
+  size_t memory_size() const { return _memory_size; }
+
+ private:
+  struct FreeNode {
+    FreeNode* next;
+  };
+  struct FreeList {
+    size_t stride;
+    FreeNode* head;
+  };
+
+  static constexpr size_t kMinSlabFloats = 1024;
+  static constexpr size_t kMaxSlabFloats = 256 * 1024;
+
+  // in floats, a free array must hold a pointer
+  static size_t stride_of(size_t size) {
+    constexpr size_t kAlign = sizeof(FreeNode) / sizeof(float);
+    return (std::max(size, kAlign) + kAlign - 1) / kAlign * kAlign;
+  }
+
+  // there are only a few distinct sizes, so a linear search is enough
+  FreeList& free_list_of(size_t stride) {
+    for (auto& free_list : _free_lists) {
+      if (free_list.stride == stride) {
+        return free_list;
+      }
+    }
+    _free_lists.push_back({stride, nullptr});
+    return _free_lists.back();
+  }
+
+  // slabs grow from kMinSlabFloats to kMaxSlabFloats, so that small tables
+  // do not reserve big slabs in each bucket
+  void create_new_slab(size_t stride) {
+    size_t slab_floats = std::max(stride, _next_slab_floats);
+    _next_slab_floats = std::min(_next_slab_floats * 2, kMaxSlabFloats);
+    float* slab = nullptr;
+    int error = posix_memalign(reinterpret_cast<void**>(&slab),
+                               64,
+                               slab_floats * sizeof(float));
+    PADDLE_ENFORCE_EQ(error,
+                      0,
+                      common::errors::ResourceExhausted(
+                          "Fail to alloc memory of %ld size, error code is %d.",
+                          slab_floats * sizeof(float),
+                          error));
+    _slabs.push_back(slab);
+    _memory_size += slab_floats * sizeof(float);
+    _slab_cursor = slab;
+    _slab_left = slab_floats;
+  }
+
+  std::vector<float*> _slabs;
+  std::vector<FreeList> _free_lists;
+  float* _slab_cursor = nullptr;
+  size_t _slab_left = 0;
+  size_t _next_slab_floats = kMinSlabFloats;
+  size_t _memory_size = 0;
+  // values of a bucket may be resized by several threads, e.g. when the
+  // GPU PS dumps values back to the CPU table
+  paddle::memory::SpinLock _lock;
+};
+
+// The value of a key in a sparse table. The floats of a value created by
+// SparseTableShard::operator[] or emplace(key) are allocated from the
+// FeatureValueArena of its bucket, the others are allocated from the heap.
 class FixedFeatureValue {
  public:
   FixedFeatureValue() {}
-  ~FixedFeatureValue() {}
-  float* data() { return _data.data(); }
-  size_t size() { return _data.size(); }
-  void resize(size_t size) { _data.resize(size); }
-  void shrink_to_fit() { _data.shrink_to_fit(); }
+  explicit FixedFeatureValue(FeatureValueArena* arena) : _arena(arena) {}
+  // A copy may outlive the shard of other, so it does not share the arena.
+  FixedFeatureValue(const FixedFeatureValue& other) { assign(other); }
+  FixedFeatureValue(FixedFeatureValue&& other) {
+    if (other._arena == nullptr) {
+      std::swap(_data, other._data);
+      std::swap(_size, other._size);
+    } else {
+      assign(other);
+    }
+  }
+  FixedFeatureValue& operator=(const FixedFeatureValue& other) {
+    if (this != &other) {
+      assign(other);
+    }
+    return *this;
+  }
+  ~FixedFeatureValue() { release_data(); }
+  float* data() { return _data; }
+  size_t size() { return _size; }
+  // keeps the first min(size, size()) floats, and zeros the new ones
+  void resize(size_t size) {
+    if (size == _size) {
+      return;
+    }
+    float* data = acquire_data(size);
+    size_t kept = std::min(size, static_cast<size_t>(_size));
+    if (kept > 0) {
+      memcpy(data, _data, kept * sizeof(float));
+    }
+    if (size > kept) {
+      memset(data + kept, 0, (size - kept) * sizeof(float));
+    }
+    release_data();
+    _data = data;
+    _size = static_cast<uint32_t>(size);
+  }
+  // the storage always fits the size
+  void shrink_to_fit() {}
 
  private:
-  std::vector<float> _data;
+  void assign(const FixedFeatureValue& other) {
+    if (_size != other._size) {
+      release_data();
+      _data = acquire_data(other._size);
+      _size = other._size;
+    }
+    if (_size > 0) {
+      memcpy(_data, other._data, _size * sizeof(float));
+    }
+  }
+
+  float* acquire_data(size_t size) {
+    if (size == 0) {
+      return nullptr;
+    }
+    if (_arena != nullptr) {
+      return _arena->acquire(size);
+    }
+    return static_cast<float*>(malloc(size * sizeof(float)));  // NOLINT
+  }
+
+  void release_data() {
+    if (_data == nullptr) {
+      return;
+    }
+    if (_arena != nullptr) {
+      _arena->release(_data, _size);
+    } else {
+      free(_data);  // NOLINT
+    }
+    _data = nullptr;
+    _size = 0;
+  }
+
+  float* _data = nullptr;
+  uint32_t _size = 0;
+  FeatureValueArena* _arena = nullptr;
 };
 
 template <class KEY, class VALUE>
 struct alignas(64) SparseTableShard {
  public:
-  typedef typename mct::closed_hash_map<KEY, mct::Pointer, std::hash<KEY>>
-      map_type;
+  typedef SwissHashMap<KEY, void*, MixedHash<KEY>> map_type;
   struct iterator {
     typename map_type::iterator it;
     size_t bucket;
@@ -147,10 +331,10 @@ struct alignas(64) SparseTableShard {
   std::pair<iterator, bool> emplace(const KEY& key, ARGS&&... args) {
     size_t hash = _hasher(key);
     size_t bucket = compute_bucket(hash);
-    auto res = _buckets[bucket].insert_with_hash({key, NULL}, hash);
+    auto res = _buckets[bucket].insert_with_hash({key, nullptr}, hash);
 
     if (res.second) {
-      res.first->second = _alloc.acquire(std::forward<ARGS>(args)...);
+      res.first->second = acquire_value(bucket, std::forward<ARGS>(args)...);
     }
 
     return {{res.first, bucket, _buckets}, res.second};
@@ -185,6 +369,15 @@ struct alignas(64) SparseTableShard {
     quick_erase(it);
     return 1;
   }
+  // bytes of the value arenas of all buckets
+  size_t arena_memory_size() const {
+    size_t memory_size = 0;
+    for (size_t bucket = 0; bucket < CTR_SPARSE_SHARD_BUCKET_NUM; bucket++) {
+      memory_size += _arenas[bucket].memory_size();
+    }
+    return memory_size;
+  }
+  // The hash is mixed by MixedHash, so its top bits spread the keys evenly.
   size_t compute_bucket(size_t hash) {
     if (CTR_SPARSE_SHARD_BUCKET_NUM == 1) {
       return 0;
@@ -194,9 +387,22 @@ struct alignas(64) SparseTableShard {
   }
 
  private:
+  // A default constructed value takes its floats from the arena of its
+  // bucket, so that the values of a bucket are stored together.
+  template <class... ARGS>
+  VALUE* acquire_value(size_t bucket, ARGS&&... args) {
+    if constexpr (sizeof...(ARGS) == 0 &&
+                  std::is_constructible<VALUE, FeatureValueArena*>::value) {
+      return _alloc.acquire(&_arenas[bucket]);
+    } else {
+      return _alloc.acquire(std::forward<ARGS>(args)...);
+    }
+  }
+
+  FeatureValueArena _arenas[CTR_SPARSE_SHARD_BUCKET_NUM];
   map_type _buckets[CTR_SPARSE_SHARD_BUCKET_NUM];
   ChunkAllocator<VALUE> _alloc;
-  std::hash<KEY> _hasher;
+  MixedHash<KEY> _hasher;
 };
 
 }  // namespace distributed
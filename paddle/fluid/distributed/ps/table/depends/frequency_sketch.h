@@ -0,0 +1,94 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace paddle {
+namespace distributed {
+
+// Count-min sketch of the access frequency of keys as in TinyLFU. The
+// counters saturate at 15 and are halved every 10 * width accesses, so the
+// estimate follows the recent frequency. Not thread safe.
+class FrequencySketch {
+ public:
+  static constexpr int kDepth = 4;
+  static constexpr uint8_t kMaxCount = 15;
+
+  explicit FrequencySketch(size_t width) {
+    _width = 1;
+    while (_width < std::max<size_t>(width, 64)) {
+      _width <<= 1;
+    }
+    _counters.resize(kDepth * _width, 0);
+    _reset_size = 10 * _width;
+  }
+
+  void Increment(uint64_t key) {
+    uint64_t hash = Mix(key);
+    for (int i = 0; i < kDepth; ++i) {
+      uint8_t& counter = _counters[i * _width + Index(hash, i)];
+      if (counter < kMaxCount) {
+        ++counter;
+      }
+    }
+    if (++_size >= _reset_size) {
+      Reset();
+    }
+  }
+
+  uint8_t Estimate(uint64_t key) const {
+    uint64_t hash = Mix(key);
+    uint8_t count = kMaxCount;
+    for (int i = 0; i < kDepth; ++i) {
+      count = std::min(count, _counters[i * _width + Index(hash, i)]);
+    }
+    return count;
+  }
+
+  size_t width() const { return _width; }
+
+ private:
+  static uint64_t Mix(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+  }
+
+  // a different 16 bits of the hash for each row
+  size_t Index(uint64_t hash, int row) const {
+    return ((hash >> (16 * row)) * 0x9E3779B1U) & (_width - 1);
+  }
+
+  void Reset() {
+    for (auto& counter : _counters) {
+      counter >>= 1;
+    }
+    _size /= 2;
+  }
+
+  size_t _width;
+  size_t _reset_size;
+  size_t _size = 0;
+  std::vector<uint8_t> _counters;
+};
+
+}  // namespace distributed
+}  // namespace paddle
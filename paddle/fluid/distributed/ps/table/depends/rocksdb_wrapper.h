@@ -23,10 +23,13 @@
 #include <rocksdb/slice.h>
 #include <rocksdb/slice_transform.h>
 #include <rocksdb/table.h>
+#include <rocksdb/utilities/checkpoint.h>
 #include <rocksdb/write_batch.h>
 
+#include <filesystem>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace paddle {
 namespace distributed {
@@ -92,7 +95,9 @@ class RocksDBHandler {
 
   int initialize(const std::string& db_path, const int colnum) {
     VLOG(0) << "db path: " << db_path << " colnum: " << colnum;
+    _db_path = db_path;
     _dbs.resize(colnum);
+    _options.resize(colnum);
     for (int i = 0; i < colnum; i++) {
       rocksdb::Options options;
       options.comparator = &_comparator;
@@ -150,6 +155,7 @@ class RocksDBHandler {
         system(rm_cmd.c_str());
       }
 
+      _options[i] = options;
       rocksdb::Status s = rocksdb::DB::Open(options, shard_path, &_dbs[i]);
       assert(s.ok());
     }
@@ -237,6 +243,111 @@ class RocksDBHandler {
 
   Uint64Comparator* get_comparator() { return &_comparator; }
 
+  const rocksdb::Options& get_options(int id) { return _options[id]; }
+
+  // Create a checkpoint of shard id in dir, which must not exist. The sst
+  // files are hard linked if dir is on the same file system.
+  int checkpoint(int id, const std::string& dir) {
+    rocksdb::Checkpoint* checkpoint = nullptr;
+    rocksdb::Status s = rocksdb::Checkpoint::Create(_dbs[id], &checkpoint);
+    if (s.ok()) {
+      // the writes skip the wal, so the memtable is always flushed
+      s = checkpoint->CreateCheckpoint(dir, 0);
+    }
+    delete checkpoint;
+    if (!s.ok()) {
+      LOG(WARNING) << "checkpoint of db " << id << " to " << dir
+                   << " failed: " << s.ToString();
+      return -1;
+    }
+    return 0;
+  }
+
+  // Replace shard id with the checkpoint in dir. The checkpoint is copied
+  // next to the shard and opened there first, so the shard is kept if it
+  // can not be restored. The sst files are never modified by rocksdb, so they
+  // are hard linked when possible, the other files are copied.
+  int restore(int id, const std::string& dir) {
+    namespace fs = std::filesystem;
+    std::string shard_path = get_shard_path(id);
+    std::string restore_path = shard_path + ".restore";
+    std::string old_path = shard_path + ".old";
+    std::error_code ec;
+    fs::remove_all(restore_path, ec);
+    fs::create_directories(restore_path, ec);
+    for (auto& entry : fs::directory_iterator(dir, ec)) {
+      fs::path target = fs::path(restore_path) / entry.path().filename();
+      bool linked = false;
+      if (entry.path().extension() == ".sst") {
+        fs::create_hard_link(entry.path(), target, ec);
+        linked = !ec;
+      }
+      if (!linked) {
+        fs::copy_file(entry.path(), target, ec);
+      }
+      if (ec) {
+        break;
+      }
+    }
+    rocksdb::Status s;
+    if (!ec) {
+      rocksdb::DB* db = nullptr;
+      s = rocksdb::DB::Open(_options[id], restore_path, &db);
+      delete db;
+    }
+    if (ec || !s.ok()) {
+      LOG(WARNING) << "restore db " << id << " from " << dir << " failed: "
+                   << (ec ? ec.message() : s.ToString());
+      fs::remove_all(restore_path, ec);
+      return -1;
+    }
+
+    delete _dbs[id];
+    _dbs[id] = nullptr;
+    fs::remove_all(old_path, ec);
+    fs::rename(shard_path, old_path, ec);
+    if (!ec) {
+      fs::rename(restore_path, shard_path, ec);
+    }
+    if (!ec) {
+      s = rocksdb::DB::Open(_options[id], shard_path, &_dbs[id]);
+    }
+    if (ec || !s.ok()) {
+      LOG(WARNING) << "replace db " << id << " with " << dir << " failed: "
+                   << (ec ? ec.message() : s.ToString());
+      delete _dbs[id];
+      _dbs[id] = nullptr;
+      if (fs::exists(old_path)) {
+        fs::remove_all(shard_path, ec);
+        fs::rename(old_path, shard_path, ec);
+      }
+      fs::remove_all(restore_path, ec);
+      s = rocksdb::DB::Open(_options[id], shard_path, &_dbs[id]);
+      if (!s.ok()) {
+        LOG(WARNING) << "reopen db " << id << " failed: " << s.ToString();
+      }
+      return -1;
+    }
+    fs::remove_all(old_path, ec);
+    return 0;
+  }
+
+  // Drop all the data of shard id.
+  int clear(int id) {
+    delete _dbs[id];
+    _dbs[id] = nullptr;
+    std::string shard_path = get_shard_path(id);
+    rocksdb::Status s = rocksdb::DestroyDB(shard_path, _options[id]);
+    if (s.ok()) {
+      s = rocksdb::DB::Open(_options[id], shard_path, &_dbs[id]);
+    }
+    if (!s.ok()) {
+      LOG(WARNING) << "clear db " << id << " failed: " << s.ToString();
+      return -1;
+    }
+    return 0;
+  }
+
   int ingest_external_file(int id,
                            const std::vector<std::string>& sst_filelist) {
     rocksdb::IngestExternalFileOptions ifo;
@@ -247,9 +358,15 @@ class RocksDBHandler {
   }
 
  private:
+  std::string get_shard_path(int id) const {
+    return _db_path + "_" + std::to_string(id);
+  }
+
   std::vector<rocksdb::ColumnFamilyHandle*> _handles;
   // rocksdb::DB* _db;
   std::vector<rocksdb::DB*> _dbs;
+  std::vector<rocksdb::Options> _options;
+  std::string _db_path;
   Uint64Comparator _comparator;
 };
 }  // namespace distributed
@@ -0,0 +1,432 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace paddle {
+namespace distributed {
+
+// The finalizer of MurmurHash3, every input bit affects all output bits.
+// std::hash of integers is the identity in libstdc++, so feature signs have
+// to be mixed before their high bits select a bucket.
+inline uint64_t MixHash(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+template <class KEY>
+struct MixedHash {
+  size_t operator()(const KEY& key) const {
+    return static_cast<size_t>(MixHash(std::hash<KEY>()(key)));
+  }
+};
+
+namespace swiss_detail {
+
+// One control byte per slot. A full slot stores the low 7 bits of the hash
+// of its key, so the sign bit tells the empty and deleted slots apart.
+typedef int8_t ctrl_t;
+static constexpr ctrl_t kEmpty = -128;
+static constexpr ctrl_t kDeleted = -2;
+static constexpr size_t kGroupWidth = 16;
+
+inline uint32_t TrailingZeros(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(mask);
+#else
+  uint32_t n = 0;
+  while ((mask & 1) == 0) {
+    mask >>= 1;
+    ++n;
+  }
+  return n;
+#endif
+}
+
+// The control bytes of kGroupWidth consecutive slots, probed at once. Bit i
+// of a returned mask is set when the i-th slot of the group matches.
+class Group {
+ public:
+  explicit Group(const ctrl_t* ctrl) {
+#if defined(__SSE2__)
+    ctrl_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+    memcpy(ctrl_, ctrl, kGroupWidth);
+#endif
+  }
+
+  uint32_t Match(ctrl_t h2) const {
+#if defined(__SSE2__)
+    return static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kGroupWidth; ++i) {
+      mask |= static_cast<uint32_t>(ctrl_[i] == h2) << i;
+    }
+    return mask;
+#endif
+  }
+
+  uint32_t MatchEmpty() const { return Match(kEmpty); }
+
+  uint32_t MatchEmptyOrDeleted() const {
+#if defined(__SSE2__)
+    return static_cast<uint32_t>(_mm_movemask_epi8(ctrl_));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kGroupWidth; ++i) {
+      mask |= static_cast<uint32_t>(ctrl_[i] < 0) << i;
+    }
+    return mask;
+#endif
+  }
+
+ private:
+#if defined(__SSE2__)
+  __m128i ctrl_;
+#else
+  ctrl_t ctrl_[kGroupWidth];
+#endif
+};
+
+}  // namespace swiss_detail
+
+// An open addressing hash map in the style of Swiss tables.
+//
+// Slots are split into groups of 16, a key is probed group by group along a
+// triangular sequence, and the 16 control bytes of a group are compared with
+// the 7-bit hash tag of the key in one SSE2 instruction, so most lookups
+// touch one cache line of control bytes and one slot.
+//
+// The interface follows the subset of mct::closed_hash_map used by
+// SparseTableShard. Elements never move unless the map is rehashed, so erase
+// does not invalidate the iterators of other elements. The end iterators of
+// all maps compare equal.
+template <class KEY,
+          class VALUE,
+          class HASH = MixedHash<KEY>,
+          class EQUAL = std::equal_to<KEY>>
+class SwissHashMap {
+ public:
+  typedef KEY key_type;
+  typedef VALUE mapped_type;
+  typedef std::pair<KEY, VALUE> value_type;
+
+  class iterator {
+   public:
+    iterator() = default;
+
+    value_type& operator*() const { return *slot_; }
+    value_type* operator->() const { return slot_; }
+
+    iterator& operator++() {
+      ++ctrl_;
+      ++slot_;
+      SkipEmptySlots();
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator ret = *this;
+      ++*this;
+      return ret;
+    }
+
+    friend bool operator==(const iterator& a, const iterator& b) {
+      return a.slot_ == b.slot_;
+    }
+    friend bool operator!=(const iterator& a, const iterator& b) {
+      return a.slot_ != b.slot_;
+    }
+
+   private:
+    friend class SwissHashMap;
+
+    iterator(const swiss_detail::ctrl_t* ctrl,
+             const swiss_detail::ctrl_t* ctrl_end,
+             value_type* slot)
+        : ctrl_(ctrl), ctrl_end_(ctrl_end), slot_(slot) {}
+
+    void SkipEmptySlots() {
+      while (ctrl_ != ctrl_end_ && *ctrl_ < 0) {
+        ++ctrl_;
+        ++slot_;
+      }
+      if (ctrl_ == ctrl_end_) {
+        *this = iterator();
+      }
+    }
+
+    const swiss_detail::ctrl_t* ctrl_{nullptr};
+    const swiss_detail::ctrl_t* ctrl_end_{nullptr};
+    value_type* slot_{nullptr};
+  };
+
+  SwissHashMap() = default;
+  SwissHashMap(const SwissHashMap&) = delete;
+  SwissHashMap& operator=(const SwissHashMap&) = delete;
+  ~SwissHashMap() {
+    DestroySlots();
+    Deallocate();
+  }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  size_t bucket_count() const { return capacity_; }
+
+  float max_load_factor() const { return max_load_factor_; }
+  void max_load_factor(float x) {
+    max_load_factor_ = std::min(std::max(x, 0.1f), 0.9375f);
+    growth_left_ = GrowthLimit(capacity_) > size_ + num_deleted_
+                       ? GrowthLimit(capacity_) - size_ - num_deleted_
+                       : 0;
+  }
+
+  void reserve(size_t n) {
+    size_t capacity = std::max(capacity_, swiss_detail::kGroupWidth);
+    while (GrowthLimit(capacity) < std::max(n, size_)) {
+      capacity *= 2;
+    }
+    if (capacity != capacity_) {
+      Resize(capacity);
+    }
+  }
+
+  iterator begin() {
+    iterator it(ctrl_, ctrl_ + capacity_, slots_);
+    it.SkipEmptySlots();
+    return it;
+  }
+  iterator end() { return iterator(); }
+
+  iterator find(const KEY& key) { return find_with_hash(key, hasher_(key)); }
+
+  iterator find_with_hash(const KEY& key, size_t hash) {
+    if (capacity_ == 0) {
+      return end();
+    }
+    swiss_detail::ctrl_t h2 = H2(hash);
+    size_t group = H1(hash) & group_mask_;
+    for (size_t step = 1;; ++step) {
+      size_t offset = group * swiss_detail::kGroupWidth;
+      swiss_detail::Group g(ctrl_ + offset);
+      for (uint32_t mask = g.Match(h2); mask != 0; mask &= mask - 1) {
+        size_t index = offset + swiss_detail::TrailingZeros(mask);
+        if (equal_(slots_[index].first, key)) {
+          return IteratorAt(index);
+        }
+      }
+      if (g.MatchEmpty() != 0) {
+        return end();
+      }
+      group = (group + step) & group_mask_;
+    }
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    size_t hash = hasher_(value.first);
+    return insert_with_hash(std::move(value), hash);
+  }
+
+  std::pair<iterator, bool> insert_with_hash(value_type&& value, size_t hash) {
+    iterator it = find_with_hash(value.first, hash);
+    if (it != end()) {
+      return {it, false};
+    }
+    size_t index = PrepareInsert(hash);
+    new (slots_ + index) value_type(std::move(value));
+    return {IteratorAt(index), true};
+  }
+
+  std::pair<iterator, bool> insert_with_hash(const value_type& value,
+                                             size_t hash) {
+    return insert_with_hash(value_type(value), hash);
+  }
+
+  iterator erase(iterator it) {
+    iterator next = it;
+    ++next;
+    quick_erase(it);
+    return next;
+  }
+
+  void quick_erase(iterator it) {
+    size_t index = it.slot_ - slots_;
+    slots_[index].~value_type();
+    --size_;
+    // A group that has never been full does not make any probe sequence go
+    // on, so the slot can be empty again. Otherwise keep a tombstone.
+    size_t offset = index & ~(swiss_detail::kGroupWidth - 1);
+    if (swiss_detail::Group(ctrl_ + offset).MatchEmpty() != 0) {
+      ctrl_[index] = swiss_detail::kEmpty;
+      ++growth_left_;
+    } else {
+      ctrl_[index] = swiss_detail::kDeleted;
+      ++num_deleted_;
+    }
+  }
+
+  size_t erase(const KEY& key) {
+    iterator it = find(key);
+    if (it == end()) {
+      return 0;
+    }
+    quick_erase(it);
+    return 1;
+  }
+
+  void clear() {
+    DestroySlots();
+    if (capacity_ > 0) {
+      memset(ctrl_, swiss_detail::kEmpty, capacity_);
+    }
+    size_ = 0;
+    num_deleted_ = 0;
+    growth_left_ = GrowthLimit(capacity_);
+  }
+
+ private:
+  static size_t H1(size_t hash) { return hash >> 7; }
+  static swiss_detail::ctrl_t H2(size_t hash) {
+    return static_cast<swiss_detail::ctrl_t>(hash & 0x7f);
+  }
+
+  size_t GrowthLimit(size_t capacity) const {
+    if (capacity == 0) {
+      return 0;
+    }
+    // keep at least one empty slot, so that every probe terminates
+    size_t limit = static_cast<size_t>(capacity * max_load_factor_);
+    return std::min(limit, capacity - 1);
+  }
+
+  iterator IteratorAt(size_t index) {
+    return iterator(ctrl_ + index, ctrl_ + capacity_, slots_ + index);
+  }
+
+  // Find a slot for a key known to be absent, and mark it full.
+  size_t PrepareInsert(size_t hash) {
+    if (growth_left_ == 0) {
+      // drop the tombstones if they take more than half of the growth limit,
+      // otherwise double the capacity, more than once if max_load_factor()
+      // was lowered since the last rehash
+      size_t capacity = std::max(capacity_, swiss_detail::kGroupWidth);
+      if (capacity_ > 0 && size_ * 2 > GrowthLimit(capacity_)) {
+        capacity *= 2;
+      }
+      while (GrowthLimit(capacity) <= size_) {
+        capacity *= 2;
+      }
+      Resize(capacity);
+    }
+    size_t index = FindFirstNonFull(hash);
+    if (ctrl_[index] == swiss_detail::kEmpty) {
+      --growth_left_;
+    } else {
+      --num_deleted_;
+    }
+    ctrl_[index] = H2(hash);
+    ++size_;
+    return index;
+  }
+
+  size_t FindFirstNonFull(size_t hash) const {
+    size_t group = H1(hash) & group_mask_;
+    for (size_t step = 1;; ++step) {
+      size_t offset = group * swiss_detail::kGroupWidth;
+      uint32_t mask =
+          swiss_detail::Group(ctrl_ + offset).MatchEmptyOrDeleted();
+      if (mask != 0) {
+        return offset + swiss_detail::TrailingZeros(mask);
+      }
+      group = (group + step) & group_mask_;
+    }
+  }
+
+  void Resize(size_t new_capacity) {
+    swiss_detail::ctrl_t* old_ctrl = ctrl_;
+    value_type* old_slots = slots_;
+    size_t old_capacity = capacity_;
+
+    ctrl_ = new swiss_detail::ctrl_t[new_capacity];
+    memset(ctrl_, swiss_detail::kEmpty, new_capacity);
+    slots_ = static_cast<value_type*>(
+        ::operator new(new_capacity * sizeof(value_type)));
+    capacity_ = new_capacity;
+    group_mask_ = new_capacity / swiss_detail::kGroupWidth - 1;
+    num_deleted_ = 0;
+    growth_left_ = GrowthLimit(new_capacity) > size_
+                       ? GrowthLimit(new_capacity) - size_
+                       : 0;
+
+    for (size_t i = 0; i < old_capacity; ++i) {
+      if (old_ctrl[i] >= 0) {
+        size_t hash = hasher_(old_slots[i].first);
+        size_t index = FindFirstNonFull(hash);
+        ctrl_[index] = H2(hash);
+        new (slots_ + index) value_type(std::move(old_slots[i]));
+        old_slots[i].~value_type();
+      }
+    }
+    delete[] old_ctrl;
+    ::operator delete(old_slots);
+  }
+
+  void DestroySlots() {
+    for (size_t i = 0; i < capacity_; ++i) {
+      if (ctrl_[i] >= 0) {
+        slots_[i].~value_type();
+      }
+    }
+  }
+
+  void Deallocate() {
+    delete[] ctrl_;
+    ::operator delete(slots_);
+    ctrl_ = nullptr;
+    slots_ = nullptr;
+    capacity_ = 0;
+  }
+
+  swiss_detail::ctrl_t* ctrl_{nullptr};
+  value_type* slots_{nullptr};
+  // a power of 2, and a multiple of kGroupWidth
+  size_t capacity_{0};
+  size_t group_mask_{0};
+  size_t size_{0};
+  size_t num_deleted_{0};
+  // the number of empty slots that can still be filled before a rehash
+  size_t growth_left_{0};
+  float max_load_factor_{0.875f};
+  HASH hasher_;
+  EQUAL equal_;
+};
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,238 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/graph/graph_csr.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <unordered_set>
+#include <utility>
+
+namespace paddle::distributed {
+
+void CsrGraphShard::Build(const std::vector<Node *> &nodes) {
+  size_t node_num = nodes.size();
+  PADDLE_ENFORCE_LT(node_num,
+                    std::numeric_limits<uint32_t>::max(),
+                    common::errors::InvalidArgument(
+                        "Too many nodes in a shard to freeze: %d.", node_num));
+  std::vector<uint32_t> order(node_num);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&nodes](uint32_t a, uint32_t b) {
+    return nodes[a]->get_id() < nodes[b]->get_id();
+  });
+
+  size_t edge_num = 0;
+  size_t slot_num = 0;
+  size_t byte_num = 0;
+  for (Node *node : nodes) {
+    edge_num += node->get_neighbor_size();
+    int node_slot_num = node->get_feature_size();
+    slot_num += node_slot_num;
+    for (int j = 0; j < node_slot_num; ++j) {
+      byte_num += node->get_feature(j).size();
+    }
+  }
+
+  ids_.resize(node_num);
+  offsets_.resize(node_num + 1);
+  neighbors_.resize(edge_num);
+  weights_.resize(edge_num);
+  feature_slot_begin_.resize(node_num + 1);
+  feature_offsets_.resize(slot_num + 1);
+  feature_bytes_.resize(byte_num);
+  offsets_[0] = 0;
+  feature_slot_begin_[0] = 0;
+  feature_offsets_[0] = 0;
+  bool has_weight = false;
+  size_t edge_pos = 0;
+  size_t slot_pos = 0;
+  size_t byte_pos = 0;
+  for (size_t i = 0; i < node_num; ++i) {
+    Node *node = nodes[order[i]];
+    ids_[i] = node->get_id();
+    size_t degree = node->get_neighbor_size();
+    for (size_t j = 0; j < degree; ++j, ++edge_pos) {
+      neighbors_[edge_pos] = node->get_neighbor_id(j);
+      weights_[edge_pos] = static_cast<float>(node->get_neighbor_weight(j));
+      has_weight = has_weight || weights_[edge_pos] != 1.0;
+    }
+    offsets_[i + 1] = edge_pos;
+
+    int node_slot_num = node->get_feature_size();
+    for (int j = 0; j < node_slot_num; ++j, ++slot_pos) {
+      std::string feature = node->get_feature(j);
+      if (!feature.empty()) {
+        memcpy(&feature_bytes_[byte_pos], feature.data(), feature.size());
+      }
+      byte_pos += feature.size();
+      feature_offsets_[slot_pos + 1] = byte_pos;
+    }
+    feature_slot_begin_[i + 1] = slot_pos;
+  }
+  if (!has_weight) {
+    std::vector<float>().swap(weights_);
+  }
+  BuildDirectory();
+}
+
+void CsrGraphShard::BuildDirectory() {
+  lut_.clear();
+  lut_shift_ = 0;
+  if (ids_.empty()) {
+    return;
+  }
+  // about one directory entry per node
+  uint64_t range = ids_.back() - ids_.front();
+  while ((range >> lut_shift_) > ids_.size()) {
+    ++lut_shift_;
+  }
+  size_t lut_size = (range >> lut_shift_) + 2;
+  lut_.resize(lut_size);
+  size_t pos = 0;
+  for (size_t b = 0; b < lut_size; ++b) {
+    while (pos < ids_.size() &&
+           ((ids_[pos] - ids_.front()) >> lut_shift_) < b) {
+      ++pos;
+    }
+    lut_[b] = pos;
+  }
+}
+
+void CsrGraphShard::set_weighted_sample(bool weighted) {
+  weighted_sample_ = weighted;
+  if (!weighted || !is_weighted()) {
+    std::vector<float>().swap(alias_prob_);
+    std::vector<uint32_t>().swap(alias_);
+    return;
+  }
+  if (!alias_.empty()) {
+    return;
+  }
+  alias_prob_.resize(weights_.size());
+  alias_.resize(weights_.size());
+  for (size_t i = 0; i < size(); ++i) {
+    const float *weights = weights_.data() + offsets_[i];
+    AliasSampler::build_table(
+        degree(i),
+        [weights](int j) { return weights[j]; },
+        alias_prob_.data() + offsets_[i],
+        alias_.data() + offsets_[i]);
+  }
+}
+
+int64_t CsrGraphShard::find(uint64_t id) const {
+  if (ids_.empty() || id < ids_.front() || id > ids_.back()) {
+    return -1;
+  }
+  uint64_t b = (id - ids_.front()) >> lut_shift_;
+  auto begin = ids_.begin() + lut_[b];
+  auto end = ids_.begin() + lut_[b + 1];
+  auto iter = std::lower_bound(begin, end, id);
+  if (iter == end || *iter != id) {
+    return -1;
+  }
+  return iter - ids_.begin();
+}
+
+void CsrGraphShard::sample_k(size_t idx,
+                             int k,
+                             const std::shared_ptr<std::mt19937_64> &rng,
+                             std::vector<int> *res) const {
+  int n = degree(idx);
+  res->clear();
+  if (k >= n) {
+    res->resize(n);
+    std::iota(res->begin(), res->end(), 0);
+    return;
+  }
+  res->reserve(k);
+  if (weighted_sample_ && is_weighted()) {
+    const float *weights = weights_.data() + offsets_[idx];
+    AliasSampler::sample_table(
+        n,
+        k,
+        [weights](int i) { return weights[i]; },
+        alias_prob_.data() + offsets_[idx],
+        alias_.data() + offsets_[idx],
+        rng.get(),
+        res);
+    return;
+  }
+  // Floyd's algorithm, a linear search is faster than a hash set for small k
+  const int kLinearSearchSize = 64;
+  std::unordered_set<int> chosen;
+  for (int j = n - k; j < n; ++j) {
+    std::uniform_int_distribution<int> distrib(0, j);
+    int t = distrib(*rng);
+    bool found = false;
+    if (k <= kLinearSearchSize) {
+      found = std::find(res->begin(), res->end(), t) != res->end();
+    } else {
+      found = !chosen.insert(t).second;
+      if (found) {
+        chosen.insert(j);
+      }
+    }
+    res->push_back(found ? j : t);
+  }
+}
+
+std::string CsrGraphShard::get_feature(size_t idx, int slot) const {
+  if (slot < 0 || slot >= feature_size(idx)) {
+    return std::string("");
+  }
+  size_t pos = feature_slot_begin_[idx] + slot;
+  return std::string(feature_bytes_.data() + feature_offsets_[pos],
+                     feature_offsets_[pos + 1] - feature_offsets_[pos]);
+}
+
+void CsrGraphShard::get_feature_ids(size_t idx,
+                                    std::vector<uint64_t> *res) const {
+  PADDLE_ENFORCE_NOT_NULL(res,
+                          common::errors::InvalidArgument(
+                              "get_feature_ids res should not be null"));
+  uint64_t begin = feature_offsets_[feature_slot_begin_[idx]];
+  uint64_t end = feature_offsets_[feature_slot_begin_[idx + 1]];
+  for (uint64_t pos = feature_slot_begin_[idx];
+       pos < feature_slot_begin_[idx + 1];
+       ++pos) {
+    PADDLE_ENFORCE_EQ(
+        (feature_offsets_[pos + 1] - feature_offsets_[pos]) % sizeof(uint64_t),
+        0,
+        common::errors::PreconditionNotMet(
+            "bad feature_item of node %d slot %d", ids_[idx], pos));
+  }
+  size_t n = res->size();
+  res->resize(n + (end - begin) / sizeof(uint64_t));
+  if (end > begin) {
+    memcpy(res->data() + n, feature_bytes_.data() + begin, end - begin);
+  }
+}
+
+size_t CsrGraphShard::memory_size() const {
+  return ids_.capacity() * sizeof(uint64_t) +
+         lut_.capacity() * sizeof(uint32_t) +
+         offsets_.capacity() * sizeof(uint64_t) +
+         neighbors_.capacity() * sizeof(uint64_t) +
+         weights_.capacity() * sizeof(float) +
+         alias_prob_.capacity() * sizeof(float) +
+         alias_.capacity() * sizeof(uint32_t) +
+         feature_slot_begin_.capacity() * sizeof(uint64_t) +
+         feature_offsets_.capacity() * sizeof(uint64_t) +
+         feature_bytes_.capacity();
+}
+
+}  // namespace paddle::distributed
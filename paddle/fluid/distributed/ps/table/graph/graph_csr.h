@@ -0,0 +1,101 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/distributed/ps/table/graph/graph_node.h"
+
+namespace paddle {
+namespace distributed {
+
+/**
+ * Immutable compressed sparse row storage of the nodes of a GraphShard.
+ *
+ * The ids are sorted and located by a binary search narrowed by a directory
+ * over the id range, the node at position i has the neighbors
+ * neighbors_[offsets_[i], offsets_[i + 1]) and the feature slots
+ * [feature_slot_begin_[i], feature_slot_begin_[i + 1]) whose bytes are
+ * packed in feature_bytes_. Weights are kept only when some edge is not of
+ * weight 1, float feature slots of FloatFeatureNode are not kept.
+ */
+class CsrGraphShard {
+ public:
+  CsrGraphShard() {}
+
+  /** Build from the nodes of a shard, the nodes are not owned. */
+  void Build(const std::vector<Node *> &nodes);
+
+  size_t size() const { return ids_.size(); }
+  uint64_t id(size_t idx) const { return ids_[idx]; }
+  const std::vector<uint64_t> &ids() const { return ids_; }
+  /** The position of id, -1 if the shard has no such node. */
+  int64_t find(uint64_t id) const;
+
+  size_t degree(size_t idx) const {
+    return offsets_[idx + 1] - offsets_[idx];
+  }
+  const uint64_t *neighbors(size_t idx) const {
+    return neighbors_.data() + offsets_[idx];
+  }
+  const std::vector<uint64_t> &all_neighbors() const { return neighbors_; }
+  float neighbor_weight(size_t idx, int pos) const {
+    return weights_.empty() ? 1.0 : weights_[offsets_[idx] + pos];
+  }
+  bool is_weighted() const { return !weights_.empty(); }
+
+  /** Sample by weight instead of uniformly, as the weighted sampler does,
+   * which builds the alias tables of all nodes. */
+  void set_weighted_sample(bool weighted);
+  /** Sample min(k, degree) distinct neighbor positions of the node at idx. */
+  void sample_k(size_t idx,
+                int k,
+                const std::shared_ptr<std::mt19937_64> &rng,
+                std::vector<int> *res) const;
+
+  int feature_size(size_t idx) const {
+    return feature_slot_begin_[idx + 1] - feature_slot_begin_[idx];
+  }
+  std::string get_feature(size_t idx, int slot) const;
+  /** Append the uint64 feature ids of all slots of the node at idx. */
+  void get_feature_ids(size_t idx, std::vector<uint64_t> *res) const;
+
+  size_t memory_size() const;
+
+ private:
+  void BuildDirectory();
+
+  std::vector<uint64_t> ids_;
+  std::vector<uint32_t> lut_;
+  int lut_shift_ = 0;
+
+  std::vector<uint64_t> offsets_;
+  std::vector<uint64_t> neighbors_;
+  std::vector<float> weights_;
+  bool weighted_sample_ = false;
+  // alias tables of AliasSampler, indexed as weights_
+  std::vector<float> alias_prob_;
+  std::vector<uint32_t> alias_;
+
+  std::vector<uint64_t> feature_slot_begin_;
+  std::vector<uint64_t> feature_offsets_;
+  std::vector<char> feature_bytes_;
+};
+
+}  // namespace distributed
+}  // namespace paddle
@@ -71,7 +71,7 @@ void GraphNode::build_sampler(std::string sample_type) {
   if (sample_type == "random") {
     sampler = new RandomSampler();
   } else if (sample_type == "weighted") {
-    sampler = new WeightedSampler();
+    sampler = new AliasSampler();
   }
   if (sampler != nullptr) {
     sampler->build(edges);
@@ -165,4 +165,30 @@ int WeightedSampler::sample(
   subtract_count_map[this]++;
   return return_idx;
 }
+
+void AliasSampler::build(GraphEdgeBlob *edges) {
+  this->edges = edges;
+  int n = edges->size();
+  prob.resize(n);
+  alias.resize(n);
+  build_table(
+      n,
+      [edges](int i) { return static_cast<float>(edges->get_weight(i)); },
+      prob.data(),
+      alias.data());
+}
+
+std::vector<int> AliasSampler::sample_k(
+    int k, const std::shared_ptr<std::mt19937_64> rng) {
+  std::vector<int> sample_result;
+  sample_table(
+      edges->size(),
+      k,
+      [this](int i) { return static_cast<float>(edges->get_weight(i)); },
+      prob.data(),
+      alias.data(),
+      rng.get(),
+      &sample_result);
+  return sample_result;
+}
 }  // namespace paddle::distributed
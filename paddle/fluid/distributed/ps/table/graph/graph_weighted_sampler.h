@@ -13,10 +13,15 @@
 // limitations under the License.
 
 #pragma once
+#include <algorithm>
+#include <cmath>
 #include <ctime>
+#include <limits>
 #include <memory>
 #include <random>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "paddle/fluid/distributed/ps/table/graph/graph_edge.h"
@@ -62,5 +67,134 @@ class WeightedSampler : public Sampler {
       std::unordered_map<WeightedSampler *, int> &subtract_count_map,  // NOLINT
       float &subtract);                                                // NOLINT
 };
+
+// Vose's alias method. The table is built once in O(degree) and takes 8 bytes
+// per edge, a neighbor is drawn in O(1). k distinct neighbors are drawn by
+// rejecting the ones already drawn, which gives the same distribution as
+// WeightedSampler: each draw is proportional to the weights of the neighbors
+// not drawn yet.
+class AliasSampler : public Sampler {
+ public:
+  virtual ~AliasSampler() {}
+  virtual void build(GraphEdgeBlob *edges);
+  virtual std::vector<int> sample_k(int k,
+                                    const std::shared_ptr<std::mt19937_64> rng);
+
+  // Fill prob and alias, both of n entries, with the alias table of the
+  // weights get_weight(0), ..., get_weight(n - 1).
+  template <typename GetWeight>
+  static void build_table(int n,
+                          const GetWeight &get_weight,
+                          float *prob,
+                          uint32_t *alias);
+  // Draw min(k, n) distinct indices into res from the table of build_table.
+  template <typename GetWeight>
+  static void sample_table(int n,
+                           int k,
+                           const GetWeight &get_weight,
+                           const float *prob,
+                           const uint32_t *alias,
+                           std::mt19937_64 *rng,
+                           std::vector<int> *res);
+
+  GraphEdgeBlob *edges;
+
+ private:
+  std::vector<float> prob;
+  std::vector<uint32_t> alias;
+};
+
+template <typename GetWeight>
+void AliasSampler::build_table(int n,
+                               const GetWeight &get_weight,
+                               float *prob,
+                               uint32_t *alias) {
+  double sum = 0;
+  for (int i = 0; i < n; i++) {
+    sum += std::max(static_cast<double>(get_weight(i)), 0.0);
+  }
+  std::vector<uint32_t> small, large;
+  for (int i = 0; i < n; i++) {
+    double w = std::max(static_cast<double>(get_weight(i)), 0.0);
+    prob[i] = sum > 0 ? w * n / sum : 1.0;
+    alias[i] = i;
+    (prob[i] < 1.0 ? small : large).push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    uint32_t s = small.back();
+    uint32_t l = large.back();
+    small.pop_back();
+    large.pop_back();
+    alias[s] = l;
+    prob[l] = (prob[l] + prob[s]) - 1.0;
+    (prob[l] < 1.0 ? small : large).push_back(l);
+  }
+  // the rest are 1 up to rounding errors
+  for (uint32_t i : small) prob[i] = 1.0;
+  for (uint32_t i : large) prob[i] = 1.0;
+}
+
+template <typename GetWeight>
+void AliasSampler::sample_table(int n,
+                                int k,
+                                const GetWeight &get_weight,
+                                const float *prob,
+                                const uint32_t *alias,
+                                std::mt19937_64 *rng,
+                                std::vector<int> *res) {
+  res->clear();
+  if (k >= n) {
+    for (int i = 0; i < n; i++) {
+      res->push_back(i);
+    }
+    return;
+  }
+  res->reserve(k);
+  // a linear search is faster than a hash set for small k
+  const int kLinearSearchSize = 64;
+  std::unordered_set<int> chosen;
+  auto is_chosen = [&](int x) {
+    return k <= kLinearSearchSize
+               ? std::find(res->begin(), res->end(), x) != res->end()
+               : chosen.count(x) > 0;
+  };
+  // Rejections are rare unless k is close to n or a few neighbors take most
+  // of the weight, the rest is drawn by Efraimidis-Spirakis then.
+  int attempts = k <= n / 2 ? 4 * k + 32 : 0;
+  std::uniform_int_distribution<int> index_distrib(0, n - 1);
+  std::uniform_real_distribution<float> prob_distrib(0, 1.0);
+  while (static_cast<int>(res->size()) < k && attempts-- > 0) {
+    int i = index_distrib(*rng);
+    int x = prob_distrib(*rng) < prob[i] ? i : alias[i];
+    if (!is_chosen(x)) {
+      res->push_back(x);
+      if (k > kLinearSearchSize) chosen.insert(x);
+    }
+  }
+  int remain = k - static_cast<int>(res->size());
+  if (remain == 0) {
+    return;
+  }
+  std::uniform_real_distribution<double> key_distrib(0, 1.0);
+  std::vector<std::pair<double, int>> keys;
+  keys.reserve(n - res->size());
+  for (int i = 0; i < n; i++) {
+    if (is_chosen(i)) continue;
+    double w = get_weight(i);
+    keys.emplace_back(w > 0 ? std::log(key_distrib(*rng)) / w
+                            : -std::numeric_limits<double>::infinity(),
+                      i);
+  }
+  std::partial_sort(keys.begin(),
+                    keys.begin() + remain,
+                    keys.end(),
+                    [](const std::pair<double, int> &a,
+                       const std::pair<double, int> &b) {
+                      return a.first > b.first;
+                    });
+  for (int i = 0; i < remain; i++) {
+    res->push_back(keys[i].second);
+  }
+}
 }  // namespace distributed
 }  // namespace paddle
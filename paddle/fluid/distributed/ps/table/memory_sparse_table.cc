@@ -38,6 +38,17 @@ PD_DEFINE_bool(pserver_enable_create_feasign_randomly,
 PD_DEFINE_int32(pserver_table_save_max_retry,
                 3,
                 "pserver_table_save_max_retry");
+PD_DEFINE_bool(pserver_push_merge,
+               false,
+               "pserver merge the pushes of the same key before update");
+PD_DEFINE_int32(pserver_push_merge_window_ms,
+                0,
+                "pserver hold the merged pushes of a shard for the ms, 0 "
+                "applies them at the end of each push, else a background "
+                "thread applies them once the window ends");
+PD_DEFINE_int32(pserver_push_merge_max_keys,
+                100000,
+                "pserver apply the merged pushes of a shard at the key num");
 
 namespace paddle::distributed {
 
@@ -50,10 +61,25 @@ int32_t MemorySparseTable::Initialize() {
   for (auto &shards_task : _shards_task_pool) {
     shards_task.reset(new ::ThreadPool(1));
   }
+  if (FLAGS_pserver_push_merge && FLAGS_pserver_push_merge_window_ms > 0 &&
+      !_push_merge_thread.joinable()) {
+    _push_merge_thread = std::thread([this]() { PushMergeTimer(); });
+  }
   VLOG(0) << "initialize MemorySparseTable succ";
   return 0;
 }
 
+MemorySparseTable::~MemorySparseTable() {
+  if (_push_merge_thread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(_push_merge_mutex);
+      _push_merge_stop = true;
+    }
+    _push_merge_cv.notify_all();
+    _push_merge_thread.join();
+  }
+}
+
 int32_t MemorySparseTable::InitializeValue() {
   _sparse_table_shard_num = static_cast<int>(_config.shard_num());
   _avg_local_shard_num =
@@ -77,6 +103,7 @@ int32_t MemorySparseTable::InitializeValue() {
           << " _use_gpu_graph:" << _use_gpu_graph;
 
   _local_shards.reset(new shard_type[_real_local_shard_num]);
+  _push_merge_buffers.reset(new PushMergeBuffer[_real_local_shard_num]);
 
   if (_config.enable_revert()) {
     // calculate merged shard number based on config param;
@@ -355,6 +382,7 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
     _local_show_threshold = -1;
     return 0;
   }
+  FlushPushMerge();
 
   VLOG(0) << "MemorySparseTable::save dirname: " << dirname;
   int save_param =
@@ -487,6 +515,7 @@ int32_t MemorySparseTable::Save_v2(const std::string &dirname,
     _local_show_threshold = -1;
     return 0;
   }
+  FlushPushMerge();
 
   VLOG(0) << "MemorySparseTable::save dirname: " << dirname;
   int save_param =
@@ -780,6 +809,7 @@ int64_t MemorySparseTable::CacheShuffle(
     ::paddle::framework::Channel<std::pair<uint64_t, std::string>>
         &shuffled_channel,
     const std::vector<Table *> &table_ptrs) {
+  FlushPushMerge();
   LOG(INFO) << "cache shuffle with cache threshold: " << cache_threshold;
   int save_param = atoi(param.c_str());  // batch_model:0  xbox:1
   if (!_config.enable_sparse_table_cache() || cache_threshold < 0) {
@@ -889,6 +919,7 @@ int32_t MemorySparseTable::SaveCache(
     const std::string &param,
     ::paddle::framework::Channel<std::pair<uint64_t, std::string>>
         &shuffled_channel) {
+  FlushPushMerge();
   if (_shard_idx >= _config.sparse_table_cache_file_num()) {
     return 0;
   }
@@ -1041,6 +1072,7 @@ int32_t MemorySparseTable::PullSparse(float *pull_values,
              pull_values,
              mf_value_size,
              select_value_size]() -> int {
+              ApplyPushMerge(shard_id, false);
               auto &local_shard = _local_shards[shard_id];
               float data_buffer[value_size];  // NOLINT
               float *data_buffer_ptr = data_buffer;
@@ -1114,6 +1146,7 @@ int32_t MemorySparseTable::PullSparsePtr(int shard_id,  // fake num
              pull_values,
              value_size,
              mf_value_size]() -> int {
+              ApplyPushMerge(shard_id, false);
               auto &keys = task_keys[shard_id];
               auto &local_shard = _local_shards[shard_id];
               float data_buffer[value_size];  // NOLINT
@@ -1146,6 +1179,164 @@ int32_t MemorySparseTable::PullSparsePtr(int shard_id,  // fake num
   return 0;
 }
 
+void MemorySparseTable::UpdateValue(int shard_id,
+                                    uint64_t key,
+                                    const float *update_data,
+                                    float *data_buffer,
+                                    bool with_revert) {
+  const size_t value_col =
+      _value_accessor->GetAccessorInfo().size / sizeof(float);
+  size_t mf_value_col =
+      _value_accessor->GetAccessorInfo().mf_size / sizeof(float);
+  auto &local_shard = _local_shards[shard_id];
+  float *data_buffer_ptr = data_buffer;
+  auto itr = local_shard.find(key);
+  if (itr == local_shard.end()) {
+    if (FLAGS_pserver_enable_create_feasign_randomly &&
+        !_value_accessor->CreateValue(1, update_data)) {
+      return;
+    }
+    auto value_size = value_col - mf_value_col;
+    auto &feature_value = local_shard[key];
+    feature_value.resize(value_size);
+    _value_accessor->Create(&data_buffer_ptr, 1);
+    memcpy(feature_value.data(), data_buffer_ptr, value_size * sizeof(float));
+    itr = local_shard.find(key);
+  }
+
+  auto &feature_value = itr.value();
+  float *value_data = feature_value.data();
+  size_t value_size = feature_value.size();
+
+  if (value_size == value_col) {  // 已拓展到最大size, 则就地update
+    _value_accessor->Update(&value_data, &update_data, 1);
+  } else {
+    // 拷入buffer区进行update，然后再回填，不需要的mf则回填时抛弃了
+    memcpy(data_buffer_ptr, value_data, value_size * sizeof(float));
+    _value_accessor->Update(&data_buffer_ptr, &update_data, 1);
+
+    if (_value_accessor->NeedExtendMF(data_buffer)) {
+      feature_value.resize(value_col);
+      value_data = feature_value.data();
+      _value_accessor->Create(&value_data, 1);
+    }
+    memcpy(value_data, data_buffer_ptr, value_size * sizeof(float));
+  }
+  if (with_revert) {
+    FixedFeatureValue *feature_value_new = &(_local_shards_new[shard_id][key]);
+    auto new_size = feature_value.size();
+    feature_value_new->resize(new_size);
+    memcpy(feature_value_new->data(), value_data, new_size * sizeof(float));
+  }
+}
+
+void MemorySparseTable::PushShard(int shard_id,
+                                  const uint64_t *keys,
+                                  const float **values,
+                                  size_t num,
+                                  bool with_revert) {
+  const size_t value_col =
+      _value_accessor->GetAccessorInfo().size / sizeof(float);
+  float data_buffer[value_col];  // NOLINT
+  if (!FLAGS_pserver_push_merge) {
+    for (size_t i = 0; i < num; ++i) {
+      UpdateValue(shard_id, keys[i], values[i], data_buffer, with_revert);
+    }
+    return;
+  }
+
+  // The gradients of a key are summed as the workers merge them before
+  // push, so that a hot key is looked up and updated once per window.
+  size_t update_value_col =
+      _value_accessor->GetAccessorInfo().update_size / sizeof(float);
+  auto &buffer = _push_merge_buffers[shard_id];
+  if (buffer.keys.empty()) {
+    buffer.begin_ms = butil::gettimeofday_ms();
+  }
+  buffer.with_revert |= with_revert;
+  for (size_t i = 0; i < num; ++i) {
+    auto res = buffer.index.emplace(keys[i], buffer.keys.size());
+    if (res.second) {
+      buffer.keys.push_back(keys[i]);
+      buffer.values.insert(
+          buffer.values.end(), values[i], values[i] + update_value_col);
+    } else {
+      float *merged =
+          buffer.values.data() + res.first->second * update_value_col;
+      _value_accessor->Merge(&merged, &values[i], 1);
+    }
+  }
+  ApplyPushMerge(shard_id, false);
+}
+
+void MemorySparseTable::ApplyPushMerge(int shard_id, bool force) {
+  auto &buffer = _push_merge_buffers[shard_id];
+  if (buffer.keys.empty()) {
+    return;
+  }
+  if (!force &&
+      buffer.keys.size() <
+          static_cast<size_t>(FLAGS_pserver_push_merge_max_keys) &&
+      butil::gettimeofday_ms() - buffer.begin_ms <
+          FLAGS_pserver_push_merge_window_ms) {
+    return;
+  }
+  const size_t value_col =
+      _value_accessor->GetAccessorInfo().size / sizeof(float);
+  size_t update_value_col =
+      _value_accessor->GetAccessorInfo().update_size / sizeof(float);
+  float data_buffer[value_col];  // NOLINT
+  for (size_t i = 0; i < buffer.keys.size(); ++i) {
+    UpdateValue(shard_id,
+                buffer.keys[i],
+                buffer.values.data() + i * update_value_col,
+                data_buffer,
+                buffer.with_revert);
+  }
+  buffer.index.clear();
+  buffer.keys.clear();
+  buffer.values.clear();
+  buffer.with_revert = false;
+}
+
+void MemorySparseTable::FlushPushMerge() {
+  if (!FLAGS_pserver_push_merge) {
+    return;
+  }
+  std::vector<std::future<int>> tasks(_real_local_shard_num);
+  for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
+    tasks[shard_id] = _shards_task_pool[shard_id % _task_pool_size]->enqueue(
+        [this, shard_id]() -> int {
+          ApplyPushMerge(shard_id, true);
+          return 0;
+        });
+  }
+  for (auto &task : tasks) {
+    task.wait();
+  }
+}
+
+void MemorySparseTable::PushMergeTimer() {
+  std::unique_lock<std::mutex> lock(_push_merge_mutex);
+  auto window = std::chrono::milliseconds(FLAGS_pserver_push_merge_window_ms);
+  while (!_push_merge_cv.wait_for(
+      lock, window, [this]() { return _push_merge_stop; })) {
+    lock.unlock();
+    std::vector<std::future<int>> tasks(_real_local_shard_num);
+    for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
+      tasks[shard_id] = _shards_task_pool[shard_id % _task_pool_size]->enqueue(
+          [this, shard_id]() -> int {
+            ApplyPushMerge(shard_id, false);
+            return 0;
+          });
+    }
+    for (auto &task : tasks) {
+      task.wait();
+    }
+    lock.lock();
+  }
+}
+
 int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
                                       const float *values,
                                       size_t num) {
@@ -1158,75 +1349,24 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
     task_keys[shard_id].push_back({keys[i], i});
   }
 
-  const size_t value_col =
-      _value_accessor->GetAccessorInfo().size / sizeof(float);
-  size_t mf_value_col =
-      _value_accessor->GetAccessorInfo().mf_size / sizeof(float);
   size_t update_value_col =
       _value_accessor->GetAccessorInfo().update_size / sizeof(float);
 
   for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
     tasks[shard_id] = _shards_task_pool[shard_id % _task_pool_size]->enqueue(
-        [this,
-         shard_id,
-         value_col,
-         mf_value_col,
-         update_value_col,
-         values,
-         &task_keys]() -> int {
+        [this, shard_id, update_value_col, values, &task_keys]() -> int {
           auto &keys = task_keys[shard_id];
-          auto &local_shard = _local_shards[shard_id];
-          auto &local_shard_new = _local_shards_new[shard_id];
-          float data_buffer[value_col];  // NOLINT
-          float *data_buffer_ptr = data_buffer;
-          for (auto &item : keys) {
-            uint64_t key = item.first;
-            uint64_t push_data_idx = item.second;
-            const float *update_data =
-                values + push_data_idx * update_value_col;
-            auto itr = local_shard.find(key);
-            if (itr == local_shard.end()) {
-              if (FLAGS_pserver_enable_create_feasign_randomly &&
-                  !_value_accessor->CreateValue(1, update_data)) {
-                continue;
-              }
-              auto value_size = value_col - mf_value_col;
-              auto &feature_value = local_shard[key];
-              feature_value.resize(value_size);
-              _value_accessor->Create(&data_buffer_ptr, 1);
-              memcpy(feature_value.data(),
-                     data_buffer_ptr,
-                     value_size * sizeof(float));
-              itr = local_shard.find(key);
-            }
-
-            auto &feature_value = itr.value();
-            float *value_data = feature_value.data();
-            size_t value_size = feature_value.size();
-
-            if (value_size == value_col) {  // 已拓展到最大size, 则就地update
-              _value_accessor->Update(&value_data, &update_data, 1);
-            } else {
-              // 拷入buffer区进行update，然后再回填，不需要的mf则回填时抛弃了
-              memcpy(data_buffer_ptr, value_data, value_size * sizeof(float));
-              _value_accessor->Update(&data_buffer_ptr, &update_data, 1);
-
-              if (_value_accessor->NeedExtendMF(data_buffer)) {
-                feature_value.resize(value_col);
-                value_data = feature_value.data();
-                _value_accessor->Create(&value_data, 1);
-              }
-              memcpy(value_data, data_buffer_ptr, value_size * sizeof(float));
-            }
-            if (_config.enable_revert()) {
-              FixedFeatureValue *feature_value_new = &(local_shard_new[key]);
-              auto new_size = feature_value.size();
-              feature_value_new->resize(new_size);
-              memcpy(feature_value_new->data(),
-                     value_data,
-                     new_size * sizeof(float));
-            }
+          std::vector<uint64_t> shard_keys(keys.size());
+          std::vector<const float *> shard_values(keys.size());
+          for (size_t i = 0; i < keys.size(); ++i) {
+            shard_keys[i] = keys[i].first;
+            shard_values[i] = values + keys[i].second * update_value_col;
           }
+          PushShard(shard_id,
+                    shard_keys.data(),
+                    shard_values.data(),
+                    keys.size(),
+                    _config.enable_revert());
           return 0;
         });
   }
@@ -1248,53 +1388,21 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
     task_keys[shard_id].push_back({keys[i], i});
   }
 
-  size_t value_col = _value_accessor->GetAccessorInfo().size / sizeof(float);
-  size_t mf_value_col =
-      _value_accessor->GetAccessorInfo().mf_size / sizeof(float);
-
   for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
     tasks[shard_id] = _shards_task_pool[shard_id % _task_pool_size]->enqueue(
-        [this, shard_id, value_col, mf_value_col, values, &task_keys]() -> int {
+        [this, shard_id, values, &task_keys]() -> int {
           auto &keys = task_keys[shard_id];
-          auto &local_shard = _local_shards[shard_id];
-          float data_buffer[value_col];  // NOLINT
-          float *data_buffer_ptr = data_buffer;
-          for (auto &item : keys) {
-            uint64_t key = item.first;
-            uint64_t push_data_idx = item.second;
-            const float *update_data = values[push_data_idx];
-            auto itr = local_shard.find(key);
-            if (itr == local_shard.end()) {
-              if (FLAGS_pserver_enable_create_feasign_randomly &&
-                  !_value_accessor->CreateValue(1, update_data)) {
-                continue;
-              }
-              auto value_size = value_col - mf_value_col;
-              auto &feature_value = local_shard[key];
-              feature_value.resize(value_size);
-              _value_accessor->Create(&data_buffer_ptr, 1);
-              memcpy(feature_value.data(),
-                     data_buffer_ptr,
-                     value_size * sizeof(float));
-              itr = local_shard.find(key);
-            }
-            auto &feature_value = itr.value();
-            float *value_data = feature_value.data();
-            size_t value_size = feature_value.size();
-            if (value_size == value_col) {  // 已拓展到最大size, 则就地update
-              _value_accessor->Update(&value_data, &update_data, 1);
-            } else {
-              // 拷入buffer区进行update，然后再回填，不需要的mf则回填时抛弃了
-              memcpy(data_buffer_ptr, value_data, value_size * sizeof(float));
-              _value_accessor->Update(&data_buffer_ptr, &update_data, 1);
-              if (_value_accessor->NeedExtendMF(data_buffer)) {
-                feature_value.resize(value_col);
-                value_data = feature_value.data();
-                _value_accessor->Create(&value_data, 1);
-              }
-              memcpy(value_data, data_buffer_ptr, value_size * sizeof(float));
-            }
+          std::vector<uint64_t> shard_keys(keys.size());
+          std::vector<const float *> shard_values(keys.size());
+          for (size_t i = 0; i < keys.size(); ++i) {
+            shard_keys[i] = keys[i].first;
+            shard_values[i] = values[keys[i].second];
           }
+          PushShard(shard_id,
+                    shard_keys.data(),
+                    shard_values.data(),
+                    keys.size(),
+                    false);
           return 0;
         });
   }
@@ -1305,10 +1413,14 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
   return 0;
 }
 
-int32_t MemorySparseTable::Flush() { return 0; }
+int32_t MemorySparseTable::Flush() {
+  FlushPushMerge();
+  return 0;
+}
 
 int32_t MemorySparseTable::Shrink(const std::string &param) {
   VLOG(0) << "MemorySparseTable::Shrink";
+  FlushPushMerge();
   std::atomic<uint32_t> shrink_size_all{0};
   int thread_num = _real_local_shard_num;
   omp_set_num_threads(thread_num);
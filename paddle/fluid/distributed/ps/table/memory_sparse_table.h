@@ -18,9 +18,11 @@
 #include <assert.h>
 #include <pthread.h>
 
+#include <condition_variable>  // NOLINT
 #include <memory>
 #include <mutex>  // NOLINT
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -40,7 +42,7 @@ class MemorySparseTable : public Table {
  public:
   typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
   MemorySparseTable() {}
-  virtual ~MemorySparseTable() {}
+  virtual ~MemorySparseTable();
 
   // unused method end
   static int32_t sparse_local_shard_num(uint32_t shard_num,
@@ -119,12 +121,49 @@ class MemorySparseTable : public Table {
   virtual int32_t LoadPatch(const std::vector<std::string>& file_list,
                             int save_param);
 
+  // Pushes of a shard merged by key, only used by the shard's task thread.
+  struct PushMergeBuffer {
+    std::unordered_map<uint64_t, uint32_t> index;
+    std::vector<uint64_t> keys;
+    std::vector<float> values;
+    int64_t begin_ms = 0;
+    bool with_revert = false;
+  };
+
+  // Update the value of key in the shard with one push value.
+  void UpdateValue(int shard_id,
+                   uint64_t key,
+                   const float* update_data,
+                   float* data_buffer,
+                   bool with_revert);
+  // Update the values of a shard with num pushes, merged by key if
+  // FLAGS_pserver_push_merge is set.
+  void PushShard(int shard_id,
+                 const uint64_t* keys,
+                 const float** values,
+                 size_t num,
+                 bool with_revert);
+  // Apply the merged pushes of a shard, only if the window ended unless
+  // force is set.
+  void ApplyPushMerge(int shard_id, bool force);
+  // Apply the merged pushes of all shards.
+  void FlushPushMerge();
+  // Apply the merged pushes of the shards whose window ended, every window
+  // until the table is destroyed, so that the pushes held by a shard without
+  // further requests are applied at most two windows late.
+  void PushMergeTimer();
+
   int _task_pool_size = 24;
   int _avg_local_shard_num;
   int _real_local_shard_num;
   int _sparse_table_shard_num;
   std::vector<std::shared_ptr<::ThreadPool>> _shards_task_pool;
   std::unique_ptr<shard_type[]> _local_shards;
+  std::unique_ptr<PushMergeBuffer[]> _push_merge_buffers;
+  std::thread _push_merge_thread;
+  std::mutex _push_merge_mutex;
+  std::condition_variable _push_merge_cv;
+  bool _push_merge_stop = false;
 
   // for patch model
   int _m_avg_local_shard_num;
@@ -99,11 +99,12 @@ void SparseAdaGradSGDRule::UpdateValueWork(float *w,
                                            float scale) {
   float &g2sum = sgd[G2SumIndex()];
   double add_g2sum = 0;
+  // g2sum is only updated after the loop
+  auto ratio = sqrt(_initial_g2sum / (_initial_g2sum + g2sum));
 
   for (size_t i = 0; i < _embedding_dim; i++) {
     double scaled_grad = grad[i] / scale;
-    w[i] -= learning_rate_ * scaled_grad *
-            sqrt(_initial_g2sum / (_initial_g2sum + g2sum));
+    w[i] -= learning_rate_ * scaled_grad * ratio;
     BoundValue(w[i]);
     add_g2sum += scaled_grad * scaled_grad;
   }
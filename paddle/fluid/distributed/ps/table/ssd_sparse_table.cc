@@ -14,11 +14,14 @@
 
 #include "paddle/fluid/distributed/ps/table/ssd_sparse_table.h"
 
+#include <algorithm>
+
 #include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/common/cost_timer.h"
 #include "paddle/fluid/distributed/common/local_random.h"
 #include "paddle/fluid/distributed/common/topk_calculator.h"
 #include "paddle/fluid/framework/archive.h"
+#include "paddle/fluid/framework/io/fs.h"
 #include "paddle/utils/string/string_helper.h"
 PD_DECLARE_bool(pserver_print_missed_key_num_every_push);
 PD_DECLARE_bool(pserver_create_value_when_push);
@@ -28,13 +31,136 @@ PD_DEFINE_int32(pserver_load_batch_size, 5000, "load batch size for ssd");
 PHI_DEFINE_EXPORTED_string(rocksdb_path,
                            "database",
                            "path of sparse table rocksdb file");
+PD_DEFINE_bool(pserver_ssd_binary_checkpoint,
+               false,
+               "pserver save and load the checkpoint of save param 0 as "
+               "binary files and rocksdb checkpoints, with delta checkpoints "
+               "of the keys changed since the last one");
+PD_DEFINE_int32(pserver_ssd_checkpoint_max_delta,
+                10,
+                "pserver max delta checkpoints based on a full checkpoint");
+PD_DEFINE_int64(pserver_ssd_mem_capacity,
+                0,
+                "pserver max values in memory of a SSDSparseTable for cpu "
+                "pull and push, the values pulled most often are kept in "
+                "memory and the others are moved to ssd in batches, 0 to "
+                "disable");
 
 namespace paddle::distributed {
 
+namespace {
+
+const size_t kCheckpointBufferSize = 4 * 1024 * 1024;
+// key and dim of a record, followed by dim floats
+const size_t kCheckpointRecordHeaderSize = sizeof(uint64_t) + sizeof(uint32_t);
+
+// Writes the records of a checkpoint file.
+class CheckpointWriter {
+ public:
+  CheckpointWriter(AfsClient* afs_client, const std::string& path) {
+    FsChannelConfig channel_config;
+    channel_config.path = path;
+    int err_no = 0;
+    _channel = afs_client->open_w(channel_config, 1024 * 1024 * 40, &err_no);
+  }
+
+  bool Write(uint64_t key, const float* value, uint32_t dim) {
+    _buffer.append(reinterpret_cast<const char*>(&key), sizeof(uint64_t));
+    _buffer.append(reinterpret_cast<const char*>(&dim), sizeof(uint32_t));
+    _buffer.append(reinterpret_cast<const char*>(value), dim * sizeof(float));
+    ++_count;
+    return _buffer.size() < kCheckpointBufferSize || Flush();
+  }
+
+  bool Close() {
+    bool ok = Flush();
+    _channel->close();
+    return ok;
+  }
+
+  uint64_t count() const { return _count; }
+
+ private:
+  bool Flush() {
+    bool ok =
+        _buffer.empty() || _channel->write(_buffer.data(), _buffer.size()) == 0;
+    _buffer.clear();
+    return ok;
+  }
+
+  std::shared_ptr<FsWriteChannel> _channel;
+  std::string _buffer;
+  uint64_t _count = 0;
+};
+
+// Calls func(key, value, dim) for the records of a checkpoint file, returns
+// -1 if the file ends in a record.
+template <typename Func>
+int ReadCheckpoint(AfsClient* afs_client, const std::string& path, Func func) {
+  FsChannelConfig channel_config;
+  channel_config.path = path;
+  int err_no = 0;
+  auto read_channel = afs_client->open_r(channel_config, 0, &err_no);
+  // records start at multiples of 4 bytes, so the values are aligned
+  std::vector<char> buf(kCheckpointBufferSize);
+  size_t size = 0;
+  while (true) {
+    int ret = read_channel->read(buf.data() + size, buf.size() - size);
+    if (ret <= 0) {
+      break;
+    }
+    size += ret;
+    size_t pos = 0;
+    while (size - pos >= kCheckpointRecordHeaderSize) {
+      uint64_t key = 0;
+      uint32_t dim = 0;
+      memcpy(&key, buf.data() + pos, sizeof(uint64_t));
+      memcpy(&dim, buf.data() + pos + sizeof(uint64_t), sizeof(uint32_t));
+      size_t len = kCheckpointRecordHeaderSize + dim * sizeof(float);
+      if (size - pos < len) {
+        buf.resize(std::max(buf.size(), len));
+        break;
+      }
+      func(key,
+           reinterpret_cast<const float*>(buf.data() + pos +
+                                          kCheckpointRecordHeaderSize),
+           dim);
+      pos += len;
+    }
+    memmove(buf.data(), buf.data() + pos, size - pos);
+    size -= pos;
+  }
+  read_channel->close();
+  return size == 0 ? 0 : -1;
+}
+
+// The binary checkpoint of a server in a table path. It is written to a
+// temporary directory and renamed into place, so that a failed save keeps the
+// checkpoint saved before.
+std::string CheckpointDir(const std::string& table_path, size_t shard_idx) {
+  return ::paddle::string::format_string(
+      "%s/checkpoint-%03d", table_path.c_str(), shard_idx);
+}
+
+}  // namespace
+
 int32_t SSDSparseTable::Initialize() {
   MemorySparseTable::Initialize();
   _db = ::paddle::distributed::RocksDBHandler::GetInstance();
   _db->initialize(FLAGS_rocksdb_path, _real_local_shard_num);
+  _dirty_keys.resize(_real_local_shard_num);
+  if (FLAGS_pserver_ssd_mem_capacity > 0 && _real_local_shard_num > 0) {
+    _mem_capacity_per_shard = std::max<size_t>(
+        FLAGS_pserver_ssd_mem_capacity / _real_local_shard_num, 1);
+    for (int i = 0; i < _real_local_shard_num; ++i) {
+      _freq_sketches.emplace_back(_mem_capacity_per_shard);
+    }
+    _demote_freq.resize(_real_local_shard_num, 0);
+    _demote_pending.resize(_real_local_shard_num, 0);
+    _tier_stats.resize(_real_local_shard_num);
+    VLOG(0) << "SSDSparseTable mem capacity per shard:"
+            << _mem_capacity_per_shard;
+  }
   VLOG(0) << "initialize SSDSparseTable succ";
   VLOG(0) << "SSD FLAGS_pserver_print_missed_key_num_every_push:"
           << FLAGS_pserver_print_missed_key_num_every_push;
@@ -124,17 +250,25 @@ int32_t SSDSparseTable::PullSparse(float* pull_values,
                 auto& local_shard = _local_shards[shard_id];
                 float data_buffer[value_size];  // NOLINT
                 float* data_buffer_ptr = data_buffer;
+                // pull rocksdb with one MultiGet
+                std::vector<uint64_t> ssd_keys;
+                for (auto& key : keys) {
+                  if (_mem_capacity_per_shard > 0) {
+                    _freq_sketches[shard_id].Increment(key.first);
+                  }
+                  if (local_shard.find(key.first) == local_shard.end()) {
+                    ssd_keys.push_back(key.first);
+                  }
+                }
+                std::unordered_map<uint64_t, std::string> ssd_values;
+                MultiGetSSD(shard_id, &ssd_keys, &ssd_values);
                 for (size_t i = 0; i < keys.size(); ++i) {
                   uint64_t key = keys[i].first;
                   auto itr = local_shard.find(key);
                   size_t data_size = value_size - mf_value_size;
                   if (itr == local_shard.end()) {
-                    // pull rocksdb
-                    std::string tmp_string("");
-                    if (_db->get(shard_id,
-                                 reinterpret_cast<char*>(&key),
-                                 sizeof(uint64_t),
-                                 tmp_string) > 0) {
+                    auto ssd_itr = ssd_values.find(key);
+                    if (ssd_itr == ssd_values.end()) {
                       ++missed_keys;
                       if (FLAGS_pserver_create_value_when_push) {
                         memset(data_buffer, 0, sizeof(float) * data_size);
@@ -147,21 +281,27 @@ int32_t SSDSparseTable::PullSparse(float* pull_values,
                         memcpy(data_ptr,
                                data_buffer_ptr,
                                data_size * sizeof(float));
+                        if (FLAGS_pserver_ssd_binary_checkpoint) {
+                          _dirty_keys[shard_id].insert(key);
+                        }
                       }
                     } else {
-                      data_size = tmp_string.size() / sizeof(float);
+                      data_size = ssd_itr->second.size() / sizeof(float);
                       memcpy(data_buffer_ptr,
-                             ::paddle::string::str_to_float(tmp_string),
-                             data_size * sizeof(float));
-                      // from rocksdb to mem
-                      auto& feature_value = local_shard[key];
-                      feature_value.resize(data_size);
-                      memcpy(const_cast<float*>(feature_value.data()),
-                             data_buffer_ptr,
+                             ::paddle::string::str_to_float(ssd_itr->second),
                              data_size * sizeof(float));
-                      _db->del_data(shard_id,
-                                    reinterpret_cast<char*>(&key),
-                                    sizeof(uint64_t));
+                      if (AdmitToMem(shard_id, key)) {
+                        // from rocksdb to mem
+                        auto& feature_value = local_shard[key];
+                        feature_value.resize(data_size);
+                        memcpy(const_cast<float*>(feature_value.data()),
+                               data_buffer_ptr,
+                               data_size * sizeof(float));
+                        _db->del_data(shard_id,
+                                      reinterpret_cast<char*>(&key),
+                                      sizeof(uint64_t));
+                        ssd_values.erase(ssd_itr);
+                      }
                     }
                   } else {
                     data_size = itr.value().size();
@@ -179,6 +319,7 @@ int32_t SSDSparseTable::PullSparse(float* pull_values,
                   _value_accessor->Select(
                       &select_data, (const float**)&data_buffer_ptr, 1);
                 }
+                MaybeDemote(shard_id);
                 return 0;
               });
     }
@@ -202,6 +343,10 @@ int32_t SSDSparseTable::PullSparsePtr(int shard_id,
   size_t value_size = _value_accessor->GetAccessorInfo().size / sizeof(float);
   size_t mf_value_size =
       _value_accessor->GetAccessorInfo().mf_size / sizeof(float);
+  if (FLAGS_pserver_ssd_binary_checkpoint) {
+    // the values are updated through the pointers
+    _dirty_keys[shard_id].insert(pull_keys, pull_keys + num);
+  }
 
   {  // 从table取值 or create
     RocksDBCtx context;
@@ -376,6 +521,17 @@ int32_t SSDSparseTable::PushSparse(const uint64_t* keys,
                 auto& local_shard = _local_shards[shard_id];
                 float data_buffer[value_col];  // NOLINT
                 float* data_buffer_ptr = data_buffer;
+                // the values not admitted to mem are updated on ssd
+                std::unordered_map<uint64_t, std::string> ssd_values;
+                if (_mem_capacity_per_shard > 0) {
+                  std::vector<uint64_t> ssd_keys;
+                  for (auto& key : keys) {
+                    if (local_shard.find(key.first) == local_shard.end()) {
+                      ssd_keys.push_back(key.first);
+                    }
+                  }
+                  MultiGetSSD(shard_id, &ssd_keys, &ssd_values);
+                }
                 for (size_t i = 0; i < keys.size(); ++i) {
                   uint64_t key = keys[i].first;
                   uint64_t push_data_idx = keys[i].second;
@@ -383,6 +539,15 @@ int32_t SSDSparseTable::PushSparse(const uint64_t* keys,
                       values + push_data_idx * update_value_col;
                   auto itr = local_shard.find(key);
                   if (itr == local_shard.end()) {
+                    auto ssd_itr = ssd_values.find(key);
+                    if (ssd_itr != ssd_values.end()) {
+                      UpdateSSDValue(
+                          &ssd_itr->second, update_data, data_buffer_ptr);
+                      if (FLAGS_pserver_ssd_binary_checkpoint) {
+                        _dirty_keys[shard_id].insert(key);
+                      }
+                      continue;
+                    }
                     if (FLAGS_pserver_enable_create_feasign_randomly &&
                         !_value_accessor->CreateValue(1, update_data)) {
                       continue;
@@ -418,7 +583,25 @@ int32_t SSDSparseTable::PushSparse(const uint64_t* keys,
                            data_buffer_ptr,
                            value_size * sizeof(float));
                   }
+                  if (FLAGS_pserver_ssd_binary_checkpoint) {
+                    _dirty_keys[shard_id].insert(key);
+                  }
                 }
+                if (!ssd_values.empty()) {
+                  std::vector<std::pair<char*, int>> batch_keys;
+                  std::vector<std::pair<char*, int>> batch_values;
+                  for (auto& ssd_value : ssd_values) {
+                    batch_keys.emplace_back(
+                        reinterpret_cast<char*>(
+                            const_cast<uint64_t*>(&ssd_value.first)),
+                        sizeof(uint64_t));
+                    batch_values.emplace_back(ssd_value.second.data(),
+                                              ssd_value.second.size());
+                  }
+                  _db->put_batch(
+                      shard_id, batch_keys, batch_values, batch_keys.size());
+                }
+                MaybeDemote(shard_id);
                 return 0;
               });
     }
@@ -477,12 +660,32 @@ int32_t SSDSparseTable::PushSparse(const uint64_t* keys,
                 auto& local_shard = _local_shards[shard_id];
                 float data_buffer[value_col];  // NOLINT
                 float* data_buffer_ptr = data_buffer;
+                // the values not admitted to mem are updated on ssd
+                std::unordered_map<uint64_t, std::string> ssd_values;
+                if (_mem_capacity_per_shard > 0) {
+                  std::vector<uint64_t> ssd_keys;
+                  for (auto& key : keys) {
+                    if (local_shard.find(key.first) == local_shard.end()) {
+                      ssd_keys.push_back(key.first);
+                    }
+                  }
+                  MultiGetSSD(shard_id, &ssd_keys, &ssd_values);
+                }
                 for (size_t i = 0; i < keys.size(); ++i) {
                   uint64_t key = keys[i].first;
                   uint64_t push_data_idx = keys[i].second;
                   const float* update_data = values[push_data_idx];
                   auto itr = local_shard.find(key);
                   if (itr == local_shard.end()) {
+                    auto ssd_itr = ssd_values.find(key);
+                    if (ssd_itr != ssd_values.end()) {
+                      UpdateSSDValue(
+                          &ssd_itr->second, update_data, data_buffer_ptr);
+                      if (FLAGS_pserver_ssd_binary_checkpoint) {
+                        _dirty_keys[shard_id].insert(key);
+                      }
+                      continue;
+                    }
                     if (FLAGS_pserver_enable_create_feasign_randomly &&
                         !_value_accessor->CreateValue(1, update_data)) {
                       continue;
@@ -518,7 +721,25 @@ int32_t SSDSparseTable::PushSparse(const uint64_t* keys,
                            data_buffer_ptr,
                            value_size * sizeof(float));
                   }
+                  if (FLAGS_pserver_ssd_binary_checkpoint) {
+                    _dirty_keys[shard_id].insert(key);
+                  }
+                }
+                if (!ssd_values.empty()) {
+                  std::vector<std::pair<char*, int>> batch_keys;
+                  std::vector<std::pair<char*, int>> batch_values;
+                  for (auto& ssd_value : ssd_values) {
+                    batch_keys.emplace_back(
+                        reinterpret_cast<char*>(
+                            const_cast<uint64_t*>(&ssd_value.first)),
+                        sizeof(uint64_t));
+                    batch_values.emplace_back(ssd_value.second.data(),
+                                              ssd_value.second.size());
+                  }
+                  _db->put_batch(
+                      shard_id, batch_keys, batch_values, batch_keys.size());
                 }
+                MaybeDemote(shard_id);
                 return 0;
               });
     }
@@ -529,7 +750,147 @@ int32_t SSDSparseTable::PushSparse(const uint64_t* keys,
   return 0;
 }
 
+void SSDSparseTable::MultiGetSSD(
+    int shard_id,
+    std::vector<uint64_t>* keys,
+    std::unordered_map<uint64_t, std::string>* values) {
+  if (keys->empty()) {
+    return;
+  }
+  // in the order of Uint64Comparator
+  std::sort(keys->begin(), keys->end());
+  keys->erase(std::unique(keys->begin(), keys->end()), keys->end());
+  std::vector<rocksdb::Slice> key_slices;
+  key_slices.reserve(keys->size());
+  for (auto& key : *keys) {
+    key_slices.emplace_back(reinterpret_cast<const char*>(&key),
+                            sizeof(uint64_t));
+  }
+  std::vector<rocksdb::PinnableSlice> value_slices(keys->size());
+  std::vector<rocksdb::Status> status(keys->size());
+  _db->multi_get(shard_id,
+                 keys->size(),
+                 key_slices.data(),
+                 value_slices.data(),
+                 status.data());
+  for (size_t i = 0; i < keys->size(); ++i) {
+    if (status[i].ok()) {
+      values->emplace((*keys)[i], value_slices[i].ToString());
+    } else if (!status[i].IsNotFound()) {
+      LOG(ERROR) << "SSDSparseTable multi get failed, shard:" << shard_id
+                 << ", key:" << (*keys)[i] << ", " << status[i].ToString();
+    }
+  }
+}
+
+void SSDSparseTable::UpdateSSDValue(std::string* value,
+                                    const float* update_data,
+                                    float* data_buffer) {
+  size_t value_col = _value_accessor->GetAccessorInfo().size / sizeof(float);
+  size_t value_size = value->size() / sizeof(float);
+  memcpy(data_buffer, value->data(), value_size * sizeof(float));
+  _value_accessor->Update(&data_buffer, &update_data, 1);
+  if (value_size < value_col && _value_accessor->NeedExtendMF(data_buffer)) {
+    value->resize(value_col * sizeof(float));
+    float* value_data = reinterpret_cast<float*>(value->data());
+    _value_accessor->Create(&value_data, 1);
+  }
+  memcpy(value->data(), data_buffer, value_size * sizeof(float));
+}
+
+bool SSDSparseTable::AdmitToMem(int shard_id, uint64_t key) {
+  if (_mem_capacity_per_shard == 0) {
+    return true;
+  }
+  // TinyLFU, a value is admitted if it is pulled more often than the values
+  // demoted last
+  if (_local_shards[shard_id].size() < _mem_capacity_per_shard ||
+      _freq_sketches[shard_id].Estimate(key) > _demote_freq[shard_id]) {
+    ++_tier_stats[shard_id].promotions;
+    return true;
+  }
+  ++_tier_stats[shard_id].rejections;
+  return false;
+}
+
+void SSDSparseTable::MaybeDemote(int shard_id) {
+  if (_mem_capacity_per_shard == 0 || _demote_pending[shard_id] ||
+      _local_shards[shard_id].size() <= _mem_capacity_per_shard * 11 / 10) {
+    return;
+  }
+  _demote_pending[shard_id] = 1;
+  _shards_task_pool[shard_id % _shards_task_pool.size()]->enqueue(
+      [this, shard_id]() -> int {
+        DemoteShard(shard_id);
+        _demote_pending[shard_id] = 0;
+        return 0;
+      });
+}
+
+void SSDSparseTable::DemoteShard(int shard_id) {
+  auto& local_shard = _local_shards[shard_id];
+  size_t target_size = _mem_capacity_per_shard * 9 / 10;
+  if (local_shard.size() <= target_size) {
+    return;
+  }
+  auto& sketch = _freq_sketches[shard_id];
+  std::vector<std::pair<uint8_t, uint64_t>> freqs;
+  freqs.reserve(local_shard.size());
+  for (auto it = local_shard.begin(); it != local_shard.end(); ++it) {
+    freqs.emplace_back(sketch.Estimate(it.key()), it.key());
+  }
+  size_t demote_num = local_shard.size() - target_size;
+  std::nth_element(freqs.begin(), freqs.begin() + demote_num - 1, freqs.end());
+  _demote_freq[shard_id] = freqs[demote_num - 1].first;
+
+  std::vector<std::pair<char*, int>> ssd_keys;
+  std::vector<std::pair<char*, int>> ssd_values;
+  for (size_t begin = 0; begin < demote_num;
+       begin += FLAGS_pserver_load_batch_size) {
+    size_t end = std::min<size_t>(begin + FLAGS_pserver_load_batch_size,
+                                  demote_num);
+    ssd_keys.clear();
+    ssd_values.clear();
+    for (size_t i = begin; i < end; ++i) {
+      auto& feature_value = local_shard.find(freqs[i].second).value();
+      ssd_keys.emplace_back(reinterpret_cast<char*>(&freqs[i].second),
+                            sizeof(uint64_t));
+      ssd_values.emplace_back(reinterpret_cast<char*>(feature_value.data()),
+                              feature_value.size() * sizeof(float));
+    }
+    _db->put_batch(shard_id, ssd_keys, ssd_values, ssd_keys.size());
+    for (size_t i = begin; i < end; ++i) {
+      local_shard.erase(freqs[i].second);
+    }
+  }
+  auto& stat = _tier_stats[shard_id];
+  stat.demotions += demote_num;
+  VLOG(1) << "SSDSparseTable demote shard:" << shard_id
+          << " count:" << demote_num << " max freq:"
+          << static_cast<int>(_demote_freq[shard_id])
+          << " mem:" << local_shard.size() << " promotions:" << stat.promotions
+          << " rejections:" << stat.rejections
+          << " demotions:" << stat.demotions;
+}
+
+void SSDSparseTable::WaitDemotion() {
+  if (_mem_capacity_per_shard == 0) {
+    return;
+  }
+  // the demotions are before these in the queues
+  std::vector<std::future<int>> tasks;
+  for (auto& task_pool : _shards_task_pool) {
+    tasks.push_back(task_pool->enqueue([]() -> int { return 0; }));
+  }
+  for (auto& task : tasks) {
+    task.wait();
+  }
+}
+
 int32_t SSDSparseTable::Shrink(const std::string& param) {
+  WaitDemotion();
+  // the values are decayed
+  _checkpoint_need_full = true;
   int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
   omp_set_num_threads(thread_num);
 #pragma omp parallel for schedule(dynamic)
@@ -570,6 +931,7 @@ int32_t SSDSparseTable::Shrink(const std::string& param) {
 }
 
 int32_t SSDSparseTable::UpdateTable() {
+  WaitDemotion();
   int count = 0;
   for (int i = 0; i < _real_local_shard_num; ++i) {
     auto& shard = _local_shards[i];
@@ -613,6 +975,12 @@ int32_t SSDSparseTable::Save(const std::string& path,
   }
 #endif
   std::lock_guard<std::mutex> guard(_table_mutex);
+  WaitDemotion();
+  if (FLAGS_pserver_ssd_binary_checkpoint && atoi(param.c_str()) == 0) {
+    return SaveCheckpoint(TableDir(path));
+  }
+  // the values may be updated after save
+  _checkpoint_need_full = true;
 #ifdef PADDLE_WITH_HETERPS
   int save_param = atoi(param.c_str());
   int32_t ret = 0;
@@ -632,6 +1000,8 @@ int32_t SSDSparseTable::Save(const std::string& path,
 int32_t SSDSparseTable::Save_v2(const std::string& path,
                                 const std::string& param) {
   std::lock_guard<std::mutex> guard(_table_mutex);
+  WaitDemotion();
+  _checkpoint_need_full = true;
 #ifdef PADDLE_WITH_HETERPS
   int save_param = atoi(param.c_str());
   int32_t ret = 0;
@@ -2424,6 +2794,7 @@ int64_t SSDSparseTable::CacheShuffle(
     const std::vector<Table*>& table_ptrs) {
   LOG(INFO) << "cache shuffle with cache threshold: " << cache_threshold
             << " param:" << param;
+  WaitDemotion();
   int save_param = atoi(param.c_str());  // batch_model:0  xbox:1
   if (!_config.enable_sparse_table_cache() || cache_threshold < 0) {
     LOG(WARNING)
@@ -2581,7 +2952,14 @@ int32_t SSDSparseTable::SaveCache(
 int32_t SSDSparseTable::Load(const std::string& path,
                              const std::string& param) {
   VLOG(0) << "LOAD FLAGS_rocksdb_path:" << FLAGS_rocksdb_path;
+  WaitDemotion();
   std::string table_path = TableDir(path);
+  if (FLAGS_pserver_ssd_binary_checkpoint && atoi(param.c_str()) == 0 &&
+      _afs_client.exist(CheckpointDir(table_path, _shard_idx) + "/meta")) {
+    _value_accessor->SetDayId(_day_id);
+    return LoadCheckpoint(table_path);
+  }
+  _checkpoint_need_full = true;
   auto file_list = _afs_client.list(::paddle::string::format_string(
       "%s/part-%03d*", table_path.c_str(), _shard_idx));
 
@@ -3044,6 +3422,248 @@ int32_t SSDSparseTable::LoadWithBinary(const std::string& path, int param) {
   return 0;
 }
 
+int32_t SSDSparseTable::SaveCheckpoint(const std::string& table_path) {
+  if (_real_local_shard_num == 0) {
+    return 0;
+  }
+  bool full = _checkpoint_need_full || _last_checkpoint_path.empty() ||
+              _last_checkpoint_path == table_path ||
+              _delta_checkpoint_num >= FLAGS_pserver_ssd_checkpoint_max_delta;
+  // rocksdb checkpoints need a local path, on hdfs and afs the values on ssd
+  // are written as records
+  bool local_fs = ::paddle::framework::fs_select_internal(table_path) == 0;
+  if (full) {
+    // a full checkpoint does not need the changed keys
+    for (auto& keys : _dirty_keys) {
+      keys.clear();
+    }
+  }
+  size_t file_start_idx = _avg_local_shard_num * _shard_idx;
+  std::string checkpoint_dir = CheckpointDir(table_path, _shard_idx);
+  std::string tmp_dir = checkpoint_dir + ".tmp";
+  _afs_client.remove_dir(tmp_dir);
+  ::paddle::framework::fs_mkdir(tmp_dir);
+
+  std::atomic<uint64_t> feasign_size_all{0};
+  std::atomic<int> failed_shard_num{0};
+  int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
+  omp_set_num_threads(thread_num);
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < _real_local_shard_num; ++i) {
+    std::string shard_path = ::paddle::string::format_string(
+        "%s/part-%05d", tmp_dir.c_str(), file_start_idx + i);
+    auto& shard = _local_shards[i];
+    CheckpointWriter writer(&_afs_client, shard_path + ".mem");
+    bool ok = true;
+    if (full) {
+      for (auto it = shard.begin(); ok && it != shard.end(); ++it) {
+        ok = writer.Write(it.key(), it.value().data(), it.value().size());
+      }
+    } else {
+      std::string ssd_value;
+      for (auto it = _dirty_keys[i].begin(); ok && it != _dirty_keys[i].end();
+           ++it) {
+        uint64_t key = *it;
+        auto itr = shard.find(key);
+        if (itr != shard.end()) {
+          ok = writer.Write(key, itr.value().data(), itr.value().size());
+        } else if (_db->get(i,
+                            reinterpret_cast<char*>(&key),
+                            sizeof(uint64_t),
+                            ssd_value) == 0) {
+          // moved to ssd since it changed
+          ok = writer.Write(key,
+                            ::paddle::string::str_to_float(ssd_value),
+                            ssd_value.size() / sizeof(float));
+        }
+      }
+    }
+    ok = writer.Close() && ok;
+    feasign_size_all += writer.count();
+
+    if (ok && full && local_fs) {
+      ok = _db->checkpoint(i, shard_path + ".db") == 0;
+    } else if (ok && full) {
+      CheckpointWriter ssd_writer(&_afs_client, shard_path + ".ssd");
+      auto* it = _db->get_iterator(i);
+      for (it->SeekToFirst(); ok && it->Valid(); it->Next()) {
+        ok = ssd_writer.Write(
+            *(reinterpret_cast<const uint64_t*>(it->key().data())),
+            ::paddle::string::str_to_float(it->value().data()),
+            it->value().size() / sizeof(float));
+      }
+      delete it;
+      ok = ssd_writer.Close() && ok;
+      feasign_size_all += ssd_writer.count();
+    }
+    if (!ok) {
+      ++failed_shard_num;
+    }
+  }
+  bool ok = failed_shard_num == 0;
+  if (!ok) {
+    LOG(WARNING) << "SSDSparseTable save checkpoint failed, shard num:"
+                 << failed_shard_num << ", path:" << table_path;
+  } else {
+    // the meta is written last, a checkpoint without it is not loaded
+    FsChannelConfig channel_config;
+    channel_config.path = tmp_dir + "/meta";
+    int err_no = 0;
+    auto meta_channel = _afs_client.open_w(channel_config, 0, &err_no);
+    std::string meta = full ? "full" : "delta " + _last_checkpoint_path;
+    ok = meta_channel->write_line(meta) == 0;
+    meta_channel->close();
+    if (!ok) {
+      LOG(WARNING) << "SSDSparseTable save checkpoint meta failed, path:"
+                   << channel_config.path;
+    }
+  }
+  if (!ok) {
+    _afs_client.remove_dir(tmp_dir);
+    // the next checkpoint is a full one
+    _checkpoint_need_full = true;
+    for (auto& keys : _dirty_keys) {
+      keys.clear();
+    }
+    return -1;
+  }
+  // the checkpoint saved before is kept until the new one is in place
+  std::string old_dir = checkpoint_dir + ".old";
+  _afs_client.remove_dir(old_dir);
+  if (_afs_client.exist(checkpoint_dir)) {
+    ::paddle::framework::fs_mv(checkpoint_dir, old_dir);
+  }
+  ::paddle::framework::fs_mv(tmp_dir, checkpoint_dir);
+  _afs_client.remove_dir(old_dir);
+
+  if (!full) {
+    for (auto& keys : _dirty_keys) {
+      keys.clear();
+    }
+  }
+  _delta_checkpoint_num = full ? 0 : _delta_checkpoint_num + 1;
+  _last_checkpoint_path = table_path;
+  _checkpoint_need_full = false;
+  VLOG(0) << "SSDSparseTable save " << (full ? "full" : "delta")
+          << " checkpoint success, feasign size:" << feasign_size_all
+          << ", path:" << table_path;
+  return 0;
+}
+
+int32_t SSDSparseTable::LoadCheckpoint(const std::string& table_path) {
+  std::string checkpoint_dir = CheckpointDir(table_path, _shard_idx);
+  FsChannelConfig channel_config;
+  channel_config.path = checkpoint_dir + "/meta";
+  int err_no = 0;
+  auto meta_channel = _afs_client.open_r(channel_config, 0, &err_no);
+  std::string meta;
+  meta_channel->read_line(meta);
+  meta_channel->close();
+  bool full = meta == "full";
+  if (!full) {
+    if (meta.compare(0, 6, "delta ") != 0) {
+      LOG(WARNING) << "SSDSparseTable invalid checkpoint meta:" << meta
+                   << ", path:" << channel_config.path;
+      return -1;
+    }
+    // a delta checkpoint is applied to the one it is based on
+    if (LoadCheckpoint(meta.substr(6)) != 0) {
+      return -1;
+    }
+  }
+
+  size_t file_start_idx = _avg_local_shard_num * _shard_idx;
+  std::atomic<uint64_t> feasign_size_all{0};
+  std::atomic<int> failed_shard_num{0};
+  int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
+  omp_set_num_threads(thread_num);
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < _real_local_shard_num; ++i) {
+    std::string shard_path = ::paddle::string::format_string(
+        "%s/part-%05d", checkpoint_dir.c_str(), file_start_idx + i);
+    auto& shard = _local_shards[i];
+    bool ok = true;
+    if (full && _afs_client.exist(shard_path + ".db")) {
+      shard.clear();
+      ok = _db->restore(i, shard_path + ".db") == 0;
+    } else if (full) {
+      shard.clear();
+      ok = _db->clear(i) == 0;
+      // the records are sorted by key, so they are written to a sst file
+      // and ingested at once
+      std::string sst_path = ::paddle::string::format_string(
+          "%s_%d/checkpoint.sst", FLAGS_rocksdb_path.c_str(), i);
+      rocksdb::SstFileWriter sst_writer(rocksdb::EnvOptions(),
+                                        _db->get_options(i));
+      rocksdb::Status status;
+      uint64_t ssd_count = 0;
+      int ret = ReadCheckpoint(
+          &_afs_client,
+          shard_path + ".ssd",
+          [&](uint64_t key, const float* value, uint32_t dim) {
+            if (status.ok() && ssd_count == 0) {
+              status = sst_writer.Open(sst_path);
+            }
+            if (status.ok()) {
+              status = sst_writer.Put(
+                  rocksdb::Slice(reinterpret_cast<char*>(&key),
+                                 sizeof(uint64_t)),
+                  rocksdb::Slice(reinterpret_cast<const char*>(value),
+                                 dim * sizeof(float)));
+              ++ssd_count;
+            }
+          });
+      if (status.ok() && ssd_count > 0) {
+        status = sst_writer.Finish();
+      }
+      ok = ok && ret == 0 && status.ok() &&
+           (ssd_count == 0 || _db->ingest_external_file(i, {sst_path}) == 0);
+      feasign_size_all += ssd_count;
+    }
+
+    uint64_t mem_count = 0;
+    int ret = ReadCheckpoint(
+        &_afs_client,
+        shard_path + ".mem",
+        [&](uint64_t key, const float* value, uint32_t dim) {
+          if (!full && shard.find(key) == shard.end()) {
+            // replaces the value on ssd
+            _db->del_data(i, reinterpret_cast<char*>(&key), sizeof(uint64_t));
+          }
+          auto& feature_value = shard[key];
+          feature_value.resize(dim);
+          memcpy(const_cast<float*>(feature_value.data()),
+                 value,
+                 dim * sizeof(float));
+          ++mem_count;
+        });
+    feasign_size_all += mem_count;
+    if (!ok || ret != 0) {
+      ++failed_shard_num;
+    }
+  }
+  if (failed_shard_num > 0) {
+    LOG(WARNING) << "SSDSparseTable load checkpoint failed, shard num:"
+                 << failed_shard_num << ", path:" << table_path;
+    return -1;
+  }
+
+  for (auto& keys : _dirty_keys) {
+    keys.clear();
+  }
+  _delta_checkpoint_num = full ? 0 : _delta_checkpoint_num + 1;
+  _last_checkpoint_path = table_path;
+  _checkpoint_need_full = false;
+  uint64_t ssd_key_num = 0;
+  _db->get_estimate_key_num(ssd_key_num);
+  _cache_tk_size =
+      (LocalSize() + ssd_key_num) * _config.sparse_table_cache_rate();
+  VLOG(0) << "SSDSparseTable load " << (full ? "full" : "delta")
+          << " checkpoint success, feasign size:" << feasign_size_all
+          << ", path:" << table_path;
+  return 0;
+}
+
 std::pair<int64_t, int64_t> SSDSparseTable::PrintTableStat() {
   int64_t feasign_size = LocalSize();
   return {feasign_size, -1};
@@ -14,7 +14,11 @@
 
 #pragma once
 
+#include <unordered_map>
+#include <unordered_set>
+
 #include "paddle/common/flags.h"
+#include "paddle/fluid/distributed/ps/table/depends/frequency_sketch.h"
 #include "paddle/fluid/distributed/ps/table/depends/rocksdb_wrapper.h"
 #include "paddle/fluid/distributed/ps/table/memory_sparse_table.h"
 
@@ -64,7 +68,7 @@ class SSDSparseTable : public MemorySparseTable {
  public:
   typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
   SSDSparseTable() {}
-  virtual ~SSDSparseTable() {}
+  virtual ~SSDSparseTable() { WaitDemotion(); }
 
   int32_t Initialize() override;
   int32_t InitializeShard() override;
@@ -91,6 +95,7 @@ class SSDSparseTable : public MemorySparseTable {
     for (int i = 0; i < _real_local_shard_num; ++i) {
       _local_shards[i].clear();
     }
+    _checkpoint_need_full = true;
   }
 
   int32_t Save(const std::string& path, const std::string& param) override;
@@ -126,6 +131,13 @@ class SSDSparseTable : public MemorySparseTable {
                          const std::vector<std::string>& file_list,
                          const std::string& param);
   int32_t LoadWithBinary(const std::string& path, int param);
+  // Binary checkpoint of save param 0 with FLAGS_pserver_ssd_binary_checkpoint.
+  // A full checkpoint has the values in memory and a rocksdb checkpoint per
+  // shard, a delta checkpoint has the values changed since the checkpoint it
+  // is based on. A save replaces the checkpoint of the server only once it
+  // is complete.
+  int32_t SaveCheckpoint(const std::string& table_path);
+  int32_t LoadCheckpoint(const std::string& table_path);
   int64_t LocalSize();
 
   std::pair<int64_t, int64_t> PrintTableStat() override;
@@ -145,6 +157,46 @@ class SSDSparseTable : public MemorySparseTable {
   paddle::framework::AfsWrapper _afs_wrapper;  // afs api wrapper
 #endif
   bool _use_afs_api = false;
+
+  // Tiering with FLAGS_pserver_ssd_mem_capacity. The values of a shard that
+  // are pulled most often are kept in memory, admitted by the frequency
+  // sketch of the shard, and the others are demoted to ssd in batches. The
+  // members of a shard are only used by its task thread.
+  struct TierStat {
+    uint64_t promotions = 0;
+    uint64_t rejections = 0;
+    uint64_t demotions = 0;
+  };
+  // Read the values of keys from rocksdb with one MultiGet, the keys are
+  // sorted and deduplicated.
+  void MultiGetSSD(int shard_id,
+                   std::vector<uint64_t>* keys,
+                   std::unordered_map<uint64_t, std::string>* values);
+  // Update a value on ssd with one push value.
+  void UpdateSSDValue(std::string* value,
+                      const float* update_data,
+                      float* data_buffer);
+  // Whether a value pulled from ssd is moved to memory.
+  bool AdmitToMem(int shard_id, uint64_t key);
+  // Enqueue the demotion of a shard over capacity to its task thread.
+  void MaybeDemote(int shard_id);
+  void DemoteShard(int shard_id);
+  // Wait for the enqueued demotions before the shards are used out of their
+  // task threads.
+  void WaitDemotion();
+  size_t _mem_capacity_per_shard = 0;
+  std::vector<FrequencySketch> _freq_sketches;
+  // the max frequency of the values last demoted from a shard
+  std::vector<uint8_t> _demote_freq;
+  std::vector<char> _demote_pending;
+  std::vector<TierStat> _tier_stats;
+
+  // keys of each shard changed since the last binary checkpoint
+  std::vector<std::unordered_set<uint64_t>> _dirty_keys;
+  std::string _last_checkpoint_path;
+  int _delta_checkpoint_num = 0;
+  // set when the values change without being tracked, e.g. by shrink
+  bool _checkpoint_need_full = true;
 };
 
 }  // namespace distributed
@@ -14,6 +14,7 @@ limitations under the License. */
 
 #include "paddle/fluid/distributed/ps/table/depends/feature_value.h"
 
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -45,4 +46,124 @@ TEST(BENCHMARK, LargeScaleKV) {
   ASSERT_FLOAT_EQ(value_data[3], 0.3);
 }
 
+TEST(SparseTableShard, BucketDistribution) {
+  typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
+  shard_type shard;
+  // small sequential feature signs used to land in bucket 0 only
+  const size_t key_num = 64 * 1000;
+  for (uint64_t key = 0; key < key_num; ++key) {
+    shard[key].resize(1);
+  }
+  ASSERT_EQ(shard.size(), key_num);
+  size_t expected = key_num / shard.bucket_count();
+  for (size_t bucket = 0; bucket < shard.bucket_count(); ++bucket) {
+    EXPECT_GT(shard.bucket_size(bucket), expected / 2);
+    EXPECT_LT(shard.bucket_size(bucket), expected * 2);
+  }
+}
+
+TEST(SparseTableShard, EraseWhileIterating) {
+  typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
+  shard_type shard;
+  const uint64_t key_num = 100000;
+  for (uint64_t key = 0; key < key_num; ++key) {
+    shard[key].resize(1);
+    shard[key].data()[0] = static_cast<float>(key);
+  }
+  for (auto it = shard.begin(); it != shard.end();) {
+    ASSERT_EQ(static_cast<uint64_t>(it.value().data()[0]), it.key());
+    if (it.key() % 2 == 0) {
+      it = shard.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  ASSERT_EQ(shard.size(), key_num / 2);
+
+  size_t visited = 0;
+  for (size_t bucket = 0; bucket < shard.bucket_count(); ++bucket) {
+    for (auto it = shard.begin(bucket); it != shard.end(bucket); ++it) {
+      ASSERT_EQ(it.key() % 2, 1UL);
+      ++visited;
+    }
+  }
+  ASSERT_EQ(visited, key_num / 2);
+  for (uint64_t key = 0; key < key_num; ++key) {
+    ASSERT_EQ(shard.find(key) == shard.end(), key % 2 == 0);
+  }
+
+  // string keys are used by the heter server
+  SparseTableShard<std::string, FixedFeatureValue> string_shard;
+  for (uint64_t key = 0; key < 1000; ++key) {
+    string_shard[std::to_string(key)].resize(1);
+  }
+  ASSERT_EQ(string_shard.erase(std::to_string(10)), 1UL);
+  ASSERT_TRUE(string_shard.find(std::to_string(10)) == string_shard.end());
+  ASSERT_EQ(string_shard.size(), 999UL);
+}
+
+TEST(SparseTableShard, ValueArena) {
+  typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
+  shard_type shard;
+  // CtrDymfAccessor values grow when the embedx part is created
+  const size_t small_dim = 9;
+  const size_t large_dim = 17;
+  const uint64_t key_num = 10000;
+  for (uint64_t key = 0; key < key_num; ++key) {
+    auto& value = shard[key];
+    value.resize(small_dim);
+    for (size_t i = 0; i < small_dim; ++i) {
+      value.data()[i] = static_cast<float>(key);
+    }
+  }
+  size_t memory_size = shard.arena_memory_size();
+  ASSERT_GE(memory_size, key_num * small_dim * sizeof(float));
+
+  for (uint64_t key = 0; key < key_num; ++key) {
+    auto& value = shard[key];
+    value.resize(large_dim);
+    ASSERT_EQ(value.size(), large_dim);
+    ASSERT_FLOAT_EQ(value.data()[small_dim - 1], static_cast<float>(key));
+    ASSERT_FLOAT_EQ(value.data()[large_dim - 1], 0.0);
+  }
+
+  // values copied out of the shard own their floats
+  FixedFeatureValue copy = shard[1];
+  shard.clear();
+  ASSERT_EQ(copy.size(), large_dim);
+  ASSERT_FLOAT_EQ(copy.data()[0], 1.0);
+
+  // released floats are reused by the next values of the same size
+  memory_size = shard.arena_memory_size();
+  for (uint64_t key = 0; key < key_num; ++key) {
+    shard[key].resize(large_dim);
+  }
+  ASSERT_EQ(shard.arena_memory_size(), memory_size);
+}
+
+TEST(SwissHashMap, LowerMaxLoadFactor) {
+  SwissHashMap<uint64_t, uint64_t> map;
+  const uint64_t key_num = 1000;
+  for (uint64_t key = 0; key < key_num; ++key) {
+    map.insert({key, key});
+  }
+  // the map is now fuller than the new load factor, even once doubled
+  map.max_load_factor(0.1f);
+  for (uint64_t key = key_num; key < key_num * 10; ++key) {
+    map.insert({key, key});
+    ASSERT_LE(map.size(), map.bucket_count() * 0.1f + 1);
+  }
+  // reserve keeps room for the elements already there
+  map.max_load_factor(0.05f);
+  map.reserve(1);
+  ASSERT_LE(map.size(), map.bucket_count() * 0.05f + 1);
+  ASSERT_EQ(map.size(), key_num * 10);
+  for (uint64_t key = 0; key < key_num * 10; ++key) {
+    auto it = map.find(key);
+    ASSERT_TRUE(it != map.end());
+    ASSERT_EQ(it->second, key);
+  }
+  ASSERT_TRUE(map.find(key_num * 10) == map.end());
+}
+
 }  // namespace paddle::distributed
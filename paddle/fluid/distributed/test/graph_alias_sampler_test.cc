@@ -0,0 +1,223 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/distributed/ps/table/common_graph_table.h"
+#include "paddle/fluid/distributed/ps/table/graph/graph_weighted_sampler.h"
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+
+COMMON_DECLARE_bool(graph_freeze_after_load);
+
+namespace distributed = paddle::distributed;
+
+namespace {
+
+void FillEdges(distributed::WeightedGraphEdgeBlob *edges,
+               const std::vector<float> &weights) {
+  for (size_t i = 0; i < weights.size(); ++i) {
+    edges->add_edge(i, weights[i]);
+  }
+}
+
+// The probability that a sample of 2 drawn one by one in proportion to the
+// weights left contains item 0.
+double PairInclusion(const std::vector<float> &weights) {
+  double sum = 0;
+  for (float w : weights) sum += w;
+  double p = weights[0] / sum;
+  for (size_t j = 1; j < weights.size(); ++j) {
+    p += weights[j] / sum * weights[0] / (sum - weights[j]);
+  }
+  return p;
+}
+
+// The degree of the nodes sampled by the benchmarks.
+constexpr int kBenchmarkDegree = 20000;
+
+}  // namespace
+
+TEST(AliasSampler, Distribution) {
+  std::vector<float> weights = {1, 2, 3, 4, 0, 10};
+  distributed::WeightedGraphEdgeBlob edges;
+  FillEdges(&edges, weights);
+  distributed::AliasSampler sampler;
+  sampler.build(&edges);
+  auto rng = std::make_shared<std::mt19937_64>(0);
+
+  const int times = 100000;
+  std::vector<int> count(weights.size(), 0);
+  for (int t = 0; t < times; ++t) {
+    auto res = sampler.sample_k(1, rng);
+    ASSERT_EQ(res.size(), 1UL);
+    ++count[res[0]];
+  }
+  for (size_t i = 0; i < weights.size(); ++i) {
+    EXPECT_NEAR(count[i] / static_cast<double>(times), weights[i] / 20, 0.01);
+  }
+
+  // samples of 2 are drawn without replacement as WeightedSampler does
+  distributed::WeightedSampler tree;
+  tree.build(&edges);
+  int alias_count = 0, tree_count = 0;
+  for (int t = 0; t < times; ++t) {
+    auto res = sampler.sample_k(2, rng);
+    ASSERT_EQ(res.size(), 2UL);
+    ASSERT_NE(res[0], res[1]);
+    alias_count += res[0] == 0 || res[1] == 0;
+    res = tree.sample_k(2, rng);
+    tree_count += res[0] == 0 || res[1] == 0;
+  }
+  EXPECT_NEAR(alias_count / static_cast<double>(times),
+              PairInclusion(weights),
+              0.01);
+  EXPECT_NEAR(tree_count / static_cast<double>(times),
+              PairInclusion(weights),
+              0.01);
+
+  // the zero weight neighbor is drawn last
+  auto res = sampler.sample_k(5, rng);
+  EXPECT_EQ(std::set<int>(res.begin(), res.end()),
+            std::set<int>({0, 1, 2, 3, 5}));
+  EXPECT_EQ(sampler.sample_k(10, rng).size(), weights.size());
+}
+
+TEST(AliasSampler, Skewed) {
+  // one neighbor takes nearly all of the weight, most draws after the first
+  // are rejected
+  std::vector<float> weights(1000, 1e-6);
+  weights[7] = 1e6;
+  distributed::WeightedGraphEdgeBlob edges;
+  FillEdges(&edges, weights);
+  distributed::AliasSampler sampler;
+  sampler.build(&edges);
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  for (int k : {1, 10, 100, 500, 999}) {
+    auto res = sampler.sample_k(k, rng);
+    ASSERT_EQ(res.size(), static_cast<size_t>(k));
+    std::set<int> unique(res.begin(), res.end());
+    EXPECT_EQ(unique.size(), res.size());
+    EXPECT_EQ(unique.count(7), 1UL);
+    EXPECT_LT(*unique.rbegin(), 1000);
+  }
+}
+
+// Sampling speed of the tree and the alias sampler at one high degree node.
+// Disabled by default, run it with --gtest_also_run_disabled_tests.
+TEST(BENCHMARK, DISABLED_AliasSamplerSampleK) {
+  const int degree = kBenchmarkDegree;
+  std::mt19937_64 weight_rng(0);
+  std::uniform_real_distribution<float> distrib(0.1, 10);
+  std::vector<float> weights(degree);
+  for (auto &w : weights) w = distrib(weight_rng);
+  distributed::WeightedGraphEdgeBlob edges;
+  FillEdges(&edges, weights);
+  distributed::WeightedSampler tree;
+  distributed::AliasSampler alias;
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  for (int k : {10, 100}) {
+    for (distributed::Sampler *sampler :
+         {static_cast<distributed::Sampler *>(&tree),
+          static_cast<distributed::Sampler *>(&alias)}) {
+      auto start = std::chrono::steady_clock::now();
+      sampler->build(&edges);
+      double build_seconds = std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+      const int times = 2000;
+      size_t sampled = 0;
+      start = std::chrono::steady_clock::now();
+      for (int t = 0; t < times; ++t) {
+        sampled += sampler->sample_k(k, rng).size();
+      }
+      double seconds = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+      EXPECT_EQ(sampled, static_cast<size_t>(times) * k);
+      LOG(INFO) << (sampler == &tree ? "tree" : "alias")
+                << " degree: " << degree << ", k: " << k
+                << ", build: " << build_seconds
+                << " s, samples/s: " << times / seconds;
+    }
+  }
+}
+
+// Throughput of GraphTable::random_sample_neighbors at high degree nodes,
+// sampled uniformly, by weight and by weight after freezing. Disabled by
+// default, run it with --gtest_also_run_disabled_tests.
+TEST(BENCHMARK, DISABLED_GraphTableSampleNeighbors) {
+  const int degree = kBenchmarkDegree;
+  const int node_num = 64;
+  const char *edge_file = "alias_benchmark_edges.txt";
+  {
+    std::ofstream fout(edge_file);
+    std::mt19937_64 weight_rng(0);
+    std::uniform_real_distribution<float> distrib(0.1, 10);
+    for (int i = 0; i < node_num; ++i) {
+      for (int j = 0; j < degree; ++j) {
+        fout << i << "\t" << node_num + j << "\t" << distrib(weight_rng)
+             << "\n";
+      }
+    }
+  }
+  std::vector<uint64_t> ids(4096);
+  for (size_t i = 0; i < ids.size(); ++i) {
+    ids[i] = i % node_num;
+  }
+
+  for (int mode = 0; mode < 3; ++mode) {
+    paddle::distributed::GraphParameter table_proto;
+    table_proto.add_edge_types("u2u");
+    table_proto.add_node_types("u");
+    table_proto.add_graph_feature();
+    table_proto.set_shard_num(8);
+    table_proto.set_task_pool_size(8);
+    distributed::GraphTable graph_table;
+    graph_table.Initialize(table_proto);
+    FLAGS_graph_freeze_after_load = mode == 2;
+    graph_table.load_edges(edge_file, false, "u2u", mode != 0);
+    FLAGS_graph_freeze_after_load = false;
+
+    const int k = 20, rounds = 20;
+    size_t sampled = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+      std::vector<std::shared_ptr<char>> buffers(ids.size());
+      std::vector<int> actual_sizes(ids.size(), 0);
+      graph_table.random_sample_neighbors(
+          0, ids.data(), k, buffers, actual_sizes, false);
+      for (int size : actual_sizes) {
+        sampled += size / distributed::Node::id_size;
+      }
+    }
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    EXPECT_EQ(sampled, ids.size() * rounds * k);
+    const char *mode_names[] = {"random", "weighted", "weighted frozen"};
+    LOG(INFO) << mode_names[mode] << " degree: " << degree << ", k: " << k
+              << ", samples/s: " << sampled / seconds;
+  }
+  std::remove(edge_file);
+}
@@ -0,0 +1,253 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/graph/graph_csr.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/distributed/ps/table/common_graph_table.h"
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+
+COMMON_DECLARE_bool(graph_freeze_after_load);
+
+namespace distributed = paddle::distributed;
+
+namespace {
+
+// Node i of the shard has id i * 7 + 3 and i % 10 neighbors i * 100 + j, the
+// weight of neighbor j is j + 1 if weighted.
+void BuildShard(distributed::GraphShard *shard, int node_num, bool weighted) {
+  for (int i = node_num - 1; i >= 0; --i) {
+    auto node = shard->add_graph_node(static_cast<uint64_t>(i) * 7 + 3);
+    node->build_edges(weighted);
+    for (int j = 0; j < i % 10; ++j) {
+      node->add_edge(static_cast<uint64_t>(i) * 100 + j, j + 1);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(GraphCsr, Edges) {
+  distributed::GraphShard shard;
+  BuildShard(&shard, 1000, true);
+  std::vector<std::vector<uint64_t>> neighbor_ids;
+  size_t neighbor_num = shard.get_all_neighbor_id(&neighbor_ids, 1);
+  shard.freeze();
+  ASSERT_TRUE(shard.is_frozen());
+  EXPECT_TRUE(shard.get_bucket().empty());
+  EXPECT_EQ(shard.get_size(), 1000UL);
+  EXPECT_ANY_THROW(shard.find_node(3));
+  EXPECT_ANY_THROW(shard.add_graph_node(5));
+
+  const distributed::CsrGraphShard *csr = shard.get_csr();
+  ASSERT_TRUE(csr->is_weighted());
+  for (int i = 0; i < 1000; ++i) {
+    int64_t pos = csr->find(static_cast<uint64_t>(i) * 7 + 3);
+    ASSERT_EQ(pos, i);
+    ASSERT_EQ(csr->degree(pos), static_cast<size_t>(i % 10));
+    for (int j = 0; j < i % 10; ++j) {
+      EXPECT_EQ(csr->neighbors(pos)[j], static_cast<uint64_t>(i) * 100 + j);
+      EXPECT_EQ(csr->neighbor_weight(pos, j), j + 1);
+    }
+  }
+  EXPECT_EQ(csr->find(0), -1);
+  EXPECT_EQ(csr->find(4), -1);
+  EXPECT_EQ(csr->find(1000 * 7 + 3), -1);
+
+  std::vector<std::vector<uint64_t>> frozen_neighbor_ids;
+  EXPECT_EQ(shard.get_all_neighbor_id(&frozen_neighbor_ids, 1), neighbor_num);
+  EXPECT_EQ(frozen_neighbor_ids, neighbor_ids);
+  std::vector<uint64_t> ids;
+  shard.get_ids_by_range(10, 12, &ids);
+  EXPECT_EQ(ids, std::vector<uint64_t>({73, 80}));
+}
+
+TEST(GraphCsr, Features) {
+  distributed::GraphShard shard;
+  std::vector<uint64_t> feasigns = {11, 12, 13};
+  std::string bytes(reinterpret_cast<const char *>(feasigns.data()),
+                    feasigns.size() * sizeof(uint64_t));
+  shard.add_feature_node(9)->set_feature(1, "hello");
+  auto node = shard.add_feature_node(2);
+  node->set_feature(0, bytes.substr(0, 2 * sizeof(uint64_t)));
+  node->set_feature(1, bytes.substr(2 * sizeof(uint64_t)));
+  auto float_node = shard.add_feature_node(5, true, 1);
+  *float_node->mutable_feature(0) = bytes;
+  *float_node->mutable_float_feature(0) = "float";
+  shard.freeze();
+
+  const distributed::CsrGraphShard *csr = shard.get_csr();
+  int64_t pos = csr->find(9);
+  EXPECT_EQ(csr->feature_size(pos), 2);
+  EXPECT_EQ(csr->get_feature(pos, 0), "");
+  EXPECT_EQ(csr->get_feature(pos, 1), "hello");
+  EXPECT_EQ(csr->get_feature(pos, 2), "");
+
+  std::vector<uint64_t> ids;
+  csr->get_feature_ids(csr->find(2), &ids);
+  EXPECT_EQ(ids, feasigns);
+  pos = csr->find(5);
+  EXPECT_EQ(csr->feature_size(pos), 1);
+  EXPECT_EQ(csr->get_feature(pos, 0), bytes);
+  EXPECT_ANY_THROW(csr->get_feature_ids(csr->find(9), &ids));
+}
+
+TEST(GraphCsr, Sample) {
+  distributed::GraphShard shard;
+  auto node = shard.add_graph_node(1);
+  node->build_edges(true);
+  const int degree = 200;
+  for (int j = 0; j < degree; ++j) {
+    node->add_edge(j, j < degree / 2 ? 1 : 9);
+  }
+  shard.freeze();
+  distributed::CsrGraphShard *csr = shard.csr.get();
+  auto rng = std::make_shared<std::mt19937_64>(0);
+
+  std::vector<int> res;
+  csr->sample_k(0, degree + 5, rng, &res);
+  EXPECT_EQ(res.size(), static_cast<size_t>(degree));
+  for (bool weighted : {false, true}) {
+    csr->set_weighted_sample(weighted);
+    for (int k : {1, 10, 100, 199}) {
+      csr->sample_k(0, k, rng, &res);
+      ASSERT_EQ(res.size(), static_cast<size_t>(k));
+      std::set<int> unique(res.begin(), res.end());
+      EXPECT_EQ(unique.size(), res.size());
+      EXPECT_GE(*unique.begin(), 0);
+      EXPECT_LT(*unique.rbegin(), degree);
+    }
+    // the heavy half is picked about 9 times as often with weights
+    int heavy = 0;
+    for (int t = 0; t < 2000; ++t) {
+      csr->sample_k(0, 1, rng, &res);
+      heavy += res[0] >= degree / 2;
+    }
+    if (weighted) {
+      EXPECT_GT(heavy, 1700);
+    } else {
+      EXPECT_GT(heavy, 850);
+      EXPECT_LT(heavy, 1150);
+    }
+  }
+}
+
+// The node types are loaded one by one, and frozen after all of them are
+// loaded and fixed with the nodes of the edges.
+TEST(GraphCsr, FreezeAfterLoadNodes) {
+  ASSERT_EQ(std::system("rm -rf ./graph_csr_nodes && "
+                        "mkdir -p ./graph_csr_nodes"),
+            0);
+  {
+    std::ofstream fout("./graph_csr_nodes/part-00000");
+    for (uint64_t id : {37, 96, 59, 97}) {
+      fout << "user\t" << id << "\n";
+    }
+    for (uint64_t id : {45, 145, 112}) {
+      fout << "item\t" << id << "\n";
+    }
+  }
+  ::paddle::distributed::GraphParameter table_proto;
+  table_proto.set_task_pool_size(4);
+  table_proto.set_shard_num(8);
+  table_proto.add_node_types("user");
+  table_proto.add_node_types("item");
+  table_proto.add_edge_types("user2item");
+  table_proto.add_graph_feature();
+  table_proto.add_graph_feature();
+  distributed::GraphTable table;
+  table.Initialize(table_proto);
+  // a source node of the edges without a node line
+  table.edge_shards_keys_[0][500 % 8].push_back(500);
+
+  bool freeze_after_load = FLAGS_graph_freeze_after_load;
+  FLAGS_graph_freeze_after_load = true;
+  int ret = table.parse_node_and_load(
+      "user:graph_csr_nodes,item:graph_csr_nodes", ".", 0, true);
+  FLAGS_graph_freeze_after_load = freeze_after_load;
+  ASSERT_EQ(ret, 0);
+
+  std::vector<size_t> sizes;
+  for (auto &shards : table.feature_shards) {
+    size_t size = 0;
+    for (auto *shard : shards) {
+      EXPECT_TRUE(shard->is_frozen());
+      size += shard->get_size();
+    }
+    sizes.push_back(size);
+  }
+  EXPECT_EQ(sizes, std::vector<size_t>({5, 3}));
+  const distributed::CsrGraphShard *csr =
+      table.feature_shards[0][500 % 8]->get_csr();
+  EXPECT_GE(csr->find(500), 0);
+  EXPECT_EQ(std::system("rm -rf ./graph_csr_nodes"), 0);
+}
+
+// Sampling speed and memory of the node objects and of the csr storage.
+// Disabled by default, run it with --gtest_also_run_disabled_tests.
+TEST(BENCHMARK, DISABLED_GraphCsrSample) {
+  const int node_num = 200000;
+  distributed::GraphShard shard;
+  BuildShard(&shard, node_num, false);
+  for (auto node : shard.get_bucket()) {
+    node->build_sampler("random");
+  }
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  std::mt19937_64 query_rng(1);
+  std::uniform_int_distribution<int> distrib(0, node_num - 1);
+
+  size_t sampled = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < node_num; ++t) {
+    auto node = shard.find_node(distrib(query_rng) * 7ULL + 3);
+    for (int x : node->sample_k(5, rng)) {
+      sampled += node->get_neighbor_id(x);
+    }
+  }
+  double node_seconds = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+
+  shard.freeze();
+  const distributed::CsrGraphShard *csr = shard.get_csr();
+  std::vector<int> res;
+  size_t csr_sampled = 0;
+  start = std::chrono::steady_clock::now();
+  for (int t = 0; t < node_num; ++t) {
+    int64_t pos = csr->find(distrib(query_rng) * 7ULL + 3);
+    csr->sample_k(pos, 5, rng, &res);
+    for (int x : res) {
+      csr_sampled += csr->neighbors(pos)[x];
+    }
+  }
+  double csr_seconds = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+  EXPECT_GT(sampled, 0UL);
+  EXPECT_GT(csr_sampled, 0UL);
+  LOG(INFO) << "nodes: " << node_num << ", node objects: " << node_seconds
+            << " s, csr: " << csr_seconds
+            << " s, csr bytes: " << csr->memory_size();
+}
@@ -17,16 +17,115 @@ limitations under the License. */
 #include <ThreadPool.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <random>
 #include <string>
 #include <thread>  // NOLINT
 
+#include "glog/logging.h"
 #include "google/protobuf/text_format.h"
 #include "gtest/gtest.h"
 #include "paddle/fluid/distributed/ps/table/table.h"
 #include "paddle/fluid/distributed/the_one_ps.pb.h"
 
+PD_DECLARE_bool(pserver_push_merge);
+PD_DECLARE_int32(pserver_push_merge_window_ms);
+PD_DEFINE_int64(memory_sparse_table_benchmark_key_num,
+                10000000,
+                "The keys pulled and pushed by the MemorySparseTable "
+                "benchmark, 100000000 for a table of production size.");
+
 namespace paddle::distributed {
 
+namespace {
+
+Table *CreateNaiveTable(int emb_dim) {
+  TableParameter table_config;
+  table_config.set_table_class("MemorySparseTable");
+  table_config.set_shard_num(10);
+  FsClientParameter fs_config;
+  Table *table = new MemorySparseTable();
+  table->SetShard(0, 1);
+
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CtrCommonAccessor");
+  accessor_config->set_fea_dim(emb_dim + 3);
+  accessor_config->set_embedx_dim(emb_dim);
+  accessor_config->set_embedx_threshold(1e9);
+  for (auto *sgd_param : {accessor_config->mutable_embed_sgd_param(),
+                          accessor_config->mutable_embedx_sgd_param()}) {
+    sgd_param->set_name("SparseNaiveSGDRule");
+    auto *naive_param = sgd_param->mutable_naive();
+    naive_param->set_learning_rate(0.1);
+    naive_param->set_initial_range(0);
+    naive_param->add_weight_bounds(-10.0);
+    naive_param->add_weight_bounds(10.0);
+  }
+  EXPECT_EQ(table->Initialize(table_config, fs_config), 0);
+  return table;
+}
+
+// Batches of keys 1 to key_num drawn with probability proportional to
+// 1 / rank, and a gradient of one show per key.
+void MakeSkewedPushes(int emb_dim,
+                      int batch_num,
+                      int batch_size,
+                      std::vector<std::vector<uint64_t>> *keys,
+                      std::vector<std::vector<float>> *values) {
+  const int key_num = 100000;
+  std::vector<double> cdf(key_num);
+  double sum = 0;
+  for (int i = 0; i < key_num; ++i) {
+    sum += 1.0 / (i + 1);
+    cdf[i] = sum;
+  }
+  std::mt19937_64 rng(0);
+  std::uniform_real_distribution<double> key_distrib(0, sum);
+  std::normal_distribution<float> grad_distrib(0, 0.01);
+  keys->resize(batch_num);
+  values->resize(batch_num);
+  for (int b = 0; b < batch_num; ++b) {
+    for (int i = 0; i < batch_size; ++i) {
+      auto pos = std::lower_bound(cdf.begin(), cdf.end(), key_distrib(rng));
+      (*keys)[b].push_back(pos - cdf.begin() + 1);
+      (*values)[b].push_back(1);  // slot
+      (*values)[b].push_back(1);  // show
+      (*values)[b].push_back(0);  // click
+      for (int j = 0; j < emb_dim + 1; ++j) {
+        (*values)[b].push_back(grad_distrib(rng));
+      }
+    }
+  }
+}
+
+void PushBatch(Table *table,
+               const std::vector<uint64_t> &keys,
+               const std::vector<float> &values) {
+  TableContext table_context;
+  table_context.value_type = Sparse;
+  table_context.push_context.keys = keys.data();
+  table_context.push_context.values = values.data();
+  table_context.num = keys.size();
+  ASSERT_EQ(table->Push(table_context), 0);
+}
+
+std::vector<float> PullKeys(Table *table,
+                            int emb_dim,
+                            const std::vector<uint64_t> &keys) {
+  std::vector<uint32_t> fres(keys.size(), 1);
+  std::vector<float> values(keys.size() * (emb_dim + 3));
+  TableContext table_context;
+  table_context.value_type = Sparse;
+  table_context.pull_context.pull_value = PullSparseValue(keys, fres, emb_dim);
+  table_context.pull_context.values = values.data();
+  EXPECT_EQ(table->Pull(table_context), 0);
+  return values;
+}
+
+}  // namespace
+
 TEST(MemorySparseTable, SGD) {
   int emb_dim = 8;
   int trainers = 2;
@@ -151,4 +250,129 @@ TEST(MemorySparseTable, SGD) {
   }
 }
 
+// The naive sgd steps are linear in the gradient, so the pushes of the same
+// key merged on the server give the values of the pushes applied one by one.
+TEST(MemorySparseTable, PushMerge) {
+  const int emb_dim = 8;
+  std::vector<std::vector<uint64_t>> keys;
+  std::vector<std::vector<float>> values;
+  MakeSkewedPushes(emb_dim, 50, 4096, &keys, &values);
+  std::vector<uint64_t> pull_keys(1000);
+  for (size_t i = 0; i < pull_keys.size(); ++i) {
+    pull_keys[i] = i + 1;
+  }
+
+  // one by one, merged in each push, merged in a window of an hour
+  std::vector<std::pair<bool, int>> configs = {
+      {false, 0}, {true, 0}, {true, 3600 * 1000}};
+  std::vector<std::vector<float>> pulled;
+  for (auto &config : configs) {
+    FLAGS_pserver_push_merge = config.first;
+    FLAGS_pserver_push_merge_window_ms = config.second;
+    std::unique_ptr<Table> table(CreateNaiveTable(emb_dim));
+    for (size_t b = 0; b < keys.size(); ++b) {
+      PushBatch(table.get(), keys[b], values[b]);
+    }
+    if (config.second > 0) {
+      // held until the window ends
+      auto held = PullKeys(table.get(), emb_dim, pull_keys);
+      EXPECT_EQ(held[0], 0);
+    }
+    ASSERT_EQ(table->Flush(), 0);
+    pulled.push_back(PullKeys(table.get(), emb_dim, pull_keys));
+  }
+  FLAGS_pserver_push_merge = false;
+  FLAGS_pserver_push_merge_window_ms = 0;
+
+  for (size_t c = 1; c < pulled.size(); ++c) {
+    for (size_t i = 0; i < pull_keys.size(); ++i) {
+      const float *row = pulled[0].data() + i * (emb_dim + 3);
+      const float *merged_row = pulled[c].data() + i * (emb_dim + 3);
+      EXPECT_EQ(row[0], merged_row[0]);  // show
+      EXPECT_EQ(row[1], merged_row[1]);  // click
+      for (int j = 2; j < emb_dim + 3; ++j) {
+        EXPECT_NEAR(row[j], merged_row[j], 1e-3) << "key " << pull_keys[i];
+      }
+    }
+  }
+}
+
+// The pushes held by a shard that gets no further request are applied by the
+// background timer once the window ends.
+TEST(MemorySparseTable, PushMergeTimer) {
+  const int emb_dim = 8;
+  FLAGS_pserver_push_merge = true;
+  FLAGS_pserver_push_merge_window_ms = 20;
+  std::unique_ptr<Table> table(CreateNaiveTable(emb_dim));
+  std::vector<uint64_t> keys = {1, 2, 3};
+  std::vector<float> values;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    values.insert(values.end(), {1, 1, 0});  // slot, show, click
+    values.insert(values.end(), emb_dim + 1, 0.1);
+  }
+  PushBatch(table.get(), keys, values);
+
+  auto *memory_table = dynamic_cast<MemorySparseTable *>(table.get());
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (memory_table->LocalSize() < static_cast<int64_t>(keys.size()) &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(memory_table->LocalSize(), static_cast<int64_t>(keys.size()));
+  table.reset();
+  FLAGS_pserver_push_merge = false;
+  FLAGS_pserver_push_merge_window_ms = 0;
+}
+
+// Pull and push throughput of a table of
+// FLAGS_memory_sparse_table_benchmark_key_num keys, in batches of a trainer.
+// Disabled by default, run it with --gtest_also_run_disabled_tests.
+TEST(BENCHMARK, DISABLED_MemorySparseTablePullPush) {
+  const int emb_dim = 8;
+  const int64_t key_num = FLAGS_memory_sparse_table_benchmark_key_num;
+  const int64_t batch_size = 1 << 16;
+  std::unique_ptr<Table> table(CreateNaiveTable(emb_dim));
+  // feature signs are hashed ids in practice, use a large odd stride
+  auto key_of = [](int64_t i) {
+    return static_cast<uint64_t>(i) * 0x9e3779b97f4a7c15ULL;
+  };
+  std::vector<uint64_t> keys(batch_size);
+  std::vector<float> push_values(batch_size * (emb_dim + 4), 0.01);
+  for (int64_t i = 0; i < batch_size; ++i) {
+    push_values[i * (emb_dim + 4)] = 1;      // slot
+    push_values[i * (emb_dim + 4) + 1] = 1;  // show
+    push_values[i * (emb_dim + 4) + 2] = 0;  // click
+  }
+
+  // the keys per second of a pass over all the keys
+  auto run_pass = [&](bool push) {
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t begin = 0; begin < key_num; begin += batch_size) {
+      int64_t num = std::min(batch_size, key_num - begin);
+      keys.resize(num);
+      for (int64_t i = 0; i < num; ++i) {
+        keys[i] = key_of(begin + i);
+      }
+      if (push) {
+        PushBatch(table.get(), keys, push_values);
+      } else {
+        PullKeys(table.get(), emb_dim, keys);
+      }
+    }
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    return static_cast<double>(key_num) / seconds;
+  };
+
+  double create_rate = run_pass(false);
+  double pull_rate = run_pass(false);
+  double push_rate = run_pass(true);
+  auto *memory_table = dynamic_cast<MemorySparseTable *>(table.get());
+  LOG(INFO) << "keys: " << key_num << ", create: " << create_rate
+            << " keys/s, pull: " << pull_rate
+            << " keys/s, push: " << push_rate << " keys/s";
+  EXPECT_EQ(memory_table->LocalSize(), key_num);
+}
+
 }  // namespace paddle::distributed
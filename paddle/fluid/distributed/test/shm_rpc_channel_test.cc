@@ -0,0 +1,175 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/service/shm_rpc_channel.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <csignal>
+#include <string>
+
+#include "brpc/controller.h"
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/ps/service/sendrecv.pb.h"
+
+namespace paddle::distributed {
+
+namespace {
+
+const uint32_t kEcho = 0;
+const uint32_t kHang = 1;
+const uint32_t kExit = 2;
+
+// Echoes the params and the attachment of a request.
+class EchoService : public PsService {
+ public:
+  void service(google::protobuf::RpcController *controller,
+               const PsRequestMessage *request,
+               PsResponseMessage *response,
+               google::protobuf::Closure *done) override {
+    if (request->cmd_id() == kHang) {
+      // never responds
+      return;
+    }
+    if (request->cmd_id() == kExit) {
+      _exit(0);
+    }
+    auto *cntl = static_cast<brpc::Controller *>(controller);
+    response->set_err_code(0);
+    response->set_err_msg("");
+    if (request->params_size() > 0) {
+      response->set_data(request->params(0));
+    }
+    cntl->response_attachment().append(cntl->request_attachment());
+    done->Run();
+  }
+};
+
+// Serves the channel of the name until the client stops, in the child.
+void ServeChild(const std::string &name, int ready_fd) {
+  EchoService service;
+  auto server = ShmRpcServer::Create(name, &service);
+  char ok = server != nullptr ? 1 : 0;
+  if (write(ready_fd, &ok, 1) != 1 || server == nullptr) {
+    _exit(1);
+  }
+  while (!server->IsClosed()) {
+    usleep(10000);
+  }
+  _exit(0);
+}
+
+void Call(PsService_Stub *stub,
+          uint32_t cmd_id,
+          const std::string &attachment,
+          brpc::Controller *cntl,
+          PsResponseMessage *response) {
+  PsRequestMessage request;
+  request.set_cmd_id(cmd_id);
+  request.add_params(std::to_string(cmd_id));
+  cntl->request_attachment().append(attachment);
+  stub->service(cntl, &request, response, nullptr);
+}
+
+}  // namespace
+
+// The server runs in a child process forked before any bthread is started,
+// so this is the only test of the binary.
+TEST(ShmRpcChannel, CallsAcrossProcesses) {
+  auto channel = ShmRpcChannel::Create();
+  ASSERT_NE(channel, nullptr);
+  int ready[2];
+  ASSERT_EQ(pipe(ready), 0);
+  // the child is reaped as it exits, a zombie would still look alive to the
+  // channel
+  signal(SIGCHLD, SIG_IGN);
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    close(ready[0]);
+    ServeChild(channel->name(), ready[1]);
+  }
+  close(ready[1]);
+  char ok = 0;
+  ASSERT_EQ(read(ready[0], &ok, 1), 1);
+  close(ready[0]);
+  ASSERT_EQ(ok, 1);
+  channel->Start();
+  PsService_Stub stub(channel.get());
+
+  {
+    brpc::Controller cntl;
+    PsResponseMessage response;
+    Call(&stub, kEcho, "hello", &cntl, &response);
+    ASSERT_FALSE(cntl.Failed()) << cntl.ErrorText();
+    EXPECT_EQ(response.err_code(), 0);
+    EXPECT_EQ(response.data(), std::to_string(kEcho));
+    EXPECT_EQ(cntl.response_attachment().to_string(), "hello");
+  }
+
+  {
+    // larger than the rings, so it is streamed through them
+    std::string attachment(10 << 20, '\0');
+    for (size_t i = 0; i < attachment.size(); ++i) {
+      attachment[i] = static_cast<char>(i * 131 + (i >> 12));
+    }
+    brpc::Controller cntl;
+    PsResponseMessage response;
+    Call(&stub, kEcho, attachment, &cntl, &response);
+    ASSERT_FALSE(cntl.Failed()) << cntl.ErrorText();
+    EXPECT_TRUE(cntl.response_attachment().to_string() == attachment);
+  }
+
+  {
+    brpc::Controller cntl;
+    cntl.set_timeout_ms(100);
+    PsResponseMessage response;
+    Call(&stub, kHang, "", &cntl, &response);
+    ASSERT_TRUE(cntl.Failed());
+    EXPECT_EQ(cntl.ErrorCode(), brpc::ERPCTIMEDOUT);
+  }
+
+  {
+    // the channel is still usable after a call times out
+    brpc::Controller cntl;
+    PsResponseMessage response;
+    Call(&stub, kEcho, "again", &cntl, &response);
+    ASSERT_FALSE(cntl.Failed()) << cntl.ErrorText();
+    EXPECT_EQ(cntl.response_attachment().to_string(), "again");
+  }
+
+  {
+    brpc::Controller cntl;
+    PsResponseMessage response;
+    Call(&stub, kExit, "", &cntl, &response);
+    EXPECT_TRUE(cntl.Failed());
+  }
+
+  {
+    // and fails once the server has exited
+    brpc::Controller cntl;
+    PsResponseMessage response;
+    Call(&stub, kEcho, "", &cntl, &response);
+    EXPECT_TRUE(cntl.Failed());
+  }
+
+  // waits for the child, which has already been reaped
+  EXPECT_EQ(waitpid(pid, nullptr, 0), -1);
+  EXPECT_EQ(errno, ECHILD);
+  signal(SIGCHLD, SIG_DFL);
+}
+
+}  // namespace paddle::distributed
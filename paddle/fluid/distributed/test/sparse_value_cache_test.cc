@@ -0,0 +1,303 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/service/communicator/sparse_value_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/ps/service/env.h"
+#include "paddle/fluid/distributed/ps/service/ps_local_client.h"
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+
+namespace paddle::distributed {
+
+namespace {
+
+const int kEmbDim = 8;
+const int kPullDim = kEmbDim + 3;  // show, click, embed_w, embedx_w
+const int kPushDim = kEmbDim + 4;  // slot, show, click, embed_g, embedx_g
+
+// Keys 1 to key_num drawn with probability proportional to 1 / rank^s
+class ZipfKeys {
+ public:
+  ZipfKeys(size_t key_num, double s, int seed) : rng_(seed) {
+    cdf_.resize(key_num);
+    double sum = 0;
+    for (size_t i = 0; i < key_num; ++i) {
+      sum += 1 / std::pow(i + 1, s);
+      cdf_[i] = sum;
+    }
+    for (auto &x : cdf_) x /= sum;
+  }
+
+  uint64_t Next() {
+    double u = distrib_(rng_);
+    return std::lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin() + 1;
+  }
+
+ private:
+  std::vector<double> cdf_;
+  std::mt19937_64 rng_;
+  std::uniform_real_distribution<double> distrib_{0, 1};
+};
+
+double ZipfHitRate(SparseCachePolicy policy) {
+  SparseValueCache cache(1000, 1, policy, 0);
+  ZipfKeys zipf(100000, 1.0, 0);
+  float value = 0;
+  for (int i = 0; i < 200000; ++i) {
+    uint64_t key = zipf.Next();
+    if (!cache.Lookup(key, &value)) {
+      value = key;
+      cache.Insert(key, &value);
+    }
+  }
+  EXPECT_LE(cache.size(), 1000UL);
+  return cache.GetStat().HitRate();
+}
+
+std::unique_ptr<PSClient> MakeLocalClient(PaddlePSEnvironment *env) {
+  PSParameter config;
+  auto *table_config = config.mutable_server_param()
+                           ->mutable_downpour_server_param()
+                           ->add_downpour_table_param();
+  table_config->set_table_id(0);
+  table_config->set_table_class("MemorySparseTable");
+  table_config->set_shard_num(10);
+  table_config->set_type(PS_SPARSE_TABLE);
+  auto *accessor_config = table_config->mutable_accessor();
+  accessor_config->set_accessor_class("CtrCommonAccessor");
+  accessor_config->set_fea_dim(11);
+  accessor_config->set_embedx_dim(kEmbDim);
+  accessor_config->set_embedx_threshold(0);
+  for (auto *sgd_param : {accessor_config->mutable_embed_sgd_param(),
+                          accessor_config->mutable_embedx_sgd_param()}) {
+    sgd_param->set_name("SparseNaiveSGDRule");
+    auto *naive_param = sgd_param->mutable_naive();
+    naive_param->set_learning_rate(0.1);
+    naive_param->set_initial_range(0.3);
+    naive_param->add_weight_bounds(-10.0);
+    naive_param->add_weight_bounds(10.0);
+  }
+  std::unique_ptr<PSClient> client(new PsLocalClient());
+  std::map<uint64_t, std::vector<Region>> regions;
+  EXPECT_EQ(client->Configure(config, regions, *env, 0), 0);
+  return client;
+}
+
+}  // namespace
+
+TEST(SparseValueCache, Staleness) {
+  SparseValueCache cache(64, 2, SparseCachePolicy::kClock, 1, 4);
+  std::vector<float> value = {1, 2};
+  std::vector<float> res(2);
+  EXPECT_FALSE(cache.Lookup(7, res.data()));
+  cache.Insert(7, value.data());
+  ASSERT_TRUE(cache.Lookup(7, res.data()));
+  EXPECT_EQ(res, value);
+
+  // served in the step after the pull, not in the one after that, whether
+  // the key is pushed or not
+  cache.AdvanceStep();
+  EXPECT_TRUE(cache.Lookup(7, res.data()));
+  cache.AdvanceStep();
+  EXPECT_FALSE(cache.Lookup(7, res.data()));
+  // pulled again, the new value is served from the step it is pulled in
+  value[0] = 3;
+  cache.Insert(7, value.data());
+  cache.AdvanceStep();
+  ASSERT_TRUE(cache.Lookup(7, res.data()));
+  EXPECT_EQ(res, value);
+
+  SparseValueCache strict(64, 2, SparseCachePolicy::kLfu, 0, 4);
+  strict.Insert(7, value.data());
+  EXPECT_TRUE(strict.Lookup(7, res.data()));
+  strict.AdvanceStep();
+  EXPECT_FALSE(strict.Lookup(7, res.data()));
+
+  auto stat = cache.GetStat();
+  EXPECT_EQ(stat.hits, 3UL);
+  EXPECT_EQ(stat.misses, 2UL);
+  EXPECT_EQ(stat.stale_misses, 1UL);
+  EXPECT_EQ(stat.bytes_saved, 3 * (sizeof(uint64_t) + 2 * sizeof(float)));
+  EXPECT_ANY_THROW(SparseValueCache::ParsePolicy("lru"));
+}
+
+TEST(SparseValueCache, Eviction) {
+  SparseValueCache cache(8, 1, SparseCachePolicy::kClock, 0, 1);
+  float value = 0;
+  for (uint64_t key = 0; key < 8; ++key) {
+    value = key;
+    cache.Insert(key, &value);
+  }
+  // the hand clears all bits in the first pass and evicts key 0, then the
+  // keys used since are kept
+  value = 8;
+  cache.Insert(8, &value);
+  EXPECT_FALSE(cache.Lookup(0, &value));
+  EXPECT_TRUE(cache.Lookup(1, &value));
+  value = 9;
+  cache.Insert(9, &value);
+  EXPECT_TRUE(cache.Lookup(1, &value));
+  EXPECT_EQ(value, 1);
+  EXPECT_FALSE(cache.Lookup(2, &value));
+  EXPECT_EQ(cache.size(), 8UL);
+  EXPECT_EQ(cache.GetStat().evictions, 2UL);
+
+  double clock_hit_rate = ZipfHitRate(SparseCachePolicy::kClock);
+  double lfu_hit_rate = ZipfHitRate(SparseCachePolicy::kLfu);
+  VLOG(3) << "zipf hit rate, clock: " << clock_hit_rate
+          << ", lfu: " << lfu_hit_rate;
+  EXPECT_GT(clock_hit_rate, 0.4);
+  EXPECT_GT(lfu_hit_rate, clock_hit_rate);
+}
+
+// The keys pushed through PsLocalClient are pulled again in the next step
+// with the pushed gradients applied, the others are still served.
+TEST(SparseValueCache, InvalidateOnPush) {
+  PaddlePSEnvironment env;
+  auto client = MakeLocalClient(&env);
+  SparseValueCache cache(1000, kPullDim, SparseCachePolicy::kClock, 100);
+  const size_t key_num = 100;
+  std::vector<uint64_t> keys(key_num);
+  std::vector<float> values(key_num * kPullDim);
+  std::vector<float *> value_ptrs(key_num);
+  for (size_t i = 0; i < key_num; ++i) {
+    keys[i] = i + 1;
+    value_ptrs[i] = values.data() + i * kPullDim;
+  }
+  client->PullSparse(value_ptrs.data(), 0, keys.data(), key_num, true);
+  for (size_t i = 0; i < key_num; ++i) {
+    cache.Insert(keys[i], value_ptrs[i]);
+  }
+
+  // push the first half
+  const size_t push_num = key_num / 2;
+  std::vector<float> grads(push_num * kPushDim, 0.5);
+  std::vector<const float *> grad_ptrs(push_num);
+  for (size_t i = 0; i < push_num; ++i) {
+    float *grad = grads.data() + i * kPushDim;
+    grad[0] = 1;  // slot
+    grad[1] = 1;  // show
+    grad[2] = 0;  // click
+    grad_ptrs[i] = grad;
+  }
+  client->PushSparse(0, keys.data(), grad_ptrs.data(), push_num);
+  cache.Invalidate(keys.data(), push_num);
+  cache.AdvanceStep();
+
+  std::vector<float> fresh(key_num * kPullDim);
+  std::vector<float *> fresh_ptrs(key_num);
+  for (size_t i = 0; i < key_num; ++i) {
+    fresh_ptrs[i] = fresh.data() + i * kPullDim;
+  }
+  client->PullSparse(fresh_ptrs.data(), 0, keys.data(), key_num, true);
+  std::vector<float> res(kPullDim);
+  for (size_t i = 0; i < key_num; ++i) {
+    std::vector<float> row(fresh_ptrs[i], fresh_ptrs[i] + kPullDim);
+    if (i < push_num) {
+      EXPECT_FALSE(cache.Lookup(keys[i], res.data())) << "key " << keys[i];
+      EXPECT_NE(row, std::vector<float>(value_ptrs[i],
+                                        value_ptrs[i] + kPullDim));
+      cache.Insert(keys[i], fresh_ptrs[i]);
+    }
+    ASSERT_TRUE(cache.Lookup(keys[i], res.data())) << "key " << keys[i];
+    EXPECT_EQ(res, row) << "key " << keys[i];
+  }
+  EXPECT_EQ(cache.GetStat().stale_misses, push_num);
+}
+
+// Pulls of a skewed workload through PsLocalClient with the cache as
+// AsyncCommunicator::PullSparseToTensorSync does them, every other step is
+// an evaluation without push. With staleness 0 every key is pulled again and
+// the values served are the values on the table.
+TEST(SparseValueCache, LocalClient) {
+  PaddlePSEnvironment env;
+  auto client = MakeLocalClient(&env);
+  const int batch_size = 2048;
+  for (int max_staleness : {0, 4}) {
+    SparseValueCache cache(
+        5000, kPullDim, SparseCachePolicy::kLfu, max_staleness);
+    ZipfKeys zipf(100000, 1.1, max_staleness);
+    std::mt19937_64 rng(0);
+    std::normal_distribution<float> grad_distrib(0, 0.01);
+    for (int step = 0; step < 40; ++step) {
+      cache.AdvanceStep();
+      std::vector<uint64_t> keys(batch_size);
+      for (auto &key : keys) key = zipf.Next();
+      std::vector<float> values(batch_size * kPullDim);
+      std::vector<uint64_t> miss_keys;
+      std::vector<float *> miss_values;
+      for (int i = 0; i < batch_size; ++i) {
+        if (!cache.Lookup(keys[i], values.data() + i * kPullDim)) {
+          miss_keys.push_back(keys[i]);
+          miss_values.push_back(values.data() + i * kPullDim);
+        }
+      }
+      client->PullSparse(
+          miss_values.data(), 0, miss_keys.data(), miss_keys.size(), true);
+      for (size_t i = 0; i < miss_keys.size(); ++i) {
+        cache.Insert(miss_keys[i], miss_values[i]);
+      }
+
+      if (max_staleness == 0) {
+        std::vector<float> fresh(batch_size * kPullDim);
+        std::vector<float *> fresh_ptrs(batch_size);
+        for (int i = 0; i < batch_size; ++i) {
+          fresh_ptrs[i] = fresh.data() + i * kPullDim;
+        }
+        client->PullSparse(
+            fresh_ptrs.data(), 0, keys.data(), keys.size(), true);
+        ASSERT_EQ(fresh, values) << "step " << step;
+      }
+
+      if (step % 2 == 1) {
+        continue;
+      }
+      std::vector<float> grads(batch_size * kPushDim);
+      std::vector<const float *> grad_ptrs(batch_size);
+      for (int i = 0; i < batch_size; ++i) {
+        float *grad = grads.data() + i * kPushDim;
+        grad[0] = 1;  // slot
+        grad[1] = 1;  // show
+        grad[2] = 0;  // click
+        for (int j = 3; j < kPushDim; ++j) {
+          grad[j] = grad_distrib(rng);
+        }
+        grad_ptrs[i] = grad;
+      }
+      client->PushSparse(0, keys.data(), grad_ptrs.data(), keys.size());
+      cache.Invalidate(keys.data(), keys.size());
+    }
+    auto stat = cache.GetStat();
+    VLOG(3) << "max staleness: " << max_staleness
+            << ", hit rate: " << stat.HitRate()
+            << ", stale misses: " << stat.stale_misses
+            << ", bytes saved: " << stat.bytes_saved;
+    if (max_staleness == 0) {
+      EXPECT_EQ(stat.hits, 0UL);
+    } else {
+      EXPECT_GT(stat.hits, 0UL);
+    }
+  }
+}
+
+}  // namespace paddle::distributed
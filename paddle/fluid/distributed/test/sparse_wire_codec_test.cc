@@ -0,0 +1,341 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/service/sparse_wire_codec.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/ps/table/memory_sparse_table.h"
+#include "paddle/fluid/distributed/ps/table/table.h"
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+
+namespace paddle::distributed {
+
+namespace {
+
+const int kEmbDim = 8;
+const int kPullDim = kEmbDim + 3;  // show, click, embed_w, embedx_w
+const int kPushDim = kEmbDim + 4;  // slot, show, click, embed_g, embedx_g
+
+std::unique_ptr<Table> MakeTable() {
+  TableParameter table_config;
+  table_config.set_table_class("MemorySparseTable");
+  table_config.set_shard_num(10);
+  FsClientParameter fs_config;
+  std::unique_ptr<Table> table(new MemorySparseTable());
+  table->SetShard(0, 1);
+
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CtrCommonAccessor");
+  accessor_config->set_fea_dim(11);
+  accessor_config->set_embedx_dim(kEmbDim);
+  accessor_config->set_embedx_threshold(0);
+  for (auto *sgd_param : {accessor_config->mutable_embed_sgd_param(),
+                          accessor_config->mutable_embedx_sgd_param()}) {
+    sgd_param->set_name("SparseNaiveSGDRule");
+    auto *naive_param = sgd_param->mutable_naive();
+    naive_param->set_learning_rate(0.1);
+    naive_param->set_initial_range(0.3);
+    naive_param->add_weight_bounds(-10.0);
+    naive_param->add_weight_bounds(10.0);
+  }
+  EXPECT_EQ(table->Initialize(table_config, fs_config), 0);
+  return table;
+}
+
+// A shard of a request, as BrpcPsClient sends it
+struct ShardRequest {
+  std::vector<uint64_t> keys;
+  std::vector<uint32_t> frequencies;
+  std::vector<float> push_values;
+};
+
+ShardRequest MakeRequest(size_t num, uint64_t key_range, int seed) {
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<uint64_t> key_distrib(0, key_range);
+  std::normal_distribution<float> grad_distrib(0, 0.01);
+  ShardRequest request;
+  for (size_t i = 0; i < num; ++i) {
+    request.keys.push_back(key_distrib(rng));
+  }
+  std::sort(request.keys.begin(), request.keys.end());
+  request.keys.erase(std::unique(request.keys.begin(), request.keys.end()),
+                     request.keys.end());
+  request.frequencies.assign(request.keys.size(), 1);
+  for (size_t i = 0; i < request.keys.size(); ++i) {
+    request.push_values.push_back(i % 26);  // slot
+    request.push_values.push_back(1);       // show
+    request.push_values.push_back(i % 3 == 0);
+    for (int j = 3; j < kPushDim; ++j) {
+      request.push_values.push_back(grad_distrib(rng));
+    }
+  }
+  return request;
+}
+
+// Client to server to client of a pull and a push as BrpcPsClient and
+// BrpcPsService do them, returns the bytes on the wire.
+size_t LoopbackPull(Table *table,
+                    const ShardRequest &request,
+                    const SparseWireCodec *codec,
+                    std::vector<float> *values) {
+  size_t num = request.keys.size();
+  // client
+  std::string req;
+  req.push_back(1);  // is_training
+  if (codec != nullptr) {
+    SparseWireCodec::EncodeKeys(request.keys.data(), num, &req);
+    SparseWireCodec::EncodeCounts(request.frequencies.data(), num, &req);
+  } else {
+    req.append(reinterpret_cast<const char *>(request.keys.data()),
+               num * sizeof(uint64_t));
+    req.append(reinterpret_cast<const char *>(request.frequencies.data()),
+               num * sizeof(uint32_t));
+  }
+
+  // server
+  std::vector<uint64_t> keys(num);
+  std::vector<uint32_t> frequencies(num);
+  auto value = PullSparseValue(num, kPullDim);
+  if (codec != nullptr) {
+    const char *end = req.data() + req.size();
+    const char *pos = SparseWireCodec::DecodeKeys(
+        req.data() + sizeof(bool), end, num, keys.data());
+    pos = SparseWireCodec::DecodeCounts(pos, end, num, frequencies.data());
+    EXPECT_EQ(pos, end);
+    value.is_training_ = req[0];
+    value.feasigns_ = keys.data();
+    value.frequencies_ = frequencies.data();
+  } else {
+    value.DeserializeFromBytes(&req[0]);
+  }
+  std::vector<float> res_data(num * kPullDim);
+  TableContext table_context;
+  table_context.value_type = Sparse;
+  table_context.pull_context.pull_value = value;
+  table_context.pull_context.values = res_data.data();
+  table->Pull(table_context);
+  std::string res;
+  if (codec != nullptr) {
+    size_t row_size = codec->EncodedRowSize(kPullDim);
+    res.resize(num * row_size);
+    for (size_t i = 0; i < num; ++i) {
+      codec->EncodeRow(
+          res_data.data() + i * kPullDim, kPullDim, &res[i * row_size]);
+    }
+  } else {
+    res.assign(reinterpret_cast<const char *>(res_data.data()),
+               res_data.size() * sizeof(float));
+  }
+
+  // client
+  values->resize(num * kPullDim);
+  if (codec != nullptr) {
+    size_t row_size = codec->EncodedRowSize(kPullDim);
+    for (size_t i = 0; i < num; ++i) {
+      codec->DecodeRow(
+          &res[i * row_size], kPullDim, values->data() + i * kPullDim);
+    }
+  } else {
+    memcpy(values->data(), res.data(), res.size());
+  }
+  return req.size() + res.size();
+}
+
+size_t LoopbackPush(Table *table,
+                    const ShardRequest &request,
+                    const SparseWireCodec *codec) {
+  size_t num = request.keys.size();
+  // client
+  std::string data;
+  if (codec != nullptr) {
+    size_t row_size = codec->EncodedRowSize(kPushDim);
+    SparseWireCodec::EncodeKeys(request.keys.data(), num, &data);
+    size_t key_bytes = data.size();
+    data.resize(key_bytes + num * row_size);
+    for (size_t i = 0; i < num; ++i) {
+      codec->EncodeRow(request.push_values.data() + i * kPushDim,
+                       kPushDim,
+                       &data[key_bytes + i * row_size]);
+    }
+  } else {
+    data.append(reinterpret_cast<const char *>(request.keys.data()),
+                num * sizeof(uint64_t));
+    data.append(reinterpret_cast<const char *>(request.push_values.data()),
+                request.push_values.size() * sizeof(float));
+  }
+
+  // server
+  TableContext table_context;
+  table_context.value_type = Sparse;
+  table_context.num = num;
+  std::vector<uint64_t> keys;
+  std::vector<float> values;
+  if (codec != nullptr) {
+    size_t row_size = codec->EncodedRowSize(kPushDim);
+    keys.resize(num);
+    values.resize(num * kPushDim);
+    const char *pos = SparseWireCodec::DecodeKeys(
+        data.data(), data.data() + data.size(), num, keys.data());
+    EXPECT_EQ(static_cast<size_t>(data.data() + data.size() - pos),
+              num * row_size);
+    for (size_t i = 0; i < num; ++i) {
+      codec->DecodeRow(
+          pos + i * row_size, kPushDim, values.data() + i * kPushDim);
+    }
+    table_context.push_context.keys = keys.data();
+    table_context.push_context.values = values.data();
+  } else {
+    table_context.push_context.keys =
+        reinterpret_cast<const uint64_t *>(data.data());
+    table_context.push_context.values =
+        reinterpret_cast<const float *>(data.data() + num * sizeof(uint64_t));
+  }
+  EXPECT_EQ(table->Push(table_context), 0);
+  return data.size();
+}
+
+}  // namespace
+
+TEST(SparseWireCodec, Keys) {
+  std::vector<uint64_t> keys = {0, 1, 2, 300, 1UL << 40, UINT64_MAX, 5, 5, 0};
+  std::string encoded;
+  SparseWireCodec::EncodeKeys(keys.data(), keys.size(), &encoded);
+  std::vector<uint32_t> counts = {1, 127, 128, UINT32_MAX};
+  SparseWireCodec::EncodeCounts(counts.data(), counts.size(), &encoded);
+
+  const char *end = encoded.data() + encoded.size();
+  std::vector<uint64_t> decoded_keys(keys.size());
+  const char *pos = SparseWireCodec::DecodeKeys(
+      encoded.data(), end, keys.size(), decoded_keys.data());
+  ASSERT_NE(pos, nullptr);
+  EXPECT_EQ(decoded_keys, keys);
+  std::vector<uint32_t> decoded_counts(counts.size());
+  EXPECT_EQ(SparseWireCodec::DecodeCounts(
+                pos, end, counts.size(), decoded_counts.data()),
+            end);
+  EXPECT_EQ(decoded_counts, counts);
+
+  // truncated
+  EXPECT_EQ(SparseWireCodec::DecodeKeys(
+                encoded.data(), encoded.data() + 5, 6, decoded_keys.data()),
+            nullptr);
+
+  // sorted keys take a byte or two
+  std::vector<uint64_t> sorted_keys(1000);
+  for (size_t i = 0; i < sorted_keys.size(); ++i) {
+    sorted_keys[i] = (1UL << 50) + i * 1000;
+  }
+  encoded.clear();
+  SparseWireCodec::EncodeKeys(sorted_keys.data(), sorted_keys.size(), &encoded);
+  EXPECT_LT(encoded.size(), 2 * sorted_keys.size() + 8);
+}
+
+TEST(SparseWireCodec, Rows) {
+  std::vector<float> row = {3, 1, 0, 0.5, -0.25, 1e-3, -2, 0};
+  for (auto codec_name : {"fp32", "fp16", "bf16", "int8"}) {
+    SparseWireCodec codec(SparseWireCodec::ParseValueCodec(codec_name), 3);
+    SparseWireCodec parsed;
+    ASSERT_TRUE(SparseWireCodec::ParseHeader(codec.Header(), &parsed));
+    EXPECT_EQ(parsed.codec(), codec.codec());
+    EXPECT_EQ(parsed.raw_dim(), 3U);
+
+    std::string encoded(codec.EncodedRowSize(row.size()), 0);
+    codec.EncodeRow(row.data(), row.size(), &encoded[0]);
+    std::vector<float> decoded(row.size());
+    codec.DecodeRow(encoded.data(), row.size(), decoded.data());
+    for (size_t i = 0; i < row.size(); ++i) {
+      // int8 is within half a step of max / 127
+      float tolerance = i < 3 ? 0 : std::abs(row[i]) / 100 + 2.0 / 254;
+      EXPECT_NEAR(decoded[i], row[i], tolerance) << codec_name << " " << i;
+    }
+  }
+  SparseWireCodec fp16(SparseValueCodec::kFp16, 3);
+  SparseWireCodec int8(SparseValueCodec::kInt8, 3);
+  EXPECT_EQ(fp16.EncodedRowSize(12), 3 * 4 + 9 * 2UL);
+  EXPECT_EQ(int8.EncodedRowSize(12), 3 * 4 + 4 + 9UL);
+  EXPECT_EQ(int8.EncodedRowSize(2), 2 * 4UL);
+
+  SparseWireCodec parsed;
+  EXPECT_FALSE(SparseWireCodec::ParseHeader("", &parsed));
+  EXPECT_ANY_THROW(SparseWireCodec::ParseValueCodec("fp8"));
+}
+
+TEST(SparseWireCodec, Table) {
+  auto raw_table = MakeTable();
+  auto codec_table = MakeTable();
+  SparseWireCodec push_codec(SparseValueCodec::kFp16, 3);
+  SparseWireCodec pull_codec(SparseValueCodec::kFp16, 2);
+  ShardRequest request = MakeRequest(1000, 1UL << 32, 0);
+  std::vector<float> raw_values, codec_values;
+  LoopbackPull(raw_table.get(), request, nullptr, &raw_values);
+  LoopbackPull(codec_table.get(), request, &pull_codec, &codec_values);
+  LoopbackPush(raw_table.get(), request, nullptr);
+  LoopbackPush(codec_table.get(), request, &push_codec);
+  LoopbackPull(raw_table.get(), request, nullptr, &raw_values);
+  LoopbackPull(codec_table.get(), request, &pull_codec, &codec_values);
+  ASSERT_EQ(raw_values.size(), codec_values.size());
+  for (size_t i = 0; i < raw_values.size(); ++i) {
+    // show and click are exact, the weights are initialized randomly
+    if (i % kPullDim < 2) {
+      ASSERT_EQ(raw_values[i], codec_values[i]);
+    } else {
+      ASSERT_LT(std::abs(codec_values[i]), 10.0);
+    }
+  }
+}
+
+// Bytes on the wire and time of the pulls and pushes of a shard with and
+// without the codecs, through the table as PsLocalClient calls it and with
+// the encoding and decoding of BrpcPsClient and BrpcPsService. Disabled by
+// default, run it with --gtest_also_run_disabled_tests.
+TEST(BENCHMARK, DISABLED_SparseWireCodecLoopback) {
+  const size_t key_num = 100000;
+  ShardRequest request = MakeRequest(key_num, 1UL << 36, 1);
+  std::vector<float> values;
+  for (auto codec_name : {"raw", "fp32", "fp16", "bf16", "int8"}) {
+    auto table = MakeTable();
+    std::unique_ptr<SparseWireCodec> pull_codec, push_codec;
+    if (std::string(codec_name) != "raw") {
+      auto codec = SparseWireCodec::ParseValueCodec(codec_name);
+      pull_codec = std::make_unique<SparseWireCodec>(codec, 2);
+      push_codec = std::make_unique<SparseWireCodec>(codec, 3);
+    }
+    const int rounds = 5;
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+      bytes += LoopbackPull(table.get(), request, pull_codec.get(), &values);
+      bytes += LoopbackPush(table.get(), request, push_codec.get());
+    }
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    LOG(INFO) << codec_name << " keys: " << request.keys.size()
+              << ", bytes per round: " << bytes / rounds
+              << ", rounds/s: " << rounds / seconds;
+  }
+}
+
+}  // namespace paddle::distributed
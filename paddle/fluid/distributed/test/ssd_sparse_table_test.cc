@@ -0,0 +1,260 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/ssd_sparse_table.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/ps/table/depends/frequency_sketch.h"
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+
+COMMON_DECLARE_string(rocksdb_path);
+PD_DECLARE_bool(pserver_ssd_binary_checkpoint);
+PD_DECLARE_int64(pserver_ssd_mem_capacity);
+
+namespace paddle::distributed {
+
+namespace {
+
+const int kEmbDim = 8;
+const char kTestDir[] = "./ssd_sparse_table_test";
+
+std::unique_ptr<SSDSparseTable> CreateTable() {
+  TableParameter table_config;
+  table_config.set_table_class("SSDSparseTable");
+  table_config.set_shard_num(4);
+  FsClientParameter fs_config;
+  std::unique_ptr<SSDSparseTable> table(new SSDSparseTable());
+  table->SetShard(0, 1);
+
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CtrCommonAccessor");
+  accessor_config->set_fea_dim(kEmbDim + 3);
+  accessor_config->set_embedx_dim(kEmbDim);
+  accessor_config->set_embedx_threshold(1e9);
+  // every value in memory is moved to ssd by UpdateTable
+  accessor_config->mutable_ctr_accessor_param()->set_ssd_unseenday_threshold(
+      -1);
+  for (auto *sgd_param : {accessor_config->mutable_embed_sgd_param(),
+                          accessor_config->mutable_embedx_sgd_param()}) {
+    sgd_param->set_name("SparseNaiveSGDRule");
+    auto *naive_param = sgd_param->mutable_naive();
+    naive_param->set_learning_rate(0.1);
+    naive_param->set_initial_range(0.3);
+    naive_param->add_weight_bounds(-10.0);
+    naive_param->add_weight_bounds(10.0);
+  }
+  EXPECT_EQ(table->Initialize(table_config, fs_config), 0);
+  return table;
+}
+
+std::vector<float> Pull(Table *table, const std::vector<uint64_t> &keys) {
+  std::vector<uint32_t> fres(keys.size(), 1);
+  std::vector<float> values(keys.size() * (kEmbDim + 3));
+  TableContext table_context;
+  table_context.value_type = Sparse;
+  table_context.pull_context.pull_value = PullSparseValue(keys, fres, kEmbDim);
+  table_context.pull_context.values = values.data();
+  EXPECT_EQ(table->Pull(table_context), 0);
+  return values;
+}
+
+// Pulls and pushes keys as a training step does.
+void Train(Table *table, const std::vector<uint64_t> &keys) {
+  std::vector<float> grads;
+  for (uint64_t key : keys) {
+    grads.push_back(1);  // slot
+    grads.push_back(1);  // show
+    grads.push_back(key % 2);
+    for (int j = 0; j < kEmbDim + 1; ++j) {
+      grads.push_back(0.01 * (key % 7) - 0.03);
+    }
+  }
+  Pull(table, keys);
+  TableContext table_context;
+  table_context.value_type = Sparse;
+  table_context.push_context.keys = keys.data();
+  table_context.push_context.values = grads.data();
+  table_context.num = keys.size();
+  ASSERT_EQ(table->Push(table_context), 0);
+}
+
+void Train(Table *table, uint64_t begin, uint64_t end) {
+  std::vector<uint64_t> keys;
+  for (uint64_t key = begin; key < end; ++key) {
+    keys.push_back(key);
+  }
+  Train(table, keys);
+}
+
+uint64_t CheckpointSize(const std::string &path, const std::string &ext) {
+  uint64_t size = 0;
+  for (auto &entry : std::filesystem::recursive_directory_iterator(path)) {
+    if (entry.is_regular_file() && entry.path().extension() == ext) {
+      size += entry.file_size();
+    }
+  }
+  return size;
+}
+
+// Batches of keys 1 to key_num drawn with probability proportional to
+// 1 / rank.
+std::vector<std::vector<uint64_t>> ZipfBatches(size_t key_num,
+                                               size_t batch_num,
+                                               size_t batch_size) {
+  std::vector<double> cdf(key_num);
+  double sum = 0;
+  for (size_t i = 0; i < key_num; ++i) {
+    sum += 1.0 / (i + 1);
+    cdf[i] = sum;
+  }
+  std::mt19937_64 rng(0);
+  std::uniform_real_distribution<double> distrib(0, sum);
+  std::vector<std::vector<uint64_t>> batches(batch_num);
+  for (auto &batch : batches) {
+    for (size_t i = 0; i < batch_size; ++i) {
+      batch.push_back(
+          std::lower_bound(cdf.begin(), cdf.end(), distrib(rng)) - cdf.begin() +
+          1);
+    }
+  }
+  return batches;
+}
+
+}  // namespace
+
+TEST(FrequencySketch, Estimate) {
+  FrequencySketch sketch(1024);
+  EXPECT_EQ(sketch.width(), 1024UL);
+  for (int i = 0; i < 10; ++i) {
+    sketch.Increment(7);
+  }
+  for (uint64_t key = 100; key < 1100; ++key) {
+    sketch.Increment(key);
+  }
+  EXPECT_GE(sketch.Estimate(7), 10);
+  EXPECT_LE(sketch.Estimate(100), 2);
+  EXPECT_LE(sketch.Estimate(5000), 1);
+  for (int i = 0; i < 100; ++i) {
+    sketch.Increment(8);
+  }
+  EXPECT_EQ(sketch.Estimate(8), FrequencySketch::kMaxCount);
+
+  // halved after 10 * width increments
+  for (uint64_t key = 0; key < 10 * 1024; ++key) {
+    sketch.Increment(1000000 + key);
+  }
+  EXPECT_LE(sketch.Estimate(8), FrequencySketch::kMaxCount / 2 + 1);
+  EXPECT_GE(sketch.Estimate(8), FrequencySketch::kMaxCount / 2);
+}
+
+// With a memory capacity the values pulled most often are kept in memory and
+// the others on ssd, and the values are the same as without it.
+TEST(SSDSparseTable, Tiering) {
+  std::filesystem::remove_all(kTestDir);
+  const int64_t capacity = 400;
+  auto batches = ZipfBatches(10000, 20, 2000);
+  std::vector<uint64_t> all_keys;
+  for (uint64_t key = 1; key <= 10000; ++key) {
+    all_keys.push_back(key);
+  }
+  std::vector<std::vector<float>> results;
+  for (int64_t mem_capacity : {static_cast<int64_t>(0), capacity}) {
+    FLAGS_pserver_ssd_mem_capacity = mem_capacity;
+    FLAGS_rocksdb_path =
+        std::string(kTestDir) + "/db_" + std::to_string(mem_capacity);
+    auto table = CreateTable();
+    for (size_t i = 0; i < batches.size(); ++i) {
+      if (i == batches.size() / 2) {
+        ASSERT_EQ(table->UpdateTable(), 0);
+      }
+      Train(table.get(), batches[i]);
+    }
+    // after the demotions enqueued
+    Pull(table.get(), {});
+    VLOG(3) << "mem capacity: " << mem_capacity
+            << ", mem size: " << table->LocalSize();
+    if (mem_capacity > 0) {
+      EXPECT_LE(table->LocalSize(), capacity * 11 / 10);
+    } else {
+      EXPECT_GT(table->LocalSize(), capacity * 11 / 10);
+    }
+    results.push_back(Pull(table.get(), all_keys));
+  }
+  EXPECT_EQ(results[0], results[1]);
+  FLAGS_pserver_ssd_mem_capacity = 0;
+  std::filesystem::remove_all(kTestDir);
+}
+
+// A delta checkpoint has only the values changed since the full checkpoint
+// it is based on, and loading it gives the values of the saved table.
+TEST(SSDSparseTable, BinaryCheckpoint) {
+  std::filesystem::remove_all(kTestDir);
+  FLAGS_rocksdb_path = std::string(kTestDir) + "/db";
+  FLAGS_pserver_ssd_binary_checkpoint = true;
+  std::string full_path = std::string(kTestDir) + "/full";
+  std::string delta_path = std::string(kTestDir) + "/delta";
+
+  std::vector<uint64_t> all_keys;
+  for (uint64_t key = 1; key <= 20000; ++key) {
+    all_keys.push_back(key);
+  }
+  std::vector<float> expected;
+  {
+    auto table = CreateTable();
+    Train(table.get(), 1, 20001);
+    ASSERT_EQ(table->UpdateTable(), 0);
+    Train(table.get(), 1, 101);
+
+    ASSERT_EQ(table->Save(full_path, "0"), 0);
+    // on ssd since the last change
+    Train(table.get(), 51, 151);
+    ASSERT_EQ(table->UpdateTable(), 0);
+    Train(table.get(), 151, 201);
+    ASSERT_EQ(table->Save(delta_path, "0"), 0);
+    // renamed into place
+    EXPECT_TRUE(std::filesystem::exists(delta_path + "/000/checkpoint-000"));
+    EXPECT_FALSE(
+        std::filesystem::exists(delta_path + "/000/checkpoint-000.tmp"));
+
+    // 100 values in memory and a rocksdb checkpoint, then 150 values
+    uint64_t full_size = CheckpointSize(full_path, ".mem");
+    uint64_t delta_size = CheckpointSize(delta_path, ".mem");
+    ASSERT_GT(full_size, 0UL);
+    EXPECT_EQ(full_size / 100, delta_size / 150);
+    EXPECT_EQ(full_size % 100, 0UL);
+    EXPECT_EQ(delta_size % 150, 0UL);
+    EXPECT_GT(CheckpointSize(full_path, ".sst"), 0UL);
+    EXPECT_EQ(CheckpointSize(delta_path, ".sst"), 0UL);
+    expected = Pull(table.get(), all_keys);
+  }
+
+  // the shards of the first table are still open
+  FLAGS_rocksdb_path = std::string(kTestDir) + "/load_db";
+  auto table = CreateTable();
+  ASSERT_EQ(table->Load(delta_path, "0"), 0);
+  EXPECT_EQ(Pull(table.get(), all_keys), expected);
+  FLAGS_pserver_ssd_binary_checkpoint = false;
+  std::filesystem::remove_all(kTestDir);
+}
+
+}  // namespace paddle::distributed
@@ -22,20 +22,31 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <atomic>
 #include <condition_variable>  // NOLINT
 #include <deque>
 #include <limits>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
+#include "paddle/fluid/framework/mpmc_ring_buffer.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/phi/core/expect.h"
 
 namespace paddle {
 namespace framework {
 
+// kMutex keeps the data in a deque guarded by a mutex, the channel may be
+// unbounded. kLockFree keeps the data in a lock-free ring, see
+// MPMCRingBuffer, the channel must be bounded and its capacity can not grow
+// beyond the one it is made with. Readers and writers of a kLockFree channel
+// only take the mutex to sleep when the channel is empty or full, so it scales
+// better with many threads moving small blocks.
+enum class ChannelBackend { kMutex, kLockFree };
+
 template <class T>
 class ChannelObject {
  public:
@@ -46,8 +57,33 @@ class ChannelObject {
     capacity_ = (std::min)(MaxCapacity(), capacity);
   }
 
-  const std::deque<T>& GetData() const { return data_; }
+  // capacity can not be zero for kLockFree
+  ChannelObject(size_t capacity, ChannelBackend backend) {
+    capacity_ = (std::min)(MaxCapacity(), capacity);
+    if (backend == ChannelBackend::kLockFree) {
+      ring_.reset(new MPMCRingBuffer<T>(capacity_));
+    }
+  }
+
+  ChannelBackend Backend() const {
+    return ring_ ? ChannelBackend::kLockFree : ChannelBackend::kMutex;
+  }
+
+  const std::deque<T>& GetData() const {
+    PADDLE_ENFORCE_EQ(ring_ == nullptr,
+                      true,
+                      common::errors::Unimplemented(
+                          "GetData() is not supported by lock-free channels."));
+    return data_;
+  }
   void Clear() {
+    if (ring_) {
+      T val;
+      while (ring_->TryPop(&val, 1) != 0) {
+      }
+      RingNotify(&ring_full_waiters_, &full_cond_);
+      return;
+    }
     std::unique_lock<std::mutex> lock(mutex_);
     data_.clear();
     data_.shrink_to_fit();
@@ -57,7 +93,23 @@ class ChannelObject {
     return capacity_;  // atomic
   }
 
-  void SetCapacity(size_t x) {  // capacity can be zero
+  // capacity can be zero for kMutex only, a kLockFree channel of capacity
+  // zero could never be written
+  void SetCapacity(size_t x) {
+    if (ring_) {
+      PADDLE_ENFORCE_GE(
+          x,
+          1,
+          common::errors::InvalidArgument(
+              "The capacity of a lock-free channel can not be zero."));
+      ring_->set_capacity(x);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_ = x;
+      }
+      RingNotify(&ring_full_waiters_, &full_cond_);
+      return;
+    }
     std::lock_guard<std::mutex> lock(mutex_);
     capacity_ = std::min(MaxCapacity(), x);
     Notify();
@@ -78,10 +130,13 @@ class ChannelObject {
     block_size_ = x;
   }
 
+  // the capacity of a kLockFree channel is not inherited
   template <class U>
   void InheritFrom(const std::shared_ptr<ChannelObject<U>>& other) {
     std::lock_guard<std::mutex> lock(mutex_);
-    capacity_ = other->Capacity();
+    if (!ring_) {
+      capacity_ = other->Capacity();
+    }
     block_size_ = other->BlockSize();
   }
 
@@ -100,15 +155,26 @@ class ChannelObject {
   void Close() {
     std::lock_guard<std::mutex> lock(mutex_);
     closed_ = true;
+    if (ring_) {
+      empty_cond_.notify_all();
+      full_cond_.notify_all();
+      return;
+    }
     Notify();
   }
 
   size_t Size() {
+    if (ring_) {
+      return ring_->Size();
+    }
     std::lock_guard<std::mutex> lock(mutex_);
     return data_.size();
   }
 
   bool Empty() {
+    if (ring_) {
+      return ring_->Size() == 0;
+    }
     std::lock_guard<std::mutex> lock(mutex_);
     return EmptyUnlocked();
   }
@@ -122,6 +188,9 @@ class ChannelObject {
     if (n == 0) {
       return 0;
     }
+    if (ring_) {
+      return RingRead(n, p, false);
+    }
 
     std::unique_lock<std::mutex> lock(mutex_);
     size_t finished = Read(n, p, lock);
@@ -141,6 +210,9 @@ class ChannelObject {
     if (n == 0) {
       return 0;
     }
+    if (ring_) {
+      return RingWrite(n, p);
+    }
     std::unique_lock<std::mutex> lock(mutex_);
     size_t finished = Write(n, p, lock);
     Notify();
@@ -152,6 +224,9 @@ class ChannelObject {
     if (n == 0) {
       return 0;
     }
+    if (ring_) {
+      return RingWrite(n, p);
+    }
     std::unique_lock<std::mutex> lock(mutex_);
     size_t finished = WriteMove(n, p, lock);
     Notify();
@@ -170,6 +245,12 @@ class ChannelObject {
     if (size == 0) {
       return 0;
     }
+    if (ring_) {
+      p.resize(size);
+      size_t finished = RingRead(size, &p[0], true);
+      p.resize(finished);
+      return finished;
+    }
     std::unique_lock<std::mutex> lock(mutex_);
     p.resize(size);
     size_t finished = Read(size, &p[0], lock, true);
@@ -202,7 +283,7 @@ class ChannelObject {
  private:
   size_t capacity_ = MaxCapacity();
   size_t block_size_ = 1024;
-  bool closed_ = false;
+  std::atomic<bool> closed_{false};
   std::mutex mutex_;
   // use deque to store data
   std::deque<T> data_;
@@ -211,11 +292,86 @@ class ChannelObject {
   int full_waiters_ = 0;
   std::condition_variable empty_cond_;
   std::condition_variable full_cond_;
+  // only for kLockFree
+  std::unique_ptr<MPMCRingBuffer<T>> ring_;
+  std::atomic<int> ring_empty_waiters_{0};
+  std::atomic<int> ring_full_waiters_{0};
 
   static constexpr size_t MaxCapacity() {
     return (std::numeric_limits<size_t>::max)() / 2;
   }
 
+  static constexpr int kRingSpinCount = 64;
+
+  // Sleep until ready() is true. The waiter count is raised before ready() is
+  // checked under the mutex, and RingNotify() checks it after the ring is
+  // changed, so one of them always sees the other and no wakeup is lost.
+  template <class Pred>
+  void RingWait(std::atomic<int>* waiters,
+                std::condition_variable* cond,
+                Pred ready) {
+    for (int i = 0; i < kRingSpinCount; ++i) {
+      if (ready()) {
+        return;
+      }
+      std::this_thread::yield();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    waiters->fetch_add(1);
+    while (!ready()) {
+      cond->wait(lock);
+    }
+    waiters->fetch_sub(1);
+  }
+
+  void RingNotify(std::atomic<int>* waiters, std::condition_variable* cond) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters->load() != 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cond->notify_all();
+    }
+  }
+
+  size_t RingRead(size_t n, T* p, bool once) {
+    size_t finished = 0;
+    while (finished < n) {
+      size_t m = ring_->TryPop(p + finished, n - finished);
+      if (m > 0) {
+        finished += m;
+        RingNotify(&ring_full_waiters_, &full_cond_);
+        if (once) {
+          break;
+        }
+        continue;
+      }
+      if (closed_ && !ring_->CanPop()) {
+        break;
+      }
+      RingWait(&ring_empty_waiters_, &empty_cond_, [this] {
+        return ring_->CanPop() || closed_;
+      });
+    }
+    return finished;
+  }
+
+  // U is const T to copy the data, T to move it
+  template <class U>
+  size_t RingWrite(size_t n, U* p) {
+    size_t finished = 0;
+    while (finished < n && !closed_) {
+      size_t m = ring_->TryPush(p + finished, n - finished);
+      if (m > 0) {
+        finished += m;
+        RingNotify(&ring_empty_waiters_, &empty_cond_);
+        continue;
+      }
+      RingWait(&ring_full_waiters_, &full_cond_, [this] {
+        return ring_->CanPush() || closed_;
+      });
+    }
+    return finished;
+  }
+
   void Notify() {
     if (empty_waiters_ != 0 && (!EmptyUnlocked() || closed_)) {
       empty_cond_.notify_one();
@@ -326,6 +482,11 @@ Channel<T> MakeChannel(size_t capacity = (std::numeric_limits<size_t>::max)()) {
   return std::make_shared<ChannelObject<T>>(capacity);
 }
 
+template <class T>
+Channel<T> MakeChannel(size_t capacity, ChannelBackend backend) {
+  return std::make_shared<ChannelObject<T>>(capacity, backend);
+}
+
 template <class T, class U>
 Channel<T> MakeChannel(const Channel<U>& other) {
   PADDLE_ENFORCE_NE(
@@ -27,6 +27,8 @@ limitations under the License. */
 #endif
 #include "io/fs.h"
 #include "paddle/common/enforce.h"
+#include "paddle/fluid/framework/data_feed_cache.h"
+#include "paddle/fluid/framework/data_feed_parser.h"
 #include "paddle/phi/core/platform/monitor.h"
 #include "paddle/phi/core/platform/timer.h"
 
@@ -55,10 +57,23 @@ class BufferedLineFileReader {
 
  public:
   typedef std::function<bool(const std::string&)> LineFunc;
+  // A view of one line without the '\n', which is valid only during the
+  // call. The line is followed by a '\0', so it can be parsed with strto*.
+  typedef std::function<bool(const char*, size_t)> LineViewFunc;
 
  private:
-  template <typename T>
-  int read_lines(T* reader, LineFunc func, int skip_lines) {
+  bool call_line_func(const LineFunc& func, const char* str, size_t len) {
+    line_.assign(str, len);
+    return func(line_);
+  }
+  bool call_line_func(const LineViewFunc& func, const char* str, size_t len) {
+    return func(str, len);
+  }
+
+  // The lines which are wholly in the buffer are passed in place, only the
+  // ones crossing two reads are assembled in x.
+  template <typename T, typename Func>
+  int read_lines(T* reader, const Func& func, int skip_lines) {
     int lines = 0;
     size_t ret = 0;
     char* ptr = nullptr;
@@ -74,10 +89,17 @@ class BufferedLineFileReader {
       eol = reinterpret_cast<char*>(memchr(ptr, '\n', ret));
       while (eol != nullptr) {
         int size = static_cast<int>((eol - ptr) + 1);
-        x.append(ptr, size - 1);
         ++lines;
         if (lines > skip_lines && spfunc()) {
-          if (!func(x)) {
+          bool ok = false;
+          if (x.empty()) {
+            *eol = '\0';
+            ok = call_line_func(func, ptr, size - 1);
+          } else {
+            x.append(ptr, size - 1);
+            ok = call_line_func(func, x.c_str(), x.size());
+          }
+          if (!ok) {
             ++error_line_;
           }
         }
@@ -94,7 +116,7 @@ class BufferedLineFileReader {
     if (!is_error() && !x.empty()) {
       ++lines;
       if (lines > skip_lines && spfunc()) {
-        if (!func(x)) {
+        if (!call_line_func(func, x.c_str(), x.size())) {
           ++error_line_;
         }
       }
@@ -115,7 +137,11 @@ class BufferedLineFileReader {
 
   int read_file(FILE* fp, LineFunc func, int skip_lines) {
     FILEReader reader(fp);
-    return read_lines<FILEReader>(&reader, func, skip_lines);
+    return read_lines(&reader, func, skip_lines);
+  }
+  int read_file(FILE* fp, LineViewFunc func, int skip_lines) {
+    FILEReader reader(fp);
+    return read_lines(&reader, func, skip_lines);
   }
   uint64_t file_size() { return total_len_; }
   void set_sample_rate(float r) { sample_rate_ = r; }
@@ -134,6 +160,7 @@ class BufferedLineFileReader {
 
  private:
   char* buff_ = nullptr;
+  std::string line_;
   uint64_t total_len_ = 0;
 
   std::default_random_engine random_engine_;
@@ -299,8 +326,10 @@ void PrivateQueueDataFeed<T>::SetQueueSize(int queue_size) {
       common::errors::InvalidArgument(
           "Queue size %d is illegal in PrivateQueueDataFeed.", queue_size));
   queue_size_ = queue_size;
-  queue_ = paddle::framework::MakeChannel<T>();
-  queue_->SetCapacity(queue_size);
+  // one reader thread puts and the trainer gets instance by instance, which
+  // is where the lock-free channel pays off most
+  queue_ = paddle::framework::MakeChannel<T>(queue_size,
+                                             ChannelBackend::kLockFree);
 }
 
 template <typename T>
@@ -933,12 +962,9 @@ bool MultiSlotDataFeed::ParseOneInstanceFromPipe(
         }
         pos = endptr - str;
       } else {
-        for (int j = 0; j <= num; ++j) {
-          // pos = line.find_first_of(' ', pos + 1);
-          while (line[pos + 1] != ' ') {
-            pos++;
-          }
-        }
+        // the slot size and the feasigns of the slot
+        pos = static_cast<int>(
+            SkipSlotTokens(&str[pos], str + line.size(), num + 1) - str);
       }
     }
     return true;
@@ -1176,7 +1202,7 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
     return false;
   } else {
     const char* str = reader.get();
-    std::string line = std::string(str);
+    const char* str_end = str + reader.length();
     // VLOG(3) << line;
     char* endptr = const_cast<char*>(str);
     int pos = 0;
@@ -1236,7 +1262,7 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
     }
     for (size_t i = 0; i < use_slots_index_.size(); ++i) {
       int idx = use_slots_index_[i];
-      int num = strtol(&str[pos], &endptr, 10);
+      int num = FastStrToInt(&str[pos], &endptr);
       PADDLE_ENFORCE_NE(
           num,
           0,
@@ -1269,7 +1295,7 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
       if (idx != -1) {
         if (all_slots_type_[i][0] == 'f') {  // float
           for (int j = 0; j < num; ++j) {
-            float feasign = strtof(endptr, &endptr);
+            float feasign = FastStrToFloat(endptr, &endptr);
             // if float feasign is equal to zero, ignore it
             // except when slot is dense
             if (fabs(feasign) < 1e-6 && !use_slots_is_dense_[i]) {
@@ -1281,7 +1307,7 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
           }
         } else if (all_slots_type_[i][0] == 'u') {  // uint64
           for (int j = 0; j < num; ++j) {
-            uint64_t feasign = (uint64_t)strtoull(endptr, &endptr, 10);
+            uint64_t feasign = FastStrToUint64(endptr, &endptr);
             // if uint64 feasign is equal to zero, ignore it
             // except when slot is dense
             if (feasign == 0 && !use_slots_is_dense_[i]) {
@@ -1294,12 +1320,9 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstanceFromPipe(Record* instance) {
         }
         pos = endptr - str;
       } else {
-        for (int j = 0; j <= num; ++j) {
-          // pos = line.find_first_of(' ', pos + 1);
-          while (line[pos + 1] != ' ') {
-            pos++;
-          }
-        }
+        // the slot size and the feasigns of the slot
+        pos = static_cast<int>(
+            SkipSlotTokens(&str[pos], str_end, num + 1) - str);
       }
     }
     instance->float_feasigns_.shrink_to_fit();
@@ -1323,7 +1346,7 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstance(Record* instance) {
     int pos = 0;
     for (size_t i = 0; i < use_slots_index_.size(); ++i) {
       int idx = use_slots_index_[i];
-      int num = strtol(&str[pos], &endptr, 10);
+      int num = FastStrToInt(&str[pos], &endptr);
       PADDLE_ENFORCE_NE(
           num,
           0,
@@ -1344,7 +1367,7 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstance(Record* instance) {
       if (idx != -1) {
         if (all_slots_type_[i][0] == 'f') {  // float
           for (int j = 0; j < num; ++j) {
-            float feasign = strtof(endptr, &endptr);
+            float feasign = FastStrToFloat(endptr, &endptr);
             if (fabs(feasign) < 1e-6) {
               continue;
             }
@@ -1354,7 +1377,7 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstance(Record* instance) {
           }
         } else if (all_slots_type_[i][0] == 'u') {  // uint64
           for (int j = 0; j < num; ++j) {
-            uint64_t feasign = (uint64_t)strtoull(endptr, &endptr, 10);
+            uint64_t feasign = FastStrToUint64(endptr, &endptr);
             if (feasign == 0) {
               continue;
             }
@@ -1365,9 +1388,9 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstance(Record* instance) {
         }
         pos = endptr - str;
       } else {
-        for (int j = 0; j <= num; ++j) {
-          pos = line.find_first_of(' ', pos + 1);
-        }
+        // the slot size and the feasigns of the slot
+        pos = static_cast<int>(
+            SkipSlotTokens(&str[pos], str + line.size(), num + 1) - str);
       }
     }
     instance->float_feasigns_.shrink_to_fit();
@@ -2427,8 +2450,34 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
     std::vector<SlotRecord> record_vec;
     platform::Timer timeline;
     timeline.Start();
+
+    // sampled records are not cached, the next passes sample again
+    std::unique_ptr<SlotRecordCacheWriter> cache_writer;
+    std::string cache_key;
+    if (!data_cache_dir_.empty() && std::abs(sample_rate_ - 1.0f) < 1e-5f) {
+      cache_key = GetDataCacheKey(filename);
+    }
+    if (!cache_key.empty()) {
+      std::string cache_path =
+          GetSlotRecordCachePath(data_cache_dir_, cache_key);
+      uint64_t cache_records = 0;
+      if (LoadIntoMemoryFromCache(cache_path, cache_key, &cache_records)) {
+        timeline.Pause();
+        VLOG(3) << "LoadIntoMemory() read cache of file=" << filename
+                << ", cache=" << cache_path << ", records=" << cache_records
+                << ", cost time=" << timeline.ElapsedSec()
+                << " seconds, thread_id=" << thread_id_;
+        continue;
+      }
+      cache_writer = std::make_unique<SlotRecordCacheWriter>(
+          cache_path, cache_key, uint64_use_slot_size_, float_use_slot_size_);
+    }
+
     SlotRecordPool().get(&record_vec, OBJPOOL_BLOCK_SIZE);
     int offset = 0;
+    // the retry skips the lines that fail to parse, so the records are not
+    // complete and must not be cached
+    bool parse_failed = false;
 
     do {
       int err_no = 0;
@@ -2441,15 +2490,24 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
 
       lines = line_reader.read_file(
           this->fp_.get(),
-          [this, &record_vec, &offset, &filename](const std::string& line) {
-            if (ParseOneInstance(line, &record_vec[offset])) {
+          [this,
+           &record_vec,
+           &offset,
+           &filename,
+           &cache_writer,
+           &parse_failed](const char* line, size_t len) {
+            if (ParseOneInstance(line, len, &record_vec[offset])) {
               ++offset;
             } else {
               LOG(WARNING) << "read file:[" << filename
                            << "] item error, line:[" << line << "]";
+              parse_failed = true;
               return false;
             }
             if (offset >= OBJPOOL_BLOCK_SIZE) {
+              if (cache_writer != nullptr) {
+                cache_writer->Append(record_vec.data(), offset);
+              }
               input_channel_->Write(std::move(record_vec));
               record_vec.clear();
               SlotRecordPool().get(&record_vec, OBJPOOL_BLOCK_SIZE);
@@ -2460,6 +2518,9 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
           lines);
     } while (line_reader.is_error());
     if (offset > 0) {
+      if (cache_writer != nullptr) {
+        cache_writer->Append(record_vec.data(), offset);
+      }
       input_channel_->WriteMove(offset, &record_vec[0]);
       if (offset < OBJPOOL_BLOCK_SIZE) {
         SlotRecordPool().put(&record_vec[offset],
@@ -2468,6 +2529,16 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
     } else {
       SlotRecordPool().put(&record_vec);
     }
+    if (cache_writer != nullptr) {
+      if (parse_failed) {
+        // the writer removes the unfinished cache
+        VLOG(3) << "Do not cache file=" << filename
+                << " as some lines fail to parse";
+        cache_writer.reset();
+      } else {
+        cache_writer->Finish();
+      }
+    }
     record_vec.clear();
     record_vec.shrink_to_fit();
     timeline.Pause();
@@ -2482,6 +2553,59 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
 #endif
 }
 
+std::string SlotRecordInMemoryDataFeed::GetDataCacheKey(
+    const std::string& filename) const {
+#ifdef _LINUX
+  // the size and mtime tell a rewritten file from the cached one, remote
+  // files have no cheap fingerprint and are not cached
+  struct stat file_stat = {};
+  if (fs_select_internal(filename) != 0 ||
+      stat(filename.c_str(), &file_stat) != 0) {
+    return "";
+  }
+  // everything that changes the parsed records
+  std::ostringstream key;
+  key << filename << '\n'
+      << file_stat.st_size << ':' << file_stat.st_mtim.tv_sec << '.'
+      << file_stat.st_mtim.tv_nsec << '\n'
+      << pipe_command_ << '\n'
+      << parse_ins_id_ << parse_logkey_ << '\n';
+  for (auto& info : all_slots_info_) {
+    key << info.slot << ':' << info.type << ':' << info.used_idx << ':'
+        << info.slot_value_idx << ';';
+  }
+  for (auto& info : used_slots_info_) {
+    key << info.dense;
+  }
+  return key.str();
+#else
+  return "";
+#endif
+}
+
+bool SlotRecordInMemoryDataFeed::LoadIntoMemoryFromCache(
+    const std::string& cache_path,
+    const std::string& cache_key,
+    uint64_t* record_num) {
+  SlotRecordCacheReader reader;
+  if (!reader.Open(cache_path,
+                   cache_key,
+                   uint64_use_slot_size_,
+                   float_use_slot_size_)) {
+    return false;
+  }
+  std::vector<SlotRecord> record_vec;
+  size_t num = 0;
+  while ((num = reader.NextBlockSize()) > 0) {
+    SlotRecordPool().get(&record_vec, static_cast<int>(num));
+    reader.ReadBlock(record_vec.data());
+    input_channel_->Write(std::move(record_vec));
+    record_vec.clear();
+  }
+  *record_num = reader.record_num();
+  return true;
+}
+
 static void parser_log_key(const std::string& log_key,
                            uint64_t* search_id,
                            uint32_t* cmatch,
@@ -2497,9 +2621,15 @@ static void parser_log_key(const std::string& log_key,
 
 bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
                                                   SlotRecord* ins) {
+  return ParseOneInstance(line.c_str(), line.size(), ins);
+}
+
+bool SlotRecordInMemoryDataFeed::ParseOneInstance(const char* str,
+                                                  size_t len,
+                                                  SlotRecord* ins) {
   SlotRecord& rec = (*ins);
   // parse line
-  const char* str = line.c_str();
+  const char* str_end = str + len;
   char* endptr = const_cast<char*>(str);
   int pos = 0;
 
@@ -2509,32 +2639,32 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
   slot_uint64_feasigns.resize(uint64_use_slot_size_);
 
   if (parse_ins_id_) {
-    int num = static_cast<int>(strtol(&str[pos], &endptr, 10));
+    int num = FastStrToInt(&str[pos], &endptr);
     PADDLE_ENFORCE_EQ(num == 1,
                       true,
                       common::errors::InvalidArgument(
                           "Num should be equal to 1, but received %d.", num));
     pos = static_cast<int>(endptr - str + 1);
-    size_t len = 0;
-    while (str[pos + len] != ' ') {
-      ++len;
+    size_t id_len = 0;
+    while (str[pos + id_len] != ' ') {
+      ++id_len;
     }
-    rec->ins_id_ = std::string(str + pos, len);
-    pos += static_cast<int>(len + 1);
+    rec->ins_id_ = std::string(str + pos, id_len);
+    pos += static_cast<int>(id_len + 1);
   }
   if (parse_logkey_) {
-    int num = static_cast<int>(strtol(&str[pos], &endptr, 10));
+    int num = FastStrToInt(&str[pos], &endptr);
     PADDLE_ENFORCE_EQ(num == 1,
                       true,
                       common::errors::InvalidArgument(
                           "Num should be equal to 1, but received %d.", num));
     pos = static_cast<int>(endptr - str + 1);
-    size_t len = 0;
-    while (str[pos + len] != ' ') {
-      ++len;
+    size_t id_len = 0;
+    while (str[pos + id_len] != ' ') {
+      ++id_len;
     }
     // parse_logkey
-    std::string log_key = std::string(str + pos, len);
+    std::string log_key = std::string(str + pos, id_len);
     uint64_t search_id = 0;
     uint32_t cmatch = 0;
     uint32_t rank = 0;
@@ -2544,14 +2674,14 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
     rec->search_id = search_id;
     rec->cmatch = cmatch;
     rec->rank = rank;
-    pos += static_cast<int>(len + 1);
+    pos += static_cast<int>(id_len + 1);
   }
 
   int float_total_slot_num = 0;
   int uint64_total_slot_num = 0;
 
   for (auto& info : all_slots_info_) {
-    int num = static_cast<int>(strtol(&str[pos], &endptr, 10));
+    int num = FastStrToInt(&str[pos], &endptr);
     PADDLE_ENFORCE(num,
                    "The number of ids can not be zero, you need padding "
                    "it in data generator; or if there is something wrong with "
@@ -2563,7 +2693,7 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
         auto& slot_fea = slot_float_feasigns[info.slot_value_idx];
         slot_fea.clear();
         for (int j = 0; j < num; ++j) {
-          float feasign = strtof(endptr, &endptr);
+          float feasign = FastStrToFloat(endptr, &endptr);
           if (fabs(feasign) < 1e-6 && !used_slots_info_[info.used_idx].dense) {
             continue;
           }
@@ -2574,20 +2704,16 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
         auto& slot_fea = slot_uint64_feasigns[info.slot_value_idx];
         slot_fea.clear();
         for (int j = 0; j < num; ++j) {
-          uint64_t feasign =
-              static_cast<uint64_t>(strtoull(endptr, &endptr, 10));
+          uint64_t feasign = FastStrToUint64(endptr, &endptr);
           slot_fea.push_back(feasign);
           ++uint64_total_slot_num;
         }
       }
       pos = static_cast<int>(endptr - str);
     } else {
-      for (int j = 0; j <= num; ++j) {
-        // pos = line.find_first_of(' ', pos + 1);
-        while (line[pos + 1] != ' ') {
-          pos++;
-        }
-      }
+      // the slot size and the feasigns of the slot
+      pos = static_cast<int>(SkipSlotTokens(&str[pos], str_end, num + 1) -
+                             str);
     }
   }
   rec->slot_float_feasigns_.add_slot_feasigns(slot_float_feasigns,
@@ -1207,6 +1207,8 @@ class DataFeed {
   virtual void SetParseLogKey(bool parse_logkey UNUSED) {}
   virtual void SetEnablePvMerge(bool enable_pv_merge UNUSED) {}
   virtual void SetCurrentPhase(int current_phase UNUSED) {}
+  // This function will do nothing at default
+  virtual void SetDataCacheDir(const std::string& cache_dir UNUSED) {}
 #if defined(PADDLE_WITH_PSCORE) && defined(PADDLE_WITH_HETERPS)
   virtual void InitGraphResource() {}
   virtual void InitGraphTrainResource() {}
@@ -1991,7 +1993,14 @@ class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
   void SetInputChannel(void* channel) override {
     input_channel_ = static_cast<ChannelObject<SlotRecord>*>(channel);
   }
+  // Cache the records parsed from every file in cache_dir, and load the
+  // cache instead of parsing the file again when the file is loaded later.
+  void SetDataCacheDir(const std::string& cache_dir) override {
+    data_cache_dir_ = cache_dir;
+  }
   bool ParseOneInstance(const std::string& line, SlotRecord* rec);
+  // str must be followed by a '\0', len excludes it.
+  bool ParseOneInstance(const char* str, size_t len, SlotRecord* rec);
   void PutToFeedVec(const SlotRecord* ins_vec, int num) override;
   void AssignFeedVar(const Scope& scope) override;
   std::vector<std::string> GetInputVarNames() override {
@@ -2052,7 +2061,14 @@ class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
   void DumpWalkPath(std::string dump_path, size_t dump_rate) override;
   void DumpSampleNeighbors(std::string dump_path) override;
 
+  // Empty if the records of filename can not be cached.
+  std::string GetDataCacheKey(const std::string& filename) const;
+  bool LoadIntoMemoryFromCache(const std::string& cache_path,
+                               const std::string& cache_key,
+                               uint64_t* record_num);
+
   float sample_rate_ = 1.0f;
+  std::string data_cache_dir_;
   int use_slot_size_ = 0;
   int float_use_slot_size_ = 0;
   int uint64_use_slot_size_ = 0;
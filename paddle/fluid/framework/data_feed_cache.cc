@@ -0,0 +1,422 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/data_feed_cache.h"
+
+#include <cstring>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "glog/logging.h"
+#include "paddle/common/enforce.h"
+#include "paddle/fluid/framework/data_feed.h"
+
+namespace paddle::framework {
+
+namespace {
+
+// "PDSLOTC1"
+constexpr uint64_t kCacheMagic = 0x3143544f4c534450ULL;
+constexpr uint32_t kCacheVersion = 1;
+
+struct CacheHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t uint64_slot_num;
+  uint32_t float_slot_num;
+  uint32_t reserved;
+  // followed by the key, padded to 8 bytes
+  uint64_t key_size;
+};
+
+struct BlockHeader {
+  uint64_t record_num;
+  // the bytes of the block after this header
+  uint64_t size;
+  uint64_t uint64_value_num;
+  uint64_t float_value_num;
+  uint64_t ins_id_size;
+};
+
+struct CacheFooter {
+  uint64_t block_num;
+  uint64_t record_num;
+  uint64_t magic;
+};
+
+inline uint64_t Align8(uint64_t size) { return (size + 7) & ~7ULL; }
+
+// The bytes of the columns of a block, in the order they are stored.
+struct BlockLayout {
+  BlockLayout(const BlockHeader& header,
+              int uint64_slot_num,
+              int float_slot_num) {
+    uint64_t n = header.record_num;
+    search_ids = 0;
+    ranks = search_ids + n * sizeof(uint64_t);
+    cmatches = ranks + n * sizeof(uint32_t);
+    ins_id_offsets = Align8(cmatches + n * sizeof(uint32_t));
+    ins_ids = ins_id_offsets + (n + 1) * sizeof(uint64_t);
+    uint64_offsets = Align8(ins_ids + header.ins_id_size);
+    uint64_values =
+        Align8(uint64_offsets + n * (uint64_slot_num + 1) * sizeof(uint32_t));
+    float_offsets = uint64_values + header.uint64_value_num * sizeof(uint64_t);
+    float_values =
+        Align8(float_offsets + n * (float_slot_num + 1) * sizeof(uint32_t));
+    size = Align8(float_values + header.float_value_num * sizeof(float));
+  }
+
+  uint64_t search_ids;
+  uint64_t ranks;
+  uint64_t cmatches;
+  uint64_t ins_id_offsets;
+  uint64_t ins_ids;
+  uint64_t uint64_offsets;
+  uint64_t uint64_values;
+  uint64_t float_offsets;
+  uint64_t float_values;
+  uint64_t size;
+};
+
+template <typename T>
+void PutSlotOffsets(const SlotValues<T>& values, int slot_num, char* dst) {
+  size_t size = (slot_num + 1) * sizeof(uint32_t);
+  if (values.slot_offsets.empty()) {
+    // a record without any slot of this type
+    memset(dst, 0, size);
+    return;
+  }
+  PADDLE_ENFORCE_EQ(values.slot_offsets.size(),
+                    static_cast<size_t>(slot_num + 1),
+                    common::errors::InvalidArgument(
+                        "The record has %d slots, but the cache expects %d.",
+                        values.slot_offsets.size() - 1,
+                        slot_num));
+  memcpy(dst, values.slot_offsets.data(), size);
+}
+
+template <typename T>
+const char* GetSlotValues(const char* offsets,
+                          const char* values,
+                          int slot_num,
+                          SlotValues<T>* slot_values) {
+  const uint32_t* begin = reinterpret_cast<const uint32_t*>(offsets);
+  slot_values->slot_offsets.assign(begin, begin + slot_num + 1);
+  uint32_t num = begin[slot_num];
+  const T* value_begin = reinterpret_cast<const T*>(values);
+  slot_values->slot_values.assign(value_begin, value_begin + num);
+  return values + num * sizeof(T);
+}
+
+}  // namespace
+
+std::string GetSlotRecordCachePath(const std::string& cache_dir,
+                                   const std::string& key) {
+  // FNV-1a, which is stable across builds
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (unsigned char c : key) {
+    hash = (hash ^ c) * 0x100000001b3ULL;
+  }
+  char name[32];
+  snprintf(name,
+           sizeof(name),
+           "%016llx.slotcache",
+           static_cast<unsigned long long>(hash));  // NOLINT
+  return cache_dir + "/" + name;
+}
+
+SlotRecordCacheWriter::SlotRecordCacheWriter(const std::string& path,
+                                             const std::string& key,
+                                             int uint64_slot_num,
+                                             int float_slot_num)
+    : path_(path),
+      tmp_path_(path + ".tmp"),
+      uint64_slot_num_(uint64_slot_num),
+      float_slot_num_(float_slot_num) {
+#ifndef _WIN32
+  // the caches of a shared cache dir may be written by several processes
+  tmp_path_ += std::to_string(getpid());
+#endif
+  fp_ = fopen(tmp_path_.c_str(), "wb");
+  if (fp_ == nullptr) {
+    LOG(WARNING) << "Fail to create data cache " << tmp_path_
+                 << ", the data is not cached.";
+    failed_ = true;
+    return;
+  }
+  CacheHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = kCacheMagic;
+  header.version = kCacheVersion;
+  header.uint64_slot_num = static_cast<uint32_t>(uint64_slot_num);
+  header.float_slot_num = static_cast<uint32_t>(float_slot_num);
+  header.key_size = key.size();
+  buffer_.assign(reinterpret_cast<const char*>(&header), sizeof(header));
+  buffer_.append(key);
+  buffer_.resize(Align8(buffer_.size()), '\0');
+  failed_ = fwrite(buffer_.data(), 1, buffer_.size(), fp_) != buffer_.size();
+}
+
+SlotRecordCacheWriter::~SlotRecordCacheWriter() { Abort(); }
+
+void SlotRecordCacheWriter::Append(const SlotRecord* records, size_t num) {
+  if (failed_ || num == 0) {
+    return;
+  }
+  BlockHeader header;
+  memset(&header, 0, sizeof(header));
+  header.record_num = num;
+  for (size_t i = 0; i < num; ++i) {
+    const SlotRecordObject& rec = *records[i];
+    header.uint64_value_num += rec.slot_uint64_feasigns_.slot_values.size();
+    header.float_value_num += rec.slot_float_feasigns_.slot_values.size();
+    header.ins_id_size += rec.ins_id_.size();
+  }
+  BlockLayout layout(header, uint64_slot_num_, float_slot_num_);
+  header.size = layout.size;
+
+  buffer_.assign(sizeof(header) + layout.size, '\0');
+  memcpy(&buffer_[0], &header, sizeof(header));
+  char* block = &buffer_[sizeof(header)];
+  auto* search_ids = reinterpret_cast<uint64_t*>(block + layout.search_ids);
+  auto* ranks = reinterpret_cast<uint32_t*>(block + layout.ranks);
+  auto* cmatches = reinterpret_cast<uint32_t*>(block + layout.cmatches);
+  auto* ins_id_offsets =
+      reinterpret_cast<uint64_t*>(block + layout.ins_id_offsets);
+  char* ins_ids = block + layout.ins_ids;
+  char* uint64_offsets = block + layout.uint64_offsets;
+  char* uint64_values = block + layout.uint64_values;
+  char* float_offsets = block + layout.float_offsets;
+  char* float_values = block + layout.float_values;
+
+  uint64_t ins_id_offset = 0;
+  for (size_t i = 0; i < num; ++i) {
+    const SlotRecordObject& rec = *records[i];
+    search_ids[i] = rec.search_id;
+    ranks[i] = rec.rank;
+    cmatches[i] = rec.cmatch;
+    ins_id_offsets[i] = ins_id_offset;
+    memcpy(ins_ids + ins_id_offset, rec.ins_id_.data(), rec.ins_id_.size());
+    ins_id_offset += rec.ins_id_.size();
+
+    PutSlotOffsets(
+        rec.slot_uint64_feasigns_, uint64_slot_num_, uint64_offsets);
+    uint64_offsets += (uint64_slot_num_ + 1) * sizeof(uint32_t);
+    const auto& uint64_feasigns = rec.slot_uint64_feasigns_.slot_values;
+    size_t uint64_size = uint64_feasigns.size() * sizeof(uint64_t);
+    if (uint64_size > 0) {
+      memcpy(uint64_values, uint64_feasigns.data(), uint64_size);
+    }
+    uint64_values += uint64_size;
+
+    PutSlotOffsets(rec.slot_float_feasigns_, float_slot_num_, float_offsets);
+    float_offsets += (float_slot_num_ + 1) * sizeof(uint32_t);
+    const auto& float_feasigns = rec.slot_float_feasigns_.slot_values;
+    size_t float_size = float_feasigns.size() * sizeof(float);
+    if (float_size > 0) {
+      memcpy(float_values, float_feasigns.data(), float_size);
+    }
+    float_values += float_size;
+  }
+  ins_id_offsets[num] = ins_id_offset;
+
+  if (fwrite(buffer_.data(), 1, buffer_.size(), fp_) != buffer_.size()) {
+    LOG(WARNING) << "Fail to write data cache " << tmp_path_
+                 << ", the data is not cached.";
+    failed_ = true;
+    return;
+  }
+  ++block_num_;
+  record_num_ += num;
+}
+
+bool SlotRecordCacheWriter::Finish() {
+  if (failed_) {
+    Abort();
+    return false;
+  }
+  CacheFooter footer;
+  footer.block_num = block_num_;
+  footer.record_num = record_num_;
+  footer.magic = kCacheMagic;
+  bool ok = fwrite(&footer, sizeof(footer), 1, fp_) == 1;
+  ok = (fclose(fp_) == 0) && ok;
+  fp_ = nullptr;
+  if (ok && rename(tmp_path_.c_str(), path_.c_str()) == 0) {
+    VLOG(3) << "write data cache " << path_ << ", records=" << record_num_
+            << ", blocks=" << block_num_;
+    return true;
+  }
+  LOG(WARNING) << "Fail to finish data cache " << path_
+               << ", the data is not cached.";
+  failed_ = true;
+  remove(tmp_path_.c_str());
+  return false;
+}
+
+void SlotRecordCacheWriter::Abort() {
+  if (fp_ != nullptr) {
+    fclose(fp_);
+    fp_ = nullptr;
+    remove(tmp_path_.c_str());
+  }
+}
+
+SlotRecordCacheReader::~SlotRecordCacheReader() { Close(); }
+
+void SlotRecordCacheReader::Close() {
+#ifndef _WIN32
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+#endif
+  data_ = nullptr;
+  size_ = 0;
+  offset_ = 0;
+  end_ = 0;
+  record_num_ = 0;
+}
+
+bool SlotRecordCacheReader::Open(const std::string& path,
+                                 const std::string& key,
+                                 int uint64_slot_num,
+                                 int float_slot_num) {
+  Close();
+#ifdef _WIN32
+  return false;
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<uint64_t>(st.st_size) <
+          sizeof(CacheHeader) + sizeof(CacheFooter)) {
+    close(fd);
+    return false;
+  }
+  void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) {
+    return false;
+  }
+  madvise(p, st.st_size, MADV_SEQUENTIAL);
+  data_ = reinterpret_cast<const char*>(p);
+  size_ = st.st_size;
+  uint64_slot_num_ = uint64_slot_num;
+  float_slot_num_ = float_slot_num;
+
+  CacheHeader header;
+  memcpy(&header, data_, sizeof(header));
+  CacheFooter footer;
+  end_ = size_ - sizeof(footer);
+  memcpy(&footer, data_ + end_, sizeof(footer));
+  offset_ = Align8(sizeof(header) + header.key_size);
+  if (header.magic != kCacheMagic || header.version != kCacheVersion ||
+      footer.magic != kCacheMagic ||
+      header.uint64_slot_num != static_cast<uint32_t>(uint64_slot_num) ||
+      header.float_slot_num != static_cast<uint32_t>(float_slot_num) ||
+      header.key_size != key.size() || offset_ > end_ ||
+      memcmp(data_ + sizeof(header), key.data(), key.size()) != 0) {
+    VLOG(3) << "data cache " << path << " does not match, ignore it";
+    Close();
+    return false;
+  }
+  // check the block chain, so that a broken cache is never read
+  uint64_t offset = offset_;
+  uint64_t block_num = 0;
+  uint64_t record_num = 0;
+  while (end_ - offset >= sizeof(BlockHeader)) {
+    BlockHeader block;
+    memcpy(&block, data_ + offset, sizeof(block));
+    BlockLayout layout(block, uint64_slot_num, float_slot_num);
+    if (block.size != layout.size ||
+        block.size > end_ - offset - sizeof(block)) {
+      break;
+    }
+    offset += sizeof(block) + block.size;
+    ++block_num;
+    record_num += block.record_num;
+  }
+  if (offset != end_ || block_num != footer.block_num ||
+      record_num != footer.record_num) {
+    LOG(WARNING) << "data cache " << path << " is broken, ignore it";
+    Close();
+    return false;
+  }
+  record_num_ = record_num;
+  return true;
+#endif
+}
+
+size_t SlotRecordCacheReader::NextBlockSize() const {
+  if (data_ == nullptr || offset_ >= end_) {
+    return 0;
+  }
+  BlockHeader header;
+  memcpy(&header, data_ + offset_, sizeof(header));
+  return header.record_num;
+}
+
+void SlotRecordCacheReader::ReadBlock(SlotRecord* records) {
+  PADDLE_ENFORCE_LT(offset_,
+                    end_,
+                    common::errors::OutOfRange(
+                        "There is no more block in the data cache."));
+  BlockHeader header;
+  memcpy(&header, data_ + offset_, sizeof(header));
+  BlockLayout layout(header, uint64_slot_num_, float_slot_num_);
+  const char* block = data_ + offset_ + sizeof(header);
+  const auto* search_ids =
+      reinterpret_cast<const uint64_t*>(block + layout.search_ids);
+  const auto* ranks = reinterpret_cast<const uint32_t*>(block + layout.ranks);
+  const auto* cmatches =
+      reinterpret_cast<const uint32_t*>(block + layout.cmatches);
+  const auto* ins_id_offsets =
+      reinterpret_cast<const uint64_t*>(block + layout.ins_id_offsets);
+  const char* ins_ids = block + layout.ins_ids;
+  const char* uint64_offsets = block + layout.uint64_offsets;
+  const char* uint64_values = block + layout.uint64_values;
+  const char* float_offsets = block + layout.float_offsets;
+  const char* float_values = block + layout.float_values;
+
+  for (uint64_t i = 0; i < header.record_num; ++i) {
+    SlotRecordObject& rec = *records[i];
+    rec.search_id = search_ids[i];
+    rec.rank = ranks[i];
+    rec.cmatch = cmatches[i];
+    rec.ins_id_.assign(ins_ids + ins_id_offsets[i],
+                       ins_id_offsets[i + 1] - ins_id_offsets[i]);
+    uint64_values = GetSlotValues(uint64_offsets,
+                                  uint64_values,
+                                  uint64_slot_num_,
+                                  &rec.slot_uint64_feasigns_);
+    uint64_offsets += (uint64_slot_num_ + 1) * sizeof(uint32_t);
+    float_values = GetSlotValues(float_offsets,
+                                 float_values,
+                                 float_slot_num_,
+                                 &rec.slot_float_feasigns_);
+    float_offsets += (float_slot_num_ + 1) * sizeof(uint32_t);
+  }
+  offset_ += sizeof(header) + header.size;
+}
+
+}  // namespace paddle::framework
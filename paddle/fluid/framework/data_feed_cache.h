@@ -0,0 +1,123 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "paddle/common/macros.h"
+
+namespace paddle {
+namespace framework {
+
+struct SlotRecordObject;
+using SlotRecord = SlotRecordObject*;
+
+// A binary cache of the SlotRecords parsed from one data file, so that the
+// next passes over the same file load the records without parsing text.
+//
+// The file is made of a header, blocks of records and a footer. Each block is
+// stored column by column: search ids, ranks, cmatches, ins ids, and the slot
+// offsets and values of the uint64 and float feasigns, so a block is loaded
+// with one bulk copy per column and record. The header keeps a key, e.g. the
+// source file name and the slot layout, and a cache is only used when the key
+// matches. The footer is written last, so an interrupted cache is never used.
+//
+//   SlotRecordCacheWriter writer(path, key, uint64_slot_num, float_slot_num);
+//   writer.Append(records, num);  // one block
+//   writer.Finish();
+//
+//   SlotRecordCacheReader reader;
+//   if (reader.Open(path, key, uint64_slot_num, float_slot_num)) {
+//     size_t num = 0;
+//     while ((num = reader.NextBlockSize()) > 0) {
+//       reader.ReadBlock(records);  // num records
+//     }
+//   }
+class SlotRecordCacheWriter {
+ public:
+  // The records are written to a temporary file which is renamed to path by
+  // Finish().
+  SlotRecordCacheWriter(const std::string& path,
+                        const std::string& key,
+                        int uint64_slot_num,
+                        int float_slot_num);
+  ~SlotRecordCacheWriter();
+
+  // Append num records as one block.
+  void Append(const SlotRecord* records, size_t num);
+  // Return false if the cache can not be written, e.g. the disk is full.
+  bool Finish();
+
+  uint64_t record_num() const { return record_num_; }
+
+ private:
+  void Abort();
+
+  std::string path_;
+  std::string tmp_path_;
+  FILE* fp_ = nullptr;
+  int uint64_slot_num_;
+  int float_slot_num_;
+  uint64_t block_num_ = 0;
+  uint64_t record_num_ = 0;
+  bool failed_ = false;
+  std::string buffer_;
+
+  DISABLE_COPY_AND_ASSIGN(SlotRecordCacheWriter);
+};
+
+class SlotRecordCacheReader {
+ public:
+  SlotRecordCacheReader() = default;
+  ~SlotRecordCacheReader();
+
+  // Map the cache at path. Return false if it does not exist, is incomplete
+  // or was written for another key or slot layout.
+  bool Open(const std::string& path,
+            const std::string& key,
+            int uint64_slot_num,
+            int float_slot_num);
+
+  uint64_t record_num() const { return record_num_; }
+  uint64_t file_size() const { return size_; }
+
+  // The number of records of the next block, 0 at the end of the cache.
+  size_t NextBlockSize() const;
+  // Fill records with the next block, which has NextBlockSize() records.
+  void ReadBlock(SlotRecord* records);
+
+ private:
+  void Close();
+
+  const char* data_ = nullptr;
+  uint64_t size_ = 0;
+  uint64_t offset_ = 0;
+  uint64_t end_ = 0;
+  uint64_t record_num_ = 0;
+  int uint64_slot_num_ = 0;
+  int float_slot_num_ = 0;
+
+  DISABLE_COPY_AND_ASSIGN(SlotRecordCacheReader);
+};
+
+// The name of the cache of a data file in cache_dir, which is derived from
+// the key.
+std::string GetSlotRecordCachePath(const std::string& cache_dir,
+                                   const std::string& key);
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,208 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Number parsers and token skipping for the MultiSlot text format, i.e.
+// "<num> <feasign> ... <num> <feasign> ..." lines separated by spaces.
+//
+// The parsers take the common decimal forms without locale lookups, and fall
+// back to strtol/strtoull/strtof for any other form (exponents, hex, inf,
+// overflow, ...), so the results and end pointers are always the same as the
+// ones of the C library functions used before.
+
+namespace paddle {
+namespace framework {
+
+namespace data_feed_parser_detail {
+
+inline bool IsDigit(char c) { return static_cast<unsigned>(c - '0') < 10; }
+
+// The characters that may follow a number parsed by the fast paths. Any
+// other character means the number has a form that the fast path does not
+// handle, e.g. "1e5" or "0x1f".
+inline bool IsNumberEnd(char c) {
+  return c == ' ' || c == '\0' || c == '\n' || c == '\t' || c == '\r';
+}
+
+inline const char* SkipBlanks(const char* str) {
+  while (*str == ' ' || *str == '\t') {
+    ++str;
+  }
+  return str;
+}
+
+// Parse the digits of a uint64_t. Return nullptr if the value overflows.
+inline const char* ParseDigits(const char* str, uint64_t* value) {
+  // 19 digits never overflow
+  constexpr int kSafeDigits = 19;
+  constexpr uint64_t kMaxDiv10 = UINT64_MAX / 10;
+  constexpr uint64_t kMaxMod10 = UINT64_MAX % 10;
+  uint64_t v = 0;
+  const char* begin = str;
+  while (IsDigit(*str) && str - begin < kSafeDigits) {
+    v = v * 10 + static_cast<uint64_t>(*str - '0');
+    ++str;
+  }
+  if (IsDigit(*str)) {
+    uint64_t digit = static_cast<uint64_t>(*str - '0');
+    if (v > kMaxDiv10 || (v == kMaxDiv10 && digit > kMaxMod10) ||
+        IsDigit(str[1])) {
+      return nullptr;
+    }
+    v = v * 10 + digit;
+    ++str;
+  }
+  *value = v;
+  return str;
+}
+
+}  // namespace data_feed_parser_detail
+
+// Same as strtoull(str, endptr, 10).
+inline uint64_t FastStrToUint64(const char* str, char** endptr) {
+  namespace detail = data_feed_parser_detail;
+  const char* p = detail::SkipBlanks(str);
+  uint64_t value = 0;
+  const char* end = nullptr;
+  if (detail::IsDigit(*p)) {
+    end = detail::ParseDigits(p, &value);
+  }
+  if (end == nullptr || !detail::IsNumberEnd(*end)) {
+    return strtoull(str, endptr, 10);
+  }
+  *endptr = const_cast<char*>(end);
+  return value;
+}
+
+// Same as strtol(str, endptr, 10), for the slot sizes.
+inline int FastStrToInt(const char* str, char** endptr) {
+  namespace detail = data_feed_parser_detail;
+  const char* p = detail::SkipBlanks(str);
+  uint64_t value = 0;
+  const char* end = nullptr;
+  if (detail::IsDigit(*p)) {
+    end = detail::ParseDigits(p, &value);
+  }
+  if (end == nullptr || !detail::IsNumberEnd(*end) || value > INT32_MAX) {
+    return static_cast<int>(strtol(str, endptr, 10));
+  }
+  *endptr = const_cast<char*>(end);
+  return static_cast<int>(value);
+}
+
+// Same as strtof(str, endptr) in the "C" locale with the default rounding
+// mode. [-+]digits[.digits] with at most 16 significant digits and at most
+// 22 fractional digits is computed as one correctly rounded double division,
+// which rounds to the same float as strtof unless the double lands exactly
+// on the midpoint of two floats; that case and all other forms fall back.
+inline float FastStrToFloat(const char* str, char** endptr) {
+  namespace detail = data_feed_parser_detail;
+  static const double kPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                  1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                  1e18, 1e19, 1e20, 1e21, 1e22};
+  constexpr uint64_t kMaxExactMantissa = static_cast<uint64_t>(1) << 53;
+
+  const char* p = detail::SkipBlanks(str);
+  bool negative = *p == '-';
+  if (*p == '-' || *p == '+') {
+    ++p;
+  }
+  uint64_t mantissa = 0;
+  int digits = 0;
+  int fraction_digits = 0;
+  const char* q = p;
+  for (; detail::IsDigit(*q) && digits < 17; ++q, ++digits) {
+    mantissa = mantissa * 10 + static_cast<uint64_t>(*q - '0');
+  }
+  if (*q == '.') {
+    ++q;
+    for (; detail::IsDigit(*q) && digits < 17; ++q, ++digits) {
+      mantissa = mantissa * 10 + static_cast<uint64_t>(*q - '0');
+      ++fraction_digits;
+    }
+  }
+  if (digits == 0 || digits == 17 || fraction_digits > 22 ||
+      mantissa > kMaxExactMantissa || !detail::IsNumberEnd(*q)) {
+    return strtof(str, endptr);
+  }
+
+  double value = static_cast<double>(mantissa) / kPow10[fraction_digits];
+  float result = static_cast<float>(value);
+  double rounded = result;
+  if (rounded != value) {
+    double other = std::nextafter(
+        result,
+        value > rounded ? HUGE_VALF : -HUGE_VALF);  // the other neighbour
+    if ((rounded + other) / 2 == value) {
+      return strtof(str, endptr);
+    }
+  }
+  *endptr = const_cast<char*>(q);
+  return negative ? -result : result;
+}
+
+// Skip num tokens separated by spaces from str, and return the position
+// right after the last one, i.e. a space or end. With SSE2, the token starts
+// of 16 bytes are counted at once.
+inline const char* SkipSlotTokens(const char* str, const char* end, int num) {
+  const char* p = str;
+  // whether the byte before p is a space, str is the start of a token
+  bool after_space = true;
+#if defined(__SSE2__)
+  const __m128i spaces = _mm_set1_epi8(' ');
+  while (num > 0 && end - p >= 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    uint32_t space_mask = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(block, spaces)));
+    // a token starts at a non-space byte right after a space
+    uint32_t start_mask =
+        ~space_mask & ((space_mask << 1) | (after_space ? 1 : 0)) & 0xffff;
+    int count = __builtin_popcount(start_mask);
+    if (count >= num) {
+      break;
+    }
+    num -= count;
+    after_space = (space_mask >> 15) != 0;
+    p += 16;
+  }
+#endif
+  // the token at p, if any, is already counted
+  if (!after_space) {
+    while (p < end && *p != ' ') {
+      ++p;
+    }
+  }
+  for (int i = 0; i < num; ++i) {
+    while (p < end && *p == ' ') {
+      ++p;
+    }
+    while (p < end && *p != ' ') {
+      ++p;
+    }
+  }
+  return p;
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -188,6 +188,12 @@ void DatasetImpl<T>::SetParseLogKey(bool parse_logkey) {
   parse_logkey_ = parse_logkey;
 }
 
+template <typename T>
+void DatasetImpl<T>::SetDataCacheDir(const std::string& cache_dir) {
+  localfs_mkdir(cache_dir);
+  data_cache_dir_ = cache_dir;
+}
+
 template <typename T>
 void DatasetImpl<T>::SetMergeByInsId(int merge_size) {
   merge_by_ins_id_ = true;
@@ -1182,6 +1188,7 @@ void DatasetImpl<T>::CreateReaders() {
     readers_[i]->SetParseUid(parse_uid_);
     readers_[i]->SetParseContent(parse_content_);
     readers_[i]->SetParseLogKey(parse_logkey_);
+    readers_[i]->SetDataCacheDir(data_cache_dir_);
     readers_[i]->SetEnablePvMerge(enable_pv_merge_);
     // Notice: it is only valid for untest of test_paddlebox_datafeed.
     // In fact, it does not affect the train process when paddle is
@@ -1262,6 +1269,7 @@ void DatasetImpl<T>::CreatePreLoadReaders() {
     preload_readers_[i]->SetParseUid(parse_uid_);
     preload_readers_[i]->SetParseContent(parse_content_);
     preload_readers_[i]->SetParseLogKey(parse_logkey_);
+    preload_readers_[i]->SetDataCacheDir(data_cache_dir_);
     preload_readers_[i]->SetEnablePvMerge(enable_pv_merge_);
     preload_readers_[i]->SetInputChannel(input_channel_.get());
     preload_readers_[i]->SetOutputChannel(nullptr);
@@ -2036,6 +2044,7 @@ void SlotRecordDataset::CreateReaders() {
     readers_[i]->SetParseInsId(parse_ins_id_);
     readers_[i]->SetParseContent(parse_content_);
     readers_[i]->SetParseLogKey(parse_logkey_);
+    readers_[i]->SetDataCacheDir(data_cache_dir_);
     readers_[i]->SetEnablePvMerge(enable_pv_merge_);
     readers_[i]->SetCurrentPhase(current_phase_);
 #if defined(PADDLE_WITH_PSCORE) && defined(PADDLE_WITH_HETERPS)
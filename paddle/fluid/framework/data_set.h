@@ -83,6 +83,9 @@ class Dataset {
   virtual void SetParseInsId(bool parse_ins_id) = 0;
   virtual void SetParseContent(bool parse_content) = 0;
   virtual void SetParseLogKey(bool parse_logkey) = 0;
+  // set the local dir that caches the parsed records of every file, so that
+  // loading the same files again skips parsing, empty means no cache
+  virtual void SetDataCacheDir(const std::string& cache_dir) = 0;
   virtual void SetEnablePvMerge(bool enable_pv_merge) = 0;
   virtual bool EnablePvMerge() = 0;
   virtual void SetMergeBySid(bool is_merge) = 0;
@@ -213,6 +216,7 @@ class DatasetImpl : public Dataset {
   virtual void SetParseInsId(bool parse_ins_id);
   virtual void SetParseContent(bool parse_content);
   virtual void SetParseLogKey(bool parse_logkey);
+  virtual void SetDataCacheDir(const std::string& cache_dir);
   virtual void SetEnablePvMerge(bool enable_pv_merge);
   virtual void SetMergeBySid(bool is_merge);
   virtual void SetShuffleByUid(bool enable_shuffle_uid);
@@ -352,6 +356,7 @@ class DatasetImpl : public Dataset {
   bool parse_ins_id_;
   bool parse_content_;
   bool parse_logkey_;
+  std::string data_cache_dir_;
   bool merge_by_sid_;
   bool shuffle_by_uid_;
   bool parse_uid_;
@@ -0,0 +1,199 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include "paddle/common/macros.h"
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace framework {
+
+// A bounded lock-free multi-producer multi-consumer queue.
+//
+// Every cell of the ring has a sequence number telling which position it is
+// ready for: a cell is free for position pos when its sequence is pos, and
+// holds the value of position pos when its sequence is pos + 1. Producers and
+// consumers claim a run of consecutive ready cells with one CAS on the tail or
+// the head, so a batch of n values costs one atomic read-modify-write instead
+// of n.
+//
+// The ring has a power of two cells, and at most capacity() values are queued
+// at once, capacity() may be changed between 1 and ring_size().
+//
+// TryPush and TryPop never block, blocking is left to the caller, see
+// ChannelObject.
+template <class T>
+class MPMCRingBuffer {
+ public:
+  explicit MPMCRingBuffer(size_t capacity) {
+    PADDLE_ENFORCE_GE(capacity,
+                      1,
+                      common::errors::InvalidArgument(
+                          "The capacity of a lock-free channel must be "
+                          "greater than or equal to 1, but got %d.",
+                          capacity));
+    PADDLE_ENFORCE_LE(capacity,
+                      kMaxRingSize,
+                      common::errors::InvalidArgument(
+                          "The capacity of a lock-free channel must be less "
+                          "than or equal to %d, but got %d.",
+                          kMaxRingSize,
+                          capacity));
+    size_t ring_size = 1;
+    while (ring_size < capacity) {
+      ring_size <<= 1;
+    }
+    mask_ = ring_size - 1;
+    cells_.reset(new Cell[ring_size]);
+    for (size_t i = 0; i < ring_size; ++i) {
+      cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+    capacity_.store(capacity, std::memory_order_relaxed);
+  }
+
+  size_t ring_size() const { return mask_ + 1; }
+
+  size_t capacity() const { return capacity_.load(std::memory_order_relaxed); }
+
+  void set_capacity(size_t capacity) {
+    PADDLE_ENFORCE_EQ(
+        capacity >= 1 && capacity <= ring_size(),
+        true,
+        common::errors::InvalidArgument(
+            "The capacity of a lock-free channel must be in [1, %d], which is "
+            "fixed when the channel is made, but got %d.",
+            ring_size(),
+            capacity));
+    capacity_.store(capacity, std::memory_order_relaxed);
+  }
+
+  // The number of queued values, which may be stale when other threads push
+  // or pop at the same time.
+  size_t Size() const {
+    size_t head = head_.load(std::memory_order_acquire);
+    size_t tail = tail_.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+  }
+
+  // Whether the value at the head is ready to pop.
+  bool CanPop() const {
+    size_t head = head_.load(std::memory_order_acquire);
+    return cells_[head & mask_].seq.load(std::memory_order_acquire) ==
+           head + 1;
+  }
+
+  // Whether one value can be pushed.
+  bool CanPush() const {
+    size_t tail = tail_.load(std::memory_order_acquire);
+    size_t head = head_.load(std::memory_order_acquire);
+    size_t size = tail > head ? tail - head : 0;
+    return size < capacity() &&
+           cells_[tail & mask_].seq.load(std::memory_order_acquire) == tail;
+  }
+
+  // Push at most n values of p, return the number of values pushed, 0 if the
+  // queue is full. U is const T to copy the values, T to move them.
+  template <class U>
+  size_t TryPush(U* p, size_t n) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    while (true) {
+      size_t head = head_.load(std::memory_order_acquire);
+      size_t size = tail > head ? tail - head : 0;
+      size_t cap = capacity();
+      size_t limit = size < cap ? (std::min)(n, cap - size) : 0;
+      size_t k = 0;
+      while (k < limit && cells_[(tail + k) & mask_].seq.load(
+                              std::memory_order_acquire) == tail + k) {
+        ++k;
+      }
+      if (k == 0) {
+        size_t cur = tail_.load(std::memory_order_relaxed);
+        if (cur == tail) {
+          return 0;
+        }
+        tail = cur;
+        continue;
+      }
+      // the k cells stay free until they are claimed
+      if (tail_.compare_exchange_weak(
+              tail, tail + k, std::memory_order_relaxed)) {
+        for (size_t i = 0; i < k; ++i) {
+          Cell& cell = cells_[(tail + i) & mask_];
+          cell.data = std::move(p[i]);
+          cell.seq.store(tail + i + 1, std::memory_order_release);
+        }
+        return k;
+      }
+    }
+  }
+
+  // Pop at most n values to p, return the number of values popped, 0 if the
+  // queue is empty.
+  size_t TryPop(T* p, size_t n) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    while (true) {
+      size_t k = 0;
+      while (k < n && cells_[(head + k) & mask_].seq.load(
+                          std::memory_order_acquire) == head + k + 1) {
+        ++k;
+      }
+      if (k == 0) {
+        size_t cur = head_.load(std::memory_order_relaxed);
+        if (cur == head) {
+          return 0;
+        }
+        head = cur;
+        continue;
+      }
+      if (head_.compare_exchange_weak(
+              head, head + k, std::memory_order_relaxed)) {
+        for (size_t i = 0; i < k; ++i) {
+          Cell& cell = cells_[(head + i) & mask_];
+          p[i] = std::move(cell.data);
+          // free for the same cell of the next lap
+          cell.seq.store(head + i + mask_ + 1, std::memory_order_release);
+        }
+        return k;
+      }
+    }
+  }
+
+ private:
+  static constexpr size_t kMaxRingSize = static_cast<size_t>(1) << 40;
+  static constexpr size_t kCacheLineSize = 64;
+
+  struct Cell {
+    std::atomic<size_t> seq;
+    T data;
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_;
+  std::atomic<size_t> capacity_;
+  // the producers and the consumers do not share cache lines
+  alignas(kCacheLineSize) std::atomic<size_t> head_{0};
+  alignas(kCacheLineSize) std::atomic<size_t> tail_{0};
+  char padding_[kCacheLineSize - sizeof(std::atomic<size_t>)];
+
+  DISABLE_COPY_AND_ASSIGN(MPMCRingBuffer);
+};
+
+}  // namespace framework
+}  // namespace paddle
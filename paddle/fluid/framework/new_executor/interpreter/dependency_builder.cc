@@ -143,6 +143,45 @@ void DependencyBuilder::ShareDependencyFrom(const DependencyBuilder& src) {
   is_build_ = true;
 }
 
+std::vector<size_t> DependencyBuilder::BuildAffinityLanes(
+    size_t op_num) const {
+  PADDLE_ENFORCE_EQ(
+      is_build_,
+      true,
+      common::errors::Unavailable("DependencyBuilder is not yet built"));
+
+  // the downstream map only records op_idx -> posterior ops, reverse it
+  std::vector<std::vector<size_t>> upstream_ops(op_num);
+  for (auto& item : *op_downstream_map_) {
+    for (size_t next_op_idx : item.second) {
+      upstream_ops[next_op_idx].push_back(item.first);
+    }
+  }
+
+  std::vector<size_t> lanes(op_num, 0);
+  std::vector<bool> lane_handed_over(op_num, false);
+  size_t lane_num = 0;
+  // op_idx is a topological order, so every upstream op has got its lane
+  for (size_t op_idx = 0; op_idx < op_num; ++op_idx) {
+    size_t inherit_from = ULLONG_MAX;
+    for (size_t prior_op_idx : upstream_ops[op_idx]) {
+      if (!lane_handed_over[prior_op_idx] &&
+          (inherit_from == ULLONG_MAX || prior_op_idx > inherit_from)) {
+        inherit_from = prior_op_idx;
+      }
+    }
+    if (inherit_from != ULLONG_MAX) {
+      lanes[op_idx] = lanes[inherit_from];
+      lane_handed_over[inherit_from] = true;
+    } else {
+      lanes[op_idx] = lane_num++;
+    }
+  }
+  VLOG(6) << "Build " << lane_num << " affinity lanes for " << op_num
+          << " ops";
+  return lanes;
+}
+
 const std::string& DependencyBuilder::GetInstructionName(size_t op_idx) const {
   return (*instructions_)[op_idx].OpBase()->Type();
 }
@@ -58,6 +58,13 @@ class DependencyBuilder {
 
   void ShareDependencyFrom(const DependencyBuilder& src);
 
+  // Assign each of the op_num ops an affinity lane along the downstream map:
+  // an op inherits the lane of its latest upstream op that has not handed its
+  // lane to another downstream op yet, otherwise it opens a new lane. So a
+  // producer-consumer chain shares one lane, and the scheduler can keep it on
+  // one thread to reuse the producer's output while it is still in cache.
+  std::vector<size_t> BuildAffinityLanes(size_t op_num) const;
+
   bool IsSameDeviceContext(size_t op1, size_t op2) const {
     return &((*instructions_)[op1].DeviceContext()) ==
            &((*instructions_)[op2].DeviceContext());
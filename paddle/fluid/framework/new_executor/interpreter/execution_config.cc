@@ -14,11 +14,13 @@
 
 #include "paddle/fluid/framework/new_executor/interpreter/execution_config.h"
 
+#include <algorithm>
 #include <set>
 #include <thread>
 
 #include "paddle/common/flags.h"
 #include "paddle/fluid/platform/device/ipu/ipu_info.h"
+#include "paddle/phi/backends/cpu/intra_op_thread_pool.h"
 #include "paddle/phi/backends/device_manager.h"
 #include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/backends/xpu/xpu_info.h"
@@ -62,6 +64,16 @@ inline std::tuple<int, int> GetThreadPoolConfig(const phi::Place& place,
   if (phi::is_cpu_place(place)) {
     num_device_threads = 0;
     num_host_threads = 4;
+    // The cpu kernels run on the intra-op threads as well, keep the host
+    // threads times the intra-op threads within the processors.
+    int intra_op_threads =
+        phi::backends::cpu::IntraOpThreadPool::GetInstance()->NumThreads();
+    processor_count = static_cast<int>(std::thread::hardware_concurrency());
+    if (intra_op_threads > 1 && processor_count) {
+      num_host_threads =
+          std::min(std::max(processor_count / intra_op_threads, 1),
+                   static_cast<int>(kHostNumThreads));
+    }
   } else {
     processor_count = static_cast<int>(std::thread::hardware_concurrency());
     if (processor_count) {
@@ -34,6 +34,7 @@
 #include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
 #include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
 #include "paddle/fluid/pir/dialect/operator/utils/op_yaml_info_parser.h"
+#include "paddle/phi/backends/cpu/intra_op_thread_pool.h"
 #include "paddle/phi/core/distributed/comm_context_manager.h"
 #include "paddle/phi/core/framework/framework.pb.h"
 #include "paddle/phi/core/kernel_context.h"
@@ -53,6 +54,7 @@
 #endif
 
 COMMON_DECLARE_bool(use_mkldnn);
+COMMON_DECLARE_int32(cpu_thread_pool_numa_node);
 COMMON_DECLARE_bool(check_nan_inf);
 COMMON_DECLARE_string(static_runtime_data_save_path);
 COMMON_DECLARE_bool(save_static_runtime_data);
@@ -104,6 +106,7 @@ const std::vector<WorkQueueOptions> ConstructWorkQueueOptions(
                              /*track_task*/ false,
                              /*detached*/ true,
                              /*events_waiter*/ waiter);
+  group_options.back().numa_node = FLAGS_cpu_thread_pool_numa_node;
   // for launch device Kernel
   group_options.emplace_back(/*name*/ "DeviceKernelLaunch",
                              /*num_threads*/ device_num_threads,
@@ -122,13 +125,44 @@ AsyncWorkQueue::AsyncWorkQueue(size_t host_num_threads,
       queue_group_(CreateWorkQueueGroup(ConstructWorkQueueOptions(
           host_num_threads, device_num_threads, waiter))) {}
 
+// The intra-op threads are set per thread, the tasks run on the host
+// threads with the ones of the thread that adds them.
+static void WithIntraOpThreads(std::function<void()>* fn) {
+  auto* intra_op_pool = phi::backends::cpu::IntraOpThreadPool::GetInstance();
+  int intra_op_threads = intra_op_pool->NumThreads();
+  if (intra_op_threads <= 1) {
+    return;
+  }
+  *fn = [intra_op_pool, intra_op_threads, fn = std::move(*fn)]() {
+    int outer = intra_op_pool->NumThreads();
+    intra_op_pool->SetNumThreads(intra_op_threads);
+    fn();
+    intra_op_pool->SetNumThreads(outer);
+  };
+}
+
 void AsyncWorkQueue::AddTask(const OpFuncType& op_func_type,
                              std::function<void()> fn) {
+  WithIntraOpThreads(&fn);
   // queue_idx=0 : kCpuSync or kGpuSync
   // queue_idx=1 : kGPUAsync
   queue_group_->AddTask(op_func_type == OpFuncType::kGpuAsync, std::move(fn));
 }
 
+void AsyncWorkQueue::AddTasksWithHint(const OpFuncType& op_func_type,
+                                      std::function<void()>* fns,
+                                      const int* thread_hints,
+                                      size_t num) {
+  if (num == 0) {
+    return;
+  }
+  for (size_t i = 0; i < num; ++i) {
+    WithIntraOpThreads(&fns[i]);
+  }
+  queue_group_->AddTasksWithHint(
+      op_func_type == OpFuncType::kGpuAsync, fns, thread_hints, num);
+}
+
 bool IsCommunicationOp(const OperatorBase* op) {
   const std::string& op_name = op->Type();
   const std::set<std::string> special_comm_op_set = {
@@ -1560,4 +1594,26 @@ std::unordered_map<std::string, std::set<std::string>> GetNoNeedBufferValues(
   return shadow_output_values;
 }
 
+std::vector<uint64_t> CalculateCriticalPathTime(
+    const std::vector<size_t>& topo_order,
+    const std::map<size_t, std::set<size_t>>& op_downstream_map,
+    const std::vector<uint64_t>& run_time_ns) {
+  std::vector<uint64_t> critical_path_ns(run_time_ns.size(), 0);
+  // walk the topological order backward so that all downstream ops are done
+  // before their upstream
+  for (auto it = topo_order.rbegin(); it != topo_order.rend(); ++it) {
+    size_t op_idx = *it;
+    uint64_t longest_downstream_path = 0;
+    auto downstream_it = op_downstream_map.find(op_idx);
+    if (downstream_it != op_downstream_map.end()) {
+      for (size_t next_op_idx : downstream_it->second) {
+        longest_downstream_path =
+            std::max(longest_downstream_path, critical_path_ns[next_op_idx]);
+      }
+    }
+    critical_path_ns[op_idx] = run_time_ns[op_idx] + longest_downstream_path;
+  }
+  return critical_path_ns;
+}
+
 }  // namespace paddle::framework::interpreter
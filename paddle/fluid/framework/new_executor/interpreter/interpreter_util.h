@@ -55,6 +55,12 @@ class AsyncWorkQueue {
 
   void AddTask(const OpFuncType& op_func_type, std::function<void()> fn);
 
+  // Batched version of AddTask, see WorkQueueGroup::AddTasksWithHint.
+  void AddTasksWithHint(const OpFuncType& op_func_type,
+                        std::function<void()>* fns,
+                        const int* thread_hints,
+                        size_t num);
+
   void Cancel() { queue_group_->Cancel(); }
 
   size_t QueueNumThreads(size_t idx) {
@@ -144,6 +150,14 @@ const std::vector<std::string> GetInstructionCallStack(
 std::unordered_map<std::string, std::set<std::string>> GetNoNeedBufferValues(
     const std::unordered_map<std::string, std::shared_ptr<::pir::Program>>&
         type_to_ir_program);
+
+// Return the longest remaining path of every op, i.e. its own run time plus
+// the longest remaining path of its downstream ops. topo_order must be a
+// topological order of all ops in op_downstream_map.
+std::vector<uint64_t> CalculateCriticalPathTime(
+    const std::vector<size_t>& topo_order,
+    const std::map<size_t, std::set<size_t>>& op_downstream_map,
+    const std::vector<uint64_t>& run_time_ns);
 }  // namespace interpreter
 }  // namespace framework
 }  // namespace paddle
@@ -45,6 +45,8 @@ PD_DECLARE_bool(new_executor_use_local_scope);
 COMMON_DECLARE_bool(check_nan_inf);
 COMMON_DECLARE_bool(benchmark);
 COMMON_DECLARE_uint64(executor_log_deps_every_microseconds);
+COMMON_DECLARE_bool(new_executor_locality_aware_schedule);
+COMMON_DECLARE_bool(new_executor_critical_path_schedule);
 COMMON_DECLARE_bool(new_executor_use_cuda_graph);
 COMMON_DECLARE_bool(enable_pir_in_executor);
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -31,6 +31,7 @@
 #include "paddle/phi/core/platform/profiler/event_tracing.h"
 #include "paddle/phi/core/sparse_coo_tensor.h"
 #include "paddle/phi/core/sparse_csr_tensor.h"
+#include "paddle/utils/small_vector.h"
 
 #ifdef PADDLE_WITH_DNNL
 #include "paddle/fluid/framework/new_executor/instruction/onednn/onednn_instruction.h"
@@ -98,6 +99,10 @@ COMMON_DECLARE_bool(pir_interpreter_record_stream_for_gc_cache);
 
 namespace paddle::framework {
 
+// Most instructions have only a few ready successors at a time, this keeps the
+// bookkeeping of a dispatch batch on the stack.
+constexpr size_t kAffinityDispatchBatchSize = 8;
+
 void RecordLowPrecisionOp(const InstructionBase* instr_node) {
   if (FLAGS_low_precision_op_list) {
     std::string op_name = instr_node->Name();
@@ -1144,6 +1149,11 @@ void PirInterpreter::BuildInstructionDependences() {
       }
     }
   }
+
+  if (FLAGS_new_executor_locality_aware_schedule) {
+    instr_affinity_lanes_ =
+        ir_dependency_builder_.BuildAffinityLanes(instr_num);
+  }
 }
 
 void PirInterpreter::RecordMemcpyD2H(InstructionBase* instr_node) {
@@ -1549,6 +1559,10 @@ paddle::framework::FetchList PirInterpreter::Run(
       MultiThreadRunImpl();
     }
 
+    if (profile_instr_run_time_) {
+      AnalyseCriticalPathPriority();
+    }
+
     is_build_ = true;
     is_shared_results_build_ = true;
   } else {
@@ -1628,6 +1642,10 @@ FetchList PirInterpreter::Run(const std::vector<std::string>& feed_names,
       MultiThreadRunImpl();
     }
 
+    if (profile_instr_run_time_) {
+      AnalyseCriticalPathPriority();
+    }
+
     is_build_ = true;
     is_shared_results_build_ = true;
   } else {
@@ -1776,18 +1794,27 @@ void PirInterpreter::MultiThreadRunInstructionList(
     }
   }
 
+  bool use_affinity_schedule = FLAGS_new_executor_locality_aware_schedule &&
+                               !FLAGS_new_executor_serial_run;
+  std::vector<size_t> ready_instr_ids;
   for (size_t i = 0; i < dependency_count_->size(); ++i) {
     if ((*dependency_count_)[i] == 0) {
       // NOTE(zhiqiu): hot fix for jit input var
       RecordMemcpyD2H(vec_instr.at(i).get());
       if (FLAGS_new_executor_serial_run) {
         RunInstructionBaseAsync(i);
+      } else if (use_affinity_schedule) {
+        ready_instr_ids.push_back(i);
       } else {
         async_work_queue_->AddTask(vec_instr.at(i)->KernelType(),
                                    [this, i] { RunInstructionBaseAsync(i); });
       }
     }
   }
+  if (!ready_instr_ids.empty()) {
+    DispatchInstructionsWithAffinity(ready_instr_ids.data(),
+                                     ready_instr_ids.size());
+  }
 
   // For debug hang in main_thread_blocker_.WaitEvent(),
   // launch async task to log deps every
@@ -1886,6 +1913,11 @@ void PirInterpreter::RunNextInstructions(InstructionBase* instr,
   phi::RecordEvent record(
       "RunNextInstructions", phi::TracerEventType::UserDefined, 10);
 
+  if (FLAGS_new_executor_locality_aware_schedule) {
+    RunNextInstructionsWithAffinity(instr, reserved_next_ops);
+    return;
+  }
+
   auto IsReady = [this](size_t next_id) {
     VLOG(4) << "op_id: " << next_id
             << ", remain deps: " << deps_[next_id]->DynamicDep();
@@ -1907,6 +1939,103 @@ void PirInterpreter::RunNextInstructions(InstructionBase* instr,
   }
 }
 
+// NOTE: Locality-aware scheduling, enabled by
+// FLAGS_new_executor_locality_aware_schedule. Compared with
+// RunNextInstructions, the current worker keeps running the ready successor
+// with the highest scheduling priority by itself instead of handing it to
+// another thread, and the rest of the ready successors are pushed to the
+// workqueue in one batch, each one starting on the thread of its affinity lane.
+void PirInterpreter::RunNextInstructionsWithAffinity(
+    InstructionBase* instr, SchedulingQueue* reserved_next_ops) {
+  phi::RecordEvent record("RunNextInstructionsWithAffinity",
+                          phi::TracerEventType::UserDefined,
+                          10);
+
+  auto IsReady = [this](size_t next_id) {
+    VLOG(4) << "op_id: " << next_id
+            << ", remain deps: " << deps_[next_id]->DynamicDep();
+    return deps_[next_id]->CheckAndDecrease();
+  };
+
+  for (size_t next_instr_id : instr->NextInstrsInSameThread()) {
+    if (IsReady(next_instr_id)) {
+      reserved_next_ops->push(next_instr_id);
+    }
+  }
+
+  paddle::small_vector<size_t, kAffinityDispatchBatchSize> ready_instr_ids;
+  for (size_t next_instr_id : instr->NextInstrsInDifferenceThread()) {
+    if (IsReady(next_instr_id)) {
+      ready_instr_ids.push_back(next_instr_id);
+    }
+  }
+  if (ready_instr_ids.empty()) {
+    return;
+  }
+
+  // Only continue inline when this thread would otherwise go idle, and only
+  // with a successor that belongs to the same workqueue as the current one.
+  if (reserved_next_ops->empty()) {
+    bool is_async = instr->KernelType() == OpFuncType::kGpuAsync;
+    size_t hottest = ready_instr_ids.size();
+    for (size_t i = 0; i < ready_instr_ids.size(); ++i) {
+      bool next_is_async =
+          vec_instruction_base_[ready_instr_ids[i]]->KernelType() ==
+          OpFuncType::kGpuAsync;
+      if (next_is_async != is_async) {
+        continue;
+      }
+      if (hottest == ready_instr_ids.size() ||
+          ir_instruction_scheduling_priority_less(ready_instr_ids[hottest],
+                                                  ready_instr_ids[i])) {
+        hottest = i;
+      }
+    }
+    if (hottest != ready_instr_ids.size()) {
+      reserved_next_ops->push(ready_instr_ids[hottest]);
+      ready_instr_ids.erase(ready_instr_ids.begin() + hottest);
+    }
+  }
+
+  DispatchInstructionsWithAffinity(ready_instr_ids.data(),
+                                   ready_instr_ids.size());
+}
+
+void PirInterpreter::DispatchInstructionsWithAffinity(const size_t* instr_ids,
+                                                      size_t num) {
+  // queue_idx=0 : kCpuSync or kGpuSync
+  // queue_idx=1 : kGPUAsync
+  for (size_t queue_idx = 0; queue_idx < 2; ++queue_idx) {
+    OpFuncType queue_type =
+        queue_idx == 0 ? OpFuncType::kCpuSync : OpFuncType::kGpuAsync;
+    size_t num_threads = 0;
+    paddle::small_vector<std::function<void()>, kAffinityDispatchBatchSize>
+        tasks;
+    paddle::small_vector<int, kAffinityDispatchBatchSize> thread_hints;
+    for (size_t i = 0; i < num; ++i) {
+      size_t instr_id = instr_ids[i];
+      bool is_async = vec_instruction_base_[instr_id]->KernelType() ==
+                      OpFuncType::kGpuAsync;
+      if (is_async != (queue_idx == 1)) {
+        continue;
+      }
+      if (num_threads == 0) {
+        num_threads = async_work_queue_->QueueNumThreads(queue_idx);
+      }
+      // [this, instr_id] fits in the small buffer of std::function, so no
+      // heap allocation happens here.
+      tasks.emplace_back(
+          [this, instr_id]() { RunInstructionBaseAsync(instr_id); });
+      thread_hints.push_back(
+          instr_id < instr_affinity_lanes_.size() && num_threads > 0
+              ? static_cast<int>(instr_affinity_lanes_[instr_id] % num_threads)
+              : -1);
+    }
+    async_work_queue_->AddTasksWithHint(
+        queue_type, tasks.data(), thread_hints.data(), tasks.size());
+  }
+}
+
 void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
   phi::RecordEvent instruction_event(
       instr_node->Name(), phi::TracerEventType::Operator, 1);
@@ -1953,6 +2082,7 @@ void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
     }
 
     if (!instr_node->IsArtificial()) {
+      uint64_t run_start_ns = profile_instr_run_time_ ? phi::PosixInNsec() : 0;
       {
         phi::RecordEvent record(
             "InstrRun", phi::TracerEventType::UserDefined, 10);
@@ -1967,6 +2097,11 @@ void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
                 << "): context wait and get last error";
 #endif
       }
+      if (UNLIKELY(profile_instr_run_time_)) {
+        // every instruction is run by exactly one thread, so there is no race
+        instr_run_time_ns_[instr_node->Id()] =
+            phi::PosixInNsec() - run_start_ns;
+      }
       if (FLAGS_check_nan_inf) {
         CheckTensorHasNanOrInf(instr_node, scope_, value_exe_info_.get());
       }
@@ -2073,6 +2208,57 @@ void PirInterpreter::PreAnalysis() {
 
   UpdateOneDNNOpNum();
   VLOG(4) << "Done UpdateOneDNNOpNum";
+
+  if (FLAGS_new_executor_critical_path_schedule) {
+    // time the instructions in the coming first run, see
+    // AnalyseCriticalPathPriority
+    instr_run_time_ns_.assign(vec_instruction_base_.size(), 0);
+    profile_instr_run_time_ = true;
+  }
+}
+
+// Note: For a wide graph, a long branch that is started late decides the
+// end-to-end latency. After the first run timed every instruction, compute
+// the longest remaining path (the run time of the instruction itself plus the
+// longest path of its downstream instructions) of each instruction, and
+// schedule the ready instruction with the longer remaining path first. The
+// static scheduling priority is only used to break ties. Note that the time
+// of kGpuAsync instructions only covers the kernel launch unless
+// FLAGS_benchmark syncs after each launch.
+void PirInterpreter::AnalyseCriticalPathPriority() {
+  profile_instr_run_time_ = false;
+
+  const auto& op_downstream_map = ir_dependency_builder_.OpDownstreamMap();
+  // trace_execute_order_ is a topological order of all instructions
+  instr_critical_path_ns_ = interpreter::CalculateCriticalPathTime(
+      trace_execute_order_, op_downstream_map, instr_run_time_ns_);
+
+  InstructionSchedulingPriorityLess static_priority_less =
+      ir_instruction_scheduling_priority_less;
+  ir_instruction_scheduling_priority_less =
+      [this, static_priority_less](size_t lhs, size_t rhs) {
+        uint64_t lhs_path = instr_critical_path_ns_[lhs];
+        uint64_t rhs_path = instr_critical_path_ns_[rhs];
+        if (lhs_path == rhs_path) {
+          return static_priority_less(lhs, rhs);
+        }
+        return lhs_path < rhs_path;
+      };
+
+  AnalyseExecuteOrderForTrace(op_downstream_map,
+                              ir_instruction_scheduling_priority_less);
+
+  if (VLOG_IS_ON(4) && !trace_execute_order_.empty()) {
+    uint64_t critical_path_ns = 0;
+    for (size_t i = 0; i < dependency_count_->size(); ++i) {
+      if ((*dependency_count_)[i] == 0) {
+        critical_path_ns =
+            std::max(critical_path_ns, instr_critical_path_ns_[i]);
+      }
+    }
+    VLOG(4) << "Done AnalyseCriticalPathPriority, the critical path takes "
+            << critical_path_ns << " ns";
+  }
 }
 
 ::pir::Value PirInterpreter::GetValueByName(const std::string& var_name) {
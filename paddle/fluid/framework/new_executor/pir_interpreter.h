@@ -134,6 +134,7 @@ class PirInterpreter : public InterpreterBaseImpl {
       std::map<size_t, std::set<size_t>> op_downstream_map,
       InstructionSchedulingPriorityLess compare);
   void AnalyzeForceSyncOps();
+  void AnalyseCriticalPathPriority();
   void ConstructEventForJitInput();
   void CalculateLastLiveOps();
 
@@ -206,6 +207,17 @@ class PirInterpreter : public InterpreterBaseImpl {
   int64_t onednn_op_num_{-1};
   std::vector<size_t> trace_execute_order_;
 
+  // used for locality-aware multi-thread scheduling, the i-th instruction
+  // prefers to start on the thread of instr_affinity_lanes_[i] % num_threads
+  std::vector<size_t> instr_affinity_lanes_;
+
+  // used for critical-path scheduling, instr_run_time_ns_ is filled in the
+  // first run, and instr_critical_path_ns_[i] is the longest time from the
+  // start of the i-th instruction to the end of the program
+  bool profile_instr_run_time_{false};
+  std::vector<uint64_t> instr_run_time_ns_;
+  std::vector<uint64_t> instr_critical_path_ns_;
+
   std::vector<PirHookFunc> pir_output_hookfuncs_;
   std::vector<PirHookFunc> pir_input_hookfuncs_;
 
@@ -241,6 +253,11 @@ class PirInterpreter : public InterpreterBaseImpl {
   void RunNextInstructions(InstructionBase* instr,
                            SchedulingQueue* reserved_next_ops);
 
+  void RunNextInstructionsWithAffinity(InstructionBase* instr,
+                                       SchedulingQueue* reserved_next_ops);
+
+  void DispatchInstructionsWithAffinity(const size_t* instr_ids, size_t num);
+
   void RunInstructionBase(InstructionBase* instr_node);
 
   void RecordMemcpyD2H(InstructionBase* instr_node);
@@ -140,6 +140,42 @@ class ThreadPoolTempl {
     }
   }
 
+  // Push num tasks at once. The i-th task is placed on the queue of worker
+  // thread thread_hints[i] if it is in [0, num_threads_), otherwise it is
+  // placed like AddTask does. A hint only decides where a task starts, idle
+  // workers can still steal it. Workers are notified after all tasks are
+  // pushed, so a woken worker never finds a half-filled batch.
+  void AddTasksWithHint(std::function<void()>* fns,
+                        const int* thread_hints,
+                        size_t num) {
+    PerThread* pt = GetPerThread();
+    const bool is_worker = pt->pool == this;
+    size_t num_pushed = 0;
+    for (size_t i = 0; i < num; ++i) {
+      Task t = env_.CreateTask(std::move(fns[i]));
+      int thread_id = thread_hints[i];
+      if (thread_id < 0 || thread_id >= num_threads_) {
+        thread_id =
+            is_worker ? pt->thread_id : Rand(&pt->rand) % num_threads_;
+      }
+      Queue& q = thread_data_[thread_id].queue;
+      // Only the owner thread is allowed to push onto the front of a queue.
+      if (is_worker && thread_id == pt->thread_id) {
+        t = q.PushFront(std::move(t));
+      } else {
+        t = q.PushBack(std::move(t));
+      }
+      if (!t.f) {
+        ++num_pushed;
+      } else {
+        env_.ExecuteTask(t);  // Push failed, execute directly.
+      }
+    }
+    for (size_t i = 0; i < num_pushed; ++i) {
+      ec_.Notify(false);
+    }
+  }
+
   void Cancel() {
     cancelled_ = true;
     done_ = true;
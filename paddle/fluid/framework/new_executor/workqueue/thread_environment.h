@@ -12,6 +12,8 @@
 #include <functional>
 #include <thread>
 
+#include "paddle/phi/core/memory/allocation/numa_allocator.h"
+
 namespace paddle {
 namespace framework {
 
@@ -40,11 +42,24 @@ struct StlThreadEnvironment {
     std::thread thr_;
   };
 
+  StlThreadEnvironment() = default;
+  explicit StlThreadEnvironment(int numa_node) : numa_node_(numa_node) {}
+
   EnvThread* CreateThread(std::function<void()> f) {
-    return new EnvThread(std::move(f));
+    if (numa_node_ < 0) {
+      return new EnvThread(std::move(f));
+    }
+    // bind the allocations of the thread to numa_node_ for its lifetime
+    return new EnvThread([f = std::move(f), numa_node = numa_node_]() {
+      paddle::memory::allocation::NumaNodeGuard guard(numa_node);
+      f();
+    });
   }
   Task CreateTask(std::function<void()> f) { return Task{std::move(f)}; }
   void ExecuteTask(const Task& t) { t.f(); }
+
+ private:
+  int numa_node_{-1};
 };
 
 }  // namespace framework
@@ -46,10 +46,12 @@ class WorkQueueImpl : public WorkQueue {
       destruct_notifier_ =
           options.events_waiter->RegisterEvent(kQueueDestructEvent);
     }
-    queue_ = new NonblockingThreadPool(options_.name,
-                                       static_cast<int>(options_.num_threads),
-                                       options_.allow_spinning,
-                                       options_.always_spinning);
+    queue_ = new NonblockingThreadPool(
+        options_.name,
+        static_cast<int>(options_.num_threads),
+        options_.allow_spinning,
+        options_.always_spinning,
+        StlThreadEnvironment(options_.numa_node));
   }
 
   ~WorkQueueImpl() override {
@@ -96,6 +98,11 @@ class WorkQueueGroupImpl : public WorkQueueGroup {
 
   void AddTask(size_t queue_idx, std::function<void()> fn) override;
 
+  void AddTasksWithHint(size_t queue_idx,
+                        std::function<void()>* fns,
+                        const int* thread_hints,
+                        size_t num) override;
+
   size_t QueueNumThreads(size_t queue_idx) const override;
 
   size_t QueueGroupNumThreads() const override;
@@ -141,7 +148,8 @@ WorkQueueGroupImpl::WorkQueueGroupImpl(
         NonblockingThreadPool(options.name,
                               static_cast<int>(options.num_threads),
                               options.allow_spinning,
-                              options.always_spinning);
+                              options.always_spinning,
+                              StlThreadEnvironment(options.numa_node));
   }
 }
 
@@ -176,6 +184,29 @@ void WorkQueueGroupImpl::AddTask(size_t queue_idx, std::function<void()> fn) {
   queues_[queue_idx]->AddTask(std::move(fn));
 }
 
+void WorkQueueGroupImpl::AddTasksWithHint(size_t queue_idx,
+                                          std::function<void()>* fns,
+                                          const int* thread_hints,
+                                          size_t num) {
+  phi::RecordEvent record("WorkQueue::AddTasksWithHint",
+                          phi::TracerEventType::UserDefined,
+                          10 /*level*/);
+  assert(queue_idx < queues_.size());
+  PADDLE_ENFORCE_NOT_NULL(
+      queues_.at(queue_idx),
+      common::errors::NotFound("Workqueue of index %d is not initialized.",
+                               queue_idx));
+  if (queues_options_.at(queue_idx).track_task) {
+    for (size_t i = 0; i < num; ++i) {
+      fns[i] = [task = std::move(fns[i]),
+                raii = CounterGuard<TaskTracker>(tracker_)]() mutable {
+        task();
+      };
+    }
+  }
+  queues_[queue_idx]->AddTasksWithHint(fns, thread_hints, num);
+}
+
 size_t WorkQueueGroupImpl::QueueNumThreads(size_t queue_idx) const {
   assert(queue_idx < queues_.size());
   if (!queues_.at(queue_idx)) {
@@ -102,6 +102,9 @@ struct WorkQueueOptions {
   // false and set events_waiter.
   bool detached{true};
   EventsWaiter* events_waiter{nullptr};  // not owned
+  // The NUMA node that the CPU memory allocated by the worker threads
+  // prefers, see NumaNodeGuard. -1 means not binding the threads.
+  int numa_node{-1};
 };
 
 class WorkQueue {
@@ -155,6 +158,14 @@ class WorkQueueGroup {
 
   virtual void AddTask(size_t queue_idx, std::function<void()> fn) = 0;
 
+  // Add num tasks to the queue in one call, the i-th task prefers to start on
+  // the thread thread_hints[i] of that queue (a negative hint means no
+  // preference). The tasks in fns are moved from.
+  virtual void AddTasksWithHint(size_t queue_idx,
+                                std::function<void()>* fns,
+                                const int* thread_hints,
+                                size_t num) = 0;
+
   // Higher cost than AddTask
   template <typename F, typename... Args>
   std::future<typename std::result_of<F(Args...)>::type> AddAwaitableTask(
@@ -0,0 +1,100 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/pir/serialize_deserialize/include/third_party.h"
+
+namespace pir {
+/**
+ * The binary module format keeps the json schema of the text format, which
+ * makes the version compatible patches of version_compat work unchanged, but
+ * encodes it compactly:
+ *
+ *   magic (8 bytes) | format version (uint32) | reserved (uint32)
+ *   string table: count, then length and bytes of each string
+ *   base code value
+ *   program value, with the ops of the top level block removed
+ *   max value id of the top level block, number of its ops
+ *   one value per op of the top level block
+ *
+ * Integers are varints (zigzag for signed ones). A value is a one byte tag
+ * followed by its content, every object key and string is an index into the
+ * string table, so op, attribute and type names are stored once.
+ *
+ * The ops of the top level block, which are nearly all of a program, are read
+ * one by one: each op is materialized as json only when it is built and the
+ * json is dropped right after, so the whole json tree is never in memory.
+ */
+class BinaryModuleWriter {
+ public:
+  /** program_json is the json of ProgramWriter, its top level ops are moved
+   * out. */
+  static void Write(const Json& base_code,
+                    Json* program_json,
+                    std::ostream* os);
+};
+
+class BinaryModuleReader {
+ public:
+  /** Return whether the file at file_path is in the binary module format. */
+  static bool IsBinaryModule(const std::string& file_path);
+
+  explicit BinaryModuleReader(const std::string& file_path);
+
+  BinaryModuleReader(const BinaryModuleReader&) = delete;
+  BinaryModuleReader& operator=(const BinaryModuleReader&) = delete;
+
+  const Json& base_code() const { return base_code_; }
+  /** The program json whose top level block has no ops. */
+  Json* program_json() { return &program_json_; }
+  /** The max value id of the ops of the top level block. */
+  int64_t max_value_id() const { return max_value_id_; }
+  uint64_t op_num() const { return op_num_; }
+
+  /** Materialize the next op of the top level block, return false after the
+   * last one. */
+  bool NextOp(Json* op_json);
+
+ private:
+  uint8_t ReadByte();
+  uint64_t ReadVarint();
+  /** Read the count of the items following, each of at least one byte. */
+  uint64_t ReadCount();
+  void ReadBytes(char* p, size_t n);
+  void ReadValue(Json* value);
+  const std::string& ReadString();
+
+  std::ifstream fin_;
+  std::string file_path_;
+  std::vector<char> buffer_;
+  size_t cursor_ = 0;
+  size_t size_ = 0;
+  // the bytes of the file, and the ones read into buffer_ so far
+  uint64_t file_size_ = 0;
+  uint64_t loaded_size_ = 0;
+
+  std::vector<std::string> strings_;
+  Json base_code_;
+  Json program_json_;
+  int64_t max_value_id_ = 0;
+  uint64_t op_num_ = 0;
+  uint64_t read_op_num_ = 0;
+};
+
+}  // namespace pir
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <fstream>
+#include <functional>
 #include "paddle/common/enforce.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/schema.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/third_party.h"
@@ -37,6 +38,18 @@ class ProgramReader {
   void IR_API RecoverProgram(Json* program_json,
                              pir::Program* recover_program,
                              pir::PatchBuilder* builder);
+  // Materialize the next op json of a block, return false after the last op.
+  using OpJsonReader = std::function<bool(Json* op_json)>;
+  // Recover the program whose top level block ops are not in program_json but
+  // are read one by one from read_op, max_value_id is GetMaxValueId() of them.
+  void IR_API RecoverProgram(Json* program_json,
+                             int64_t max_value_id,
+                             const OpJsonReader& read_op,
+                             pir::Program* recover_program,
+                             pir::PatchBuilder* builder);
+  // The max value id used by the ops of a block, which is needed by op pair
+  // patches before any op is read.
+  static int64_t GetMaxValueId(const Json& ops_json);
   pir::Type RecoverType(Json* type_json);
   pir::AttributeMap RecoverOpAttributesMap(Json* attrs_json);
   ~ProgramReader() = default;
@@ -49,6 +62,7 @@ class ProgramReader {
   void ReadProgram(Json* program_json, pir::Program* program);
   void ReadRegion(Json* region_json, pir::Region* region);
   void ReadBlock(Json* block_json, pir::Block* block);
+  void ReadBlockArgs(Json* block_json, pir::Block* block);
   pir::Operation* ReadOp(Json* op_json);
   pir::AttributeMap ReadAttributesMap(
       Json* attrs_json,
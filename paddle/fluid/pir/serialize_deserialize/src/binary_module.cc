@@ -0,0 +1,372 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/serialize_deserialize/include/binary_module.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+
+#include "paddle/common/enforce.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/ir_deserialize.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/schema.h"
+
+namespace pir {
+
+namespace {
+
+constexpr char kMagic[8] = {'\x89', 'P', 'I', 'R', 'B', 'I', 'N', '\n'};
+constexpr uint32_t kFormatVersion = 1;
+constexpr size_t kBufferSize = 1 << 16;
+
+enum ValueTag : uint8_t {
+  kNull = 0,
+  kFalse = 1,
+  kTrue = 2,
+  kInt = 3,
+  kUint = 4,
+  kFloat = 5,
+  kString = 6,
+  kArray = 7,
+  kObject = 8,
+};
+
+uint64_t ZigZag(int64_t x) {
+  return (static_cast<uint64_t>(x) << 1) ^ static_cast<uint64_t>(x >> 63);
+}
+
+int64_t UnZigZag(uint64_t x) {
+  return static_cast<int64_t>(x >> 1) ^ -static_cast<int64_t>(x & 1);
+}
+
+class Encoder {
+ public:
+  explicit Encoder(std::ostream* os) : os_(os) {}
+
+  // The strings are numbered by decreasing frequency, so the frequent ones
+  // get one byte indices.
+  void CollectStrings(const Json& value) {
+    if (value.is_string()) {
+      ++counts_[value.get_ref<const std::string&>()];
+    } else if (value.is_object()) {
+      for (auto it = value.begin(); it != value.end(); ++it) {
+        ++counts_[it.key()];
+        CollectStrings(it.value());
+      }
+    } else if (value.is_array()) {
+      for (auto& item : value) {
+        CollectStrings(item);
+      }
+    }
+  }
+
+  void WriteHeader() {
+    std::vector<std::pair<std::string, size_t>> strings(counts_.begin(),
+                                                        counts_.end());
+    std::sort(strings.begin(), strings.end(), [](const auto& a, const auto& b) {
+      return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    os_->write(kMagic, sizeof(kMagic));
+    WriteFixed(kFormatVersion);
+    WriteFixed(static_cast<uint32_t>(0));
+    WriteVarint(strings.size());
+    ids_.reserve(strings.size());
+    for (auto& item : strings) {
+      ids_.emplace(item.first, ids_.size());
+      WriteVarint(item.first.size());
+      os_->write(item.first.data(), item.first.size());
+    }
+  }
+
+  void WriteVarint(uint64_t x) {
+    char buf[10];
+    size_t n = 0;
+    while (x >= 0x80) {
+      buf[n++] = static_cast<char>((x & 0x7f) | 0x80);
+      x >>= 7;
+    }
+    buf[n++] = static_cast<char>(x);
+    os_->write(buf, n);
+  }
+
+  void WriteValue(const Json& value) {
+    switch (value.type()) {
+      case Json::value_t::null:
+        WriteTag(kNull);
+        break;
+      case Json::value_t::boolean:
+        WriteTag(value.get<bool>() ? kTrue : kFalse);
+        break;
+      case Json::value_t::number_integer:
+        WriteTag(kInt);
+        WriteVarint(ZigZag(value.get<int64_t>()));
+        break;
+      case Json::value_t::number_unsigned:
+        WriteTag(kUint);
+        WriteVarint(value.get<uint64_t>());
+        break;
+      case Json::value_t::number_float: {
+        WriteTag(kFloat);
+        double x = value.get<double>();
+        os_->write(reinterpret_cast<const char*>(&x), sizeof(x));
+        break;
+      }
+      case Json::value_t::string:
+        WriteTag(kString);
+        WriteVarint(ids_.at(value.get_ref<const std::string&>()));
+        break;
+      case Json::value_t::array:
+        WriteTag(kArray);
+        WriteVarint(value.size());
+        for (auto& item : value) {
+          WriteValue(item);
+        }
+        break;
+      case Json::value_t::object:
+        WriteTag(kObject);
+        WriteVarint(value.size());
+        for (auto it = value.begin(); it != value.end(); ++it) {
+          WriteVarint(ids_.at(it.key()));
+          WriteValue(it.value());
+        }
+        break;
+      default:
+        PADDLE_THROW(common::errors::Unimplemented(
+            "Json value of type %s can not be saved in binary format.",
+            value.type_name()));
+    }
+  }
+
+ private:
+  void WriteTag(ValueTag tag) { os_->put(static_cast<char>(tag)); }
+
+  void WriteFixed(uint32_t x) {
+    os_->write(reinterpret_cast<const char*>(&x), sizeof(x));
+  }
+
+  std::ostream* os_;
+  std::unordered_map<std::string, size_t> counts_;
+  std::unordered_map<std::string, size_t> ids_;
+};
+
+}  // namespace
+
+void BinaryModuleWriter::Write(const Json& base_code,
+                               Json* program_json,
+                               std::ostream* os) {
+  PADDLE_ENFORCE_EQ(
+      program_json->at(REGIONS).size(),
+      1,
+      common::errors::InvalidArgument(
+          "The regions size of program module should be 1 but got %d.",
+          program_json->at(REGIONS).size()));
+  Json& block_json = program_json->at(REGIONS).at(0).at(BLOCKS).at(0);
+  Json ops_json = std::move(block_json.at(BLOCKOPS));
+  block_json[BLOCKOPS] = Json::array();
+
+  Encoder encoder(os);
+  encoder.CollectStrings(base_code);
+  encoder.CollectStrings(*program_json);
+  encoder.CollectStrings(ops_json);
+  encoder.WriteHeader();
+  encoder.WriteValue(base_code);
+  encoder.WriteValue(*program_json);
+  encoder.WriteVarint(ZigZag(ProgramReader::GetMaxValueId(ops_json)));
+  encoder.WriteVarint(ops_json.size());
+  for (auto& op_json : ops_json) {
+    encoder.WriteValue(op_json);
+  }
+  VLOG(6) << "Finish write binary module of " << ops_json.size() << " ops.";
+}
+
+bool BinaryModuleReader::IsBinaryModule(const std::string& file_path) {
+  std::ifstream fin(file_path, std::ios::binary);
+  char magic[sizeof(kMagic)];
+  return fin.read(magic, sizeof(magic)) &&
+         memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+BinaryModuleReader::BinaryModuleReader(const std::string& file_path)
+    : fin_(file_path, std::ios::binary),
+      file_path_(file_path),
+      buffer_(kBufferSize) {
+  PADDLE_ENFORCE_EQ(static_cast<bool>(fin_),
+                    true,
+                    common::errors::Unavailable(
+                        "Cannot open %s to load program.", file_path));
+  fin_.seekg(0, std::ios::end);
+  file_size_ = static_cast<uint64_t>(fin_.tellg());
+  fin_.seekg(0, std::ios::beg);
+  char magic[sizeof(kMagic)];
+  ReadBytes(magic, sizeof(magic));
+  PADDLE_ENFORCE_EQ(memcmp(magic, kMagic, sizeof(kMagic)),
+                    0,
+                    common::errors::InvalidArgument(
+                        "Invalid binary model file: %s.", file_path));
+  uint32_t format_version = 0;
+  ReadBytes(reinterpret_cast<char*>(&format_version), sizeof(format_version));
+  PADDLE_ENFORCE_LE(
+      format_version,
+      kFormatVersion,
+      common::errors::Unimplemented(
+          "The binary model file %s has format version %d, but only version "
+          "%d and older ones can be loaded, please update paddle.",
+          file_path,
+          format_version,
+          kFormatVersion));
+  uint32_t reserved = 0;
+  ReadBytes(reinterpret_cast<char*>(&reserved), sizeof(reserved));
+
+  strings_.resize(ReadCount());
+  for (auto& str : strings_) {
+    str.resize(ReadCount());
+    ReadBytes(&str[0], str.size());
+  }
+  ReadValue(&base_code_);
+  ReadValue(&program_json_);
+  max_value_id_ = UnZigZag(ReadVarint());
+  op_num_ = ReadCount();
+  VLOG(6) << "Open binary module " << file_path << " of " << op_num_
+          << " ops and " << strings_.size() << " strings.";
+}
+
+bool BinaryModuleReader::NextOp(Json* op_json) {
+  if (read_op_num_ == op_num_) {
+    return false;
+  }
+  ReadValue(op_json);
+  ++read_op_num_;
+  return true;
+}
+
+uint8_t BinaryModuleReader::ReadByte() {
+  if (cursor_ == size_) {
+    fin_.read(buffer_.data(), buffer_.size());
+    size_ = fin_.gcount();
+    cursor_ = 0;
+    loaded_size_ += size_;
+    PADDLE_ENFORCE_GT(size_,
+                      0,
+                      common::errors::InvalidArgument(
+                          "The binary model file %s is truncated.",
+                          file_path_));
+  }
+  return static_cast<uint8_t>(buffer_[cursor_++]);
+}
+
+uint64_t BinaryModuleReader::ReadVarint() {
+  uint64_t x = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    uint8_t byte = ReadByte();
+    x |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return x;
+    }
+  }
+  PADDLE_THROW(common::errors::InvalidArgument(
+      "The binary model file %s is corrupted.", file_path_));
+}
+
+uint64_t BinaryModuleReader::ReadCount() {
+  uint64_t count = ReadVarint();
+  uint64_t bytes_left = file_size_ - loaded_size_ + (size_ - cursor_);
+  PADDLE_ENFORCE_LE(
+      count,
+      bytes_left,
+      common::errors::InvalidArgument(
+          "The binary model file %s is corrupted, it has %d items in the "
+          "%d bytes left.",
+          file_path_,
+          count,
+          bytes_left));
+  return count;
+}
+
+void BinaryModuleReader::ReadBytes(char* p, size_t n) {
+  while (n > 0) {
+    if (cursor_ == size_) {
+      ReadByte();
+      --cursor_;
+    }
+    size_t m = std::min(n, size_ - cursor_);
+    memcpy(p, buffer_.data() + cursor_, m);
+    cursor_ += m;
+    p += m;
+    n -= m;
+  }
+}
+
+const std::string& BinaryModuleReader::ReadString() {
+  uint64_t id = ReadVarint();
+  PADDLE_ENFORCE_LT(id,
+                    strings_.size(),
+                    common::errors::InvalidArgument(
+                        "The binary model file %s is corrupted.", file_path_));
+  return strings_[id];
+}
+
+void BinaryModuleReader::ReadValue(Json* value) {
+  uint8_t tag = ReadByte();
+  switch (tag) {
+    case kNull:
+      *value = nullptr;
+      break;
+    case kFalse:
+      *value = false;
+      break;
+    case kTrue:
+      *value = true;
+      break;
+    case kInt:
+      *value = UnZigZag(ReadVarint());
+      break;
+    case kUint:
+      *value = ReadVarint();
+      break;
+    case kFloat: {
+      double x = 0;
+      ReadBytes(reinterpret_cast<char*>(&x), sizeof(x));
+      *value = x;
+      break;
+    }
+    case kString:
+      *value = ReadString();
+      break;
+    case kArray: {
+      uint64_t size = ReadCount();
+      *value = Json::array();
+      auto& array = value->get_ref<Json::array_t&>();
+      array.resize(size);
+      for (auto& item : array) {
+        ReadValue(&item);
+      }
+      break;
+    }
+    case kObject: {
+      uint64_t size = ReadCount();
+      *value = Json::object();
+      for (uint64_t i = 0; i < size; ++i) {
+        const std::string& key = ReadString();
+        ReadValue(&(*value)[key]);
+      }
+      break;
+    }
+    default:
+      PADDLE_THROW(common::errors::InvalidArgument(
+          "The binary model file %s is corrupted.", file_path_));
+  }
+}
+
+}  // namespace pir
@@ -15,6 +15,7 @@
 #include "paddle/fluid/pir/serialize_deserialize/include/interface.h"
 #include <stdio.h>
 #include "paddle/common/enforce.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/binary_module.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/ir_deserialize.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/ir_serialize.h"
 #include "paddle/phi/common/port.h"
@@ -26,12 +27,63 @@ namespace pir {
 #define PIRVERSION "version"
 #define TRAINABLE "trainable"
 #define PIR "pir"
+
+namespace {
+
+void BuildPatches(const Json& base_code,
+                  int64_t pir_version,
+                  PatchBuilder* builder) {
+  if (base_code.contains(MAGIC) && base_code[MAGIC] == PIR) {
+    uint64_t file_version = base_code.at(PIRVERSION).template get<uint64_t>();
+    if (file_version != (uint64_t)pir_version) {
+      builder->SetFileVersion(file_version);
+      // Set max_version to the max version number of release pir plus 1.
+      auto max_version = RELEASE_VERSION + 1;
+      // If pir_version_ is not 0, we will build patch from file_version_ to
+      // pir_version_; If pir_version_ is 0, we will first build patch from
+      // file_version_ to max_version, and then add 0.yaml to the end.
+      auto version = pir_version == 0 ? max_version : pir_version;
+      VLOG(6) << "file_version: " << file_version
+              << ", pir_version: " << pir_version
+              << ", final_version: " << version;
+      builder->BuildPatch(version, max_version);
+    }
+  } else {
+    PADDLE_THROW(common::errors::InvalidArgument("Invalid model file."));
+  }
+}
+
+bool ReadBinaryModule(const std::string& file_path,
+                      pir::Program* program,
+                      int64_t pir_version) {
+  BinaryModuleReader module_reader(file_path);
+  PatchBuilder builder(pir_version);
+  BuildPatches(module_reader.base_code(), pir_version, &builder);
+
+  ProgramReader reader(pir_version);
+  reader.RecoverProgram(
+      module_reader.program_json(),
+      module_reader.max_value_id(),
+      [&module_reader](Json* op_json) { return module_reader.NextOp(op_json); },
+      program,
+      &builder);
+
+  if (module_reader.base_code().contains(TRAINABLE)) {
+    return module_reader.base_code()[TRAINABLE].get<bool>();
+  } else {
+    return false;
+  }
+}
+
+}  // namespace
+
 void WriteModule(const pir::Program& program,
                  const std::string& file_path,
                  uint64_t pir_version,
                  bool overwrite,
                  bool readable,
-                 bool trainable) {
+                 bool trainable,
+                 bool binary) {
   PADDLE_ENFORCE_EQ(
       FileExists(file_path) && !overwrite,
       false,
@@ -49,12 +101,6 @@ void WriteModule(const pir::Program& program,
   ProgramWriter writer(pir_version, trainable);
   // write program
   total[PROGRAM] = writer.GetProgramJson(&program);
-  std::string total_str;
-  if (readable) {
-    total_str = total.dump(4);
-  } else {
-    total_str = total.dump();
-  }
 
   MkDirRecursively(DirName(file_path).c_str());
   std::ofstream fout(file_path, std::ios::binary);
@@ -62,39 +108,36 @@ void WriteModule(const pir::Program& program,
                     true,
                     common::errors::Unavailable(
                         "Cannot open %s to save variables.", file_path));
-  fout << total_str;
+  if (binary) {
+    BinaryModuleWriter::Write(total[BASE_CODE], &total[PROGRAM], &fout);
+  } else if (readable) {
+    fout << total.dump(4);
+  } else {
+    fout << total.dump();
+  }
   fout.close();
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(fout),
+      true,
+      common::errors::Unavailable("Failed to save program to %s.", file_path));
 }
 
 bool ReadModule(const std::string& file_path,
                 pir::Program* program,
                 int64_t pir_version) {
-  std::ifstream f(file_path);
-  Json data = Json::parse(f);
   if (pir_version < 0) {
     pir_version = DEVELOP_VERSION;
     VLOG(6) << "pir_version is null, get pir_version: " << pir_version;
   }
+  if (BinaryModuleReader::IsBinaryModule(file_path)) {
+    return ReadBinaryModule(file_path, program, pir_version);
+  }
 
+  std::ifstream f(file_path);
+  Json data = Json::parse(f);
   PatchBuilder builder(pir_version);
-
-  if (data.contains(BASE_CODE) && data[BASE_CODE].contains(MAGIC) &&
-      data[BASE_CODE][MAGIC] == PIR) {
-    uint64_t file_version =
-        data.at(BASE_CODE).at(PIRVERSION).template get<uint64_t>();
-    if (file_version != (uint64_t)pir_version) {
-      builder.SetFileVersion(file_version);
-      // Set max_version to the max version number of release pir plus 1.
-      auto max_version = RELEASE_VERSION + 1;
-      // If pir_version_ is not 0, we will build patch from file_version_ to
-      // pir_version_; If pir_version_ is 0, we will first build patch from
-      // file_version_ to max_version, and then add 0.yaml to the end.
-      auto version = pir_version == 0 ? max_version : pir_version;
-      VLOG(6) << "file_version: " << file_version
-              << ", pir_version: " << pir_version
-              << ", final_version: " << version;
-      builder.BuildPatch(version, max_version);
-    }
+  if (data.contains(BASE_CODE)) {
+    BuildPatches(data[BASE_CODE], pir_version, &builder);
   } else {
     PADDLE_THROW(common::errors::InvalidArgument("Invalid model file."));
   }
@@ -26,6 +26,56 @@ void ProgramReader::RecoverProgram(Json* program_json,
   return;
 }
 
+void ProgramReader::RecoverProgram(Json* program_json,
+                                   int64_t max_value_id,
+                                   const OpJsonReader& read_op,
+                                   pir::Program* recover_program,
+                                   pir::PatchBuilder* builder) {
+  id_value_map[0] = pir::Value();
+  patch_builder = builder;
+  PADDLE_ENFORCE_EQ(
+      program_json->at(REGIONS).size(),
+      1,
+      common::errors::InvalidArgument(
+          "The regions size of program module should be 1 but got %d.",
+          program_json->at(REGIONS).size()));
+  auto& block_json = program_json->at(REGIONS).at(0).at(BLOCKS).at(0);
+  auto& block = recover_program->module_op().block();
+  ReadBlockArgs(&block_json, &block);
+
+  Json op_json;
+  if (read_op(&op_json)) {
+    max_value_id += id_value_map.size();
+    VLOG(6) << "max_value_id: " << max_value_id;
+    patch_builder->ApplyOpPairPatches(&max_value_id);
+    do {
+      block.push_back(ReadOp(&op_json));
+    } while (read_op(&op_json));
+    VLOG(6) << "read block size" << block.size() << ".";
+  }
+  VLOG(6) << "Finish op stream to program.";
+}
+
+int64_t ProgramReader::GetMaxValueId(const Json& ops_json) {
+  int64_t max_value_id = 0;
+  for (auto& op_json : ops_json) {
+    if (op_json.at(ID).template get<std::string>() == PARAMETEROP) {
+      int64_t id = op_json.at(OPRESULTS).at(VALUE_ID).template get<int64_t>();
+      max_value_id = std::max(max_value_id, id);
+      continue;
+    }
+    for (auto& operand_json : op_json.at(OPOPERANDS)) {
+      int64_t id = operand_json.at(VALUE_ID).template get<int64_t>();
+      max_value_id = std::max(max_value_id, id);
+    }
+    for (auto& opresult_json : op_json.at(OPRESULTS)) {
+      int64_t id = opresult_json.at(VALUE_ID).template get<int64_t>();
+      max_value_id = std::max(max_value_id, id);
+    }
+  }
+  return max_value_id;
+}
+
 pir::Type ProgramReader::RecoverType(Json* type_json) {
   return ReadType(type_json);
 }
@@ -65,7 +115,28 @@ void ProgramReader::ReadRegion(Json* region_json, pir::Region* region) {
 
 void ProgramReader::ReadBlock(Json* block_json, pir::Block* block) {
   auto block_name = block_json->at(ID).template get<std::string>();
+  ReadBlockArgs(block_json, block);
 
+  Json& ops_json = block_json->at(BLOCKOPS);
+  if (!ops_json.empty()) {
+    // get value id for op_pair io patch
+    VLOG(6) << "Begin to read value num ...";
+    int64_t max_value_id = GetMaxValueId(ops_json);
+    max_value_id += id_value_map.size();
+    VLOG(6) << "max_value_id: " << max_value_id;
+    // Apply op_pair io patch
+    patch_builder->ApplyOpPairPatches(&max_value_id);
+    for (auto& op_json : ops_json) {
+      block->push_back(ReadOp(&op_json));
+    }
+    VLOG(6) << "read block size" << block->size() << ".";
+  }
+
+  VLOG(4) << "Finish Read " << block_name << ".";
+  return;
+}
+
+void ProgramReader::ReadBlockArgs(Json* block_json, pir::Block* block) {
   Json& args_json = block_json->at(BLOCKARGS);
   if (!args_json.empty()) {
     for (auto& arg_json : args_json) {
@@ -90,42 +161,8 @@ void ProgramReader::ReadBlock(Json* block_json, pir::Block* block) {
       VLOG(6) << "Finish Read keyword blockarguments. ";
     }
   }
-
-  Json& ops_json = block_json->at(BLOCKOPS);
-  if (!ops_json.empty()) {
-    // get value id for op_pair io patch
-    VLOG(6) << "Begin to read value num ...";
-    int64_t max_value_id = 0;
-    for (auto& op_json : ops_json) {
-      if (op_json.at(ID).template get<std::string>() == PARAMETEROP) {
-        int64_t id = op_json.at(OPRESULTS).at(VALUE_ID).template get<int64_t>();
-        max_value_id = std::max(max_value_id, id);
-        continue;
-      }
-      Json& operands_json = op_json.at(OPOPERANDS);
-      for (auto& operand_json : operands_json) {
-        int64_t id = operand_json.at(VALUE_ID).template get<int64_t>();
-        max_value_id = std::max(max_value_id, id);
-      }
-      Json& opresults_json = op_json.at(OPRESULTS);
-      for (auto& opresult_json : opresults_json) {
-        int64_t id = opresult_json.at(VALUE_ID).template get<int64_t>();
-        max_value_id = std::max(max_value_id, id);
-      }
-    }
-    max_value_id += id_value_map.size();
-    VLOG(6) << "max_value_id: " << max_value_id;
-    // Apply op_pair io patch
-    patch_builder->ApplyOpPairPatches(&max_value_id);
-    for (auto& op_json : ops_json) {
-      block->push_back(ReadOp(&op_json));
-    }
-    VLOG(6) << "read block size" << block->size() << ".";
-  }
-
-  VLOG(4) << "Finish Read " << block_name << ".";
-  return;
 }
+
 pir::ArrayAttribute GetOneBoolArrayAttribute(pir::IrContext* ctx,
                                              Json* attr_json) {
   std::vector<pir::Attribute> val;
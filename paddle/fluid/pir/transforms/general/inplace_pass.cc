@@ -407,8 +407,8 @@ std::unordered_map<pir::Operation*, std::string> GetInplaceOps(
     VLOG(6) << "analyse op: " << upper_op_name;
 
     // NOTE(zhangbo): add_grad cpu kernel can't do inplace, for the reason shown
-    // in the function: CommonElementwiseBroadcastBackward
-    // (paddle/phi/kernels/funcs/elementwise_grad_base.h)
+    // in the function: CPUBroadcastGrad
+    // (paddle/phi/kernels/funcs/cpu_broadcast.h)
     if ((upper_op_name == "pd_op.add_grad" ||
          upper_op_name == "pd_op.subtract_grad") &&
         (upper_op_attrs.at("kernel_key")
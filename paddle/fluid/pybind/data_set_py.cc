@@ -305,6 +305,9 @@ void BindDataset(py::module *m) {
       .def("set_parse_logkey",
            &framework::Dataset::SetParseLogKey,
            py::call_guard<py::gil_scoped_release>())
+      .def("set_data_cache_dir",
+           &framework::Dataset::SetDataCacheDir,
+           py::call_guard<py::gil_scoped_release>())
       .def("set_merge_by_sid",
            &framework::Dataset::SetMergeBySid,
            py::call_guard<py::gil_scoped_release>())
@@ -2573,6 +2573,12 @@ All parameter, weight, gradient are variables in Paddle.
   m.def("host_memory_stat_peak_value", memory::HostMemoryStatPeakValue);
   m.def("host_memory_stat_reset_peak_value",
         memory::HostMemoryStatResetPeakValue);
+  m.def("host_numa_memory_stat_current_value",
+        memory::HostNumaMemoryStatCurrentValue);
+  m.def("host_numa_memory_stat_peak_value",
+        memory::HostNumaMemoryStatPeakValue);
+  m.def("host_numa_memory_stat_reset_peak_value",
+        memory::HostNumaMemoryStatResetPeakValue);
   m.def(
       "run_cmd",
       [](const std::string &cmd,
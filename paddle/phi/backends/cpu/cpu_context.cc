@@ -14,6 +14,7 @@
 
 #include "paddle/phi/backends/cpu/cpu_context.h"
 
+#include "paddle/phi/backends/cpu/intra_op_thread_pool.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/enforce.h"
 
@@ -50,6 +51,8 @@ struct CPUContext::Impl {
 
   bool owned_{false};
   Eigen::DefaultDevice* eigen_device_{nullptr};
+  backends::cpu::IntraOpThreadPool* intra_op_thread_pool_{
+      backends::cpu::IntraOpThreadPool::GetInstance()};
   Place place_;
 };
 
@@ -73,6 +76,10 @@ Eigen::DefaultDevice* CPUContext::eigen_device() const {
   return impl_->GetEigenDevice();
 }
 
+backends::cpu::IntraOpThreadPool* CPUContext::intra_op_thread_pool() const {
+  return impl_->intra_op_thread_pool_;
+}
+
 const Place& CPUContext::GetPlace() const { return impl_->place_; }
 
 void CPUContext::SetEigenDevice(Eigen::DefaultDevice* device) {
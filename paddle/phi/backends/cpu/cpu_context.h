@@ -23,6 +23,11 @@ limitations under the License. */
 #include "paddle/phi/common/place.h"
 
 namespace phi {
+namespace backends {
+namespace cpu {
+class IntraOpThreadPool;
+}  // namespace cpu
+}  // namespace backends
 
 class PADDLE_API CPUContext : public DeviceContext,
                               public TypeInfoTraits<DeviceContext, CPUContext> {
@@ -33,6 +38,9 @@ class PADDLE_API CPUContext : public DeviceContext,
   explicit CPUContext(const Place&);
   virtual ~CPUContext();
   Eigen::DefaultDevice* eigen_device() const;
+  // The threads shared by the kernels to run on several cores, see
+  // phi::ParallelFor.
+  backends::cpu::IntraOpThreadPool* intra_op_thread_pool() const;
   const Place& GetPlace() const override;
 
   static const char* name() { return "CPUContext"; }
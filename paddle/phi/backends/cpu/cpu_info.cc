@@ -139,6 +139,8 @@ bool MayIUse(const cpu_isa_t cpu_isa) {
              cpu.has(Cpu::tAVX512_4VNNIW);
     case avx512_bf16:
       return true && cpu.has(Cpu::tAVX512_BF16);
+    case fma3:
+      return cpu.has(Cpu::tFMA);
     case isa_any:
       return true;
   }
@@ -162,6 +164,10 @@ bool MayIUse(const cpu_isa_t cpu_isa) {
       if (cpu_isa == avx) {
         int avx_mask = (1 << 28);
         return (reg[2] & avx_mask) != 0;
+      } else if (cpu_isa == fma3) {
+        // FMA3: ECX Bit 12
+        int fma_mask = (1 << 12);
+        return (reg[2] & fma_mask) != 0;
       }
     }
     if (nIds >= 0x00000007) {
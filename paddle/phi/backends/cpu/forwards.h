@@ -18,4 +18,5 @@ limitations under the License. */
 // Forward declaration of Eigen DefaultDevice types.
 namespace Eigen {
 struct DefaultDevice;
+class ThreadPoolInterface;
 }  // namespace Eigen
@@ -0,0 +1,150 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/backends/cpu/intra_op_thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/memory/allocation/numa_allocator.h"
+#include "unsupported/Eigen/CXX11/ThreadPool"
+
+COMMON_DECLARE_int32(cpu_thread_pool_numa_node);
+
+namespace phi {
+namespace backends {
+namespace cpu {
+
+namespace {
+
+thread_local bool in_parallel_region = false;
+thread_local int num_threads_of_thread = 1;
+
+int MaxNumThreads() {
+  return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+// Run a task of a region, with the nested regions on this thread only.
+template <typename Fn>
+void RunInRegion(const Fn& fn) {
+  bool outer = in_parallel_region;
+  in_parallel_region = true;
+  try {
+    fn();
+  } catch (...) {
+    in_parallel_region = outer;
+    throw;
+  }
+  in_parallel_region = outer;
+}
+
+// Bind the allocations of every pool thread to numa_node, see NumaNodeGuard.
+struct NumaThreadEnvironment : public Eigen::StlThreadEnvironment {
+  explicit NumaThreadEnvironment(int numa_node = -1) : numa_node(numa_node) {}
+
+  EnvThread* CreateThread(std::function<void()> f) {
+    return new EnvThread([f = std::move(f), node = numa_node]() {
+      paddle::memory::allocation::NumaNodeGuard guard(node);
+      f();
+    });
+  }
+
+  int numa_node;
+};
+
+}  // namespace
+
+IntraOpThreadPool* IntraOpThreadPool::GetInstance() {
+  // never destroyed, the kernels may run while the process exits
+  static auto* instance = new IntraOpThreadPool();
+  return instance;
+}
+
+IntraOpThreadPool::IntraOpThreadPool() = default;
+
+IntraOpThreadPool::~IntraOpThreadPool() = default;
+
+int IntraOpThreadPool::NumThreads() const { return num_threads_of_thread; }
+
+void IntraOpThreadPool::SetNumThreads(int num_threads) {
+  num_threads_of_thread = std::min(std::max(num_threads, 1), MaxNumThreads());
+}
+
+int IntraOpThreadPool::AvailableThreads() const {
+  if (in_parallel_region) {
+    return 1;
+  }
+  return std::max(1, NumThreads() / (active_regions_.load() + 1));
+}
+
+Eigen::ThreadPoolInterface* IntraOpThreadPool::Pool() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (pool_ == nullptr) {
+    // the calling thread runs a task of each region as well
+    int num_threads = MaxNumThreads() - 1;
+    if (FLAGS_cpu_thread_pool_numa_node >= 0) {
+      pool_ = std::make_unique<Eigen::ThreadPoolTempl<NumaThreadEnvironment>>(
+          num_threads,
+          NumaThreadEnvironment(FLAGS_cpu_thread_pool_numa_node));
+    } else {
+      pool_ = std::make_unique<Eigen::ThreadPool>(num_threads);
+    }
+  }
+  return pool_.get();
+}
+
+void IntraOpThreadPool::Run(int num_tasks,
+                            const std::function<void(int)>& fn) {
+  if (num_tasks <= 1 || MaxNumThreads() == 1) {
+    for (int task = 0; task < num_tasks; ++task) {
+      RunInRegion([&] { fn(task); });
+    }
+    return;
+  }
+
+  std::mutex error_mutex;
+  std::exception_ptr error;
+  auto run_task = [&](int task) {
+    try {
+      RunInRegion([&] { fn(task); });
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (error == nullptr) {
+        error = std::current_exception();
+      }
+    }
+  };
+
+  auto* pool = Pool();
+  ++active_regions_;
+  Eigen::Barrier barrier(num_tasks - 1);
+  for (int task = 1; task < num_tasks; ++task) {
+    pool->Schedule([&, task] {
+      run_task(task);
+      barrier.Notify();
+    });
+  }
+  run_task(0);
+  barrier.Wait();
+  --active_regions_;
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace cpu
+}  // namespace backends
+}  // namespace phi
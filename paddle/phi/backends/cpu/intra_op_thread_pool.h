@@ -0,0 +1,67 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "paddle/phi/backends/cpu/forwards.h"
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+namespace backends {
+namespace cpu {
+
+// The threads shared by all the CPUContexts to run one kernel on several
+// cores. The number of threads follows paddle::platform::SetNumThreads of
+// the calling thread, as the threads of the math library do, so a kernel
+// runs on the calling thread alone by default, and the predictors running on
+// different threads keep their own numbers.
+class IntraOpThreadPool {
+ public:
+  TEST_API static IntraOpThreadPool* GetInstance();
+
+  ~IntraOpThreadPool();
+
+  // The threads of a parallel region entered by the calling thread, itself
+  // included, at most the number of the processors.
+  TEST_API int NumThreads() const;
+  TEST_API void SetNumThreads(int num_threads);
+
+  // The threads for a parallel region entered now by this thread: shared
+  // with the regions already running on the other threads, such as the
+  // host threads of the executor, and 1 inside a region.
+  TEST_API int AvailableThreads() const;
+
+  // Run fn(0), ..., fn(num_tasks - 1), the first one on the calling thread
+  // and the others on the pool, and return when all of them are done. The
+  // first exception thrown by the tasks is rethrown.
+  TEST_API void Run(int num_tasks, const std::function<void(int)>& fn);
+
+ private:
+  IntraOpThreadPool();
+
+  Eigen::ThreadPoolInterface* Pool();
+
+  std::atomic<int> active_regions_{0};
+  std::mutex mutex_;
+  std::unique_ptr<Eigen::ThreadPoolInterface> pool_;
+};
+
+}  // namespace cpu
+}  // namespace backends
+}  // namespace phi
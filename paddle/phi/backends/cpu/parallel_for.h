@@ -0,0 +1,62 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/backends/cpu/intra_op_thread_pool.h"
+
+namespace phi {
+
+/**
+ * Run f(b, e) on the subranges [b, e) of [begin, end), on the intra-op
+ * threads of the context. Each subrange but the last has grain_size
+ * elements at least, so a small range runs on the calling thread as one.
+ *
+ * The subranges depend on the threads available at the moment, so f
+ * should give the same result for any split. An exception thrown by f is
+ * rethrown once all the subranges are done.
+ */
+template <typename Function>
+void ParallelFor(const CPUContext& dev_ctx,
+                 int64_t begin,
+                 int64_t end,
+                 int64_t grain_size,
+                 const Function& f) {
+  if (begin >= end) {
+    return;
+  }
+  int64_t range = end - begin;
+  grain_size = std::max<int64_t>(grain_size, 1);
+  auto* pool = dev_ctx.intra_op_thread_pool();
+  int64_t num_tasks = std::min<int64_t>(pool->AvailableThreads(),
+                                        (range + grain_size - 1) / grain_size);
+  if (num_tasks <= 1) {
+    f(begin, end);
+    return;
+  }
+  int64_t chunk = (range + num_tasks - 1) / num_tasks;
+  pool->Run(static_cast<int>(num_tasks), [&](int task) {
+    int64_t task_begin = begin + task * chunk;
+    int64_t task_end = std::min(end, task_begin + chunk);
+    if (task_begin < task_end) {
+      f(task_begin, task_end);
+    }
+  });
+}
+
+}  // namespace phi
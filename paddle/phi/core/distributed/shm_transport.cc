@@ -0,0 +1,518 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _WIN32
+
+#include "paddle/phi/core/distributed/shm_transport.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <thread>
+
+#include "glog/logging.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/memory/allocation/mmap_allocator.h"
+
+namespace phi::distributed {
+
+namespace {
+
+using paddle::memory::allocation::AllocateMemoryMap;
+using paddle::memory::allocation::GetIPCName;
+using paddle::memory::allocation::MAPPED_EXCLUSIVE;
+using paddle::memory::allocation::MAPPED_FROMFD;
+using paddle::memory::allocation::MAPPED_SHAREDMEM;
+using paddle::memory::allocation::MemoryMapFdSet;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free &&
+                  std::atomic<int32_t>::is_always_lock_free,
+              "the atomics in shared memory should be lock free");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "the futex words should be plain 32 bit integers");
+
+constexpr size_t kCacheLine = 64;
+// bytes of a rank in a half of the segment of ShmAllReducer
+constexpr size_t kSlotBytes = 1 << 20;
+// elements reduced at a time, on the stack
+constexpr int64_t kReduceBlock = 2048;
+
+size_t AlignUp(size_t size) {
+  return (size + kCacheLine - 1) / kCacheLine * kCacheLine;
+}
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Bump seq after a change that the other side may wait for, and wake it up
+// if it blocks on seq.
+void Notify(std::atomic<uint32_t>* seq,
+            const std::atomic<int32_t>* waiting,
+            bool force = false) {
+  seq->fetch_add(1);
+#ifdef __linux__
+  if (force || waiting->load() != 0) {
+    // not FUTEX_PRIVATE_FLAG, the word is shared between processes
+    syscall(SYS_futex,
+            reinterpret_cast<uint32_t*>(seq),
+            FUTEX_WAKE,
+            INT_MAX,
+            nullptr,
+            nullptr,
+            0);
+  }
+#endif
+}
+
+// Spins, yields and then sleeps while waiting for other processes, and
+// checks every while that they are still alive. With seq, the sleeps block
+// until the other side notifies seq, otherwise they back off up to
+// kMaxSleepUs, so that an idle side wakes up rarely.
+class Waiter {
+ public:
+  Waiter(const std::atomic<int32_t>* pids,
+         int num_pids,
+         std::atomic<uint32_t>* seq = nullptr,
+         std::atomic<int32_t>* waiting = nullptr)
+      : pids_(pids), num_pids_(num_pids), seq_(seq), waiting_(waiting) {}
+
+  // seen is the value of seq loaded before the condition waited for was
+  // found false.
+  void Pause(uint32_t seen = 0) {
+    ++rounds_;
+    if (rounds_ <= kSpinRounds) {
+      CpuRelax();
+    } else if (rounds_ <= kSpinRounds + kYieldRounds) {
+      std::this_thread::yield();
+    } else {
+      Sleep(seen);
+      auto now = std::chrono::steady_clock::now();
+      if (now - last_check_ >= kCheckInterval) {
+        last_check_ = now;
+        CheckAlive();
+      }
+    }
+  }
+
+  void Reset() {
+    rounds_ = 0;
+    sleep_us_ = kMinSleepUs;
+  }
+
+ private:
+  static constexpr int64_t kSpinRounds = 4096;
+  static constexpr int64_t kYieldRounds = 1024;
+  static constexpr int64_t kMinSleepUs = 50;
+  static constexpr int64_t kMaxSleepUs = 1000;
+  static constexpr std::chrono::milliseconds kCheckInterval{100};
+
+  void Sleep(uint32_t seen) {
+#ifdef __linux__
+    if (seq_ != nullptr) {
+      // returns at once if seq has changed since seen, the timeout is for
+      // the other side to be checked
+      waiting_->store(1);
+      struct timespec timeout = {0, kCheckInterval.count() * 1000000};
+      syscall(SYS_futex,
+              reinterpret_cast<uint32_t*>(seq_),
+              FUTEX_WAIT,
+              seen,
+              &timeout,
+              nullptr,
+              0);
+      waiting_->store(0);
+      return;
+    }
+#endif
+    std::this_thread::sleep_for(std::chrono::microseconds(sleep_us_));
+    sleep_us_ = std::min(sleep_us_ * 2, kMaxSleepUs);
+  }
+
+  void CheckAlive() const {
+    for (int i = 0; i < num_pids_; ++i) {
+      int32_t pid = pids_[i].load(std::memory_order_relaxed);
+      PADDLE_ENFORCE_EQ(
+          pid == 0 || kill(pid, 0) == 0 || errno != ESRCH,
+          true,
+          common::errors::Unavailable(
+              "The process %d sharing the memory has exited.", pid));
+    }
+  }
+
+  const std::atomic<int32_t>* pids_;
+  int num_pids_;
+  std::atomic<uint32_t>* seq_;
+  std::atomic<int32_t>* waiting_;
+  int64_t rounds_{0};
+  int64_t sleep_us_{kMinSleepUs};
+  std::chrono::steady_clock::time_point last_check_{
+      std::chrono::steady_clock::now()};
+};
+
+template <typename T>
+void ReduceBlock(T* acc, const T* src, int64_t len, ReduceOp reduce_op) {
+  switch (reduce_op) {
+    case ReduceOp::SUM:
+      for (int64_t i = 0; i < len; ++i) {
+        acc[i] += src[i];
+      }
+      break;
+    case ReduceOp::MAX:
+      for (int64_t i = 0; i < len; ++i) {
+        acc[i] = std::max(acc[i], src[i]);
+      }
+      break;
+    case ReduceOp::MIN:
+      for (int64_t i = 0; i < len; ++i) {
+        acc[i] = std::min(acc[i], src[i]);
+      }
+      break;
+    case ReduceOp::PRODUCT:
+      for (int64_t i = 0; i < len; ++i) {
+        acc[i] *= src[i];
+      }
+      break;
+    default:
+      PADDLE_THROW(common::errors::Unimplemented(
+          "Unsupported reduce op of shared memory allreduce."));
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<ShmSegment> ShmSegment::Create(size_t size) {
+  // ftruncate of /dev/shm succeeds beyond its space, and the first write
+  // past it raises SIGBUS
+  struct statvfs stat;
+  if (statvfs("/dev/shm", &stat) == 0 &&
+      static_cast<size_t>(stat.f_bavail) * stat.f_frsize < size) {
+    VLOG(1) << "No space of /dev/shm for a shared memory segment of " << size
+            << " bytes";
+    return nullptr;
+  }
+  std::string name = GetIPCName();
+  int fd = -1;
+  void* data = nullptr;
+  try {
+    AllocateMemoryMap(
+        name, &fd, MAPPED_SHAREDMEM | MAPPED_EXCLUSIVE, size, &data);
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Failed to create shared memory segment " << name << ": "
+                 << e.what();
+    return nullptr;
+  }
+  return std::unique_ptr<ShmSegment>(new ShmSegment(name, data, size));
+}
+
+std::unique_ptr<ShmSegment> ShmSegment::Open(const std::string& name,
+                                             size_t size) {
+  int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd == -1) {
+    return nullptr;
+  }
+  struct stat stat;
+  if (fstat(fd, &stat) != 0 || static_cast<size_t>(stat.st_size) != size) {
+    ::close(fd);
+    return nullptr;
+  }
+  void* data = nullptr;
+  AllocateMemoryMap(name, &fd, MAPPED_SHAREDMEM | MAPPED_FROMFD, size, &data);
+  auto segment = std::unique_ptr<ShmSegment>(new ShmSegment(name, data, size));
+  // the creator owns the name
+  segment->unlinked_ = true;
+  return segment;
+}
+
+ShmSegment::~ShmSegment() {
+  Unlink();
+  munmap(data_, size_);
+}
+
+void ShmSegment::Unlink() {
+  if (unlinked_) {
+    return;
+  }
+  unlinked_ = true;
+  shm_unlink(name_.c_str());
+  MemoryMapFdSet::Instance().Remove(name_);
+}
+
+struct ShmRing::Header {
+  // bytes written and read, the offsets in the buffer modulo capacity
+  alignas(kCacheLine) std::atomic<uint64_t> head;
+  alignas(kCacheLine) std::atomic<uint64_t> tail;
+  alignas(kCacheLine) std::atomic<int32_t> closed;
+  // of the writer and the reader
+  std::atomic<int32_t> pids[2];
+  // notified after head and tail move, and set while the reader or the
+  // writer blocks on them
+  alignas(kCacheLine) std::atomic<uint32_t> head_seq;
+  std::atomic<int32_t> reader_waiting;
+  alignas(kCacheLine) std::atomic<uint32_t> tail_seq;
+  std::atomic<int32_t> writer_waiting;
+};
+
+size_t ShmRing::MemorySize(size_t capacity) {
+  return AlignUp(sizeof(Header)) + capacity;
+}
+
+ShmRing::ShmRing(void* base, size_t capacity, bool is_writer)
+    : header_(static_cast<Header*>(base)),
+      buffer_(static_cast<char*>(base) + AlignUp(sizeof(Header))),
+      capacity_(capacity),
+      is_writer_(is_writer) {
+  PADDLE_ENFORCE_EQ(
+      capacity > 0 && (capacity & (capacity - 1)) == 0,
+      true,
+      common::errors::InvalidArgument(
+          "The capacity of ShmRing should be a power of 2, but got %d.",
+          capacity));
+  header_->pids[is_writer ? 0 : 1].store(getpid());
+}
+
+void ShmRing::Write(const void* data, size_t size) {
+  PADDLE_ENFORCE_EQ(
+      is_writer_,
+      true,
+      common::errors::PreconditionNotMet("Write to the reader of ShmRing."));
+  const char* src = static_cast<const char*>(data);
+  uint64_t head = header_->head.load(std::memory_order_relaxed);
+  Waiter waiter(
+      &header_->pids[1], 1, &header_->tail_seq, &header_->writer_waiting);
+  while (size > 0) {
+    PADDLE_ENFORCE_EQ(IsClosed(),
+                      false,
+                      common::errors::Unavailable("The ShmRing is closed."));
+    uint32_t seen = header_->tail_seq.load();
+    uint64_t tail = header_->tail.load(std::memory_order_acquire);
+    size_t space = capacity_ - (head - tail);
+    if (space == 0) {
+      waiter.Pause(seen);
+      continue;
+    }
+    waiter.Reset();
+    size_t offset = head & (capacity_ - 1);
+    size_t len = std::min({size, space, capacity_ - offset});
+    std::memcpy(buffer_ + offset, src, len);
+    head += len;
+    src += len;
+    size -= len;
+    header_->head.store(head, std::memory_order_release);
+    Notify(&header_->head_seq, &header_->reader_waiting);
+  }
+}
+
+void ShmRing::Read(void* data, size_t size) {
+  PADDLE_ENFORCE_EQ(
+      is_writer_,
+      false,
+      common::errors::PreconditionNotMet("Read from the writer of ShmRing."));
+  char* dst = static_cast<char*>(data);
+  uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+  Waiter waiter(
+      &header_->pids[0], 1, &header_->head_seq, &header_->reader_waiting);
+  while (size > 0) {
+    uint32_t seen = header_->head_seq.load();
+    uint64_t head = header_->head.load(std::memory_order_acquire);
+    size_t ready = head - tail;
+    if (ready == 0) {
+      PADDLE_ENFORCE_EQ(IsClosed(),
+                        false,
+                        common::errors::Unavailable("The ShmRing is closed."));
+      waiter.Pause(seen);
+      continue;
+    }
+    waiter.Reset();
+    size_t offset = tail & (capacity_ - 1);
+    size_t len = std::min({size, ready, capacity_ - offset});
+    std::memcpy(dst, buffer_ + offset, len);
+    tail += len;
+    dst += len;
+    size -= len;
+    header_->tail.store(tail, std::memory_order_release);
+    Notify(&header_->tail_seq, &header_->writer_waiting);
+  }
+}
+
+void ShmRing::Close() {
+  header_->closed.store(1, std::memory_order_release);
+  Notify(&header_->head_seq, &header_->reader_waiting, /*force*/ true);
+  Notify(&header_->tail_seq, &header_->writer_waiting, /*force*/ true);
+}
+
+bool ShmRing::IsClosed() const {
+  return header_->closed.load(std::memory_order_acquire) != 0;
+}
+
+struct ShmAllReducer::Header {
+  alignas(kCacheLine) std::atomic<int32_t> count;
+  alignas(kCacheLine) std::atomic<uint32_t> generation;
+  // followed by the pids of the ranks
+};
+
+size_t ShmAllReducer::MemorySize(int nranks) {
+  return AlignUp(sizeof(Header) + nranks * sizeof(std::atomic<int32_t>)) +
+         2 * nranks * kSlotBytes;
+}
+
+bool ShmAllReducer::IsSupported(phi::DataType dtype, ReduceOp reduce_op) {
+  bool dtype_supported =
+      dtype == phi::DataType::FLOAT32 || dtype == phi::DataType::FLOAT64 ||
+      dtype == phi::DataType::INT32 || dtype == phi::DataType::INT64;
+  bool op_supported = reduce_op == ReduceOp::SUM ||
+                      reduce_op == ReduceOp::MAX ||
+                      reduce_op == ReduceOp::MIN ||
+                      reduce_op == ReduceOp::PRODUCT;
+  return dtype_supported && op_supported;
+}
+
+ShmAllReducer::ShmAllReducer(std::unique_ptr<ShmSegment> segment,
+                             int rank,
+                             int nranks)
+    : segment_(std::move(segment)),
+      header_(static_cast<Header*>(segment_->data())),
+      rank_(rank),
+      nranks_(nranks) {
+  PADDLE_ENFORCE_EQ(segment_->size(),
+                    MemorySize(nranks),
+                    common::errors::InvalidArgument(
+                        "The shared memory segment of %d ranks should be of "
+                        "%d bytes, but got %d.",
+                        nranks,
+                        MemorySize(nranks),
+                        segment_->size()));
+  slots_ = static_cast<char*>(segment_->data()) +
+           AlignUp(sizeof(Header) + nranks * sizeof(std::atomic<int32_t>));
+  Pids()[rank].store(getpid());
+}
+
+std::atomic<int32_t>* ShmAllReducer::Pids() const {
+  return reinterpret_cast<std::atomic<int32_t>*>(header_ + 1);
+}
+
+char* ShmAllReducer::Slot(int half, int rank) const {
+  return slots_ + (half * nranks_ + rank) * kSlotBytes;
+}
+
+void ShmAllReducer::Barrier() {
+  uint32_t generation = header_->generation.load(std::memory_order_acquire);
+  if (header_->count.fetch_add(1, std::memory_order_acq_rel) + 1 == nranks_) {
+    header_->count.store(0, std::memory_order_relaxed);
+    header_->generation.store(generation + 1, std::memory_order_release);
+    return;
+  }
+  Waiter waiter(Pids(), nranks_);
+  while (header_->generation.load(std::memory_order_acquire) == generation) {
+    waiter.Pause();
+  }
+}
+
+template <typename T>
+void ShmAllReducer::AllReduceImpl(T* out,
+                                  const T* in,
+                                  int64_t numel,
+                                  ReduceOp reduce_op) {
+  const int64_t chunk = kSlotBytes / sizeof(T);
+  T acc[kReduceBlock];
+  for (int64_t offset = 0; offset < numel; offset += chunk) {
+    int64_t len = std::min(chunk, numel - offset);
+    // the other half may still be read by the ranks behind
+    half_ ^= 1;
+    std::memcpy(Slot(half_, rank_), in + offset, len * sizeof(T));
+    Barrier();
+
+    // the part of the rank, reduced in its own slot
+    int64_t begin = len * rank_ / nranks_;
+    int64_t end = len * (rank_ + 1) / nranks_;
+    T* part = reinterpret_cast<T*>(Slot(half_, rank_));
+    for (int64_t i = begin; i < end; i += kReduceBlock) {
+      int64_t block = std::min(kReduceBlock, end - i);
+      std::memcpy(
+          acc, reinterpret_cast<T*>(Slot(half_, 0)) + i, block * sizeof(T));
+      for (int r = 1; r < nranks_; ++r) {
+        ReduceBlock(
+            acc, reinterpret_cast<T*>(Slot(half_, r)) + i, block, reduce_op);
+      }
+      std::memcpy(part + i, acc, block * sizeof(T));
+    }
+    Barrier();
+
+    for (int r = 0; r < nranks_; ++r) {
+      int64_t part_begin = len * r / nranks_;
+      int64_t part_end = len * (r + 1) / nranks_;
+      std::memcpy(out + offset + part_begin,
+                  reinterpret_cast<T*>(Slot(half_, r)) + part_begin,
+                  (part_end - part_begin) * sizeof(T));
+    }
+  }
+}
+
+void ShmAllReducer::AllReduce(void* out,
+                              const void* in,
+                              int64_t numel,
+                              phi::DataType dtype,
+                              ReduceOp reduce_op) {
+  switch (dtype) {
+    case phi::DataType::FLOAT32:
+      AllReduceImpl(static_cast<float*>(out),
+                    static_cast<const float*>(in),
+                    numel,
+                    reduce_op);
+      break;
+    case phi::DataType::FLOAT64:
+      AllReduceImpl(static_cast<double*>(out),
+                    static_cast<const double*>(in),
+                    numel,
+                    reduce_op);
+      break;
+    case phi::DataType::INT32:
+      AllReduceImpl(static_cast<int32_t*>(out),
+                    static_cast<const int32_t*>(in),
+                    numel,
+                    reduce_op);
+      break;
+    case phi::DataType::INT64:
+      AllReduceImpl(static_cast<int64_t*>(out),
+                    static_cast<const int64_t*>(in),
+                    numel,
+                    reduce_op);
+      break;
+    default:
+      PADDLE_THROW(common::errors::Unimplemented(
+          "Unsupported data type %s of shared memory allreduce.", dtype));
+  }
+}
+
+}  // namespace phi::distributed
+
+#endif
@@ -0,0 +1,150 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#ifndef _WIN32
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "paddle/phi/common/data_type.h"
+#include "paddle/phi/core/distributed/types.h"
+
+namespace phi {
+namespace distributed {
+
+/**
+ * A named region of shared memory between the processes on one host, mapped
+ * by the facilities of mmap_allocator.h. The memory is zero filled when it is
+ * created.
+ */
+class ShmSegment {
+ public:
+  /**
+   * Create a segment with a new name, nullptr if the shared memory of the
+   * host has not enough space for it.
+   */
+  static std::unique_ptr<ShmSegment> Create(size_t size);
+
+  /**
+   * Map the segment created by another process, nullptr if there is no
+   * segment of the name, as when that process is on another host.
+   */
+  static std::unique_ptr<ShmSegment> Open(const std::string& name,
+                                          size_t size);
+
+  ~ShmSegment();
+
+  const std::string& name() const { return name_; }
+  void* data() const { return data_; }
+  size_t size() const { return size_; }
+
+  // Remove the name, the memory is kept until all the processes unmap it.
+  void Unlink();
+
+ private:
+  ShmSegment(const std::string& name, void* data, size_t size)
+      : name_(name), data_(data), size_(size) {}
+
+  std::string name_;
+  void* data_;
+  size_t size_;
+  bool unlinked_{false};
+};
+
+/**
+ * A byte stream from one process to another through a ring in shared memory,
+ * with a single writer and a single reader. A message larger than the ring
+ * is streamed while the reader consumes it.
+ *
+ * The waiting side spins, then blocks until the other side moves the ring,
+ * and throws if the ring is closed or the process of the other side exits.
+ */
+class ShmRing {
+ public:
+  // The bytes of shared memory of a ring of capacity bytes.
+  static size_t MemorySize(size_t capacity);
+
+  /**
+   * base is MemorySize(capacity) zero filled bytes shared by the writer and
+   * the reader, capacity is a power of 2.
+   */
+  ShmRing(void* base, size_t capacity, bool is_writer);
+
+  void Write(const void* data, size_t size);
+  void Read(void* data, size_t size);
+
+  // Wake up and fail the waiting side of both processes.
+  void Close();
+  bool IsClosed() const;
+
+ private:
+  struct Header;
+
+  Header* header_;
+  char* buffer_;
+  size_t capacity_;
+  bool is_writer_;
+};
+
+/**
+ * AllReduce of the ranks of a group on one host through a segment of shared
+ * memory: each rank copies its tensor in, reduces a part of it from all the
+ * ranks, and copies all the parts out. Tensors larger than a slot are
+ * reduced by chunks, on the two halves of the segment in turn so that two
+ * barriers per chunk are enough.
+ *
+ * The calls of all the ranks should be in the same order, and from one
+ * thread at a time.
+ */
+class ShmAllReducer {
+ public:
+  // The bytes of the segment of a group of nranks.
+  static size_t MemorySize(int nranks);
+
+  static bool IsSupported(phi::DataType dtype, ReduceOp reduce_op);
+
+  ShmAllReducer(std::unique_ptr<ShmSegment> segment, int rank, int nranks);
+
+  void AllReduce(void* out,
+                 const void* in,
+                 int64_t numel,
+                 phi::DataType dtype,
+                 ReduceOp reduce_op);
+
+ private:
+  struct Header;
+
+  std::atomic<int32_t>* Pids() const;
+  void Barrier();
+  char* Slot(int half, int rank) const;
+
+  template <typename T>
+  void AllReduceImpl(T* out, const T* in, int64_t numel, ReduceOp reduce_op);
+
+  std::unique_ptr<ShmSegment> segment_;
+  Header* header_;
+  char* slots_;
+  int rank_;
+  int nranks_;
+  int half_{0};
+};
+
+}  // namespace distributed
+}  // namespace phi
+
+#endif
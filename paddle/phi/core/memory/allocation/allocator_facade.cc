@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "paddle/phi/core/memory/allocation/allocator_facade.h"
+#include <algorithm>
 #include <cstdint>
 
 #include "paddle/common/macros.h"
@@ -25,7 +26,9 @@
 #include "paddle/phi/core/memory/allocation/auto_growth_best_fit_allocator_v2.h"
 #include "paddle/phi/core/memory/allocation/cpu_allocator.h"
 #include "paddle/phi/core/memory/allocation/naive_best_fit_allocator.h"
+#include "paddle/phi/core/memory/allocation/numa_allocator.h"
 #include "paddle/phi/core/memory/allocation/retry_allocator.h"
+#include "paddle/phi/core/memory/allocation/size_class_allocator.h"
 #include "paddle/phi/core/memory/allocation/stat_allocator.h"
 #include "paddle/phi/core/platform/device_context.h"
 
@@ -113,6 +116,8 @@ PHI_DEFINE_EXPORTED_bool(
 
 COMMON_DECLARE_string(allocator_strategy);
 COMMON_DECLARE_uint64(auto_growth_chunk_size_in_mb);
+COMMON_DECLARE_string(cpu_huge_page);
+COMMON_DECLARE_int32(cpu_numa_node);
 COMMON_DECLARE_bool(use_auto_growth_pinned_allocator);
 COMMON_DECLARE_bool(use_cuda_malloc_async_allocator);
 COMMON_DECLARE_bool(auto_free_cudagraph_allocations_on_launch);
@@ -823,6 +828,10 @@ class AllocatorFacadePrivate {
   const AllocatorMap& GetAllocatorMap() { return allocators_; }
 
   void InitNaiveBestFitCPUAllocator() {
+    if (GetCPUAllocatorStrategy() == CPUAllocatorStrategy::kSizeClass) {
+      InitSizeClassCPUAllocator();
+      return;
+    }
 #if defined(__APPLE__) && defined(__arm64__)
     // NOTE(wuweilong): It is more efficient to use CPUAllocator directly,
     // but it will cause some problem in Mac OS m1 chip, so we use
@@ -830,10 +839,53 @@ class AllocatorFacadePrivate {
     allocators_[phi::CPUPlace()] =
         std::make_shared<NaiveBestFitAllocator>(phi::CPUPlace());
 #else
+    if (UseNumaCPUAllocator()) {
+      // Every mmap of NumaAllocator is a syscall, so small tensors are
+      // carved from bigger chunks.
+      auto chunk_size =
+          std::max(FLAGS_auto_growth_chunk_size_in_mb << 20,
+                   static_cast<uint64_t>(NumaAllocator::GetHugePageSize()));
+      VLOG(4) << "Use NumaAllocator for CPUPlace, chunk_size: " << chunk_size;
+      allocators_[phi::CPUPlace()] =
+          std::make_shared<AutoGrowthBestFitAllocator>(
+              CreateCPUSystemAllocator(),
+              CPUAllocator::kAlignment,
+              chunk_size,
+              /*allow_free_idle_chunk=*/true);
+      return;
+    }
     allocators_[phi::CPUPlace()] = std::make_shared<CPUAllocator>();
 #endif
   }
 
+  bool UseNumaCPUAllocator() {
+    return FLAGS_cpu_numa_node >= 0 || FLAGS_cpu_huge_page != "none";
+  }
+
+  std::shared_ptr<Allocator> CreateCPUSystemAllocator() {
+    if (!UseNumaCPUAllocator()) {
+      return std::make_shared<CPUAllocator>();
+    }
+    VLOG(4) << "FLAGS_cpu_numa_node: " << FLAGS_cpu_numa_node
+            << ", FLAGS_cpu_huge_page: " << FLAGS_cpu_huge_page;
+    return std::make_shared<NumaAllocator>(
+        FLAGS_cpu_numa_node, StringToHugePageMode(FLAGS_cpu_huge_page));
+  }
+
+  void InitSizeClassCPUAllocator() {
+    // Small tensors only need to be aligned to a cache line, the chunks of
+    // the size-class and auto-growth allocators are aligned by CPUAllocator.
+    constexpr size_t kSizeClassAlignment = 64;
+    auto chunk_size = FLAGS_auto_growth_chunk_size_in_mb << 20;
+    VLOG(4) << "FLAGS_cpu_allocator_strategy=size_class, chunk_size: "
+            << chunk_size;
+    allocators_[phi::CPUPlace()] =
+        std::make_shared<SizeClassAllocator>(CreateCPUSystemAllocator(),
+                                             kSizeClassAlignment,
+                                             chunk_size,
+                                             /*allow_free_idle_chunk=*/true);
+  }
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   void InitNaiveBestFitCUDAPinnedAllocator() {
     if (FLAGS_use_auto_growth_pinned_allocator) {
@@ -18,6 +18,7 @@
 #include "paddle/phi/core/enforce.h"
 
 COMMON_DECLARE_string(allocator_strategy);
+COMMON_DECLARE_string(cpu_allocator_strategy);
 
 namespace paddle {
 namespace memory {
@@ -47,6 +48,26 @@ AllocatorStrategy GetAllocatorStrategy() {
   return strategy;
 }
 
+static CPUAllocatorStrategy GetCPUStrategyFromFlag() {
+  if (FLAGS_cpu_allocator_strategy == "default") {
+    return CPUAllocatorStrategy::kDefault;
+  }
+
+  if (FLAGS_cpu_allocator_strategy == "size_class") {
+    return CPUAllocatorStrategy::kSizeClass;
+  }
+
+  PADDLE_THROW(common::errors::InvalidArgument(
+      "Unsupported cpu allocator strategy: %s, candidates are default or "
+      "size_class.",
+      FLAGS_cpu_allocator_strategy));
+}
+
+CPUAllocatorStrategy GetCPUAllocatorStrategy() {
+  static CPUAllocatorStrategy strategy = GetCPUStrategyFromFlag();
+  return strategy;
+}
+
 void UseAllocatorStrategyGFlag() {}
 }  // namespace allocation
 }  // namespace memory
@@ -23,6 +23,10 @@ enum class AllocatorStrategy { kNaiveBestFit, kAutoGrowth, kThreadLocal };
 
 extern AllocatorStrategy GetAllocatorStrategy();
 
+enum class CPUAllocatorStrategy { kDefault, kSizeClass };
+
+extern CPUAllocatorStrategy GetCPUAllocatorStrategy();
+
 // Do nothing, just make sure linker do not prune this file.
 TEST_API void UseAllocatorStrategyGFlag();
 
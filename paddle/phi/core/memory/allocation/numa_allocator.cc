@@ -0,0 +1,302 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/numa_allocator.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "glog/logging.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/memory/allocation/cpu_allocator.h"
+#include "paddle/phi/core/memory/stats.h"
+
+#ifdef __linux__
+// from linux/mempolicy.h, which is not installed everywhere
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+#endif
+
+namespace paddle::memory::allocation {
+
+namespace {
+
+// The node ids that have a HostNumaReserved stat, see stats.h
+constexpr int kNumaStatNodeNum = 8;
+
+constexpr size_t kDefaultHugePageSize = 2UL << 20;
+
+thread_local int thread_numa_node = -1;
+
+class NumaAllocation : public Allocation {
+ public:
+  NumaAllocation(void* ptr, size_t size, int numa_node)
+      : Allocation(ptr, size, phi::CPUPlace()), numa_node_(numa_node) {}
+
+  int numa_node() const { return numa_node_; }
+
+ private:
+  int numa_node_;
+};
+
+void UpdateNumaStat(int numa_node, int64_t increment) {
+  if (numa_node >= 0 && numa_node < kNumaStatNodeNum) {
+    HOST_NUMA_MEMORY_STAT_UPDATE(Reserved, numa_node, increment);
+  }
+}
+
+#ifdef __linux__
+size_t GetSystemPageSize() {
+  static size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return page_size;
+}
+
+// Map size bytes aligned to alignment, by mapping more and unmapping the
+// unaligned head and the tail.
+void* MapAligned(size_t size, size_t alignment) {
+  size_t page_size = GetSystemPageSize();
+  size_t padded_size = size + (alignment > page_size ? alignment : 0);
+  void* p = mmap(nullptr,
+                 padded_size,
+                 PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS,
+                 -1,
+                 0);
+  if (p == MAP_FAILED) {
+    return nullptr;
+  }
+  if (padded_size == size) {
+    return p;
+  }
+  uintptr_t begin = reinterpret_cast<uintptr_t>(p);
+  uintptr_t aligned_begin = AlignedSize(begin, alignment);
+  if (aligned_begin > begin) {
+    munmap(p, aligned_begin - begin);
+  }
+  uintptr_t end = begin + padded_size;
+  uintptr_t aligned_end = aligned_begin + size;
+  if (end > aligned_end) {
+    munmap(reinterpret_cast<void*>(aligned_end), end - aligned_end);
+  }
+  return reinterpret_cast<void*>(aligned_begin);
+}
+
+void BindToNumaNode(void* p, size_t size, int numa_node) {
+  constexpr int kMaxNodeNum = sizeof(unsigned long) * 8;  // NOLINT
+  if (numa_node >= kMaxNodeNum) {
+    LOG_FIRST_N(WARNING, 1) << "NUMA node " << numa_node
+                            << " is out of range, the memory is not bound.";
+    return;
+  }
+  unsigned long node_mask = 1UL << numa_node;  // NOLINT
+  long ret = syscall(SYS_mbind,                // NOLINT
+                     p,
+                     size,
+                     MPOL_PREFERRED,
+                     &node_mask,
+                     kMaxNodeNum + 1,
+                     0);
+  if (ret != 0) {
+    // e.g. mbind is forbidden in containers, the memory is still usable.
+    LOG_FIRST_N(WARNING, 1) << "Fail to bind memory to NUMA node "
+                            << numa_node << ", error code is " << errno
+                            << ". The memory is placed by first touch.";
+  }
+}
+#endif
+
+}  // namespace
+
+HugePageMode StringToHugePageMode(const std::string& mode) {
+  if (mode == "none") {
+    return HugePageMode::kNone;
+  }
+  if (mode == "transparent") {
+    return HugePageMode::kTransparent;
+  }
+  if (mode == "explicit") {
+    return HugePageMode::kExplicit;
+  }
+  PADDLE_THROW(common::errors::InvalidArgument(
+      "Unsupported huge page mode: %s, candidates are none, transparent or "
+      "explicit.",
+      mode));
+}
+
+NumaAllocator::NumaAllocator(int numa_node, HugePageMode huge_page_mode)
+    : numa_node_(numa_node), huge_page_mode_(huge_page_mode) {
+#ifdef __linux__
+  int node_count = GetNumaNodeCount();
+  if (numa_node_ >= node_count) {
+    LOG(WARNING) << "NUMA node " << numa_node_ << " does not exist, only "
+                 << node_count << " nodes are found. Use first touch instead.";
+    numa_node_ = -1;
+  }
+#else
+  if (numa_node_ >= 0 || huge_page_mode_ != HugePageMode::kNone) {
+    LOG(WARNING) << "Huge page and NUMA binding are only supported on Linux.";
+  }
+#endif
+}
+
+int NumaAllocator::GetNumaNodeCount() {
+  static int node_count = [] {
+    int count = 1;
+#ifdef __linux__
+    // e.g. "0-1" or "0"
+    std::ifstream fin("/sys/devices/system/node/online");
+    std::string online;
+    if (fin >> online) {
+      auto pos = online.find_last_of("-,");
+      std::string last =
+          pos == std::string::npos ? online : online.substr(pos + 1);
+      count = std::atoi(last.c_str()) + 1;
+    }
+#endif
+    return count > 0 ? count : 1;
+  }();
+  return node_count;
+}
+
+int NumaAllocator::GetCurrentNumaNode() {
+#ifdef __linux__
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return static_cast<int>(node);
+  }
+#endif
+  return 0;
+}
+
+size_t NumaAllocator::GetHugePageSize() {
+  static size_t huge_page_size = [] {
+    size_t size = kDefaultHugePageSize;
+#ifdef __linux__
+    // e.g. "Hugepagesize:       2048 kB"
+    std::ifstream fin("/proc/meminfo");
+    std::string key;
+    size_t value = 0;
+    while (fin >> key) {
+      if (key == "Hugepagesize:" && fin >> value && value > 0) {
+        size = value << 10;
+        break;
+      }
+    }
+#endif
+    return size;
+  }();
+  return huge_page_size;
+}
+
+int NumaAllocator::GetThreadNumaNode() { return thread_numa_node; }
+
+void NumaAllocator::SetThreadNumaNode(int numa_node) {
+  thread_numa_node = numa_node;
+}
+
+phi::Allocation* NumaAllocator::AllocateImpl(size_t size) {
+#ifdef __linux__
+  int numa_node = thread_numa_node >= 0 ? thread_numa_node : numa_node_;
+  size_t huge_page_size = GetHugePageSize();
+  bool use_huge_page =
+      huge_page_mode_ != HugePageMode::kNone && size >= huge_page_size;
+  size_t page_size = use_huge_page ? huge_page_size : GetSystemPageSize();
+  // mmap does not accept 0 bytes
+  size_t mapped_size = size == 0 ? page_size : AlignedSize(size, page_size);
+
+  void* p = nullptr;
+  if (use_huge_page && huge_page_mode_ == HugePageMode::kExplicit) {
+    p = mmap(nullptr,
+             mapped_size,
+             PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+             -1,
+             0);
+    if (p == MAP_FAILED) {
+      p = nullptr;
+      LOG_FIRST_N(WARNING, 1)
+          << "Fail to map " << mapped_size
+          << " bytes of explicit huge pages, error code is " << errno
+          << ". Fall back to transparent huge pages.";
+    }
+  }
+  if (p == nullptr) {
+    p = MapAligned(mapped_size,
+                   use_huge_page ? huge_page_size : CPUAllocator::kAlignment);
+    PADDLE_ENFORCE_NOT_NULL(
+        p,
+        common::errors::ResourceExhausted(
+            "Fail to alloc memory of %ld size, error code is %d.",
+            size,
+            errno));
+    if (use_huge_page) {
+      madvise(p, mapped_size, MADV_HUGEPAGE);
+    }
+  }
+  // the policy takes effect when the pages are touched for the first time
+  if (numa_node >= 0) {
+    BindToNumaNode(p, mapped_size, numa_node);
+  } else {
+    numa_node = GetCurrentNumaNode();
+  }
+
+  HOST_MEMORY_STAT_UPDATE(Reserved, 0, mapped_size);
+  UpdateNumaStat(numa_node, mapped_size);
+  return new NumaAllocation(p, mapped_size, numa_node);
+#else
+  void* p = nullptr;
+#ifdef _WIN32
+  p = _aligned_malloc(size, CPUAllocator::kAlignment);
+  PADDLE_ENFORCE_NOT_NULL(p,
+                          common::errors::ResourceExhausted(
+                              "Fail to alloc memory of %ld size.", size));
+#else
+  int error = posix_memalign(&p, CPUAllocator::kAlignment, size);
+  PADDLE_ENFORCE_EQ(
+      error,
+      0,
+      common::errors::ResourceExhausted(
+          "Fail to alloc memory of %ld size, error code is %d.", size, error));
+#endif
+  HOST_MEMORY_STAT_UPDATE(Reserved, 0, size);
+  return new NumaAllocation(p, size, -1);
+#endif
+}
+
+void NumaAllocator::FreeImpl(phi::Allocation* allocation) {
+  auto* numa_allocation = static_cast<NumaAllocation*>(allocation);
+  auto size = numa_allocation->size();
+  void* p = numa_allocation->ptr();
+#ifdef __linux__
+  munmap(p, size);
+#elif defined(_WIN32)
+  _aligned_free(p);
+#else
+  free(p);  // NOLINT
+#endif
+  HOST_MEMORY_STAT_UPDATE(Reserved, 0, -size);
+  UpdateNumaStat(numa_allocation->numa_node(), -static_cast<int64_t>(size));
+  delete numa_allocation;
+}
+
+}  // namespace paddle::memory::allocation
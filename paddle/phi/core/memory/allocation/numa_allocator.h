@@ -0,0 +1,112 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+
+#include "paddle/common/macros.h"
+#include "paddle/phi/core/memory/allocation/allocator.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+enum class HugePageMode {
+  // 4K pages only.
+  kNone,
+  // Huge-page aligned anonymous mappings advised with MADV_HUGEPAGE, the
+  // kernel backs them with transparent huge pages when it can.
+  kTransparent,
+  // MAP_HUGETLB mappings from the reserved huge page pool, falls back to
+  // kTransparent when the pool is exhausted.
+  kExplicit,
+};
+
+HugePageMode StringToHugePageMode(const std::string& mode);
+
+// CPU system allocator that maps memory with mmap, so that big buffers can be
+// backed by huge pages and bound to a NUMA node.
+//
+// Only requests not smaller than one huge page use huge pages, smaller ones
+// use normal pages, so that a small request never takes a whole huge page.
+//
+// When numa_node is negative, the pages are not bound and are placed on the
+// node of the thread that touches them first. Otherwise the mapping prefers
+// numa_node (MPOL_PREFERRED), and falls back to other nodes when numa_node is
+// full. A thread can override the node of its own allocations with
+// NumaNodeGuard, e.g. a thread pool whose threads run on one socket.
+// FLAGS_cpu_thread_pool_numa_node does so for the host threads of the
+// executor (WorkQueueOptions::numa_node) and the intra-op threads.
+//
+// The reserved size of every node is reported by the HostNumaReserved stat in
+// memory/stats.h. For unbound allocations, the node is the one of the
+// allocating thread, which is where first touch places the pages when the
+// allocating thread also writes them.
+//
+// On platforms other than Linux, it behaves like CPUAllocator.
+class NumaAllocator : public Allocator {
+ public:
+  explicit NumaAllocator(int numa_node = -1,
+                         HugePageMode huge_page_mode = HugePageMode::kNone);
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  int numa_node() const { return numa_node_; }
+
+  HugePageMode huge_page_mode() const { return huge_page_mode_; }
+
+  // The number of NUMA nodes of this machine, 1 if it is unknown.
+  static int GetNumaNodeCount();
+
+  // The NUMA node of the CPU running the calling thread, 0 if it is unknown.
+  static int GetCurrentNumaNode();
+
+  // The size of a huge page, 2MB if it is unknown.
+  static size_t GetHugePageSize();
+
+  // The node that the allocations of the calling thread are bound to, which
+  // takes precedence over the node of the allocator. -1 means not set.
+  static int GetThreadNumaNode();
+  static void SetThreadNumaNode(int numa_node);
+
+ protected:
+  phi::Allocation* AllocateImpl(size_t size) override;
+  void FreeImpl(phi::Allocation* allocation) override;
+
+ private:
+  int numa_node_;
+  HugePageMode huge_page_mode_;
+};
+
+// Bind the allocations of NumaAllocator issued by the current thread to
+// numa_node until the guard is destroyed.
+class NumaNodeGuard {
+ public:
+  explicit NumaNodeGuard(int numa_node)
+      : prev_numa_node_(NumaAllocator::GetThreadNumaNode()) {
+    NumaAllocator::SetThreadNumaNode(numa_node);
+  }
+
+  ~NumaNodeGuard() { NumaAllocator::SetThreadNumaNode(prev_numa_node_); }
+
+ private:
+  int prev_numa_node_;
+
+  DISABLE_COPY_AND_ASSIGN(NumaNodeGuard);
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
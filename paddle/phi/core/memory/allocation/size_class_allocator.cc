@@ -0,0 +1,386 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/size_class_allocator.h"
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "paddle/phi/api/profiler/event_tracing.h"
+#include "paddle/phi/core/memory/allocation/auto_growth_best_fit_allocator.h"
+#include "paddle/phi/core/memory/allocation/spin_lock.h"
+
+namespace paddle::memory::allocation {
+
+namespace {
+
+// A slab holds at least kMinBlocksPerSlab blocks and is at least
+// kMinSlabSize bytes, so that growing a bin is rare for small classes.
+constexpr size_t kMinSlabSize = 64UL << 10;
+constexpr size_t kMinBlocksPerSlab = 8;
+
+// A thread caches about kThreadCacheBytesPerClass bytes of every class, and
+// at least kMinThreadCacheBlocks blocks.
+constexpr size_t kThreadCacheBytesPerClass = 64UL << 10;
+constexpr size_t kMinThreadCacheBlocks = 4;
+constexpr size_t kMaxThreadCacheBlocks = 256;
+
+}  // namespace
+
+struct SizeClassSlab {
+  SizeClassSlab(DecoratedAllocationPtr allocation, size_t class_idx)
+      : allocation_(std::move(allocation)), class_idx_(class_idx) {}
+
+  DecoratedAllocationPtr allocation_;
+  size_t class_idx_;
+  // number of blocks that are not in the central bin, i.e., used by tensors
+  // or cached by threads, guarded by the lock of the bin
+  size_t used_blocks_{0};
+};
+
+struct SizeClassBlock {
+  void *ptr_;
+  SizeClassSlab *slab_;
+};
+
+struct SizeClassAllocation : public Allocation {
+  SizeClassAllocation(const SizeClassBlock &block, size_t size)
+      : Allocation(block.ptr_,
+                   block.slab_->allocation_->base_ptr(),
+                   size,
+                   block.slab_->allocation_->place()),
+        slab_(block.slab_) {}
+
+  SizeClassSlab *slab_;
+};
+
+class SizeClassCentralCache {
+ public:
+  SizeClassCentralCache(std::shared_ptr<Allocator> underlying_allocator,
+                        size_t alignment,
+                        size_t max_small_size)
+      : underlying_allocator_(std::move(underlying_allocator)) {
+    // 4 size classes per power of two, rounded up to alignment.
+    size_t size = alignment;
+    while (size <= max_small_size) {
+      if (class_sizes_.empty() || class_sizes_.back() < size) {
+        class_sizes_.push_back(size);
+      }
+      size_t step = std::max<size_t>(1, size / 4);
+      size = AlignedSize(size + step, alignment);
+    }
+    bins_ = std::vector<Bin>(class_sizes_.size());
+    for (size_t i = 0; i < class_sizes_.size(); ++i) {
+      size_t blocks_per_slab =
+          std::max(kMinBlocksPerSlab, kMinSlabSize / class_sizes_[i]);
+      bins_[i].slab_size_ = blocks_per_slab * class_sizes_[i];
+      thread_cache_capacity_.push_back(
+          std::min(kMaxThreadCacheBlocks,
+                   std::max(kMinThreadCacheBlocks,
+                            kThreadCacheBytesPerClass / class_sizes_[i])));
+    }
+    VLOG(4) << "SizeClassAllocator uses " << class_sizes_.size()
+            << " size classes from " << class_sizes_.front() << " to "
+            << class_sizes_.back() << " bytes";
+  }
+
+  size_t ClassNum() const { return class_sizes_.size(); }
+
+  size_t MaxClassSize() const { return class_sizes_.back(); }
+
+  size_t ClassIndex(size_t size) const {
+    return std::lower_bound(class_sizes_.begin(), class_sizes_.end(), size) -
+           class_sizes_.begin();
+  }
+
+  size_t ClassSize(size_t class_idx) const { return class_sizes_[class_idx]; }
+
+  size_t ThreadCacheCapacity(size_t class_idx) const {
+    return thread_cache_capacity_[class_idx];
+  }
+
+  // Move num blocks of class class_idx to the end of blocks, grow the bin
+  // with a new slab if it has not enough free blocks.
+  void Fetch(size_t class_idx,
+             size_t num,
+             std::vector<SizeClassBlock> *blocks) {
+    Bin &bin = bins_[class_idx];
+    {
+      std::lock_guard<SpinLock> guard(bin.spinlock_);
+      if (bin.free_blocks_.size() >= num) {
+        MoveFreeBlocks(&bin, num, blocks);
+        return;
+      }
+    }
+
+    // allocate the slab outside of the lock, the underlying allocator may
+    // be slow
+    DecoratedAllocationPtr allocation;
+    try {
+      allocation = static_unique_ptr_cast<Allocation>(
+          underlying_allocator_->Allocate(bin.slab_size_));
+    } catch (BadAlloc &ex) {
+      VLOG(2) << "SizeClassAllocator fails to grow size class "
+              << class_sizes_[class_idx] << ", free idle slabs and retry";
+      ReleaseIdleSlabs();
+      allocation = static_unique_ptr_cast<Allocation>(
+          underlying_allocator_->Allocate(bin.slab_size_));
+    }
+
+    std::lock_guard<SpinLock> guard(bin.spinlock_);
+    bin.slabs_.emplace_back(
+        std::make_unique<SizeClassSlab>(std::move(allocation), class_idx));
+    SizeClassSlab *slab = bin.slabs_.back().get();
+    uint8_t *base = reinterpret_cast<uint8_t *>(slab->allocation_->ptr());
+    size_t class_size = class_sizes_[class_idx];
+    // push in reverse order so that the blocks are handed out by address
+    for (size_t offset = bin.slab_size_; offset >= class_size;
+         offset -= class_size) {
+      bin.free_blocks_.push_back(
+          SizeClassBlock{base + offset - class_size, slab});
+    }
+    MoveFreeBlocks(&bin, std::min(num, bin.free_blocks_.size()), blocks);
+  }
+
+  // Return the blocks in [first, last) to their bin.
+  void Return(size_t class_idx,
+              std::vector<SizeClassBlock>::iterator first,
+              std::vector<SizeClassBlock>::iterator last) {
+    Bin &bin = bins_[class_idx];
+    std::lock_guard<SpinLock> guard(bin.spinlock_);
+    for (auto it = first; it != last; ++it) {
+      --(it->slab_->used_blocks_);
+      bin.free_blocks_.push_back(*it);
+    }
+  }
+
+  // Free the slabs whose blocks are all in the central bins.
+  uint64_t ReleaseIdleSlabs() {
+    uint64_t released_size = 0;
+    for (auto &bin : bins_) {
+      std::vector<std::unique_ptr<SizeClassSlab>> idle_slabs;
+      {
+        std::lock_guard<SpinLock> guard(bin.spinlock_);
+        std::unordered_set<SizeClassSlab *> idle_slab_set;
+        for (auto &slab : bin.slabs_) {
+          if (slab->used_blocks_ == 0) {
+            idle_slab_set.insert(slab.get());
+          }
+        }
+        if (idle_slab_set.empty()) {
+          continue;
+        }
+        bin.free_blocks_.erase(
+            std::remove_if(bin.free_blocks_.begin(),
+                           bin.free_blocks_.end(),
+                           [&](const SizeClassBlock &block) {
+                             return idle_slab_set.count(block.slab_) > 0;
+                           }),
+            bin.free_blocks_.end());
+        auto idle_begin = std::partition(
+            bin.slabs_.begin(),
+            bin.slabs_.end(),
+            [&](const std::unique_ptr<SizeClassSlab> &slab) {
+              return idle_slab_set.count(slab.get()) == 0;
+            });
+        std::move(
+            idle_begin, bin.slabs_.end(), std::back_inserter(idle_slabs));
+        bin.slabs_.erase(idle_begin, bin.slabs_.end());
+      }
+      // return the memory to the underlying allocator outside of the lock
+      released_size += idle_slabs.size() * bin.slab_size_;
+    }
+    return released_size;
+  }
+
+ private:
+  struct Bin {
+    SpinLock spinlock_;
+    size_t slab_size_{0};
+    std::vector<SizeClassBlock> free_blocks_;
+    std::vector<std::unique_ptr<SizeClassSlab>> slabs_;
+  };
+
+  void MoveFreeBlocks(Bin *bin,
+                      size_t num,
+                      std::vector<SizeClassBlock> *blocks) {
+    auto first = bin->free_blocks_.end() - num;
+    for (auto it = first; it != bin->free_blocks_.end(); ++it) {
+      ++(it->slab_->used_blocks_);
+      blocks->push_back(*it);
+    }
+    bin->free_blocks_.erase(first, bin->free_blocks_.end());
+  }
+
+  std::shared_ptr<Allocator> underlying_allocator_;
+  std::vector<size_t> class_sizes_;
+  std::vector<size_t> thread_cache_capacity_;
+  std::vector<Bin> bins_;
+};
+
+// The blocks cached by one thread for one SizeClassAllocator. It is only
+// touched by its owner thread, and returns all blocks to the central cache
+// when the thread exits.
+class SizeClassThreadCache {
+ public:
+  explicit SizeClassThreadCache(
+      std::shared_ptr<SizeClassCentralCache> central_cache)
+      : central_cache_(std::move(central_cache)),
+        blocks_(central_cache_->ClassNum()) {}
+
+  ~SizeClassThreadCache() { Flush(); }
+
+  SizeClassBlock Pop(size_t class_idx) {
+    auto &blocks = blocks_[class_idx];
+    if (UNLIKELY(blocks.empty())) {
+      size_t capacity = central_cache_->ThreadCacheCapacity(class_idx);
+      central_cache_->Fetch(
+          class_idx, std::max<size_t>(1, capacity / 2), &blocks);
+    }
+    SizeClassBlock block = blocks.back();
+    blocks.pop_back();
+    return block;
+  }
+
+  void Push(size_t class_idx, const SizeClassBlock &block) {
+    auto &blocks = blocks_[class_idx];
+    blocks.push_back(block);
+    size_t capacity = central_cache_->ThreadCacheCapacity(class_idx);
+    if (UNLIKELY(blocks.size() > capacity)) {
+      // keep the most recently freed half, which is likely still in cache
+      size_t keep = capacity / 2;
+      central_cache_->Return(
+          class_idx, blocks.begin(), blocks.begin() + (blocks.size() - keep));
+      blocks.erase(blocks.begin(), blocks.begin() + (blocks.size() - keep));
+    }
+  }
+
+  void Flush() {
+    for (size_t class_idx = 0; class_idx < blocks_.size(); ++class_idx) {
+      auto &blocks = blocks_[class_idx];
+      if (!blocks.empty()) {
+        central_cache_->Return(class_idx, blocks.begin(), blocks.end());
+        blocks.clear();
+      }
+    }
+  }
+
+ private:
+  std::shared_ptr<SizeClassCentralCache> central_cache_;
+  std::vector<std::vector<SizeClassBlock>> blocks_;
+};
+
+namespace {
+
+struct ThreadCacheHolder {
+  const SizeClassCentralCache *last_owner_{nullptr};
+  SizeClassThreadCache *last_cache_{nullptr};
+  // The thread cache keeps its central cache alive, so the key can not be
+  // reused by another central cache while the entry exists.
+  std::unordered_map<const SizeClassCentralCache *,
+                     std::unique_ptr<SizeClassThreadCache>>
+      caches_;
+};
+
+thread_local ThreadCacheHolder thread_cache_holder;
+
+}  // namespace
+
+SizeClassAllocator::SizeClassAllocator(
+    std::shared_ptr<Allocator> underlying_allocator,
+    size_t alignment,
+    size_t chunk_size,
+    bool allow_free_idle_chunk,
+    size_t max_small_size)
+    : central_cache_(std::make_shared<SizeClassCentralCache>(
+          underlying_allocator, alignment, max_small_size)),
+      large_allocator_(std::make_shared<AutoGrowthBestFitAllocator>(
+          underlying_allocator, alignment, chunk_size, allow_free_idle_chunk)),
+      max_small_size_(central_cache_->MaxClassSize()),
+      allow_free_idle_chunk_(allow_free_idle_chunk) {}
+
+SizeClassAllocator::~SizeClassAllocator() {
+  // Drop the cache of the current thread. Other threads may still hold caches
+  // of this allocator, they keep central_cache_ alive and return their blocks
+  // to it when they exit.
+  if (thread_cache_holder.last_owner_ == central_cache_.get()) {
+    thread_cache_holder.last_owner_ = nullptr;
+    thread_cache_holder.last_cache_ = nullptr;
+  }
+  thread_cache_holder.caches_.erase(central_cache_.get());
+}
+
+size_t SizeClassAllocator::RoundUpSize(size_t size) const {
+  if (size > max_small_size_) {
+    return size;
+  }
+  return central_cache_->ClassSize(central_cache_->ClassIndex(size));
+}
+
+SizeClassThreadCache *SizeClassAllocator::GetThreadCache() {
+  ThreadCacheHolder &holder = thread_cache_holder;
+  const SizeClassCentralCache *owner = central_cache_.get();
+  if (LIKELY(holder.last_owner_ == owner)) {
+    return holder.last_cache_;
+  }
+  auto &cache = holder.caches_[owner];
+  if (cache == nullptr) {
+    cache = std::make_unique<SizeClassThreadCache>(central_cache_);
+  }
+  holder.last_owner_ = owner;
+  holder.last_cache_ = cache.get();
+  return cache.get();
+}
+
+phi::Allocation *SizeClassAllocator::AllocateImpl(size_t size) {
+  if (size > max_small_size_) {
+    return large_allocator_->Allocate(size).release();
+  }
+  size_t class_idx = central_cache_->ClassIndex(size);
+  SizeClassBlock block = GetThreadCache()->Pop(class_idx);
+  return new SizeClassAllocation(block, central_cache_->ClassSize(class_idx));
+}
+
+void SizeClassAllocator::FreeImpl(phi::Allocation *allocation) {
+  // blocks of size classes are never larger than max_small_size_, while
+  // allocations of large_allocator_ are always larger than it
+  if (allocation->size() > max_small_size_) {
+    large_allocator_->Free(allocation);
+    return;
+  }
+  auto *size_class_allocation = static_cast<SizeClassAllocation *>(allocation);
+  SizeClassSlab *slab = size_class_allocation->slab_;
+  GetThreadCache()->Push(slab->class_idx_,
+                         SizeClassBlock{allocation->ptr(), slab});
+  delete size_class_allocation;
+}
+
+uint64_t SizeClassAllocator::ReleaseImpl(const phi::Place &place) {
+  phi::RecordEvent record("SizeClassAllocator::Release",
+                          phi::TracerEventType::UserDefined,
+                          9 /*level*/);
+  uint64_t released_size = large_allocator_->Release(place);
+  if (allow_free_idle_chunk_) {
+    GetThreadCache()->Flush();
+    released_size += central_cache_->ReleaseIdleSlabs();
+  }
+  VLOG(10) << "SizeClassAllocator releases " << released_size << " bytes";
+  return released_size;
+}
+
+}  // namespace paddle::memory::allocation
@@ -0,0 +1,82 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "paddle/phi/core/memory/allocation/allocator.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+class SizeClassCentralCache;
+class SizeClassThreadCache;
+
+// SizeClassAllocator is a CPU allocator for many small, short-lived tensors.
+//
+// Requests not larger than max_small_size are rounded up to one of a fixed
+// set of size classes (4 classes per power of two). Every size class owns
+// slabs carved into equal blocks. A freed block goes to a cache of the
+// freeing thread first, and the next allocation of the same class on that
+// thread takes it back without any lock or atomic operation. Only when the
+// thread cache of a class is empty or full, a batch of blocks is moved
+// from/to the central bin of the class, which is protected by a SpinLock of
+// that class only.
+//
+// Requests larger than max_small_size go to an AutoGrowthBestFitAllocator, so
+// big tensors keep the chunk-growth behaviour of the auto_growth strategy.
+//
+// Release() frees the idle chunks of the large allocator, and the slabs whose
+// blocks are all back in the central bins. Blocks cached by other threads
+// stay cached until those threads allocate, free, or exit.
+class SizeClassAllocator : public Allocator {
+ public:
+  SizeClassAllocator(std::shared_ptr<Allocator> underlying_allocator,
+                     size_t alignment,
+                     size_t chunk_size = 0,
+                     bool allow_free_idle_chunk = true,
+                     size_t max_small_size = kDefaultMaxSmallSize);
+
+  ~SizeClassAllocator() override;
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  // The block size that a request of size bytes takes, for the requests
+  // served by size classes.
+  size_t RoundUpSize(size_t size) const;
+
+  static constexpr size_t kDefaultMaxSmallSize = 256UL << 10;
+
+ protected:
+  phi::Allocation *AllocateImpl(size_t size) override;
+
+  void FreeImpl(phi::Allocation *allocation) override;
+
+  uint64_t ReleaseImpl(const phi::Place &place) override;
+
+ private:
+  SizeClassThreadCache *GetThreadCache();
+
+  std::shared_ptr<SizeClassCentralCache> central_cache_;
+  std::shared_ptr<Allocator> large_allocator_;
+  size_t max_small_size_;
+  bool allow_free_idle_chunk_;
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -120,6 +120,31 @@ void HostMemoryStatResetPeakValue(const std::string& stat_type, int dev_id) {
   StatRegistry::GetInstance()->ResetPeakValue("Host" + stat_type, dev_id);
 }
 
+int64_t HostNumaMemoryStatCurrentValue(const std::string& stat_type,
+                                       int numa_node) {
+  return StatRegistry::GetInstance()->GetCurrentValue("HostNuma" + stat_type,
+                                                      numa_node);
+}
+
+int64_t HostNumaMemoryStatPeakValue(const std::string& stat_type,
+                                    int numa_node) {
+  return StatRegistry::GetInstance()->GetPeakValue("HostNuma" + stat_type,
+                                                   numa_node);
+}
+
+void HostNumaMemoryStatUpdate(const std::string& stat_type,
+                              int numa_node,
+                              int64_t increment) {
+  StatRegistry::GetInstance()->Update(
+      "HostNuma" + stat_type, numa_node, increment);
+}
+
+void HostNumaMemoryStatResetPeakValue(const std::string& stat_type,
+                                      int numa_node) {
+  StatRegistry::GetInstance()->ResetPeakValue("HostNuma" + stat_type,
+                                              numa_node);
+}
+
 void LogDeviceMemoryStats(const phi::Place& place, const std::string& op_name) {
   if (FLAGS_log_memory_stats && phi::is_gpu_place(place)) {
     VLOG(0) << "After launching op_name: " << op_name << ", "
@@ -172,12 +197,28 @@ void LogDeviceMemoryStats(const phi::Place& place, const std::string& op_name) {
   StatRegistry::GetInstance()->Register( \
       "Host" #item, 0, Stat<HostMemoryStat##item##0>::GetInstance());
 
+#define HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, id) \
+  StatRegistry::GetInstance()->Register(                 \
+      "HostNuma" #item, id, Stat<HostNumaMemoryStat##item##id>::GetInstance());
+
+#define HOST_NUMA_MEMORY_STAT_REGISTER(item)       \
+  HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, 0); \
+  HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, 1); \
+  HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, 2); \
+  HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, 3); \
+  HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, 4); \
+  HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, 5); \
+  HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, 6); \
+  HOST_NUMA_MEMORY_STAT_REGISTER_WITH_ID(item, 7)
+
 int RegisterAllStats() {
   DEVICE_MEMORY_STAT_REGISTER(Allocated);
   DEVICE_MEMORY_STAT_REGISTER(Reserved);
 
   HOST_MEMORY_STAT_REGISTER(Allocated);
   HOST_MEMORY_STAT_REGISTER(Reserved);
+
+  HOST_NUMA_MEMORY_STAT_REGISTER(Reserved);
   return 0;
 }
 
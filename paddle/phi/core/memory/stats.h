@@ -154,6 +154,16 @@ void HostMemoryStatUpdate(const std::string& stat_type,
                           int64_t increment);
 void HostMemoryStatResetPeakValue(const std::string& stat_type, int dev_id);
 
+int64_t HostNumaMemoryStatCurrentValue(const std::string& stat_type,
+                                       int numa_node);
+int64_t HostNumaMemoryStatPeakValue(const std::string& stat_type,
+                                    int numa_node);
+void HostNumaMemoryStatUpdate(const std::string& stat_type,
+                              int numa_node,
+                              int64_t increment);
+void HostNumaMemoryStatResetPeakValue(const std::string& stat_type,
+                                      int numa_node);
+
 void LogDeviceMemoryStats(const phi::Place& place, const std::string& op_name);
 
 #define DEVICE_MEMORY_STAT_FUNC_SWITCH_CASE(item, id)               \
@@ -223,6 +233,43 @@ void LogDeviceMemoryStats(const phi::Place& place, const std::string& op_name);
 #define HOST_MEMORY_STAT_RESET_PEAK_VALUE(item, id) \
   HOST_MEMORY_STAT_FUNC(item, id, ResetPeakValue)
 
+#define HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, id)              \
+  case id:                                                            \
+    stat = paddle::memory::Stat<                                      \
+        paddle::memory::HostNumaMemoryStat##item##id>::GetInstance(); \
+    break
+
+#define HOST_NUMA_MEMORY_STAT_FUNC(item, node, func, ...)                     \
+  [&] {                                                                       \
+    paddle::memory::StatBase* stat = nullptr;                                 \
+    switch (node) {                                                           \
+      HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, 0);                        \
+      HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, 1);                        \
+      HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, 2);                        \
+      HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, 3);                        \
+      HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, 4);                        \
+      HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, 5);                        \
+      HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, 6);                        \
+      HOST_NUMA_MEMORY_STAT_FUNC_SWITCH_CASE(item, 7);                        \
+      default:                                                                \
+        PADDLE_THROW(common::errors::OutOfRange(                              \
+            "Only support NUMA node id between [0, 7] for host memory stats," \
+            "not support NUMA node id: %d",                                   \
+            node));                                                           \
+        break;                                                                \
+    }                                                                         \
+    return stat->func(__VA_ARGS__);                                           \
+  }()
+
+#define HOST_NUMA_MEMORY_STAT_CURRENT_VALUE(item, node) \
+  HOST_NUMA_MEMORY_STAT_FUNC(item, node, GetCurrentValue)
+#define HOST_NUMA_MEMORY_STAT_PEAK_VALUE(item, node) \
+  HOST_NUMA_MEMORY_STAT_FUNC(item, node, GetPeakValue)
+#define HOST_NUMA_MEMORY_STAT_UPDATE(item, node, increment) \
+  HOST_NUMA_MEMORY_STAT_FUNC(item, node, Update, increment)
+#define HOST_NUMA_MEMORY_STAT_RESET_PEAK_VALUE(item, node) \
+  HOST_NUMA_MEMORY_STAT_FUNC(item, node, ResetPeakValue)
+
 #define DEVICE_MEMORY_STAT_DECLARE_WITH_ID(item, id) \
   struct DeviceMemoryStat##item##id : public ThreadLocalStatBase {}
 
@@ -248,6 +295,20 @@ void LogDeviceMemoryStats(const phi::Place& place, const std::string& op_name);
 #define HOST_MEMORY_STAT_DECLARE(item) \
   struct HostMemoryStat##item##0 : public ThreadLocalStatBase{};
 
+// Host memory stats of every NUMA node, only support node id in [0, 7]
+#define HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, id) \
+  struct HostNumaMemoryStat##item##id : public ThreadLocalStatBase {}
+
+#define HOST_NUMA_MEMORY_STAT_DECLARE(item)       \
+  HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, 0); \
+  HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, 1); \
+  HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, 2); \
+  HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, 3); \
+  HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, 4); \
+  HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, 5); \
+  HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, 6); \
+  HOST_NUMA_MEMORY_STAT_DECLARE_WITH_ID(item, 7)
+
 // To add a new STAT type, declare here and register in stats.cc
 DEVICE_MEMORY_STAT_DECLARE(Allocated);
 DEVICE_MEMORY_STAT_DECLARE(Reserved);
@@ -255,5 +316,7 @@ DEVICE_MEMORY_STAT_DECLARE(Reserved);
 HOST_MEMORY_STAT_DECLARE(Allocated);
 HOST_MEMORY_STAT_DECLARE(Reserved);
 
+HOST_NUMA_MEMORY_STAT_DECLARE(Reserved);
+
 }  // namespace memory
 }  // namespace paddle
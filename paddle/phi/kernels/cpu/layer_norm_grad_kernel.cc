@@ -19,6 +19,7 @@
 #include "paddle/phi/core/tensor_utils.h"
 #include "paddle/phi/kernels/cpu/elementwise.h"
 #include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/cpu_row_kernels.h"
 #include "paddle/phi/kernels/funcs/elementwise_base.h"
 #include "paddle/phi/kernels/funcs/elementwise_functor.h"
 #include "paddle/phi/kernels/funcs/layer_norm_util.h"
@@ -26,19 +27,53 @@
 
 namespace phi {
 
+// The gradients of the layer norm of float and bfloat16 by the CPU row
+// kernels, from the mean and the variance in float. The gradients of the
+// scale and the bias are of their type.
+template <typename T, typename P>
+void LayerNormGradRowsKernel(const CPUContext& dev_ctx,
+                             const DenseTensor& x,
+                             const DenseTensor* scale,
+                             const DenseTensor& mean,
+                             const DenseTensor& variance,
+                             const DenseTensor& out_grad,
+                             float epsilon,
+                             int begin_norm_axis,
+                             DenseTensor* x_grad,
+                             DenseTensor* scale_grad,
+                             DenseTensor* bias_grad) {
+  auto matrix_dim = common::flatten_to_2d(x.dims(), begin_norm_axis);
+  T* x_grad_data = x_grad ? dev_ctx.template Alloc<T>(x_grad) : nullptr;
+  P* scale_grad_data =
+      scale_grad ? dev_ctx.template Alloc<P>(scale_grad) : nullptr;
+  P* bias_grad_data =
+      bias_grad ? dev_ctx.template Alloc<P>(bias_grad) : nullptr;
+  funcs::LayerNormGradRowsCPU<T, P>(dev_ctx,
+                                    x.data<T>(),
+                                    mean.data<float>(),
+                                    variance.data<float>(),
+                                    scale ? scale->data<P>() : nullptr,
+                                    out_grad.data<T>(),
+                                    matrix_dim[0],
+                                    matrix_dim[1],
+                                    epsilon,
+                                    x_grad_data,
+                                    scale_grad_data,
+                                    bias_grad_data);
+}
+
 template <typename T, typename Context>
-void LayerNormGradKernel(const Context& dev_ctx,
-                         const DenseTensor& x,
-                         const paddle::optional<DenseTensor>& scale_opt,
-                         const paddle::optional<DenseTensor>& bias_opt UNUSED,
-                         const DenseTensor& mean,
-                         const DenseTensor& variance,
-                         const DenseTensor& out_grad,
-                         float epsilon,
-                         int begin_norm_axis,
-                         DenseTensor* x_grad,
-                         DenseTensor* scale_grad,
-                         DenseTensor* bias_grad) {
+void LayerNormGradKernelImpl(const Context& dev_ctx,
+                             const DenseTensor& x,
+                             const paddle::optional<DenseTensor>& scale_opt,
+                             const DenseTensor& mean,
+                             const DenseTensor& variance,
+                             const DenseTensor& out_grad,
+                             float epsilon,
+                             int begin_norm_axis,
+                             DenseTensor* x_grad,
+                             DenseTensor* scale_grad,
+                             DenseTensor* bias_grad) {
   auto* scale = scale_opt.get_ptr();
   auto d_y = out_grad;
 
@@ -152,8 +187,67 @@ void LayerNormGradKernel(const Context& dev_ctx,
   }
 }
 
+template <typename T, typename Context>
+void LayerNormGradKernel(const Context& dev_ctx,
+                         const DenseTensor& x,
+                         const paddle::optional<DenseTensor>& scale_opt,
+                         const paddle::optional<DenseTensor>& bias_opt,
+                         const DenseTensor& mean,
+                         const DenseTensor& variance,
+                         const DenseTensor& out_grad,
+                         float epsilon,
+                         int begin_norm_axis,
+                         DenseTensor* x_grad,
+                         DenseTensor* scale_grad,
+                         DenseTensor* bias_grad) {
+  if constexpr (funcs::IsCPURowKernelType<T>::value) {
+    auto* param = scale_opt ? scale_opt.get_ptr() : bias_opt.get_ptr();
+    if (param == nullptr || param->dtype() == DataType::FLOAT32) {
+      LayerNormGradRowsKernel<T, float>(dev_ctx,
+                                        x,
+                                        scale_opt.get_ptr(),
+                                        mean,
+                                        variance,
+                                        out_grad,
+                                        epsilon,
+                                        begin_norm_axis,
+                                        x_grad,
+                                        scale_grad,
+                                        bias_grad);
+    } else {
+      LayerNormGradRowsKernel<T, T>(dev_ctx,
+                                    x,
+                                    scale_opt.get_ptr(),
+                                    mean,
+                                    variance,
+                                    out_grad,
+                                    epsilon,
+                                    begin_norm_axis,
+                                    x_grad,
+                                    scale_grad,
+                                    bias_grad);
+    }
+  } else {
+    LayerNormGradKernelImpl<T, Context>(dev_ctx,
+                                        x,
+                                        scale_opt,
+                                        mean,
+                                        variance,
+                                        out_grad,
+                                        epsilon,
+                                        begin_norm_axis,
+                                        x_grad,
+                                        scale_grad,
+                                        bias_grad);
+  }
+}
+
 }  // namespace phi
 
-PD_REGISTER_KERNEL(
-    layer_norm_grad, CPU, ALL_LAYOUT, phi::LayerNormGradKernel, float, double) {
-}
+PD_REGISTER_KERNEL(layer_norm_grad,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::LayerNormGradKernel,
+                   float,
+                   double,
+                   phi::dtype::bfloat16) {}
@@ -15,6 +15,7 @@
 #include "paddle/phi/kernels/layer_norm_kernel.h"
 
 #include "paddle/phi/kernels/cpu/elementwise.h"
+#include "paddle/phi/kernels/funcs/cpu_row_kernels.h"
 #include "paddle/phi/kernels/funcs/layer_norm_util.h"
 #if !defined(PADDLE_WITH_CUDA) && !defined(_WIN32) && !defined(__APPLE__) && \
     !defined(__OSX__)
@@ -28,16 +29,76 @@
 
 namespace phi {
 
+// The layer norm of float and bfloat16 by the CPU row kernels, with the mean
+// and the variance in float, and the scale and the bias of T or of float.
+template <typename T>
+void LayerNormRowsKernel(const CPUContext& dev_ctx,
+                         const DenseTensor& x,
+                         const DenseTensor* scale,
+                         const DenseTensor* bias,
+                         float epsilon,
+                         int begin_norm_axis,
+                         DenseTensor* y,
+                         DenseTensor* mean,
+                         DenseTensor* var) {
+  auto matrix_dim = common::flatten_to_2d(x.dims(), begin_norm_axis);
+  int64_t left = matrix_dim[0];
+  int64_t right = matrix_dim[1];
+  for (auto* param : {scale, bias}) {
+    if (param) {
+      PADDLE_ENFORCE_EQ(
+          param->numel(),
+          right,
+          common::errors::InvalidArgument(
+              "The length of scale and bias (%d) is not equal with "
+              "expected (%d).",
+              param->numel(),
+              right));
+    }
+  }
+  T* y_data = dev_ctx.template Alloc<T>(y);
+  float* mean_data = dev_ctx.template Alloc<float>(mean);
+  float* var_data = dev_ctx.template Alloc<float>(var);
+  if (x.numel() == 0) {
+    return;
+  }
+
+  auto* param = scale ? scale : bias;
+  if (param == nullptr || param->dtype() == DataType::FLOAT32) {
+    funcs::LayerNormRowsCPU<T, float>(dev_ctx,
+                                      x.data<T>(),
+                                      scale ? scale->data<float>() : nullptr,
+                                      bias ? bias->data<float>() : nullptr,
+                                      left,
+                                      right,
+                                      epsilon,
+                                      y_data,
+                                      mean_data,
+                                      var_data);
+  } else {
+    funcs::LayerNormRowsCPU<T, T>(dev_ctx,
+                                  x.data<T>(),
+                                  scale ? scale->data<T>() : nullptr,
+                                  bias ? bias->data<T>() : nullptr,
+                                  left,
+                                  right,
+                                  epsilon,
+                                  y_data,
+                                  mean_data,
+                                  var_data);
+  }
+}
+
 template <typename T, typename Context>
-void LayerNormKernel(const Context& dev_ctx,
-                     const DenseTensor& x,
-                     const paddle::optional<DenseTensor>& scale_opt,
-                     const paddle::optional<DenseTensor>& bias_opt,
-                     float epsilon,
-                     int begin_norm_axis,
-                     DenseTensor* y,
-                     DenseTensor* mean,
-                     DenseTensor* var) {
+void LayerNormKernelImpl(const Context& dev_ctx,
+                         const DenseTensor& x,
+                         const paddle::optional<DenseTensor>& scale_opt,
+                         const paddle::optional<DenseTensor>& bias_opt,
+                         float epsilon,
+                         int begin_norm_axis,
+                         DenseTensor* y,
+                         DenseTensor* mean,
+                         DenseTensor* var) {
   const auto x_dims = x.dims();
   auto* scale = scale_opt.get_ptr();
   auto* bias = bias_opt.get_ptr();
@@ -146,10 +207,48 @@ void LayerNormKernel(const Context& dev_ctx,
 #endif
 }
 
+template <typename T, typename Context>
+void LayerNormKernel(const Context& dev_ctx,
+                     const DenseTensor& x,
+                     const paddle::optional<DenseTensor>& scale_opt,
+                     const paddle::optional<DenseTensor>& bias_opt,
+                     float epsilon,
+                     int begin_norm_axis,
+                     DenseTensor* y,
+                     DenseTensor* mean,
+                     DenseTensor* var) {
+  if constexpr (funcs::IsCPURowKernelType<T>::value) {
+    LayerNormRowsKernel<T>(dev_ctx,
+                           x,
+                           scale_opt.get_ptr(),
+                           bias_opt.get_ptr(),
+                           epsilon,
+                           begin_norm_axis,
+                           y,
+                           mean,
+                           var);
+  } else {
+    LayerNormKernelImpl<T, Context>(dev_ctx,
+                                    x,
+                                    scale_opt,
+                                    bias_opt,
+                                    epsilon,
+                                    begin_norm_axis,
+                                    y,
+                                    mean,
+                                    var);
+  }
+}
+
 }  // namespace phi
 
-PD_REGISTER_KERNEL(
-    layer_norm, CPU, ALL_LAYOUT, phi::LayerNormKernel, float, double) {
+PD_REGISTER_KERNEL(layer_norm,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::LayerNormKernel,
+                   float,
+                   double,
+                   phi::dtype::bfloat16) {
   kernel->OutputAt(1).SetDataType(phi::DataType::UNDEFINED);
   kernel->OutputAt(2).SetDataType(phi::DataType::UNDEFINED);
 }
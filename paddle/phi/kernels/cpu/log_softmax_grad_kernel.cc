@@ -17,6 +17,7 @@
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/axis_utils.h"
+#include "paddle/phi/kernels/funcs/cpu_row_kernels.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
 #include "paddle/phi/kernels/funcs/eigen/eigen_function.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
@@ -40,6 +41,18 @@ struct LogSoftmaxGradFunctor {
 
     const int n = funcs::SizeToAxis(axis, Y->dims());
     const int d = funcs::SizeFromAxis(axis, Y->dims());
+    if constexpr (funcs::IsCPURowKernelType<T>::value) {
+      if (d == Y->dims()[axis]) {
+        funcs::SoftmaxGradRowsCPU<T>(context,
+                                     Y->data<T>(),
+                                     dY->data<T>(),
+                                     n,
+                                     d,
+                                     /*log=*/true,
+                                     dX->data<T>());
+        return;
+      }
+    }
     phi::DDim dim_2d{n, d};
 
     auto y = EigenMatrixTemplate<T>::From(*Y, dim_2d);
@@ -90,4 +103,5 @@ PD_REGISTER_KERNEL(log_softmax_grad,
                    ALL_LAYOUT,
                    phi::LogSoftmaxGradKernel,
                    float,
-                   double) {}
+                   double,
+                   phi::dtype::bfloat16) {}
@@ -17,6 +17,7 @@
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/axis_utils.h"
+#include "paddle/phi/kernels/funcs/cpu_row_kernels.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
 #include "paddle/phi/kernels/funcs/eigen/eigen_function.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
@@ -49,6 +50,13 @@ struct LogSoftmaxFunctor {
     int axis_dim = static_cast<int>(X->dims()[axis]);
     const int n = funcs::SizeToAxis(axis, X->dims());
     const int d = funcs::SizeFromAxis(axis, X->dims());
+    if constexpr (funcs::IsCPURowKernelType<T>::value) {
+      if (d == axis_dim) {
+        funcs::SoftmaxRowsCPU<T>(
+            context, X->data<T>(), n, d, /*log=*/true, Y->data<T>());
+        return;
+      }
+    }
     phi::DDim dim_2d{n, d};
 
     auto logits = EigenMatrixTemplate<T>::From(*X, dim_2d);
@@ -124,5 +132,10 @@ void LogSoftmaxKernel(const Context& dev_ctx,
 
 // TODO(YuanRisheng): The layout of onednn kernel should be OneDNN, we should
 // support specifying the exact layout when the kernel is registered
-PD_REGISTER_KERNEL(
-    log_softmax, CPU, ALL_LAYOUT, phi::LogSoftmaxKernel, float, double) {}
+PD_REGISTER_KERNEL(log_softmax,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::LogSoftmaxKernel,
+                   float,
+                   double,
+                   phi::dtype::bfloat16) {}
@@ -15,13 +15,35 @@
 #pragma once
 
 #include <set>
+#include <type_traits>
 
 #include "paddle/phi/core/visit_type.h"
 #include "paddle/phi/kernels/cast_kernel.h"
+#include "paddle/phi/kernels/funcs/cpu_reduce.h"
 #include "paddle/phi/kernels/funcs/reduce_function.h"
 
 namespace phi {
 
+// The reduce of the CPU reduce engine when it has a reducer of Functor on
+// OutT, or the Eigen reduce.
+template <typename DeviceContext, typename T, typename OutT, typename Functor>
+void ReduceKernelImplCPU(const DeviceContext& dev_ctx,
+                         const phi::DenseTensor& input,
+                         phi::DenseTensor* output,
+                         const std::vector<int64_t>& dims,
+                         bool keep_dim,
+                         bool reduce_all) {
+  using CPUReducer = funcs::CPUReducerOf<Functor, OutT>;
+  if constexpr (std::is_same<DeviceContext, CPUContext>::value &&
+                CPUReducer::kSupported) {
+    funcs::ReduceCPUKernelDriver<OutT, CPUReducer::template Reducer>(
+        dev_ctx, input, dims, reduce_all, output);
+  } else {
+    funcs::ReduceKernelImpl<DeviceContext, T, OutT, Functor>(
+        dev_ctx, input, output, dims, keep_dim, reduce_all);
+  }
+}
+
 template <typename DeviceContext, typename T, typename Functor>
 void Reduce(const DeviceContext& dev_ctx,
             const DenseTensor& x,
@@ -49,7 +71,7 @@ void Reduce(const DeviceContext& dev_ctx,
     // do reduce sum
     PD_VISIT_ALL_TYPES(
         x.dtype(), "ReduceKernelImpl", ([&] {
-          phi::funcs::ReduceKernelImpl<DeviceContext, T, data_t, Functor>(
+          ReduceKernelImplCPU<DeviceContext, T, data_t, Functor>(
               dev_ctx, x, out, dims, keep_dim, reduce_all);
         }));
 
@@ -60,7 +82,7 @@ void Reduce(const DeviceContext& dev_ctx,
     // do reduce sum
     PD_VISIT_ALL_TYPES(
         out_dtype, "ReduceKernelImpl", ([&] {
-          phi::funcs::ReduceKernelImpl<DeviceContext, T, data_t, Functor>(
+          ReduceKernelImplCPU<DeviceContext, T, data_t, Functor>(
               dev_ctx, tmp_tensor, out, dims, keep_dim, reduce_all);
         }));
   }
@@ -94,7 +116,7 @@ void BoolReduceKernel(const DeviceContext& dev_ctx,
   } else {
     tmp_tensor = input;
   }
-  funcs::ReduceKernelImpl<DeviceContext, bool, bool, Functor>(
+  ReduceKernelImplCPU<DeviceContext, bool, bool, Functor>(
       dev_ctx, tmp_tensor, output, dims, keep_dim, reduce_all);
 }
 
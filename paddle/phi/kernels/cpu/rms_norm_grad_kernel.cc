@@ -0,0 +1,75 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/rms_norm_grad_kernel.h"
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/cpu_row_kernels.h"
+
+namespace phi {
+
+template <typename T, typename Context>
+void RmsNormGradKernel(const Context& dev_ctx,
+                       const DenseTensor& x,
+                       const paddle::optional<DenseTensor>& bias,
+                       const paddle::optional<DenseTensor>& residual,
+                       const DenseTensor& norm_weight,
+                       const paddle::optional<DenseTensor>& norm_bias,
+                       const DenseTensor& inv_var,
+                       const DenseTensor& out_grad,
+                       const float epsilon UNUSED,
+                       const int begin_norm_axis,
+                       const float quant_scale,
+                       DenseTensor* x_grad,
+                       DenseTensor* norm_weight_grad,
+                       DenseTensor* norm_bias_grad) {
+  if (bias || residual) {
+    PADDLE_THROW(common::errors::Unimplemented(
+        "bias or residual is not supported yet"));
+  }
+  if (quant_scale > 0.0f) {
+    PADDLE_THROW(common::errors::Unimplemented("quant is not supported yet"));
+  }
+
+  auto matrix_dim = common::flatten_to_2d(x.dims(), begin_norm_axis);
+  int64_t rows = matrix_dim[0];
+  int64_t cols = matrix_dim[1];
+  T* x_grad_data = x_grad ? dev_ctx.template Alloc<T>(x_grad) : nullptr;
+  T* norm_weight_grad_data =
+      norm_weight_grad ? dev_ctx.template Alloc<T>(norm_weight_grad) : nullptr;
+  T* norm_bias_grad_data = norm_bias && norm_bias_grad
+                               ? dev_ctx.template Alloc<T>(norm_bias_grad)
+                               : nullptr;
+
+  funcs::RmsNormGradRowsCPU<T>(dev_ctx,
+                               x.data<T>(),
+                               inv_var.data<float>(),
+                               norm_weight.data<T>(),
+                               out_grad.data<T>(),
+                               rows,
+                               cols,
+                               x_grad_data,
+                               norm_weight_grad_data,
+                               norm_bias_grad_data);
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(rms_norm_grad,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::RmsNormGradKernel,
+                   float,
+                   phi::dtype::bfloat16) {}
@@ -18,5 +18,10 @@ limitations under the License. */
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/impl/softmax_kernel_impl.h"
 
-PD_REGISTER_KERNEL(
-    softmax, CPU, ALL_LAYOUT, phi::SoftmaxKernel, float, double) {}
+PD_REGISTER_KERNEL(softmax,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::SoftmaxKernel,
+                   float,
+                   double,
+                   phi::dtype::bfloat16) {}
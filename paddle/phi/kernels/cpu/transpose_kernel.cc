@@ -19,7 +19,8 @@
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/core/kernel_registry.h"
-#include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/funcs/cpu_transpose.h"
 
 namespace phi {
 
@@ -40,40 +41,11 @@ void TransposeKernel(const Context& ctx,
   if (out->numel() == 0) {
     return;
   }
-  int rank = static_cast<int>(formatted_axis.size());
-  switch (rank) {
-    case 0:
-      phi::Copy<Context>(ctx, x, ctx.GetPlace(), false, out);
-      break;
-    case 1:
-      funcs::Transpose<Context, T, 1> trans1;
-      trans1(ctx, x, out, formatted_axis);
-      break;
-    case 2:
-      funcs::Transpose<Context, T, 2> trans2;
-      trans2(ctx, x, out, formatted_axis);
-      break;
-    case 3:
-      funcs::Transpose<Context, T, 3> trans3;
-      trans3(ctx, x, out, formatted_axis);
-      break;
-    case 4:
-      funcs::Transpose<Context, T, 4> trans4;
-      trans4(ctx, x, out, formatted_axis);
-      break;
-    case 5:
-      funcs::Transpose<Context, T, 5> trans5;
-      trans5(ctx, x, out, formatted_axis);
-      break;
-    case 6:
-      funcs::Transpose<Context, T, 6> trans6;
-      trans6(ctx, x, out, formatted_axis);
-      break;
-    default:
-      // for rank >= 7 situation
-      funcs::TransposeNormal<Context, T> trans_normal;
-      trans_normal(ctx, x, out, formatted_axis);
+  if (formatted_axis.empty()) {
+    phi::Copy<Context>(ctx, x, ctx.GetPlace(), false, out);
+    return;
   }
+  funcs::TransposeCPUKernelDriver<T>(ctx, x, formatted_axis, out);
 }
 
 }  // namespace phi
@@ -0,0 +1,123 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/cpu_broadcast.h"
+
+#include <cstdlib>
+
+#include "paddle/phi/kernels/funcs/common_shape.h"
+
+namespace phi {
+namespace funcs {
+
+CPUBroadcastDims::CPUBroadcastDims(const DDim& x_dims,
+                                   const DDim& y_dims,
+                                   int axis) {
+  int max_dim = std::max(x_dims.size(), y_dims.size());
+  axis = (axis == -1 ? std::abs(x_dims.size() - y_dims.size()) : axis);
+  std::vector<int> x_dims_array(max_dim);
+  std::vector<int> y_dims_array(max_dim);
+  std::vector<int> out_dims_array(max_dim);
+  GetBroadcastDimsArrays(x_dims,
+                         y_dims,
+                         x_dims_array.data(),
+                         y_dims_array.data(),
+                         out_dims_array.data(),
+                         max_dim,
+                         axis);
+
+  std::vector<int64_t> x_dim_strides(max_dim), y_dim_strides(max_dim);
+  int64_t x_stride = 1, y_stride = 1;
+  for (int i = max_dim - 1; i >= 0; --i) {
+    x_dim_strides[i] = x_dims_array[i] == 1 ? 0 : x_stride;
+    y_dim_strides[i] = y_dims_array[i] == 1 ? 0 : y_stride;
+    x_stride *= x_dims_array[i];
+    y_stride *= y_dims_array[i];
+  }
+
+  numel = 1;
+  for (int i = 0; i < max_dim; ++i) {
+    int64_t size = out_dims_array[i];
+    numel *= size;
+    if (size == 1) {
+      continue;
+    }
+    // merged into the outer dim when both inputs run on from it
+    if (!sizes.empty() && x_strides.back() == x_dim_strides[i] * size &&
+        y_strides.back() == y_dim_strides[i] * size) {
+      sizes.back() *= size;
+      x_strides.back() = x_dim_strides[i];
+      y_strides.back() = y_dim_strides[i];
+    } else {
+      sizes.push_back(size);
+      x_strides.push_back(x_dim_strides[i]);
+      y_strides.push_back(y_dim_strides[i]);
+    }
+  }
+  if (numel == 0) {
+    sizes.assign(1, 0);
+    x_strides.assign(1, 0);
+    y_strides.assign(1, 0);
+  } else if (sizes.empty()) {
+    // a single element, of the shape of both inputs
+    sizes.push_back(1);
+    x_strides.push_back(1);
+    y_strides.push_back(1);
+  }
+
+  out_strides.resize(sizes.size());
+  int64_t out_stride = 1;
+  for (int i = rank() - 1; i >= 0; --i) {
+    out_strides[i] = out_stride;
+    out_stride *= sizes[i];
+  }
+}
+
+BroadcastOffsets::BroadcastOffsets(const CPUBroadcastDims& dims,
+                                   const std::vector<int>& axes,
+                                   int64_t index) {
+  axes_.resize(axes.size());
+  for (int i = static_cast<int>(axes.size()) - 1; i >= 0; --i) {
+    int axis = axes[i];
+    auto& item = axes_[i];
+    item.size = dims.sizes[axis];
+    item.x_stride = dims.x_strides[axis];
+    item.y_stride = dims.y_strides[axis];
+    item.out_stride = dims.out_strides[axis];
+    item.index = index % item.size;
+    index /= item.size;
+    x_ += item.index * item.x_stride;
+    y_ += item.index * item.y_stride;
+    out_ += item.index * item.out_stride;
+  }
+}
+
+void BroadcastOffsets::Next() {
+  for (int i = static_cast<int>(axes_.size()) - 1; i >= 0; --i) {
+    auto& item = axes_[i];
+    x_ += item.x_stride;
+    y_ += item.y_stride;
+    out_ += item.out_stride;
+    if (++item.index < item.size) {
+      return;
+    }
+    x_ -= item.size * item.x_stride;
+    y_ -= item.size * item.y_stride;
+    out_ -= item.size * item.out_stride;
+    item.index = 0;
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
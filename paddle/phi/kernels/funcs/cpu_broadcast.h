@@ -0,0 +1,405 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/backends/cpu/parallel_for.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/core/ddim.h"
+
+namespace phi {
+namespace funcs {
+
+// The elements of the output of a broadcast run by a task at least.
+constexpr int64_t kCPUBroadcastGrain = 32768;
+
+/**
+ * The dims of the broadcast of x and y, simplified: the dims of size 1 of
+ * the output are dropped, and the dims next to each other broadcast in the
+ * same inputs are merged. The strides of x and y are 0 in the dims they are
+ * broadcast in, out is contiguous.
+ *
+ * So the innermost dim tells the pattern of the inner loop: x and y both
+ * contiguous, or one of them a scalar along it. It is the column broadcast
+ * when y is a scalar along the innermost dim only, the row broadcast when y
+ * is contiguous along it but not along the outer dims, and the scalar
+ * broadcast when there is one dim. The dims left are walked as an odometer.
+ */
+struct CPUBroadcastDims {
+  CPUBroadcastDims(const DDim& x_dims, const DDim& y_dims, int axis);
+
+  int rank() const { return static_cast<int>(sizes.size()); }
+
+  std::vector<int64_t> sizes;
+  std::vector<int64_t> x_strides;
+  std::vector<int64_t> y_strides;
+  std::vector<int64_t> out_strides;
+  int64_t numel;
+};
+
+/**
+ * The offsets into x, y and out of the element index of some of the dims
+ * of a broadcast, the axes given from the outermost. Next() moves to the
+ * next index like an odometer.
+ */
+class BroadcastOffsets {
+ public:
+  BroadcastOffsets(const CPUBroadcastDims& dims,
+                   const std::vector<int>& axes,
+                   int64_t index);
+
+  int64_t x() const { return x_; }
+  int64_t y() const { return y_; }
+  int64_t out() const { return out_; }
+
+  void Next();
+
+ private:
+  struct Axis {
+    int64_t size;
+    int64_t x_stride;
+    int64_t y_stride;
+    int64_t out_stride;
+    int64_t index;
+  };
+  std::vector<Axis> axes_;
+  int64_t x_ = 0;
+  int64_t y_ = 0;
+  int64_t out_ = 0;
+};
+
+// Call f with the strides of x and y along the innermost dim, which are 0
+// or 1, as constants, so the inner loops are vectorized for each pattern.
+template <typename Function>
+inline void DispatchInnerStrides(int64_t x_stride,
+                                 int64_t y_stride,
+                                 const Function& f) {
+  using Stride0 = std::integral_constant<int64_t, 0>;
+  using Stride1 = std::integral_constant<int64_t, 1>;
+  if (x_stride != 0 && y_stride != 0) {
+    f(Stride1(), Stride1());
+  } else if (x_stride != 0) {
+    f(Stride1(), Stride0());
+  } else if (y_stride != 0) {
+    f(Stride0(), Stride1());
+  } else {
+    f(Stride0(), Stride0());
+  }
+}
+
+// Run f(x_offset, y_offset, out_offset, n) on the parts of the lines of the
+// innermost dim, the out elements [out_offset, out_offset + n), which cover
+// the output once, on the intra-op threads of the context.
+template <typename Function>
+void ForEachBroadcastLine(const CPUContext& dev_ctx,
+                          const CPUBroadcastDims& dims,
+                          const Function& f) {
+  int inner_axis = dims.rank() - 1;
+  int64_t inner = dims.sizes[inner_axis];
+  int64_t x_stride = dims.x_strides[inner_axis];
+  int64_t y_stride = dims.y_strides[inner_axis];
+  std::vector<int> outer_axes(inner_axis);
+  for (int i = 0; i < inner_axis; ++i) {
+    outer_axes[i] = i;
+  }
+  ParallelFor(
+      dev_ctx, 0, dims.numel, kCPUBroadcastGrain, [&](int64_t b, int64_t e) {
+        BroadcastOffsets outer(dims, outer_axes, b / inner);
+        int64_t pos = b % inner;
+        while (b < e) {
+          int64_t n = std::min(inner - pos, e - b);
+          f(outer.x() + pos * x_stride, outer.y() + pos * y_stride, b, n);
+          b += n;
+          pos = 0;
+          outer.Next();
+        }
+      });
+}
+
+/**
+ * out = func(x, y) broadcast, or func(y, x) when is_xsize_larger is false,
+ * the order of the arguments of the functors of ElementwiseCompute.
+ */
+template <typename Functor, typename T, typename OutType>
+void CPUBroadcastCompute(const CPUContext& dev_ctx,
+                         const CPUBroadcastDims& dims,
+                         const T* x,
+                         const T* y,
+                         OutType* out,
+                         Functor func,
+                         bool is_xsize_larger) {
+  int inner_axis = dims.rank() - 1;
+  DispatchInnerStrides(
+      dims.x_strides[inner_axis],
+      dims.y_strides[inner_axis],
+      [&](auto x_stride, auto y_stride) {
+        constexpr int64_t kXStride = decltype(x_stride)::value;
+        constexpr int64_t kYStride = decltype(y_stride)::value;
+        ForEachBroadcastLine(
+            dev_ctx,
+            dims,
+            [&](int64_t x_offset, int64_t y_offset, int64_t offset, int64_t n) {
+              const T* x_line = x + x_offset;
+              const T* y_line = y + y_offset;
+              OutType* out_line = out + offset;
+              if (is_xsize_larger) {
+                for (int64_t i = 0; i < n; ++i) {
+                  out_line[i] =
+                      func(x_line[i * kXStride], y_line[i * kYStride]);
+                }
+              } else {
+                for (int64_t i = 0; i < n; ++i) {
+                  out_line[i] =
+                      func(y_line[i * kYStride], x_line[i * kXStride]);
+                }
+              }
+            });
+      });
+}
+
+// dx = dx_op(x, y, out, dout) and dy = dy_op(x, y, out, dout) of the inputs
+// of the shape of the output, either nullptr. Both are computed before
+// they are stored, so they may share the buffer of dout.
+template <typename T, typename Tout, typename DX_OP, typename DY_OP>
+void CPUBroadcastGradMap(const CPUContext& dev_ctx,
+                         const CPUBroadcastDims& dims,
+                         const T* x,
+                         const T* y,
+                         const Tout* out,
+                         const Tout* dout,
+                         DX_OP dx_op,
+                         DY_OP dy_op,
+                         T* dx,
+                         T* dy) {
+  int inner_axis = dims.rank() - 1;
+  DispatchInnerStrides(
+      dims.x_strides[inner_axis],
+      dims.y_strides[inner_axis],
+      [&](auto x_stride, auto y_stride) {
+        constexpr int64_t kXStride = decltype(x_stride)::value;
+        constexpr int64_t kYStride = decltype(y_stride)::value;
+        ForEachBroadcastLine(
+            dev_ctx,
+            dims,
+            [&](int64_t x_offset, int64_t y_offset, int64_t offset, int64_t n) {
+              const T* x_line = x + x_offset;
+              const T* y_line = y + y_offset;
+              const Tout* out_line = out + offset;
+              const Tout* dout_line = dout + offset;
+              if (dx != nullptr && dy != nullptr) {
+                for (int64_t i = 0; i < n; ++i) {
+                  T dx_value = dx_op(x_line[i * kXStride],
+                                     y_line[i * kYStride],
+                                     out_line[i],
+                                     dout_line[i]);
+                  T dy_value = dy_op(x_line[i * kXStride],
+                                     y_line[i * kYStride],
+                                     out_line[i],
+                                     dout_line[i]);
+                  dx[offset + i] = dx_value;
+                  dy[offset + i] = dy_value;
+                }
+              } else if (dx != nullptr) {
+                for (int64_t i = 0; i < n; ++i) {
+                  dx[offset + i] = dx_op(x_line[i * kXStride],
+                                         y_line[i * kYStride],
+                                         out_line[i],
+                                         dout_line[i]);
+                }
+              } else {
+                for (int64_t i = 0; i < n; ++i) {
+                  dy[offset + i] = dy_op(x_line[i * kXStride],
+                                         y_line[i * kYStride],
+                                         out_line[i],
+                                         dout_line[i]);
+                }
+              }
+            });
+      });
+}
+
+/**
+ * grad = sum of op(x, y, out, dout) over the dims the input is broadcast
+ * in, which are those of grad_strides 0, summed in MPType.
+ *
+ * When the innermost dim is not reduced, the rows of the reduced dims are
+ * summed into a block of the gradient. Otherwise each element of the
+ * gradient is a sum of the contiguous lines, in several partial sums. The
+ * elements of the gradient are split between the threads, each summed in
+ * the same order by one thread, so the result does not depend on the
+ * threads.
+ */
+template <typename T, typename Tout, typename Op>
+void CPUBroadcastGradReduce(const CPUContext& dev_ctx,
+                            const CPUBroadcastDims& dims,
+                            const std::vector<int64_t>& grad_strides,
+                            const T* x,
+                            const T* y,
+                            const Tout* out,
+                            const Tout* dout,
+                            Op op,
+                            T* grad) {
+  using MPType = typename phi::dtype::MPTypeTrait<T>::Type;
+  constexpr int64_t kBlock = 512;
+  constexpr int kLanes = 8;
+
+  int inner_axis = dims.rank() - 1;
+  int64_t inner = dims.sizes[inner_axis];
+  std::vector<int> kept_axes, reduced_axes;
+  int64_t grad_numel = 1;
+  for (int i = 0; i < inner_axis; ++i) {
+    if (grad_strides[i] != 0) {
+      kept_axes.push_back(i);
+      grad_numel *= dims.sizes[i];
+    } else {
+      reduced_axes.push_back(i);
+    }
+  }
+  // the reduced lines, of the innermost dim when it is reduced
+  int64_t reduce_numel = dims.numel / inner / grad_numel;
+  bool reduce_inner = grad_strides[inner_axis] == 0;
+  if (!reduce_inner) {
+    grad_numel *= inner;
+  }
+  int64_t grain =
+      std::max<int64_t>(1, kCPUBroadcastGrain * grad_numel / dims.numel);
+
+  DispatchInnerStrides(
+      dims.x_strides[inner_axis],
+      dims.y_strides[inner_axis],
+      [&](auto x_stride, auto y_stride) {
+        constexpr int64_t kXStride = decltype(x_stride)::value;
+        constexpr int64_t kYStride = decltype(y_stride)::value;
+        auto value = [&](const T* x_line,
+                         const T* y_line,
+                         int64_t offset,
+                         int64_t i) {
+          return static_cast<MPType>(op(x_line[i * kXStride],
+                                        y_line[i * kYStride],
+                                        out[offset + i],
+                                        dout[offset + i]));
+        };
+
+        if (!reduce_inner) {
+          ParallelFor(
+              dev_ctx, 0, grad_numel, grain, [&](int64_t b, int64_t e) {
+                std::vector<MPType> sums(std::min(inner, kBlock));
+                BroadcastOffsets kept(dims, kept_axes, b / inner);
+                int64_t pos = b % inner;
+                while (b < e) {
+                  int64_t n = std::min({inner - pos, e - b, kBlock});
+                  std::fill(sums.begin(), sums.begin() + n, MPType(0));
+                  BroadcastOffsets reduced(dims, reduced_axes, 0);
+                  for (int64_t r = 0; r < reduce_numel; ++r) {
+                    const T* x_line =
+                        x + kept.x() + reduced.x() + pos * kXStride;
+                    const T* y_line =
+                        y + kept.y() + reduced.y() + pos * kYStride;
+                    int64_t offset = kept.out() + reduced.out() + pos;
+                    for (int64_t i = 0; i < n; ++i) {
+                      sums[i] += value(x_line, y_line, offset, i);
+                    }
+                    reduced.Next();
+                  }
+                  for (int64_t i = 0; i < n; ++i) {
+                    grad[b + i] = static_cast<T>(sums[i]);
+                  }
+                  b += n;
+                  pos += n;
+                  if (pos == inner) {
+                    pos = 0;
+                    kept.Next();
+                  }
+                }
+              });
+          return;
+        }
+
+        ParallelFor(dev_ctx, 0, grad_numel, grain, [&](int64_t b, int64_t e) {
+          BroadcastOffsets kept(dims, kept_axes, b);
+          for (int64_t g = b; g < e; ++g) {
+            MPType sums[kLanes] = {};
+            BroadcastOffsets reduced(dims, reduced_axes, 0);
+            for (int64_t r = 0; r < reduce_numel; ++r) {
+              const T* x_line = x + kept.x() + reduced.x();
+              const T* y_line = y + kept.y() + reduced.y();
+              int64_t offset = kept.out() + reduced.out();
+              int64_t i = 0;
+              for (; i + kLanes <= inner; i += kLanes) {
+                for (int k = 0; k < kLanes; ++k) {
+                  sums[k] += value(x_line, y_line, offset, i + k);
+                }
+              }
+              for (; i < inner; ++i) {
+                sums[0] += value(x_line, y_line, offset, i);
+              }
+              reduced.Next();
+            }
+            MPType sum = sums[0];
+            for (int k = 1; k < kLanes; ++k) {
+              sum += sums[k];
+            }
+            grad[g] = static_cast<T>(sum);
+            kept.Next();
+          }
+        });
+      });
+}
+
+/**
+ * The gradients of a broadcast binary op, dx and dy either nullptr. The
+ * gradients of the inputs of the shape of the output are computed after
+ * the reduced ones, so they may share the buffer of dout, the reduced ones
+ * may not.
+ */
+template <typename T, typename Tout, typename DX_OP, typename DY_OP>
+void CPUBroadcastGrad(const CPUContext& dev_ctx,
+                      const CPUBroadcastDims& dims,
+                      const T* x,
+                      const T* y,
+                      const Tout* out,
+                      const Tout* dout,
+                      DX_OP dx_op,
+                      DY_OP dy_op,
+                      T* dx,
+                      T* dy) {
+  auto is_full = [](const std::vector<int64_t>& strides) {
+    return std::find(strides.begin(), strides.end(), 0) == strides.end();
+  };
+  bool dx_full = is_full(dims.x_strides);
+  bool dy_full = is_full(dims.y_strides);
+  if (dx != nullptr && !dx_full) {
+    CPUBroadcastGradReduce(
+        dev_ctx, dims, dims.x_strides, x, y, out, dout, dx_op, dx);
+  }
+  if (dy != nullptr && !dy_full) {
+    CPUBroadcastGradReduce(
+        dev_ctx, dims, dims.y_strides, x, y, out, dout, dy_op, dy);
+  }
+  T* dx_map = dx_full ? dx : nullptr;
+  T* dy_map = dy_full ? dy : nullptr;
+  if (dx_map != nullptr || dy_map != nullptr) {
+    CPUBroadcastGradMap(
+        dev_ctx, dims, x, y, out, dout, dx_op, dy_op, dx_map, dy_map);
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
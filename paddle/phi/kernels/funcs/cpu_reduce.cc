@@ -0,0 +1,80 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/cpu_reduce.h"
+
+#include <algorithm>
+
+namespace phi {
+namespace funcs {
+
+CPUReduceShape::CPUReduceShape(const DDim& x_dims,
+                               const std::vector<int64_t>& reduce_dims,
+                               bool reduce_all) {
+  int rank = x_dims.size();
+  std::vector<bool> reduced(rank, reduce_all);
+  // the dims are checked by the infer meta, a 0-D tensor is reduced all
+  for (auto dim : reduce_dims) {
+    if (rank > 0) {
+      reduced[dim < 0 ? dim + rank : dim] = true;
+    }
+  }
+
+  // the merged dims and whether they are reduced
+  std::vector<int64_t> sizes;
+  std::vector<bool> is_reduced;
+  for (int i = 0; i < rank; ++i) {
+    if (x_dims[i] == 1) {
+      continue;
+    }
+    if (!sizes.empty() && is_reduced.back() == reduced[i]) {
+      sizes.back() *= x_dims[i];
+    } else {
+      sizes.push_back(x_dims[i]);
+      is_reduced.push_back(reduced[i]);
+    }
+  }
+
+  int num_reduced =
+      static_cast<int>(std::count(is_reduced.begin(), is_reduced.end(), true));
+  if (num_reduced <= 1) {
+    int64_t* size = &outer;
+    for (size_t i = 0; i < sizes.size(); ++i) {
+      if (is_reduced[i]) {
+        reduce = sizes[i];
+        size = &inner;
+      } else {
+        *size = sizes[i];
+      }
+    }
+    return;
+  }
+
+  dims = sizes;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    if (!is_reduced[i]) {
+      perm.push_back(static_cast<int>(i));
+      outer *= sizes[i];
+    }
+  }
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    if (is_reduced[i]) {
+      perm.push_back(static_cast<int>(i));
+      reduce *= sizes[i];
+    }
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,407 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/backends/cpu/parallel_for.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/kernels/funcs/cpu_broadcast.h"
+#include "paddle/phi/kernels/funcs/cpu_transpose.h"
+#include "paddle/phi/kernels/funcs/reduce_functor.h"
+
+namespace phi {
+namespace funcs {
+
+/**
+ * A reduce of a tensor as [outer, reduce, inner]. The dims of size 1 are
+ * dropped and the dims next to each other both reduced or both kept are
+ * merged. When the reduced dims are still apart, the input is transposed
+ * first, by perm on dims, to [kept dims, reduced dims], so inner is 1.
+ */
+struct CPUReduceShape {
+  CPUReduceShape(const DDim& x_dims,
+                 const std::vector<int64_t>& reduce_dims,
+                 bool reduce_all);
+
+  bool NeedTranspose() const { return !perm.empty(); }
+
+  int64_t outer = 1;
+  int64_t reduce = 1;
+  int64_t inner = 1;
+  std::vector<int64_t> dims;
+  std::vector<int> perm;
+};
+
+// The elements of the input reduced into a partial result at most, the
+// partial results of a reduced line are combined in a pairwise tree. It is
+// fixed, so the result does not depend on the threads.
+constexpr int64_t kCPUReduceBlock = 4096;
+
+// The reducers of the CPU reduce, on the accumulation type MT. Max and Min
+// propagate NaN, like the Eigen reducers of MaxFunctor and MinFunctor.
+template <typename MT>
+struct CPUSumReducer {
+  static MT Identity() { return static_cast<MT>(0); }
+  static MT Combine(MT a, MT b) { return a + b; }
+  static MT Finalize(MT a, int64_t count UNUSED) { return a; }
+};
+
+template <typename MT>
+struct CPUMeanReducer {
+  static MT Identity() { return static_cast<MT>(0); }
+  static MT Combine(MT a, MT b) { return a + b; }
+  static MT Finalize(MT a, int64_t count) {
+    return a / static_cast<MT>(count);
+  }
+};
+
+template <typename MT>
+struct CPUProdReducer {
+  static MT Identity() { return static_cast<MT>(1); }
+  static MT Combine(MT a, MT b) { return a * b; }
+  static MT Finalize(MT a, int64_t count UNUSED) { return a; }
+};
+
+template <typename MT>
+struct CPUMaxReducer {
+  static MT Identity() {
+    return std::numeric_limits<MT>::has_infinity
+               ? -std::numeric_limits<MT>::infinity()
+               : std::numeric_limits<MT>::lowest();
+  }
+  static MT Combine(MT a, MT b) { return (a > b || a != a) ? a : b; }
+  static MT Finalize(MT a, int64_t count UNUSED) { return a; }
+};
+
+template <typename MT>
+struct CPUMinReducer {
+  static MT Identity() {
+    return std::numeric_limits<MT>::has_infinity
+               ? std::numeric_limits<MT>::infinity()
+               : std::numeric_limits<MT>::max();
+  }
+  static MT Combine(MT a, MT b) { return (a < b || a != a) ? a : b; }
+  static MT Finalize(MT a, int64_t count UNUSED) { return a; }
+};
+
+template <typename MT>
+struct CPUAnyReducer {
+  static MT Identity() { return false; }
+  static MT Combine(MT a, MT b) { return a || b; }
+  static MT Finalize(MT a, int64_t count UNUSED) { return a; }
+};
+
+template <typename MT>
+struct CPUAllReducer {
+  static MT Identity() { return true; }
+  static MT Combine(MT a, MT b) { return a && b; }
+  static MT Finalize(MT a, int64_t count UNUSED) { return a; }
+};
+
+// The types reduced by the CPU reduce, the others run the Eigen reduce.
+template <typename T>
+struct IsCPUReduceType
+    : std::integral_constant<bool,
+                             (std::is_arithmetic<T>::value &&
+                              !std::is_same<T, bool>::value) ||
+                                 std::is_same<T, dtype::float16>::value ||
+                                 std::is_same<T, dtype::bfloat16>::value> {};
+
+// The reducer of the CPU reduce of an Eigen reduce functor on T.
+template <typename Functor, typename T>
+struct CPUReducerOf {
+  static constexpr bool kSupported = false;
+};
+
+#define DEFINE_CPU_REDUCER_OF(FUNCTOR, REDUCER)                              \
+  template <typename T>                                                      \
+  struct CPUReducerOf<FUNCTOR, T> {                                          \
+    static constexpr bool kSupported = IsCPUReduceType<T>::value;            \
+    template <typename MT>                                                   \
+    using Reducer = REDUCER<MT>;                                             \
+  }
+
+DEFINE_CPU_REDUCER_OF(SumFunctor, CPUSumReducer);
+DEFINE_CPU_REDUCER_OF(MeanFunctor, CPUMeanReducer);
+DEFINE_CPU_REDUCER_OF(ProdFunctor, CPUProdReducer);
+DEFINE_CPU_REDUCER_OF(MaxFunctor, CPUMaxReducer);
+DEFINE_CPU_REDUCER_OF(MinFunctor, CPUMinReducer);
+
+#undef DEFINE_CPU_REDUCER_OF
+
+template <typename T>
+struct CPUReducerOf<AnyFunctor<T>, bool> {
+  static constexpr bool kSupported = true;
+  template <typename MT>
+  using Reducer = CPUAnyReducer<MT>;
+};
+
+template <typename T>
+struct CPUReducerOf<AllFunctor<T>, bool> {
+  static constexpr bool kSupported = true;
+  template <typename MT>
+  using Reducer = CPUAllReducer<MT>;
+};
+
+// Combine the partial results p[0], ..., p[n - 1] of width elements each
+// into p[0], in a pairwise tree.
+template <typename MT, typename Reducer>
+inline void CombinePartials(MT* p, int64_t n, int64_t width) {
+  for (int64_t step = 1; step < n; step *= 2) {
+    for (int64_t i = 0; i + step < n; i += 2 * step) {
+      MT* a = p + i * width;
+      const MT* b = p + (i + step) * width;
+      for (int64_t k = 0; k < width; ++k) {
+        a[k] = Reducer::Combine(a[k], b[k]);
+      }
+    }
+  }
+}
+
+// The reduce of n contiguous elements, in kLanes partial results.
+template <typename T, typename MT, typename Reducer>
+inline MT ReduceContiguous(const T* x, int64_t n) {
+  constexpr int kLanes = 8;
+  MT acc[kLanes];
+  for (int k = 0; k < kLanes; ++k) {
+    acc[k] = Reducer::Identity();
+  }
+  int64_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    for (int k = 0; k < kLanes; ++k) {
+      acc[k] = Reducer::Combine(acc[k], static_cast<MT>(x[i + k]));
+    }
+  }
+  for (int k = 0; i + k < n; ++k) {
+    acc[k] = Reducer::Combine(acc[k], static_cast<MT>(x[i + k]));
+  }
+  CombinePartials<MT, Reducer>(acc, kLanes, 1);
+  return acc[0];
+}
+
+/**
+ * out[o, i] = reduce of x[o, r, i] over r, in the accumulation type.
+ *
+ * The reduced dim is split into blocks of about kCPUReduceBlock elements,
+ * or of the whole dim when there are enough outputs to run in parallel.
+ * A block of a row (inner 1) is reduced in several accumulators, a block
+ * of columns is reduced row by row into a line of accumulators, which is
+ * vectorized along the inner dim. The partial results of the blocks are
+ * computed in parallel and then combined in a pairwise tree.
+ */
+template <typename T, template <typename> class ReducerT>
+void ReduceCPU(const CPUContext& dev_ctx,
+               const T* x,
+               int64_t outer,
+               int64_t reduce,
+               int64_t inner,
+               T* out) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  using Reducer = ReducerT<MT>;
+  constexpr int64_t kColumnChunk = 512;
+
+  int64_t rows_per_block = reduce;
+  if (outer * inner < kCPUReduceBlock) {
+    rows_per_block = std::max<int64_t>(1, kCPUReduceBlock / inner);
+  }
+  int64_t num_blocks = (reduce + rows_per_block - 1) / rows_per_block;
+  int64_t num_chunks = (inner + kColumnChunk - 1) / kColumnChunk;
+  int64_t work_size = std::min(rows_per_block, reduce) *
+                      std::min(inner, kColumnChunk);
+  int64_t grain = std::max<int64_t>(1, kCPUBroadcastGrain / work_size);
+
+  // partial[o][block][i], not a std::vector for MT of bool
+  std::unique_ptr<MT[]> partial(new MT[outer * num_blocks * inner]);
+  ParallelFor(dev_ctx,
+              0,
+              outer * num_blocks * num_chunks,
+              grain,
+              [&](int64_t begin, int64_t end) {
+                for (int64_t item = begin; item < end; ++item) {
+                  int64_t chunk = item % num_chunks;
+                  int64_t block = item / num_chunks % num_blocks;
+                  int64_t o = item / num_chunks / num_blocks;
+                  int64_t r_begin = block * rows_per_block;
+                  int64_t rows = std::min(rows_per_block, reduce - r_begin);
+                  const T* in = x + (o * reduce + r_begin) * inner;
+                  MT* acc = partial.get() + (o * num_blocks + block) * inner;
+                  if (inner == 1) {
+                    acc[0] = ReduceContiguous<T, MT, Reducer>(in, rows);
+                    continue;
+                  }
+                  int64_t i_begin = chunk * kColumnChunk;
+                  int64_t width = std::min(kColumnChunk, inner - i_begin);
+                  in += i_begin;
+                  acc += i_begin;
+                  for (int64_t k = 0; k < width; ++k) {
+                    acc[k] = static_cast<MT>(in[k]);
+                  }
+                  for (int64_t r = 1; r < rows; ++r) {
+                    const T* line = in + r * inner;
+                    for (int64_t k = 0; k < width; ++k) {
+                      acc[k] = Reducer::Combine(acc[k],
+                                                static_cast<MT>(line[k]));
+                    }
+                  }
+                }
+              });
+
+  int64_t combine_grain = std::max<int64_t>(
+      1, kCPUBroadcastGrain / std::max<int64_t>(1, num_blocks * inner));
+  ParallelFor(dev_ctx, 0, outer, combine_grain, [&](int64_t b, int64_t e) {
+    for (int64_t o = b; o < e; ++o) {
+      MT* p = partial.get() + o * num_blocks * inner;
+      CombinePartials<MT, Reducer>(p, num_blocks, inner);
+      for (int64_t i = 0; i < inner; ++i) {
+        out[o * inner + i] = static_cast<T>(Reducer::Finalize(p[i], reduce));
+      }
+    }
+  });
+}
+
+/**
+ * out = the reduce of x over reduce_dims, or over all dims when reduce_all
+ * is true, with out allocated of the kept dims.
+ */
+template <typename T, template <typename> class ReducerT>
+void ReduceCPUKernelDriver(const CPUContext& dev_ctx,
+                           const DenseTensor& x,
+                           const std::vector<int64_t>& reduce_dims,
+                           bool reduce_all,
+                           DenseTensor* out) {
+  PADDLE_ENFORCE_GT(x.numel(),
+                    0,
+                    common::errors::InvalidArgument(
+                        "Tensor need be reduced must not empty."));
+  CPUReduceShape shape(x.dims(), reduce_dims, reduce_all);
+  const T* x_data = x.data<T>();
+  T* out_data = dev_ctx.template Alloc<T>(out);
+  DenseTensor transposed;
+  if (shape.NeedTranspose()) {
+    transposed.Resize({x.numel()});
+    TransposeCPU(dev_ctx,
+                 x_data,
+                 dev_ctx.template Alloc<T>(&transposed),
+                 sizeof(T),
+                 shape.dims,
+                 shape.perm);
+    x_data = transposed.data<T>();
+  }
+  ReduceCPU<T, ReducerT>(
+      dev_ctx, x_data, shape.outer, shape.reduce, shape.inner, out_data);
+}
+
+// The gradients of the reduces, dx of x, the output y and its gradient dy,
+// with the size of the reduce.
+template <typename Functor, typename T>
+struct CPUReduceGradOf {
+  static constexpr bool kSupported = false;
+};
+
+template <typename T>
+struct CPUReduceGradOf<SumGradFunctor, T> {
+  static constexpr bool kSupported = IsCPUReduceType<T>::value;
+  static T Compute(T x UNUSED, T y UNUSED, T dy, T size UNUSED) { return dy; }
+};
+
+template <typename T>
+struct CPUReduceGradOf<MeanGradFunctor, T> {
+  static constexpr bool kSupported = IsCPUReduceType<T>::value;
+  static T Compute(T x UNUSED, T y UNUSED, T dy, T size) { return dy / size; }
+};
+
+template <typename T>
+struct CPUReduceGradOf<ProdGradFunctor, T> {
+  static constexpr bool kSupported = IsCPUReduceType<T>::value;
+  static T Compute(T x, T y, T dy, T size UNUSED) {
+    return dy * y * (static_cast<T>(1) / x);
+  }
+};
+
+template <typename T>
+struct CPUReduceGradOf<MaxOrMinGradFunctor, T> {
+  static constexpr bool kSupported = IsCPUReduceType<T>::value;
+  static T Compute(T x, T y, T dy, T size UNUSED) {
+    return dy * (x == y ? static_cast<T>(1) : static_cast<T>(0));
+  }
+};
+
+/**
+ * dx = Grad::Compute(x, y, dy, size), with y and dy of the kept dims
+ * broadcast along the reduced dims, which is the broadcast of the CPU
+ * elementwise ops. dx and x are of the shape of the output of the
+ * broadcast. x is not read by the gradients of sum and mean, so it may be
+ * dx.
+ */
+template <typename T, typename Grad>
+void ReduceGradCPU(const CPUContext& dev_ctx,
+                   const DDim& x_dims,
+                   const std::vector<int>& reduce_dims,
+                   bool reduce_all,
+                   const T* x,
+                   const T* y,
+                   const T* dy,
+                   T* dx) {
+  std::vector<int64_t> y_dims(x_dims.size(), 1);
+  if (!reduce_all) {
+    y_dims = common::vectorize<int64_t>(x_dims);
+    for (int dim : reduce_dims) {
+      y_dims[dim < 0 ? dim + x_dims.size() : dim] = 1;
+    }
+  }
+  CPUBroadcastDims dims(x_dims, common::make_ddim(y_dims), -1);
+  int64_t y_numel = 1;
+  for (auto dim : y_dims) {
+    y_numel *= dim;
+  }
+  const T size = static_cast<T>(y_numel == 0 ? 0 : dims.numel / y_numel);
+  int inner_axis = dims.rank() - 1;
+  DispatchInnerStrides(
+      dims.x_strides[inner_axis],
+      dims.y_strides[inner_axis],
+      [&](auto x_stride UNUSED, auto y_stride) {
+        constexpr int64_t kYStride = decltype(y_stride)::value;
+        ForEachBroadcastLine(
+            dev_ctx,
+            dims,
+            [&](int64_t x_offset UNUSED,
+                int64_t y_offset,
+                int64_t offset,
+                int64_t n) {
+              const T* y_line = y + y_offset;
+              const T* dy_line = dy + y_offset;
+              for (int64_t i = 0; i < n; ++i) {
+                dx[offset + i] = Grad::Compute(x[offset + i],
+                                               y_line[i * kYStride],
+                                               dy_line[i * kYStride],
+                                               size);
+              }
+            });
+      });
+}
+
+}  // namespace funcs
+}  // namespace phi
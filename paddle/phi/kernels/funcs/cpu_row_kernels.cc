@@ -0,0 +1,402 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/cpu_row_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/backends/cpu/parallel_for.h"
+#include "paddle/phi/kernels/funcs/cpu_reduce.h"
+#include "paddle/phi/kernels/funcs/cpu_row_kernels_impl.h"
+
+namespace phi {
+namespace funcs {
+
+namespace {
+
+using row_kernels::RowKernels;
+
+// The most blocks of rows of the gradients of the parameters of the norms.
+constexpr int64_t kMaxRowBlocks = 64;
+
+// The vectors of one lane of the generic kernels.
+struct VecGeneric {
+  using Reg = float;
+  static constexpr int64_t kWidth = 1;
+  static float Zero() { return 0.0f; }
+  static float Set1(float a) { return a; }
+  static float Load(const float* p) { return *p; }
+  static float Load(const uint16_t* p) { return row_kernels::LoadScalar(p); }
+  static void Store(float* p, float a) { *p = a; }
+  static void Store(uint16_t* p, float a) { row_kernels::StoreScalar(p, a); }
+  static float Add(float a, float b) { return a + b; }
+  static float Sub(float a, float b) { return a - b; }
+  static float Mul(float a, float b) { return a * b; }
+  static float Fma(float a, float b, float c) { return a * b + c; }
+  static float Max(float a, float b) { return a > b ? a : b; }
+  static float Exp(float a) { return std::exp(a); }
+  static float ReduceAdd(float a) { return a; }
+};
+
+// The type of the elements of the kernels, the bits of bfloat16.
+template <typename T>
+struct RowKernelElement {
+  using Type = T;
+};
+
+template <>
+struct RowKernelElement<dtype::bfloat16> {
+  using Type = uint16_t;
+};
+
+template <typename T>
+using ElementOf = typename RowKernelElement<T>::Type;
+
+template <typename T>
+const ElementOf<T>* Elements(const T* p) {
+  return reinterpret_cast<const ElementOf<T>*>(p);
+}
+
+template <typename T>
+ElementOf<T>* Elements(T* p) {
+  return reinterpret_cast<ElementOf<T>*>(p);
+}
+
+template <typename E>
+const RowKernels<E>* SelectRowKernels() {
+  const RowKernels<E>* kernels = nullptr;
+  if (backends::cpu::MayIUse(backends::cpu::avx512f)) {
+    kernels = row_kernels::RowKernelsAVX512F<E>();
+  }
+  if (kernels == nullptr && backends::cpu::MayIUse(backends::cpu::avx2) &&
+      backends::cpu::MayIUse(backends::cpu::fma3)) {
+    kernels = row_kernels::RowKernelsAVX2<E>();
+  }
+  if (kernels == nullptr) {
+    kernels = row_kernels::MakeRowKernels<VecGeneric, E>();
+  }
+  return kernels;
+}
+
+template <typename T>
+const RowKernels<ElementOf<T>>& GetRowKernels() {
+  static const RowKernels<ElementOf<T>>* kernels =
+      SelectRowKernels<ElementOf<T>>();
+  return *kernels;
+}
+
+int64_t RowGrain(int64_t cols) {
+  return std::max<int64_t>(1, kCPURowKernelGrain / std::max<int64_t>(1, cols));
+}
+
+// The parameters in float, converted into buffer unless they are float.
+template <typename P>
+const float* ParamToFloat(const P* param,
+                          int64_t n,
+                          std::vector<float>* buffer) {
+  if constexpr (std::is_same<P, float>::value) {
+    return param;
+  } else {
+    if (param == nullptr) {
+      return nullptr;
+    }
+    buffer->resize(n);
+    for (int64_t i = 0; i < n; ++i) {
+      (*buffer)[i] = static_cast<float>(param[i]);
+    }
+    return buffer->data();
+  }
+}
+
+/**
+ * Runs f(begin, end, dparam0, dparam1) on the rows, with the gradients of
+ * the parameters of each block of rows added to a zeroed partial result of
+ * its own, nullptr for the gradients not wanted. The blocks depend on the
+ * shape only, and their partial results are combined in a pairwise tree.
+ */
+template <typename P, typename Function>
+void RowsWithParamGrads(const CPUContext& dev_ctx,
+                        int64_t rows,
+                        int64_t cols,
+                        P* dparam0,
+                        P* dparam1,
+                        const Function& f) {
+  if (dparam0 == nullptr && dparam1 == nullptr) {
+    ParallelFor(dev_ctx, 0, rows, RowGrain(cols), [&](int64_t b, int64_t e) {
+      f(b, e, nullptr, nullptr);
+    });
+    return;
+  }
+  int64_t block_rows = std::max<int64_t>(
+      RowGrain(cols), (rows + kMaxRowBlocks - 1) / kMaxRowBlocks);
+  int64_t num_blocks =
+      std::max<int64_t>(1, (rows + block_rows - 1) / block_rows);
+  std::vector<float> partial0(dparam0 ? num_blocks * cols : 0, 0.0f);
+  std::vector<float> partial1(dparam1 ? num_blocks * cols : 0, 0.0f);
+  ParallelFor(dev_ctx, 0, num_blocks, 1, [&](int64_t b, int64_t e) {
+    for (int64_t block = b; block < e; ++block) {
+      int64_t begin = block * block_rows;
+      f(begin,
+        std::min(rows, begin + block_rows),
+        dparam0 ? partial0.data() + block * cols : nullptr,
+        dparam1 ? partial1.data() + block * cols : nullptr);
+    }
+  });
+  for (auto item : {std::make_pair(dparam0, &partial0),
+                    std::make_pair(dparam1, &partial1)}) {
+    if (item.first == nullptr) {
+      continue;
+    }
+    float* partial = item.second->data();
+    CombinePartials<float, CPUSumReducer<float>>(partial, num_blocks, cols);
+    for (int64_t j = 0; j < cols; ++j) {
+      item.first[j] = static_cast<P>(partial[j]);
+    }
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void SoftmaxRowsCPU(const CPUContext& dev_ctx,
+                    const T* x,
+                    int64_t rows,
+                    int64_t cols,
+                    bool log,
+                    T* y) {
+  const auto& kernels = GetRowKernels<T>();
+  ParallelFor(dev_ctx, 0, rows, RowGrain(cols), [&](int64_t b, int64_t e) {
+    kernels.softmax(
+        Elements(x) + b * cols, e - b, cols, log, Elements(y) + b * cols);
+  });
+}
+
+template <typename T>
+void SoftmaxGradRowsCPU(const CPUContext& dev_ctx,
+                        const T* y,
+                        const T* dy,
+                        int64_t rows,
+                        int64_t cols,
+                        bool log,
+                        T* dx) {
+  const auto& kernels = GetRowKernels<T>();
+  ParallelFor(dev_ctx, 0, rows, RowGrain(cols), [&](int64_t b, int64_t e) {
+    kernels.softmax_grad(Elements(y) + b * cols,
+                         Elements(dy) + b * cols,
+                         e - b,
+                         cols,
+                         log,
+                         Elements(dx) + b * cols);
+  });
+}
+
+template <typename T, typename P>
+void LayerNormRowsCPU(const CPUContext& dev_ctx,
+                      const T* x,
+                      const P* scale,
+                      const P* bias,
+                      int64_t rows,
+                      int64_t cols,
+                      float epsilon,
+                      T* y,
+                      float* mean,
+                      float* var) {
+  const auto& kernels = GetRowKernels<T>();
+  std::vector<float> scale_buffer, bias_buffer;
+  const float* scale_data = ParamToFloat(scale, cols, &scale_buffer);
+  const float* bias_data = ParamToFloat(bias, cols, &bias_buffer);
+  ParallelFor(dev_ctx, 0, rows, RowGrain(cols), [&](int64_t b, int64_t e) {
+    kernels.layer_norm(Elements(x) + b * cols,
+                       scale_data,
+                       bias_data,
+                       e - b,
+                       cols,
+                       epsilon,
+                       Elements(y) + b * cols,
+                       mean + b,
+                       var + b);
+  });
+}
+
+template <typename T, typename P>
+void LayerNormGradRowsCPU(const CPUContext& dev_ctx,
+                          const T* x,
+                          const float* mean,
+                          const float* var,
+                          const P* scale,
+                          const T* dy,
+                          int64_t rows,
+                          int64_t cols,
+                          float epsilon,
+                          T* dx,
+                          P* dscale,
+                          P* dbias) {
+  const auto& kernels = GetRowKernels<T>();
+  std::vector<float> scale_buffer;
+  const float* scale_data = ParamToFloat(scale, cols, &scale_buffer);
+  RowsWithParamGrads(
+      dev_ctx,
+      rows,
+      cols,
+      dscale,
+      dbias,
+      [&](int64_t b, int64_t e, float* dscale_data, float* dbias_data) {
+        kernels.layer_norm_grad(Elements(x) + b * cols,
+                                mean + b,
+                                var + b,
+                                scale_data,
+                                Elements(dy) + b * cols,
+                                e - b,
+                                cols,
+                                epsilon,
+                                dx ? Elements(dx) + b * cols : nullptr,
+                                dscale_data,
+                                dbias_data);
+      });
+}
+
+template <typename T>
+void RmsNormRowsCPU(const CPUContext& dev_ctx,
+                    const T* x,
+                    const T* residual,
+                    const T* bias,
+                    const T* weight,
+                    const T* norm_bias,
+                    int64_t rows,
+                    int64_t cols,
+                    float epsilon,
+                    T* y,
+                    T* residual_out,
+                    float* inv_var) {
+  const auto& kernels = GetRowKernels<T>();
+  std::vector<float> bias_buffer, weight_buffer, norm_bias_buffer;
+  const float* bias_data = ParamToFloat(bias, cols, &bias_buffer);
+  const float* weight_data = ParamToFloat(weight, cols, &weight_buffer);
+  const float* norm_bias_data =
+      ParamToFloat(norm_bias, cols, &norm_bias_buffer);
+  ParallelFor(dev_ctx, 0, rows, RowGrain(cols), [&](int64_t b, int64_t e) {
+    kernels.rms_norm(Elements(x) + b * cols,
+                     residual ? Elements(residual) + b * cols : nullptr,
+                     bias_data,
+                     weight_data,
+                     norm_bias_data,
+                     e - b,
+                     cols,
+                     epsilon,
+                     Elements(y) + b * cols,
+                     residual ? Elements(residual_out) + b * cols : nullptr,
+                     inv_var ? inv_var + b : nullptr);
+  });
+}
+
+template <typename T>
+void RmsNormGradRowsCPU(const CPUContext& dev_ctx,
+                        const T* x,
+                        const float* inv_var,
+                        const T* weight,
+                        const T* dy,
+                        int64_t rows,
+                        int64_t cols,
+                        T* dx,
+                        T* dweight,
+                        T* dnorm_bias) {
+  const auto& kernels = GetRowKernels<T>();
+  std::vector<float> weight_buffer;
+  const float* weight_data = ParamToFloat(weight, cols, &weight_buffer);
+  RowsWithParamGrads(
+      dev_ctx,
+      rows,
+      cols,
+      dweight,
+      dnorm_bias,
+      [&](int64_t b, int64_t e, float* dweight_data, float* dnorm_bias_data) {
+        kernels.rms_norm_grad(Elements(x) + b * cols,
+                              inv_var + b,
+                              weight_data,
+                              Elements(dy) + b * cols,
+                              e - b,
+                              cols,
+                              dx ? Elements(dx) + b * cols : nullptr,
+                              dweight_data,
+                              dnorm_bias_data);
+      });
+}
+
+#define INSTANTIATE_CPU_ROW_KERNELS(T)                                       \
+  template void SoftmaxRowsCPU<T>(                                           \
+      const CPUContext&, const T*, int64_t, int64_t, bool, T*);              \
+  template void SoftmaxGradRowsCPU<T>(                                       \
+      const CPUContext&, const T*, const T*, int64_t, int64_t, bool, T*);    \
+  template void RmsNormRowsCPU<T>(const CPUContext&,                         \
+                                  const T*,                                  \
+                                  const T*,                                  \
+                                  const T*,                                  \
+                                  const T*,                                  \
+                                  const T*,                                  \
+                                  int64_t,                                   \
+                                  int64_t,                                   \
+                                  float,                                     \
+                                  T*,                                        \
+                                  T*,                                        \
+                                  float*);                                   \
+  template void RmsNormGradRowsCPU<T>(const CPUContext&,                     \
+                                      const T*,                              \
+                                      const float*,                          \
+                                      const T*,                              \
+                                      const T*,                              \
+                                      int64_t,                               \
+                                      int64_t,                               \
+                                      T*,                                    \
+                                      T*,                                    \
+                                      T*)
+
+#define INSTANTIATE_CPU_LAYER_NORM_ROWS(T, P)                                \
+  template void LayerNormRowsCPU<T, P>(const CPUContext&,                    \
+                                       const T*,                             \
+                                       const P*,                             \
+                                       const P*,                             \
+                                       int64_t,                              \
+                                       int64_t,                              \
+                                       float,                                \
+                                       T*,                                   \
+                                       float*,                               \
+                                       float*);                              \
+  template void LayerNormGradRowsCPU<T, P>(const CPUContext&,                \
+                                           const T*,                         \
+                                           const float*,                     \
+                                           const float*,                     \
+                                           const P*,                         \
+                                           const T*,                         \
+                                           int64_t,                          \
+                                           int64_t,                          \
+                                           float,                            \
+                                           T*,                               \
+                                           P*,                               \
+                                           P*)
+
+INSTANTIATE_CPU_ROW_KERNELS(float);
+INSTANTIATE_CPU_ROW_KERNELS(dtype::bfloat16);
+INSTANTIATE_CPU_LAYER_NORM_ROWS(float, float);
+INSTANTIATE_CPU_LAYER_NORM_ROWS(dtype::bfloat16, dtype::bfloat16);
+INSTANTIATE_CPU_LAYER_NORM_ROWS(dtype::bfloat16, float);
+
+#undef INSTANTIATE_CPU_ROW_KERNELS
+#undef INSTANTIATE_CPU_LAYER_NORM_ROWS
+
+}  // namespace funcs
+}  // namespace phi
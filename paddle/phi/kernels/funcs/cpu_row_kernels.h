@@ -0,0 +1,131 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/common/bfloat16.h"
+
+namespace phi {
+namespace funcs {
+
+// The elements of the rows run by a thread at least.
+constexpr int64_t kCPURowKernelGrain = 16384;
+
+// The types of the CPU row kernels, float and bfloat16, computed in float.
+template <typename T>
+struct IsCPURowKernelType
+    : std::integral_constant<bool,
+                             std::is_same<T, float>::value ||
+                                 std::is_same<T, dtype::bfloat16>::value> {};
+
+/**
+ * The CPU row kernels of softmax, log_softmax, layer_norm and rms_norm, on
+ * rows of cols contiguous elements, run on the intra-op threads of the
+ * context over the rows.
+ *
+ * Each row is computed in float by the kernels of the widest instruction
+ * set of the CPU, AVX-512 or AVX2 with FMA, or by the generic kernels,
+ * found once with MayIUse. The statistics of a row are found in one pass,
+ * by an online softmax or by Welford's algorithm, and the output in a
+ * second one. The gradients of the parameters of the norms are summed in
+ * blocks of rows fixed by the shape and then in a pairwise tree, so they do
+ * not depend on the number of threads.
+ */
+
+// y = softmax(x) of each row, log_softmax(x) when log is true.
+template <typename T>
+void SoftmaxRowsCPU(const CPUContext& dev_ctx,
+                    const T* x,
+                    int64_t rows,
+                    int64_t cols,
+                    bool log,
+                    T* y);
+
+// dx of softmax, or of log_softmax when log is true, from y and dy.
+template <typename T>
+void SoftmaxGradRowsCPU(const CPUContext& dev_ctx,
+                        const T* y,
+                        const T* dy,
+                        int64_t rows,
+                        int64_t cols,
+                        bool log,
+                        T* dx);
+
+// The layer norm of each row with the parameters of P, either of them may
+// be nullptr, writing the mean and the variance of each row.
+template <typename T, typename P>
+void LayerNormRowsCPU(const CPUContext& dev_ctx,
+                      const T* x,
+                      const P* scale,
+                      const P* bias,
+                      int64_t rows,
+                      int64_t cols,
+                      float epsilon,
+                      T* y,
+                      float* mean,
+                      float* var);
+
+// The gradients of the layer norm, any of dx, dscale and dbias may be
+// nullptr.
+template <typename T, typename P>
+void LayerNormGradRowsCPU(const CPUContext& dev_ctx,
+                          const T* x,
+                          const float* mean,
+                          const float* var,
+                          const P* scale,
+                          const T* dy,
+                          int64_t rows,
+                          int64_t cols,
+                          float epsilon,
+                          T* dx,
+                          P* dscale,
+                          P* dbias);
+
+// The rms norm of each row, of x + residual + bias when there is a
+// residual, which is written to residual_out. bias, norm_bias and inv_var
+// may be nullptr.
+template <typename T>
+void RmsNormRowsCPU(const CPUContext& dev_ctx,
+                    const T* x,
+                    const T* residual,
+                    const T* bias,
+                    const T* weight,
+                    const T* norm_bias,
+                    int64_t rows,
+                    int64_t cols,
+                    float epsilon,
+                    T* y,
+                    T* residual_out,
+                    float* inv_var);
+
+// The gradients of the rms norm from its inv_var, any of dx, dweight and
+// dnorm_bias may be nullptr.
+template <typename T>
+void RmsNormGradRowsCPU(const CPUContext& dev_ctx,
+                        const T* x,
+                        const float* inv_var,
+                        const T* weight,
+                        const T* dy,
+                        int64_t rows,
+                        int64_t cols,
+                        T* dx,
+                        T* dweight,
+                        T* dnorm_bias);
+
+}  // namespace funcs
+}  // namespace phi
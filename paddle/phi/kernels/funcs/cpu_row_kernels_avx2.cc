@@ -0,0 +1,127 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The row kernels of AVX2 with FMA, built with the flags of them, and run
+// only when the CPU has them. MSVC has FMA with /arch:AVX2 but does not
+// define __FMA__.
+
+#include "paddle/phi/kernels/funcs/cpu_row_kernels_impl.h"
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#include <immintrin.h>
+#endif
+
+namespace phi {
+namespace funcs {
+namespace row_kernels {
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+
+namespace {
+
+struct VecAVX2 {
+  using Reg = __m256;
+  static constexpr int64_t kWidth = 8;
+
+  static Reg Zero() { return _mm256_setzero_ps(); }
+  static Reg Set1(float a) { return _mm256_set1_ps(a); }
+  static Reg Load(const float* p) { return _mm256_loadu_ps(p); }
+  static Reg Load(const uint16_t* p) {
+    __m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    return _mm256_castsi256_ps(
+        _mm256_slli_epi32(_mm256_cvtepu16_epi32(bits), 16));
+  }
+  static void Store(float* p, Reg a) { _mm256_storeu_ps(p, a); }
+  // Rounded to nearest even, NaN to 0x7FFF, as StoreScalar.
+  static void Store(uint16_t* p, Reg a) {
+    __m256i bits = _mm256_castps_si256(a);
+    __m256i odd =
+        _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+    bits = _mm256_add_epi32(bits,
+                            _mm256_add_epi32(odd, _mm256_set1_epi32(0x7FFF)));
+    bits = _mm256_srli_epi32(bits, 16);
+    __m256 nan = _mm256_cmp_ps(a, a, _CMP_UNORD_Q);
+    bits = _mm256_blendv_epi8(
+        bits, _mm256_set1_epi32(0x7FFF), _mm256_castps_si256(nan));
+    __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(bits),
+                                      _mm256_extracti128_si256(bits, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), packed);
+  }
+
+  static Reg Add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+  static Reg Sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+  static Reg Mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+  static Reg Fma(Reg a, Reg b, Reg c) { return _mm256_fmadd_ps(a, b, c); }
+  static Reg Max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+
+  // The exp of Cephes, 0 below -88 and NaN kept.
+  static Reg Exp(Reg x) {
+    x = _mm256_min_ps(_mm256_set1_ps(88.0f), x);
+    x = _mm256_max_ps(_mm256_set1_ps(-88.0f), x);
+    Reg n = _mm256_round_ps(
+        _mm256_mul_ps(x, _mm256_set1_ps(1.44269504088896341f)),
+        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    Reg r = _mm256_fnmadd_ps(n, _mm256_set1_ps(0.693359375f), x);
+    r = _mm256_fnmadd_ps(n, _mm256_set1_ps(-2.12194440e-4f), r);
+    Reg y = _mm256_set1_ps(1.9875691500E-4f);
+    y = _mm256_fmadd_ps(y, r, _mm256_set1_ps(1.3981999507E-3f));
+    y = _mm256_fmadd_ps(y, r, _mm256_set1_ps(8.3334519073E-3f));
+    y = _mm256_fmadd_ps(y, r, _mm256_set1_ps(4.1665795894E-2f));
+    y = _mm256_fmadd_ps(y, r, _mm256_set1_ps(1.6666665459E-1f));
+    y = _mm256_fmadd_ps(y, r, _mm256_set1_ps(5.0000001201E-1f));
+    y = _mm256_fmadd_ps(
+        y, _mm256_mul_ps(r, r), _mm256_add_ps(r, _mm256_set1_ps(1.0f)));
+    __m256i pow2n = _mm256_slli_epi32(
+        _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(y, _mm256_castsi256_ps(pow2n));
+  }
+
+  static float ReduceAdd(Reg a) {
+    __m128 sum =
+        _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+    return _mm_cvtss_f32(sum);
+  }
+};
+
+}  // namespace
+
+template <>
+const RowKernels<float>* RowKernelsAVX2<float>() {
+  return MakeRowKernels<VecAVX2, float>();
+}
+
+template <>
+const RowKernels<uint16_t>* RowKernelsAVX2<uint16_t>() {
+  return MakeRowKernels<VecAVX2, uint16_t>();
+}
+
+#else
+
+template <>
+const RowKernels<float>* RowKernelsAVX2<float>() {
+  return nullptr;
+}
+
+template <>
+const RowKernels<uint16_t>* RowKernelsAVX2<uint16_t>() {
+  return nullptr;
+}
+
+#endif
+
+}  // namespace row_kernels
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,118 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The row kernels of AVX-512, built with the flags of it, and run only when
+// the CPU has it.
+
+#include "paddle/phi/kernels/funcs/cpu_row_kernels_impl.h"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace phi {
+namespace funcs {
+namespace row_kernels {
+
+#if defined(__AVX512F__)
+
+namespace {
+
+struct VecAVX512F {
+  using Reg = __m512;
+  static constexpr int64_t kWidth = 16;
+
+  static Reg Zero() { return _mm512_setzero_ps(); }
+  static Reg Set1(float a) { return _mm512_set1_ps(a); }
+  static Reg Load(const float* p) { return _mm512_loadu_ps(p); }
+  static Reg Load(const uint16_t* p) {
+    __m256i bits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    return _mm512_castsi512_ps(
+        _mm512_slli_epi32(_mm512_cvtepu16_epi32(bits), 16));
+  }
+  static void Store(float* p, Reg a) { _mm512_storeu_ps(p, a); }
+  // Rounded to nearest even, NaN to 0x7FFF, as StoreScalar.
+  static void Store(uint16_t* p, Reg a) {
+    __m512i bits = _mm512_castps_si512(a);
+    __m512i odd =
+        _mm512_and_si512(_mm512_srli_epi32(bits, 16), _mm512_set1_epi32(1));
+    bits = _mm512_add_epi32(bits,
+                            _mm512_add_epi32(odd, _mm512_set1_epi32(0x7FFF)));
+    bits = _mm512_srli_epi32(bits, 16);
+    __mmask16 nan = _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q);
+    bits = _mm512_mask_blend_epi32(nan, bits, _mm512_set1_epi32(0x7FFF));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p),
+                        _mm512_cvtepi32_epi16(bits));
+  }
+
+  static Reg Add(Reg a, Reg b) { return _mm512_add_ps(a, b); }
+  static Reg Sub(Reg a, Reg b) { return _mm512_sub_ps(a, b); }
+  static Reg Mul(Reg a, Reg b) { return _mm512_mul_ps(a, b); }
+  static Reg Fma(Reg a, Reg b, Reg c) { return _mm512_fmadd_ps(a, b, c); }
+  static Reg Max(Reg a, Reg b) { return _mm512_max_ps(a, b); }
+
+  // The exp of Cephes, 0 below -88 and NaN kept.
+  static Reg Exp(Reg x) {
+    x = _mm512_min_ps(_mm512_set1_ps(88.0f), x);
+    x = _mm512_max_ps(_mm512_set1_ps(-88.0f), x);
+    Reg n = _mm512_roundscale_ps(
+        _mm512_mul_ps(x, _mm512_set1_ps(1.44269504088896341f)),
+        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    Reg r = _mm512_fnmadd_ps(n, _mm512_set1_ps(0.693359375f), x);
+    r = _mm512_fnmadd_ps(n, _mm512_set1_ps(-2.12194440e-4f), r);
+    Reg y = _mm512_set1_ps(1.9875691500E-4f);
+    y = _mm512_fmadd_ps(y, r, _mm512_set1_ps(1.3981999507E-3f));
+    y = _mm512_fmadd_ps(y, r, _mm512_set1_ps(8.3334519073E-3f));
+    y = _mm512_fmadd_ps(y, r, _mm512_set1_ps(4.1665795894E-2f));
+    y = _mm512_fmadd_ps(y, r, _mm512_set1_ps(1.6666665459E-1f));
+    y = _mm512_fmadd_ps(y, r, _mm512_set1_ps(5.0000001201E-1f));
+    y = _mm512_fmadd_ps(
+        y, _mm512_mul_ps(r, r), _mm512_add_ps(r, _mm512_set1_ps(1.0f)));
+    __m512i pow2n = _mm512_slli_epi32(
+        _mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127)), 23);
+    return _mm512_mul_ps(y, _mm512_castsi512_ps(pow2n));
+  }
+
+  static float ReduceAdd(Reg a) { return _mm512_reduce_add_ps(a); }
+};
+
+}  // namespace
+
+template <>
+const RowKernels<float>* RowKernelsAVX512F<float>() {
+  return MakeRowKernels<VecAVX512F, float>();
+}
+
+template <>
+const RowKernels<uint16_t>* RowKernelsAVX512F<uint16_t>() {
+  return MakeRowKernels<VecAVX512F, uint16_t>();
+}
+
+#else
+
+template <>
+const RowKernels<float>* RowKernelsAVX512F<float>() {
+  return nullptr;
+}
+
+template <>
+const RowKernels<uint16_t>* RowKernelsAVX512F<uint16_t>() {
+  return nullptr;
+}
+
+#endif
+
+}  // namespace row_kernels
+}  // namespace funcs
+}  // namespace phi
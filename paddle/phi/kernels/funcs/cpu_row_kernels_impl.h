@@ -0,0 +1,550 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// The kernels of the rows of cpu_row_kernels.h, written once on a vector
+// type V and built by a source file for each instruction set, with the
+// flags of it. They depend on nothing but V and the C math functions, so
+// no inline function of another header is built with the flags of an
+// instruction set the CPU may not have.
+//
+// V has the float vectors Reg of kWidth lanes and the static functions
+// Zero, Set1, Load and Store of float and of the bits of bfloat16, Add,
+// Sub, Mul, Fma(a, b, c) = a * b + c, Max(a, b) which is b when one of them
+// is NaN, Exp and ReduceAdd.
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace phi {
+namespace funcs {
+namespace row_kernels {
+
+/**
+ * The row kernels of an instruction set. They run on the rows given, of
+ * cols contiguous elements of T, which is float or the bits of bfloat16,
+ * single threaded and in float. The parameters of the norms have cols
+ * elements of float, and the kernels of the gradients add the gradients of
+ * the parameters of their rows to dscale, dbias, dweight and dnorm_bias.
+ */
+template <typename T>
+struct RowKernels {
+  void (*softmax)(const T* x, int64_t rows, int64_t cols, bool log, T* y);
+  void (*softmax_grad)(const T* y,
+                       const T* dy,
+                       int64_t rows,
+                       int64_t cols,
+                       bool log,
+                       T* dx);
+  void (*layer_norm)(const T* x,
+                     const float* scale,
+                     const float* bias,
+                     int64_t rows,
+                     int64_t cols,
+                     float epsilon,
+                     T* y,
+                     float* mean,
+                     float* var);
+  void (*layer_norm_grad)(const T* x,
+                          const float* mean,
+                          const float* var,
+                          const float* scale,
+                          const T* dy,
+                          int64_t rows,
+                          int64_t cols,
+                          float epsilon,
+                          T* dx,
+                          float* dscale,
+                          float* dbias);
+  void (*rms_norm)(const T* x,
+                   const T* residual,
+                   const float* bias,
+                   const float* weight,
+                   const float* norm_bias,
+                   int64_t rows,
+                   int64_t cols,
+                   float epsilon,
+                   T* y,
+                   T* residual_out,
+                   float* inv_var);
+  void (*rms_norm_grad)(const T* x,
+                        const float* inv_var,
+                        const float* weight,
+                        const T* dy,
+                        int64_t rows,
+                        int64_t cols,
+                        T* dx,
+                        float* dweight,
+                        float* dnorm_bias);
+};
+
+// The kernels of AVX2 with FMA and of AVX-512, nullptr when the source file
+// of the instruction set is built without its flags.
+template <typename T>
+const RowKernels<T>* RowKernelsAVX2();
+template <typename T>
+const RowKernels<T>* RowKernelsAVX512F();
+
+template <>
+const RowKernels<float>* RowKernelsAVX2<float>();
+template <>
+const RowKernels<uint16_t>* RowKernelsAVX2<uint16_t>();
+template <>
+const RowKernels<float>* RowKernelsAVX512F<float>();
+template <>
+const RowKernels<uint16_t>* RowKernelsAVX512F<uint16_t>();
+
+static inline int64_t Min(int64_t a, int64_t b) { return a < b ? a : b; }
+
+static inline float LoadScalar(const float* p) { return *p; }
+
+static inline float LoadScalar(const uint16_t* p) {
+  uint32_t bits = static_cast<uint32_t>(*p) << 16;
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+static inline void StoreScalar(float* p, float value) { *p = value; }
+
+// Rounded to nearest even, as the conversion of bfloat16.
+static inline void StoreScalar(uint16_t* p, float value) {
+  if (value != value) {
+    *p = 0x7FFF;
+    return;
+  }
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  bits += 0x7FFF + ((bits >> 16) & 1);
+  *p = static_cast<uint16_t>(bits >> 16);
+}
+
+// Loads n <= kWidth elements, the other lanes are fill.
+template <typename V, typename T>
+inline typename V::Reg LoadN(const T* p, int64_t n, float fill) {
+  if (n == V::kWidth) {
+    return V::Load(p);
+  }
+  float buffer[V::kWidth];
+  for (int64_t i = 0; i < V::kWidth; ++i) {
+    buffer[i] = i < n ? LoadScalar(p + i) : fill;
+  }
+  return V::Load(buffer);
+}
+
+template <typename V, typename T>
+inline void StoreN(T* p, int64_t n, typename V::Reg value) {
+  if (n == V::kWidth) {
+    V::Store(p, value);
+    return;
+  }
+  float buffer[V::kWidth];
+  V::Store(buffer, value);
+  for (int64_t i = 0; i < n; ++i) {
+    StoreScalar(p + i, buffer[i]);
+  }
+}
+
+// The sum of f(j, n) over the vectors of a row, in two accumulators.
+template <typename V, typename Function>
+inline typename V::Reg SumVectors(int64_t cols, const Function& f) {
+  constexpr int64_t kWidth = V::kWidth;
+  auto acc0 = V::Zero();
+  auto acc1 = V::Zero();
+  int64_t j = 0;
+  for (; j + 2 * kWidth <= cols; j += 2 * kWidth) {
+    acc0 = V::Add(acc0, f(j, kWidth));
+    acc1 = V::Add(acc1, f(j + kWidth, kWidth));
+  }
+  for (; j < cols; j += kWidth) {
+    acc0 = V::Add(acc0, f(j, Min(kWidth, cols - j)));
+  }
+  return V::Add(acc0, acc1);
+}
+
+/**
+ * y = softmax(x), or log_softmax(x) when log is true, of each row.
+ *
+ * An online softmax: the max and the sum of the exps relative to it are
+ * found in one pass, lane by lane, with the sum rescaled once for each
+ * block of kBlock elements. The second pass writes the output. The shifted
+ * logits are clipped at -64 as the Eigen softmax.
+ */
+template <typename V, typename T>
+void Softmax(const T* x, int64_t rows, int64_t cols, bool log, T* y) {
+  using Reg = typename V::Reg;
+  constexpr int64_t kWidth = V::kWidth;
+  constexpr int64_t kBlock = 16 * kWidth;
+  for (int64_t r = 0; r < rows; ++r) {
+    const T* px = x + r * cols;
+    T* py = y + r * cols;
+    Reg max = V::Set1(-FLT_MAX);
+    Reg sum = V::Zero();
+    for (int64_t b = 0; b < cols; b += kBlock) {
+      int64_t end = Min(cols, b + kBlock);
+      Reg block_max = max;
+      for (int64_t j = b; j < end; j += kWidth) {
+        block_max = V::Max(
+            block_max, LoadN<V>(px + j, Min(kWidth, end - j), -INFINITY));
+      }
+      sum = V::Mul(sum, V::Exp(V::Sub(max, block_max)));
+      for (int64_t j = b; j < end; j += kWidth) {
+        Reg value = LoadN<V>(px + j, Min(kWidth, end - j), -INFINITY);
+        sum = V::Add(sum, V::Exp(V::Sub(value, block_max)));
+      }
+      max = block_max;
+    }
+
+    float lane_max[kWidth];
+    float lane_sum[kWidth];
+    V::Store(lane_max, max);
+    V::Store(lane_sum, sum);
+    float row_max = lane_max[0];
+    for (int64_t i = 1; i < kWidth; ++i) {
+      row_max = lane_max[i] > row_max ? lane_max[i] : row_max;
+    }
+    float row_sum = 0.0f;
+    for (int64_t i = 0; i < kWidth; ++i) {
+      row_sum += lane_sum[i] * expf(lane_max[i] - row_max);
+    }
+
+    Reg shift = V::Set1(row_max);
+    Reg clip = V::Set1(-64.0f);
+    if (log) {
+      Reg log_sum = V::Set1(logf(row_sum));
+      for (int64_t j = 0; j < cols; j += kWidth) {
+        int64_t n = Min(kWidth, cols - j);
+        Reg value = V::Max(clip, V::Sub(LoadN<V>(px + j, n, 0.0f), shift));
+        StoreN<V>(py + j, n, V::Sub(value, log_sum));
+      }
+    } else {
+      Reg inv_sum = V::Set1(1.0f / row_sum);
+      for (int64_t j = 0; j < cols; j += kWidth) {
+        int64_t n = Min(kWidth, cols - j);
+        Reg value = V::Max(clip, V::Sub(LoadN<V>(px + j, n, 0.0f), shift));
+        StoreN<V>(py + j, n, V::Mul(V::Exp(value), inv_sum));
+      }
+    }
+  }
+}
+
+// dx = (dy - sum(dy * y)) * y of softmax, dx = dy - exp(y) * sum(dy) of
+// log_softmax.
+template <typename V, typename T>
+void SoftmaxGrad(
+    const T* y, const T* dy, int64_t rows, int64_t cols, bool log, T* dx) {
+  using Reg = typename V::Reg;
+  constexpr int64_t kWidth = V::kWidth;
+  for (int64_t r = 0; r < rows; ++r) {
+    const T* py = y + r * cols;
+    const T* pdy = dy + r * cols;
+    T* pdx = dx + r * cols;
+    if (log) {
+      Reg sum = SumVectors<V>(cols, [&](int64_t j, int64_t n) {
+        return LoadN<V>(pdy + j, n, 0.0f);
+      });
+      Reg vsum = V::Set1(V::ReduceAdd(sum));
+      for (int64_t j = 0; j < cols; j += kWidth) {
+        int64_t n = Min(kWidth, cols - j);
+        Reg exp_y = V::Exp(LoadN<V>(py + j, n, 0.0f));
+        StoreN<V>(pdx + j,
+                  n,
+                  V::Sub(LoadN<V>(pdy + j, n, 0.0f), V::Mul(exp_y, vsum)));
+      }
+    } else {
+      Reg dot = SumVectors<V>(cols, [&](int64_t j, int64_t n) {
+        return V::Mul(LoadN<V>(py + j, n, 0.0f), LoadN<V>(pdy + j, n, 0.0f));
+      });
+      Reg vdot = V::Set1(V::ReduceAdd(dot));
+      for (int64_t j = 0; j < cols; j += kWidth) {
+        int64_t n = Min(kWidth, cols - j);
+        Reg grad = V::Sub(LoadN<V>(pdy + j, n, 0.0f), vdot);
+        StoreN<V>(pdx + j, n, V::Mul(grad, LoadN<V>(py + j, n, 0.0f)));
+      }
+    }
+  }
+}
+
+/**
+ * y = (x - mean) / sqrt(var + epsilon) * scale + bias of each row, with the
+ * mean and the variance of the row found by Welford's algorithm in each
+ * lane of two accumulators, and then over the lanes and the elements left.
+ */
+template <typename V, typename T>
+void LayerNorm(const T* x,
+               const float* scale,
+               const float* bias,
+               int64_t rows,
+               int64_t cols,
+               float epsilon,
+               T* y,
+               float* mean,
+               float* var) {
+  using Reg = typename V::Reg;
+  constexpr int64_t kWidth = V::kWidth;
+  for (int64_t r = 0; r < rows; ++r) {
+    const T* px = x + r * cols;
+    T* py = y + r * cols;
+    Reg mean0 = V::Zero(), m2_0 = V::Zero();
+    Reg mean1 = V::Zero(), m2_1 = V::Zero();
+    int64_t k = 0;
+    int64_t j = 0;
+    for (; j + 2 * kWidth <= cols; j += 2 * kWidth) {
+      ++k;
+      Reg inv_k = V::Set1(1.0f / static_cast<float>(k));
+      Reg x0 = V::Load(px + j);
+      Reg x1 = V::Load(px + j + kWidth);
+      Reg delta0 = V::Sub(x0, mean0);
+      Reg delta1 = V::Sub(x1, mean1);
+      mean0 = V::Fma(delta0, inv_k, mean0);
+      mean1 = V::Fma(delta1, inv_k, mean1);
+      m2_0 = V::Fma(delta0, V::Sub(x0, mean0), m2_0);
+      m2_1 = V::Fma(delta1, V::Sub(x1, mean1), m2_1);
+    }
+
+    float row_mean = 0.0f;
+    float row_m2 = 0.0f;
+    int64_t count = 0;
+    if (k > 0) {
+      // the lanes of k elements each
+      float lane_mean[2 * kWidth];
+      float lane_m2[2 * kWidth];
+      V::Store(lane_mean, mean0);
+      V::Store(lane_mean + kWidth, mean1);
+      V::Store(lane_m2, m2_0);
+      V::Store(lane_m2 + kWidth, m2_1);
+      for (int64_t i = 0; i < 2 * kWidth; ++i) {
+        row_mean += lane_mean[i];
+      }
+      row_mean /= static_cast<float>(2 * kWidth);
+      for (int64_t i = 0; i < 2 * kWidth; ++i) {
+        float delta = lane_mean[i] - row_mean;
+        row_m2 += lane_m2[i] + static_cast<float>(k) * delta * delta;
+      }
+      count = 2 * kWidth * k;
+    }
+    for (; j < cols; ++j) {
+      float value = LoadScalar(px + j);
+      ++count;
+      float delta = value - row_mean;
+      row_mean += delta / static_cast<float>(count);
+      row_m2 += delta * (value - row_mean);
+    }
+    float row_var = row_m2 / static_cast<float>(cols);
+    mean[r] = row_mean;
+    var[r] = row_var;
+
+    Reg vmean = V::Set1(row_mean);
+    Reg rstd = V::Set1(1.0f / sqrtf(row_var + epsilon));
+    for (j = 0; j < cols; j += kWidth) {
+      int64_t n = Min(kWidth, cols - j);
+      Reg value = V::Mul(V::Sub(LoadN<V>(px + j, n, 0.0f), vmean), rstd);
+      if (scale) {
+        value = V::Mul(value, LoadN<V>(scale + j, n, 0.0f));
+      }
+      if (bias) {
+        value = V::Add(value, LoadN<V>(bias + j, n, 0.0f));
+      }
+      StoreN<V>(py + j, n, value);
+    }
+  }
+}
+
+// With x_hat = (x - mean) * rstd and g = dy * scale,
+// dx = rstd * (g - mean(g) - x_hat * mean(g * x_hat)),
+// dscale += dy * x_hat and dbias += dy.
+template <typename V, typename T>
+void LayerNormGrad(const T* x,
+                   const float* mean,
+                   const float* var,
+                   const float* scale,
+                   const T* dy,
+                   int64_t rows,
+                   int64_t cols,
+                   float epsilon,
+                   T* dx,
+                   float* dscale,
+                   float* dbias) {
+  using Reg = typename V::Reg;
+  constexpr int64_t kWidth = V::kWidth;
+  for (int64_t r = 0; r < rows; ++r) {
+    const T* px = x + r * cols;
+    const T* pdy = dy + r * cols;
+    Reg vmean = V::Set1(mean[r]);
+    float row_rstd = 1.0f / sqrtf(var[r] + epsilon);
+    Reg rstd = V::Set1(row_rstd);
+    Reg sum_g = V::Zero();
+    Reg sum_g_x_hat = V::Zero();
+    for (int64_t j = 0; j < cols; j += kWidth) {
+      int64_t n = Min(kWidth, cols - j);
+      Reg x_hat = V::Mul(V::Sub(LoadN<V>(px + j, n, 0.0f), vmean), rstd);
+      Reg grad = LoadN<V>(pdy + j, n, 0.0f);
+      if (dscale) {
+        StoreN<V>(
+            dscale + j, n, V::Fma(grad, x_hat, LoadN<V>(dscale + j, n, 0.0f)));
+      }
+      if (dbias) {
+        StoreN<V>(dbias + j, n, V::Add(grad, LoadN<V>(dbias + j, n, 0.0f)));
+      }
+      Reg g = scale ? V::Mul(grad, LoadN<V>(scale + j, n, 0.0f)) : grad;
+      sum_g = V::Add(sum_g, g);
+      sum_g_x_hat = V::Fma(g, x_hat, sum_g_x_hat);
+    }
+    if (dx == nullptr) {
+      continue;
+    }
+
+    T* pdx = dx + r * cols;
+    Reg mean_g = V::Set1(V::ReduceAdd(sum_g) / static_cast<float>(cols));
+    Reg mean_g_x_hat =
+        V::Set1(V::ReduceAdd(sum_g_x_hat) / static_cast<float>(cols));
+    for (int64_t j = 0; j < cols; j += kWidth) {
+      int64_t n = Min(kWidth, cols - j);
+      Reg x_hat = V::Mul(V::Sub(LoadN<V>(px + j, n, 0.0f), vmean), rstd);
+      Reg g = LoadN<V>(pdy + j, n, 0.0f);
+      if (scale) {
+        g = V::Mul(g, LoadN<V>(scale + j, n, 0.0f));
+      }
+      Reg value = V::Sub(V::Sub(g, mean_g), V::Mul(x_hat, mean_g_x_hat));
+      StoreN<V>(pdx + j, n, V::Mul(value, rstd));
+    }
+  }
+}
+
+/**
+ * y = x / sqrt(mean(x * x) + epsilon) * weight + norm_bias of each row,
+ * with x = x + residual + bias when there is a residual, which is written
+ * to residual_out. inv_var is 1 / sqrt(mean(x * x) + epsilon).
+ */
+template <typename V, typename T>
+void RmsNorm(const T* x,
+             const T* residual,
+             const float* bias,
+             const float* weight,
+             const float* norm_bias,
+             int64_t rows,
+             int64_t cols,
+             float epsilon,
+             T* y,
+             T* residual_out,
+             float* inv_var) {
+  using Reg = typename V::Reg;
+  constexpr int64_t kWidth = V::kWidth;
+  for (int64_t r = 0; r < rows; ++r) {
+    const T* px = x + r * cols;
+    const T* pr = residual ? residual + r * cols : nullptr;
+    T* py = y + r * cols;
+    auto load = [&](int64_t j, int64_t n) {
+      Reg value = LoadN<V>(px + j, n, 0.0f);
+      if (pr) {
+        value = V::Add(value, LoadN<V>(pr + j, n, 0.0f));
+        if (bias) {
+          value = V::Add(value, LoadN<V>(bias + j, n, 0.0f));
+        }
+      }
+      return value;
+    };
+    Reg square_sum = SumVectors<V>(cols, [&](int64_t j, int64_t n) {
+      Reg value = load(j, n);
+      if (pr) {
+        StoreN<V>(residual_out + r * cols + j, n, value);
+      }
+      return V::Mul(value, value);
+    });
+    float row_inv_var = 1.0f / sqrtf(V::ReduceAdd(square_sum) /
+                                         static_cast<float>(cols) +
+                                     epsilon);
+    if (inv_var) {
+      inv_var[r] = row_inv_var;
+    }
+
+    Reg vinv_var = V::Set1(row_inv_var);
+    for (int64_t j = 0; j < cols; j += kWidth) {
+      int64_t n = Min(kWidth, cols - j);
+      Reg value = V::Mul(V::Mul(load(j, n), vinv_var),
+                         LoadN<V>(weight + j, n, 0.0f));
+      if (norm_bias) {
+        value = V::Add(value, LoadN<V>(norm_bias + j, n, 0.0f));
+      }
+      StoreN<V>(py + j, n, value);
+    }
+  }
+}
+
+// With x_hat = x * inv_var and g = dy * weight,
+// dx = inv_var * (g - x_hat * mean(g * x_hat)), dweight += dy * x_hat and
+// dnorm_bias += dy.
+template <typename V, typename T>
+void RmsNormGrad(const T* x,
+                 const float* inv_var,
+                 const float* weight,
+                 const T* dy,
+                 int64_t rows,
+                 int64_t cols,
+                 T* dx,
+                 float* dweight,
+                 float* dnorm_bias) {
+  using Reg = typename V::Reg;
+  constexpr int64_t kWidth = V::kWidth;
+  for (int64_t r = 0; r < rows; ++r) {
+    const T* px = x + r * cols;
+    const T* pdy = dy + r * cols;
+    Reg vinv_var = V::Set1(inv_var[r]);
+    Reg sum = SumVectors<V>(cols, [&](int64_t j, int64_t n) {
+      Reg x_hat = V::Mul(LoadN<V>(px + j, n, 0.0f), vinv_var);
+      Reg grad = LoadN<V>(pdy + j, n, 0.0f);
+      if (dweight) {
+        StoreN<V>(dweight + j,
+                  n,
+                  V::Fma(grad, x_hat, LoadN<V>(dweight + j, n, 0.0f)));
+      }
+      if (dnorm_bias) {
+        StoreN<V>(dnorm_bias + j,
+                  n,
+                  V::Add(grad, LoadN<V>(dnorm_bias + j, n, 0.0f)));
+      }
+      return V::Mul(V::Mul(grad, LoadN<V>(weight + j, n, 0.0f)), x_hat);
+    });
+    if (dx == nullptr) {
+      continue;
+    }
+
+    T* pdx = dx + r * cols;
+    Reg mean = V::Set1(V::ReduceAdd(sum) / static_cast<float>(cols));
+    for (int64_t j = 0; j < cols; j += kWidth) {
+      int64_t n = Min(kWidth, cols - j);
+      Reg x_hat = V::Mul(LoadN<V>(px + j, n, 0.0f), vinv_var);
+      Reg g = V::Mul(LoadN<V>(pdy + j, n, 0.0f), LoadN<V>(weight + j, n, 0.0f));
+      StoreN<V>(pdx + j, n, V::Mul(V::Sub(g, V::Mul(x_hat, mean)), vinv_var));
+    }
+  }
+}
+
+template <typename V, typename T>
+const RowKernels<T>* MakeRowKernels() {
+  static const RowKernels<T> kernels = {&Softmax<V, T>,
+                                        &SoftmaxGrad<V, T>,
+                                        &LayerNorm<V, T>,
+                                        &LayerNormGrad<V, T>,
+                                        &RmsNorm<V, T>,
+                                        &RmsNormGrad<V, T>};
+  return &kernels;
+}
+
+}  // namespace row_kernels
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,417 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/cpu_transpose.h"
+
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include "paddle/phi/backends/cpu/parallel_for.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/kernels/funcs/dims_simplifier.h"
+
+namespace phi::funcs {
+
+namespace {
+
+// the side of the tiles of a plane, in elements
+constexpr int64_t kTile = 64;
+// the bytes moved by a task of the intra-op threads at least
+constexpr int64_t kGrainBytes = 64 * 1024;
+
+struct Bytes16 {
+  uint64_t data[2];
+};
+
+// The dims of the output other than the ones moved by the inner loops, with
+// the strides of both tensors.
+struct OuterDims {
+  std::vector<int64_t> sizes;
+  std::vector<int64_t> in_strides;
+  std::vector<int64_t> out_strides;
+
+  int64_t Count() const {
+    int64_t count = 1;
+    for (auto size : sizes) {
+      count *= size;
+    }
+    return count;
+  }
+};
+
+// Walks the outer dims in the order of the output from an index.
+class OuterIterator {
+ public:
+  OuterIterator(const OuterDims& dims, int64_t index)
+      : dims_(dims), index_(dims.sizes.size()) {
+    for (int i = static_cast<int>(index_.size()) - 1; i >= 0; --i) {
+      index_[i] = index % dims_.sizes[i];
+      index /= dims_.sizes[i];
+      in_offset_ += index_[i] * dims_.in_strides[i];
+      out_offset_ += index_[i] * dims_.out_strides[i];
+    }
+  }
+
+  int64_t in_offset() const { return in_offset_; }
+  int64_t out_offset() const { return out_offset_; }
+
+  void Next() {
+    for (int i = static_cast<int>(index_.size()) - 1; i >= 0; --i) {
+      in_offset_ += dims_.in_strides[i];
+      out_offset_ += dims_.out_strides[i];
+      if (++index_[i] < dims_.sizes[i]) {
+        return;
+      }
+      in_offset_ -= dims_.sizes[i] * dims_.in_strides[i];
+      out_offset_ -= dims_.sizes[i] * dims_.out_strides[i];
+      index_[i] = 0;
+    }
+  }
+
+ private:
+  const OuterDims& dims_;
+  std::vector<int64_t> index_;
+  int64_t in_offset_{0};
+  int64_t out_offset_{0};
+};
+
+#ifdef __AVX__
+// out[j * ldo + i] = in[i * ldi + j] for i, j < 8
+inline void Transpose8x8(const uint32_t* in_data,
+                         int64_t ldi,
+                         uint32_t* out_data,
+                         int64_t ldo) {
+  // any bits of 4 bytes, moved as float
+  const auto* in = reinterpret_cast<const float*>(in_data);
+  auto* out = reinterpret_cast<float*>(out_data);
+  __m256 r0 = _mm256_loadu_ps(in + 0 * ldi);
+  __m256 r1 = _mm256_loadu_ps(in + 1 * ldi);
+  __m256 r2 = _mm256_loadu_ps(in + 2 * ldi);
+  __m256 r3 = _mm256_loadu_ps(in + 3 * ldi);
+  __m256 r4 = _mm256_loadu_ps(in + 4 * ldi);
+  __m256 r5 = _mm256_loadu_ps(in + 5 * ldi);
+  __m256 r6 = _mm256_loadu_ps(in + 6 * ldi);
+  __m256 r7 = _mm256_loadu_ps(in + 7 * ldi);
+
+  __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+  __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+  __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+  __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+  __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+  __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+  __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+  __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+
+  r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  r4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+  r5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+  r6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+  r7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+  _mm256_storeu_ps(out + 0 * ldo, _mm256_permute2f128_ps(r0, r4, 0x20));
+  _mm256_storeu_ps(out + 1 * ldo, _mm256_permute2f128_ps(r1, r5, 0x20));
+  _mm256_storeu_ps(out + 2 * ldo, _mm256_permute2f128_ps(r2, r6, 0x20));
+  _mm256_storeu_ps(out + 3 * ldo, _mm256_permute2f128_ps(r3, r7, 0x20));
+  _mm256_storeu_ps(out + 4 * ldo, _mm256_permute2f128_ps(r0, r4, 0x31));
+  _mm256_storeu_ps(out + 5 * ldo, _mm256_permute2f128_ps(r1, r5, 0x31));
+  _mm256_storeu_ps(out + 6 * ldo, _mm256_permute2f128_ps(r2, r6, 0x31));
+  _mm256_storeu_ps(out + 7 * ldo, _mm256_permute2f128_ps(r3, r7, 0x31));
+}
+
+// out[j * ldo + i] = in[i * ldi + j] for i, j < 4
+inline void Transpose4x4(const uint64_t* in_data,
+                         int64_t ldi,
+                         uint64_t* out_data,
+                         int64_t ldo) {
+  const auto* in = reinterpret_cast<const double*>(in_data);
+  auto* out = reinterpret_cast<double*>(out_data);
+  __m256d r0 = _mm256_loadu_pd(in + 0 * ldi);
+  __m256d r1 = _mm256_loadu_pd(in + 1 * ldi);
+  __m256d r2 = _mm256_loadu_pd(in + 2 * ldi);
+  __m256d r3 = _mm256_loadu_pd(in + 3 * ldi);
+
+  __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+  __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+  __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+  __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+
+  _mm256_storeu_pd(out + 0 * ldo, _mm256_permute2f128_pd(t0, t2, 0x20));
+  _mm256_storeu_pd(out + 1 * ldo, _mm256_permute2f128_pd(t1, t3, 0x20));
+  _mm256_storeu_pd(out + 2 * ldo, _mm256_permute2f128_pd(t0, t2, 0x31));
+  _mm256_storeu_pd(out + 3 * ldo, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+#endif
+
+template <typename T>
+void TransposeTileScalar(const T* in,
+                         int64_t ldi,
+                         T* out,
+                         int64_t ldo,
+                         int64_t rows,
+                         int64_t cols) {
+  for (int64_t j = 0; j < cols; ++j) {
+    for (int64_t i = 0; i < rows; ++i) {
+      out[j * ldo + i] = in[i * ldi + j];
+    }
+  }
+}
+
+// out[j * ldo + i] = in[i * ldi + j] for i < rows, j < cols, by the micro
+// kernel of block x block elements where it fits.
+template <typename T, typename Micro>
+void TransposeTile(const T* in,
+                   int64_t ldi,
+                   T* out,
+                   int64_t ldo,
+                   int64_t rows,
+                   int64_t cols,
+                   int64_t block,
+                   Micro micro) {
+  int64_t full_rows = rows / block * block;
+  int64_t full_cols = cols / block * block;
+  for (int64_t i = 0; i < full_rows; i += block) {
+    for (int64_t j = 0; j < full_cols; j += block) {
+      micro(in + i * ldi + j, ldi, out + j * ldo + i, ldo);
+    }
+  }
+  TransposeTileScalar(
+      in + full_cols, ldi, out + full_cols * ldo, ldo, rows, cols - full_cols);
+  TransposeTileScalar(in + full_rows * ldi,
+                      ldi,
+                      out + full_rows,
+                      ldo,
+                      rows - full_rows,
+                      full_cols);
+}
+
+template <typename T>
+void TransposeTileOf(const T* in,
+                     int64_t ldi,
+                     T* out,
+                     int64_t ldo,
+                     int64_t rows,
+                     int64_t cols) {
+#ifdef __AVX__
+  if constexpr (std::is_same<T, uint32_t>::value) {
+    TransposeTile(in, ldi, out, ldo, rows, cols, 8, Transpose8x8);
+    return;
+  } else if constexpr (std::is_same<T, uint64_t>::value) {
+    TransposeTile(in, ldi, out, ldo, rows, cols, 4, Transpose4x4);
+    return;
+  }
+#endif
+  TransposeTileScalar(in, ldi, out, ldo, rows, cols);
+}
+
+void CopyCPU(const CPUContext& ctx, const char* in, char* out, int64_t bytes) {
+  ParallelFor(ctx, 0, bytes, kGrainBytes, [&](int64_t begin, int64_t end) {
+    std::memcpy(out + begin, in + begin, end - begin);
+  });
+}
+
+// The innermost dim stays innermost, copy the rows of it. The rows along
+// the last outer dim are copied by the inner loop.
+template <typename T>
+void TransposeRows(const CPUContext& ctx,
+                   const T* in,
+                   T* out,
+                   int64_t row_size,
+                   OuterDims outer) {
+  int64_t rows = outer.sizes.back();
+  int64_t in_stride = outer.in_strides.back();
+  int64_t out_stride = outer.out_strides.back();
+  outer.sizes.pop_back();
+  outer.in_strides.pop_back();
+  outer.out_strides.pop_back();
+  int64_t row_bytes = row_size * sizeof(T);
+  int64_t grain = std::max<int64_t>(1, kGrainBytes / (rows * row_bytes));
+  ParallelFor(ctx, 0, outer.Count(), grain, [&](int64_t begin, int64_t end) {
+    OuterIterator it(outer, begin);
+    for (int64_t index = begin; index < end; ++index, it.Next()) {
+      const T* in_row = in + it.in_offset();
+      T* out_row = out + it.out_offset();
+      for (int64_t row = 0; row < rows; ++row) {
+        std::memcpy(out_row, in_row, row_bytes);
+        in_row += in_stride;
+        out_row += out_stride;
+      }
+    }
+  });
+}
+
+// Transpose the plane of the input dim moved innermost, of rows elements
+// and stride ldi in the input, and of the input innermost dim, of cols
+// elements and stride ldo in the output, for each index of the outer dims.
+template <typename T>
+void TransposePlanes(const CPUContext& ctx,
+                     const T* in,
+                     T* out,
+                     int64_t rows,
+                     int64_t ldi,
+                     int64_t cols,
+                     int64_t ldo,
+                     const OuterDims& outer) {
+  int64_t row_tiles = (rows + kTile - 1) / kTile;
+  int64_t col_tiles = (cols + kTile - 1) / kTile;
+  int64_t tiles = row_tiles * col_tiles;
+  int64_t grain =
+      std::max<int64_t>(1, kGrainBytes / (kTile * kTile * sizeof(T)));
+  ParallelFor(
+      ctx, 0, outer.Count() * tiles, grain, [&](int64_t begin, int64_t end) {
+        OuterIterator it(outer, begin / tiles);
+        for (int64_t index = begin; index < end; ++index) {
+          int64_t tile = index % tiles;
+          if (tile == 0 && index != begin) {
+            it.Next();
+          }
+          int64_t i = tile / col_tiles * kTile;
+          int64_t j = tile % col_tiles * kTile;
+          TransposeTileOf(in + it.in_offset() + i * ldi + j,
+                          ldi,
+                          out + it.out_offset() + j * ldo + i,
+                          ldo,
+                          std::min(kTile, rows - i),
+                          std::min(kTile, cols - j));
+        }
+      });
+}
+
+template <typename T>
+void TransposeImpl(const CPUContext& ctx,
+                   const T* in,
+                   T* out,
+                   const std::vector<int64_t>& dims,
+                   const std::vector<int>& perm) {
+  int rank = static_cast<int>(dims.size());
+  std::vector<int64_t> in_strides(rank, 1);
+  std::vector<int64_t> out_strides(rank, 1);
+  for (int i = rank - 2; i >= 0; --i) {
+    in_strides[i] = in_strides[i + 1] * dims[i + 1];
+    out_strides[i] = out_strides[i + 1] * dims[perm[i + 1]];
+  }
+
+  // the dims of the output but the inner ones, in its order
+  auto outer_dims = [&](int inner_out_dims, int skip_in_dim) {
+    OuterDims outer;
+    for (int i = 0; i < rank - inner_out_dims; ++i) {
+      if (perm[i] != skip_in_dim) {
+        outer.sizes.push_back(dims[perm[i]]);
+        outer.in_strides.push_back(in_strides[perm[i]]);
+        outer.out_strides.push_back(out_strides[i]);
+      }
+    }
+    return outer;
+  };
+
+  if (perm[rank - 1] == rank - 1) {
+    TransposeRows(ctx, in, out, dims[rank - 1], outer_dims(1, -1));
+    return;
+  }
+
+  // the input dim moved innermost, and the dim of the output where the
+  // input innermost dim goes
+  int moved_dim = perm[rank - 1];
+  int out_dim =
+      static_cast<int>(std::find(perm.begin(), perm.end(), rank - 1) -
+                       perm.begin());
+  TransposePlanes(ctx,
+                  in,
+                  out,
+                  dims[moved_dim],
+                  in_strides[moved_dim],
+                  dims[rank - 1],
+                  out_strides[out_dim],
+                  outer_dims(1, rank - 1));
+}
+
+}  // namespace
+
+void TransposeCPU(const CPUContext& ctx,
+                  const void* in,
+                  void* out,
+                  size_t elem_size,
+                  const std::vector<int64_t>& dims,
+                  const std::vector<int>& perm) {
+  int64_t numel = 1;
+  for (auto dim : dims) {
+    numel *= dim;
+  }
+  if (numel == 0) {
+    return;
+  }
+
+  PermuteDimsSimplifier simplifier(
+      static_cast<int>(dims.size()), numel, perm, dims);
+  const auto& simple_perm = simplifier.GetPerm();
+  const auto& simple_dims = simplifier.GetSrcDims();
+  if (simplifier.GetRank() == 1) {
+    CopyCPU(ctx,
+            static_cast<const char*>(in),
+            static_cast<char*>(out),
+            numel * static_cast<int64_t>(elem_size));
+    return;
+  }
+
+  switch (elem_size) {
+    case 1:
+      TransposeImpl(ctx,
+                    static_cast<const uint8_t*>(in),
+                    static_cast<uint8_t*>(out),
+                    simple_dims,
+                    simple_perm);
+      break;
+    case 2:
+      TransposeImpl(ctx,
+                    static_cast<const uint16_t*>(in),
+                    static_cast<uint16_t*>(out),
+                    simple_dims,
+                    simple_perm);
+      break;
+    case 4:
+      TransposeImpl(ctx,
+                    static_cast<const uint32_t*>(in),
+                    static_cast<uint32_t*>(out),
+                    simple_dims,
+                    simple_perm);
+      break;
+    case 8:
+      TransposeImpl(ctx,
+                    static_cast<const uint64_t*>(in),
+                    static_cast<uint64_t*>(out),
+                    simple_dims,
+                    simple_perm);
+      break;
+    case 16:
+      TransposeImpl(ctx,
+                    static_cast<const Bytes16*>(in),
+                    static_cast<Bytes16*>(out),
+                    simple_dims,
+                    simple_perm);
+      break;
+    default:
+      PADDLE_THROW(common::errors::Unimplemented(
+          "Transpose of elements of %d bytes is not supported on CPU.",
+          elem_size));
+  }
+}
+
+}  // namespace phi::funcs
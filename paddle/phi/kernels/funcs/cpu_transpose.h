@@ -0,0 +1,58 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+namespace funcs {
+
+/**
+ * Transpose of elements of elem_size bytes, out[i_0, ..., i_n] =
+ * in[j_0, ..., j_n] with j_perm[k] = i_k.
+ *
+ * The dims are simplified first, the size 1 dims are dropped and the dims
+ * staying next to each other are merged. Then it is a copy of the rows when
+ * the innermost dim stays innermost, or a transpose of the planes of the
+ * innermost dims of the input and of the output, in tiles, with AVX micro
+ * kernels for the elements of 4 and 8 bytes. Both run on the intra-op
+ * threads of the context.
+ */
+void TransposeCPU(const CPUContext& ctx,
+                  const void* in,
+                  void* out,
+                  size_t elem_size,
+                  const std::vector<int64_t>& dims,
+                  const std::vector<int>& perm);
+
+template <typename T>
+void TransposeCPUKernelDriver(const CPUContext& ctx,
+                              const DenseTensor& in,
+                              const std::vector<int>& perm,
+                              DenseTensor* out) {
+  TransposeCPU(ctx,
+               in.data<T>(),
+               out->data<T>(),
+               sizeof(T),
+               common::vectorize<int64_t>(in.dims()),
+               perm);
+}
+
+}  // namespace funcs
+}  // namespace phi
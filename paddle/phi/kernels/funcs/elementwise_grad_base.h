@@ -22,6 +22,7 @@ limitations under the License. */
 #include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/kernels/funcs/common_shape.h"
+#include "paddle/phi/kernels/funcs/cpu_broadcast.h"
 #include "paddle/phi/kernels/funcs/elementwise_utils.h"
 #include "paddle/phi/kernels/funcs/for_range.h"
 
@@ -49,219 +50,6 @@ namespace phi {
 namespace funcs {
 using DDim = phi::DDim;
 
-template <typename T, typename DX_OP, typename DY_OP, typename Tout = T>
-void CommonGradBroadcastCPU(const DenseTensor &x,
-                            const DenseTensor &y,
-                            const DenseTensor &out,
-                            const DenseTensor &dout,
-                            DenseTensor *dx,
-                            DenseTensor *dy,
-                            int *x_dims_array,
-                            int *y_dims_array,
-                            int *out_dims_array,
-                            int max_dim,
-                            const CPUContext &ctx,
-                            DX_OP dx_op,
-                            DY_OP dy_op) {
-  std::vector<int> index_array(max_dim, 0);
-  const T *x_data = x.data<T>();
-  const T *y_data = y.data<T>();
-  const Tout *out_data = out.data<Tout>();
-  const Tout *dout_data = dout.data<Tout>();
-  T *dx_data = dx == nullptr ? nullptr : ctx.Alloc<T>(dx);
-  T *dy_data = dy == nullptr ? nullptr : ctx.Alloc<T>(dy);
-  if (dx_data != nullptr) {
-    memset(dx_data, 0, dx->numel() * sizeof(T));
-  }
-  if (dy_data != nullptr) {
-    memset(dy_data, 0, dy->numel() * sizeof(T));
-  }
-  const int out_size = std::accumulate(
-      out_dims_array, out_dims_array + max_dim, 1, std::multiplies<int>());
-  int x_index, y_index;
-  for (int out_index = 0; out_index < out_size; ++out_index) {
-    x_index = GetElementwiseIndex(x_dims_array, max_dim, index_array.data());
-    y_index = GetElementwiseIndex(y_dims_array, max_dim, index_array.data());
-    if (dx_data != nullptr) {
-      dx_data[x_index] += dx_op(x_data[x_index],
-                                y_data[y_index],
-                                out_data[out_index],
-                                dout_data[out_index]);
-    }
-    if (dy_data != nullptr) {
-      dy_data[y_index] += dy_op(x_data[x_index],
-                                y_data[y_index],
-                                out_data[out_index],
-                                dout_data[out_index]);
-    }
-
-    UpdateElementwiseIndexArray(out_dims_array, max_dim, index_array.data());
-  }
-}
-
-template <typename T, typename DX_OP, typename DY_OP, typename Tout = T>
-static void ElemwiseGradBroadcast1CPU(const T *x,
-                                      const T *y,
-                                      const Tout *out,
-                                      const Tout *dout,
-                                      int h,
-                                      int w,
-                                      bool is_xsize_larger,
-                                      DX_OP dx_op,
-                                      DY_OP dy_op,
-                                      T *dx,
-                                      T *dy) {
-  using MPType = typename phi::dtype::MPTypeTrait<T>::Type;
-
-  if (is_xsize_larger) {
-    for (int j = 0; j < w; ++j) {
-      MPType sum_y = static_cast<MPType>(0);
-      for (int i = 0; i < h; ++i) {
-        int x_offset = i * w + j;
-        if (dx != nullptr) {
-          dx[x_offset] =
-              dx_op(x[x_offset], y[j], out[x_offset], dout[x_offset]);
-        }
-        if (dy != nullptr) {
-          sum_y += static_cast<MPType>(
-              dy_op(x[x_offset], y[j], out[x_offset], dout[x_offset]));
-        }
-      }
-      if (dy != nullptr) {
-        dy[j] = static_cast<T>(sum_y);
-      }
-    }
-  } else {
-    for (int j = 0; j < w; ++j) {
-      MPType sum_x = static_cast<MPType>(0);
-      for (int i = 0; i < h; ++i) {
-        int y_offset = i * w + j;
-        if (dy != nullptr) {
-          dy[y_offset] =
-              dy_op(x[j], y[y_offset], out[y_offset], dout[y_offset]);
-        }
-        if (dx != nullptr) {
-          sum_x += static_cast<MPType>(
-              dx_op(x[j], y[y_offset], out[y_offset], dout[y_offset]));
-        }
-      }
-      if (dx != nullptr) {
-        dx[j] = static_cast<T>(sum_x);
-      }
-    }
-  }
-}
-
-template <typename T, typename DX_OP, typename DY_OP, typename Tout = T>
-static void ElemwiseGradBroadcast2CPU(const T *x,
-                                      const T *y,
-                                      const Tout *out,
-                                      const Tout *dout,
-                                      int pre,
-                                      int n,
-                                      int post,
-                                      bool is_xsize_larger,
-                                      DX_OP dx_op,
-                                      DY_OP dy_op,
-                                      T *dx,
-                                      T *dy) {
-  using MPType = typename phi::dtype::MPTypeTrait<T>::Type;
-
-  if (is_xsize_larger) {
-    for (int j = 0; j < n; ++j) {
-      MPType sum_y = static_cast<MPType>(0);
-      for (int i = 0; i < pre; ++i) {
-        for (int k = 0; k < post; ++k) {
-          int x_offset = i * n * post + j * post + k;
-          if (dx != nullptr) {
-            dx[x_offset] =
-                dx_op(x[x_offset], y[j], out[x_offset], dout[x_offset]);
-          }
-          if (dy != nullptr) {
-            sum_y += static_cast<MPType>(
-                dy_op(x[x_offset], y[j], out[x_offset], dout[x_offset]));
-          }
-        }
-      }
-      if (dy != nullptr) {
-        dy[j] = static_cast<T>(sum_y);
-      }
-    }
-  } else {
-    for (int j = 0; j < n; ++j) {
-      MPType sum_x = static_cast<MPType>(0);
-      for (int i = 0; i < pre; ++i) {
-        for (int k = 0; k < post; ++k) {
-          int y_offset = i * n * post + j * post + k;
-          if (dy != nullptr) {
-            dy[y_offset] =
-                dy_op(x[j], y[y_offset], out[y_offset], dout[y_offset]);
-          }
-          if (dx != nullptr) {
-            sum_x += static_cast<MPType>(
-                dx_op(x[j], y[y_offset], out[y_offset], dout[y_offset]));
-          }
-        }
-      }
-      if (dx != nullptr) {
-        dx[j] = static_cast<T>(sum_x);
-      }
-    }
-  }
-}
-
-template <typename T, typename DX_OP, typename DY_OP, typename Tout = T>
-void CommonElementwiseBroadcastBackward(const CPUContext &ctx,
-                                        const DDim &x_dims,
-                                        const DDim &y_dims,
-                                        const DenseTensor &x,
-                                        const DenseTensor &y,
-                                        const DenseTensor &out,
-                                        const DenseTensor &dout,
-                                        int axis,
-                                        DenseTensor *dx,
-                                        DenseTensor *dy,
-                                        DX_OP dx_op,
-                                        DY_OP dy_op) {
-  int max_dim = std::max(x_dims.size(), y_dims.size());
-  axis = (axis == -1 ? std::abs(x_dims.size() - y_dims.size()) : axis);
-  std::vector<int> x_dims_array(max_dim);
-  std::vector<int> y_dims_array(max_dim);
-  std::vector<int> out_dims_array(max_dim);
-  GetBroadcastDimsArrays(x_dims,
-                         y_dims,
-                         x_dims_array.data(),
-                         y_dims_array.data(),
-                         out_dims_array.data(),
-                         max_dim,
-                         axis);
-  // for inplace strategy. memset will make dx and dout clear and get wrong
-  // result.
-  if (dx && dx->IsSharedBufferWith(dout)) {
-    dx->clear();
-    dx->Resize(x_dims);
-    ctx.template Alloc<T>(dx);
-  }
-
-  VLOG(3) << "CommonElementwiseBroadcastBackward xdims:"
-          << common::make_ddim(x_dims_array)
-          << " ydim:" << common::make_ddim(y_dims_array);
-
-  CommonGradBroadcastCPU<T, DX_OP, DY_OP, Tout>(x,
-                                                y,
-                                                out,
-                                                dout,
-                                                dx,
-                                                dy,
-                                                x_dims_array.data(),
-                                                y_dims_array.data(),
-                                                out_dims_array.data(),
-                                                max_dim,
-                                                ctx,
-                                                dx_op,
-                                                dy_op);
-}
-
 template <typename T, typename DX_OP, typename DY_OP, typename Tout = T>
 void ElemwiseGradComputeWithBroadcast(const CPUContext &ctx,
                                       const DDim &x_dims,
@@ -275,83 +63,44 @@ void ElemwiseGradComputeWithBroadcast(const CPUContext &ctx,
                                       DenseTensor *dy,
                                       DX_OP dx_op,
                                       DY_OP dy_op) {
-  bool is_xsize_larger = true;
-
-  int max_dim = x_dims.size();
-  if (x_dims.size() < y_dims.size()) {
-    is_xsize_larger = false;
-    max_dim = y_dims.size();
+  CPUBroadcastDims broadcast_dims(x_dims, y_dims, axis);
+  T *dx_data = nullptr;
+  T *dy_data = nullptr;
+  // for inplace strategy. a reduced gradient is written while dout is read,
+  // so it gets a buffer of its own.
+  if (dx != nullptr) {
+    if (dx->numel() != dout.numel() && dx->IsSharedBufferWith(dout)) {
+      dx->clear();
+      dx->Resize(x_dims);
+    }
+    dx_data = ctx.Alloc<T>(dx);
   }
-
-  axis = (axis == -1 ? std::abs(x_dims.size() - y_dims.size()) : axis);
-  PADDLE_ENFORCE_GE(
-      axis,
-      0,
-      errors::InvalidArgument(
-          "Axis should be great than or equal to 0, but received axis is %d.",
-          axis));
-  PADDLE_ENFORCE_LE(
-      axis,
-      max_dim,
-      errors::InvalidArgument(
-          "Axis should be less than or equal to %d, but received axis is %d.",
-          max_dim,
-          axis));
-
-  int pre, n, post, is_run_common_broadcast, axis_trim = 0;
-  if (is_xsize_larger) {
-    auto y_dims_trimmed = TrimTrailingSingularDims(y_dims);
-    axis_trim = (y_dims_trimmed.size() == 0) ? x_dims.size() : axis;
-    GetMidDims(x_dims,
-               y_dims_trimmed,
-               axis_trim,
-               &pre,
-               &n,
-               &post,
-               &is_run_common_broadcast);
-  } else {
-    auto x_dims_trimmed = TrimTrailingSingularDims(x_dims);
-    axis_trim = (x_dims_trimmed.size() == 0) ? y_dims.size() : axis;
-    GetMidDims(y_dims,
-               x_dims_trimmed,
-               axis_trim,
-               &pre,
-               &n,
-               &post,
-               &is_run_common_broadcast);
+  if (dy != nullptr) {
+    if (dy->numel() != dout.numel() && dy->IsSharedBufferWith(dout)) {
+      dy->clear();
+      dy->Resize(y_dims);
+    }
+    dy_data = ctx.Alloc<T>(dy);
   }
-  // special case for common backward implementation.
-  if (is_run_common_broadcast) {
-    CommonElementwiseBroadcastBackward<T, DX_OP, DY_OP, Tout>(
-        ctx, x_dims, y_dims, x, y, out, dout, axis, dx, dy, dx_op, dy_op);
+  if (broadcast_dims.numel == 0) {
+    if (dx_data != nullptr) {
+      std::fill(dx_data, dx_data + dx->numel(), static_cast<T>(0));
+    }
+    if (dy_data != nullptr) {
+      std::fill(dy_data, dy_data + dy->numel(), static_cast<T>(0));
+    }
     return;
   }
-  if (post == 1) {
-    ElemwiseGradBroadcast1CPU(x.data<T>(),
-                              y.data<T>(),
-                              out.data<Tout>(),
-                              dout.data<Tout>(),
-                              pre,
-                              n,
-                              is_xsize_larger,
-                              dx_op,
-                              dy_op,
-                              dx == nullptr ? nullptr : ctx.Alloc<T>(dx),
-                              dy == nullptr ? nullptr : ctx.Alloc<T>(dy));
-  } else {
-    ElemwiseGradBroadcast2CPU(x.data<T>(),
-                              y.data<T>(),
-                              out.data<Tout>(),
-                              dout.data<Tout>(),
-                              pre,
-                              n,
-                              post,
-                              is_xsize_larger,
-                              dx_op,
-                              dy_op,
-                              dx == nullptr ? nullptr : ctx.Alloc<T>(dx),
-                              dy == nullptr ? nullptr : ctx.Alloc<T>(dy));
-  }
+  CPUBroadcastGrad(ctx,
+                   broadcast_dims,
+                   x.data<T>(),
+                   y.data<T>(),
+                   out.data<Tout>(),
+                   dout.data<Tout>(),
+                   dx_op,
+                   dy_op,
+                   dx_data,
+                   dy_data);
 }
 
 template <typename T, typename DX_OP, typename DY_OP, typename Tout = T>
@@ -14,9 +14,12 @@
 
 #pragma once
 
+#include <type_traits>
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/kernels/cpu/reduce.h"
+#include "paddle/phi/kernels/funcs/cpu_reduce.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
 #include "paddle/phi/kernels/funcs/eigen/eigen_function.h"
 namespace phi {
@@ -134,6 +137,19 @@ void LaunchReduceGradKernel(const Context& dev_ctx,
                             Functor functor,
                             const std::vector<int>& dims,
                             bool reduce_all = false) {
+  using CPUReduceGrad = CPUReduceGradOf<Functor, T>;
+  if constexpr (std::is_same<Context, CPUContext>::value &&
+                CPUReduceGrad::kSupported) {
+    ReduceGradCPU<T, CPUReduceGrad>(dev_ctx,
+                                    input0->dims(),
+                                    dims,
+                                    reduce_all,
+                                    input0->data<T>(),
+                                    input1->data<T>(),
+                                    input2->data<T>(),
+                                    output->data<T>());
+    return;
+  }
   if (reduce_all) {
     auto x = phi::EigenVector<T>::Flatten(*input0);
     auto x_reduce = phi::EigenVector<T>::Flatten(*input1);
@@ -21,7 +21,9 @@ namespace phi::funcs {
 
 template class SoftmaxFunctor<phi::CPUContext, float>;
 template class SoftmaxFunctor<phi::CPUContext, double>;
+template class SoftmaxFunctor<phi::CPUContext, phi::dtype::bfloat16>;
 template class SoftmaxGradFunctor<phi::CPUContext, float>;
 template class SoftmaxGradFunctor<phi::CPUContext, double>;
+template class SoftmaxGradFunctor<phi::CPUContext, phi::dtype::bfloat16>;
 
 }  // namespace phi::funcs
@@ -21,6 +21,7 @@ limitations under the License. */
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/common/float16.h"
 #include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/kernels/funcs/cpu_row_kernels.h"
 #include "paddle/phi/kernels/funcs/cpu_vec.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
 
@@ -245,8 +246,18 @@ class SoftmaxFunctor<DeviceContext, T, enable_if_CPU<DeviceContext>> {
     const int batch_size = in_dims[kBatchDim];
     const int num_remain = num_classes / axis_dim;
 
-    if (num_remain == 1 &&
-        phi::backends::cpu::MayIUse(phi::backends::cpu::avx)) {
+    if constexpr (IsCPURowKernelType<T>::value) {
+      if (num_remain == 1) {
+        SoftmaxRowsCPU<T>(context,
+                          X->data<T>(),
+                          batch_size,
+                          num_classes,
+                          /*log=*/false,
+                          Y->data<T>());
+        return;
+      }
+    } else if (num_remain == 1 &&
+               phi::backends::cpu::MayIUse(phi::backends::cpu::avx)) {
       const T* in_data = X->data<T>();
       T* out_data = Y->data<T>();
       for (int bs = 0; bs < batch_size; ++bs) {
@@ -267,9 +278,9 @@ class SoftmaxFunctor<DeviceContext, T, enable_if_CPU<DeviceContext>> {
         in_data += num_classes;
         out_data += num_classes;
       }
-    } else {
-      SoftmaxEigen<DeviceContext, T>()(context, axis_dim, X, Y);
+      return;
     }
+    SoftmaxEigen<DeviceContext, T>()(context, axis_dim, X, Y);
   }
 };
 
@@ -401,8 +412,19 @@ class SoftmaxGradFunctor<DeviceContext, T, enable_if_CPU<DeviceContext>> {
     const int batch_size = out_dims[kBatchDim];
     const int num_remain = num_classes / axis_dim;
 
-    if (num_remain == 1 &&
-        phi::backends::cpu::MayIUse(phi::backends::cpu::avx)) {
+    if constexpr (IsCPURowKernelType<T>::value) {
+      if (num_remain == 1) {
+        SoftmaxGradRowsCPU<T>(context,
+                              y->data<T>(),
+                              y_grad->data<T>(),
+                              batch_size,
+                              num_classes,
+                              /*log=*/false,
+                              x_grad->data<T>());
+        return;
+      }
+    } else if (num_remain == 1 &&
+               phi::backends::cpu::MayIUse(phi::backends::cpu::avx)) {
       const T* out_data = y->data<T>();
       const T* out_grad = y_grad->data<T>();
       T* in_grad = x_grad->data<T>();
@@ -419,10 +441,9 @@ class SoftmaxGradFunctor<DeviceContext, T, enable_if_CPU<DeviceContext>> {
         out_grad += num_classes;
         in_grad += num_classes;
       }
-    } else {
-      SoftmaxGradEigen<DeviceContext, T>()(
-          context, axis_dim, y, y_grad, x_grad);
+      return;
     }
+    SoftmaxGradEigen<DeviceContext, T>()(context, axis_dim, y, y_grad, x_grad);
   }
 };
 
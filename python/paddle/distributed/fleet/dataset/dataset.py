@@ -466,6 +466,7 @@ class InMemoryDataset(DatasetBase):
         self.enable_pv_merge = False
         self.merge_by_lineid = False
         self.fleet_send_sleep_seconds = None
+        self.data_cache_dir = ""
 
     def _init_distributed_settings(
         self, **kwargs: Unpack[_InMemoryDatasetDistributedSettings]
@@ -731,6 +732,7 @@ class InMemoryDataset(DatasetBase):
         self.dataset.set_parse_logkey(self.parse_logkey)
         self.dataset.set_merge_by_sid(self.merge_by_sid)
         self.dataset.set_enable_pv_merge(self.enable_pv_merge)
+        self.dataset.set_data_cache_dir(self.data_cache_dir)
         self.dataset.set_data_feed_desc(self._desc())
         self.dataset.create_channel()
         self.dataset.create_readers()
@@ -1344,6 +1346,30 @@ class InMemoryDataset(DatasetBase):
             self.dataset.set_fea_eval(fea_eval, record_candidate_size)
         self.fea_eval = fea_eval
 
+    def _set_data_cache_dir(self, data_cache_dir):
+        """
+        Set a local dir to cache the parsed instances of every file in binary,
+        the next load_into_memory of the same files reads the cache instead of
+        parsing the files again. Only SlotRecordInMemoryDataFeed supports it.
+        The cache of a file is used as long as the file name, its size and
+        modification time, the pipe command and the slots are the same. Only
+        local files are cached.
+
+        Args:
+            data_cache_dir(str): the local dir of the cache, empty means no
+                                 cache. default is empty.
+
+        Examples:
+            .. code-block:: python
+
+                >>> import paddle
+                >>> paddle.enable_static()
+                >>> dataset = paddle.distributed.InMemoryDataset()
+                >>> dataset._set_data_cache_dir("./data_cache")
+
+        """
+        self.data_cache_dir = data_cache_dir
+
     def slots_shuffle(self, slots: list[str]) -> None:
         """
         Slots Shuffle
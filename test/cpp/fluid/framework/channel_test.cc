@@ -0,0 +1,185 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/channel.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+const char* BackendName(ChannelBackend backend) {
+  return backend == ChannelBackend::kMutex ? "mutex" : "lock-free";
+}
+
+// Every producer writes the values [0, item_num) of its share in blocks, every
+// consumer reads blocks until the channel is closed. Return the number of
+// items moved per second.
+double ProduceConsume(ChannelBackend backend,
+                      int thread_num,
+                      size_t item_num,
+                      size_t capacity,
+                      size_t block_size,
+                      uint64_t* sum,
+                      size_t* count) {
+  auto chan = MakeChannel<uint64_t>(capacity, backend);
+  std::atomic<uint64_t> total_sum{0};
+  std::atomic<size_t> total_count{0};
+  size_t item_per_thread = item_num / thread_num;
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> consumers;
+  for (int i = 0; i < thread_num; ++i) {
+    consumers.emplace_back([&] {
+      std::vector<uint64_t> block;
+      uint64_t local_sum = 0;
+      size_t local_count = 0;
+      while (chan->ReadOnce(block, block_size) > 0) {
+        for (uint64_t x : block) {
+          local_sum += x;
+        }
+        local_count += block.size();
+      }
+      total_sum += local_sum;
+      total_count += local_count;
+    });
+  }
+  std::vector<std::thread> producers;
+  for (int i = 0; i < thread_num; ++i) {
+    producers.emplace_back([&, i] {
+      std::vector<uint64_t> block;
+      for (size_t j = 0; j < item_per_thread; ++j) {
+        block.push_back(i * item_per_thread + j);
+        if (block.size() == block_size || j + 1 == item_per_thread) {
+          EXPECT_EQ(chan->Write(block.size(), block.data()), block.size());
+          block.clear();
+        }
+      }
+    });
+  }
+  for (auto& t : producers) {
+    t.join();
+  }
+  chan->Close();
+  for (auto& t : consumers) {
+    t.join();
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  *sum = total_sum;
+  *count = total_count;
+  return item_per_thread * thread_num / seconds;
+}
+
+}  // namespace
+
+TEST(Channel, ProduceConsume) {
+  for (auto backend : {ChannelBackend::kMutex, ChannelBackend::kLockFree}) {
+    for (int thread_num : {1, 4}) {
+      for (size_t block_size : {1, 7, 64}) {
+        const size_t item_num = 40000;
+        uint64_t sum = 0;
+        size_t count = 0;
+        ProduceConsume(
+            backend, thread_num, item_num, 100, block_size, &sum, &count);
+        EXPECT_EQ(count, item_num) << BackendName(backend);
+        EXPECT_EQ(sum, item_num * (item_num - 1) / 2) << BackendName(backend);
+      }
+    }
+  }
+}
+
+TEST(Channel, LockFreeSemantics) {
+  auto chan = MakeChannel<std::string>(3, ChannelBackend::kLockFree);
+  EXPECT_EQ(chan->Backend(), ChannelBackend::kLockFree);
+  EXPECT_TRUE(chan->Empty());
+
+  // a writer blocks on a full channel until a reader makes room
+  std::vector<std::string> in = {"a", "b", "c", "d", "e"};
+  std::thread writer([&] { EXPECT_EQ(chan->Write(in), in.size()); });
+  while (chan->Size() < 3) {
+    std::this_thread::yield();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(chan->Size(), 3UL);
+  std::vector<std::string> out;
+  EXPECT_EQ(chan->ReadOnce(out, 2), 2UL);
+  EXPECT_EQ(out, std::vector<std::string>({"a", "b"}));
+  writer.join();
+  EXPECT_EQ(in[4], "e");  // copied, not moved
+
+  chan->SetBlockSize(2);
+  EXPECT_EQ(chan->Read(out), 2UL);
+  EXPECT_EQ(out, std::vector<std::string>({"c", "d"}));
+
+  // the data left can be read after the channel is closed, but no more data
+  // can be written
+  chan->Close();
+  EXPECT_FALSE(chan->Put("f"));
+  EXPECT_EQ(chan->ReadAll(out), 1UL);
+  EXPECT_EQ(out[0], "e");
+  std::string val;
+  EXPECT_FALSE(chan->Get(val));
+
+  // a reader blocked on an empty channel is woken up by Close()
+  chan->Open();
+  std::thread reader([&] { EXPECT_EQ(chan->ReadAll(out), 1UL); });
+  EXPECT_TRUE(chan->Put(std::string("g")));
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  chan->Close();
+  reader.join();
+  EXPECT_EQ(out[0], "g");
+
+  // the capacity can be changed within the size of the ring
+  chan->SetCapacity(4);
+  EXPECT_EQ(chan->Capacity(), 4UL);
+  EXPECT_ANY_THROW(chan->SetCapacity(5));
+  EXPECT_ANY_THROW(chan->SetCapacity(0));
+  EXPECT_ANY_THROW(chan->GetData());
+  EXPECT_ANY_THROW(MakeChannel<int>(0, ChannelBackend::kLockFree));
+}
+
+// Throughput of both backends with 1 to 64 producers and as many consumers.
+// Disabled by default, run it with --gtest_also_run_disabled_tests.
+TEST(BENCHMARK, DISABLED_ChannelContention) {
+  const size_t item_num = 1 << 20;
+  for (size_t block_size : {1, 64}) {
+    for (int thread_num = 1; thread_num <= 64; thread_num *= 2) {
+      for (auto backend : {ChannelBackend::kMutex, ChannelBackend::kLockFree}) {
+        uint64_t sum = 0;
+        size_t count = 0;
+        double rate = ProduceConsume(
+            backend, thread_num, item_num, 4096, block_size, &sum, &count);
+        EXPECT_EQ(count, item_num / thread_num * thread_num);
+        LOG(INFO) << "threads: " << thread_num << " x " << thread_num
+                  << ", block size: " << block_size
+                  << ", backend: " << BackendName(backend)
+                  << ", items/s: " << rate;
+      }
+    }
+  }
+}
+
+}  // namespace framework
+}  // namespace paddle
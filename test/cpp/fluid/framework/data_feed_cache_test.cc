@@ -0,0 +1,202 @@
+/* Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/data_feed_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/data_feed.h"
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+const int kUint64SlotNum = 5;
+const int kFloatSlotNum = 2;
+
+template <typename T>
+void FillSlotValues(std::mt19937_64* rng, int slot_num, SlotValues<T>* values) {
+  std::vector<std::vector<T>> slots(slot_num);
+  uint32_t total = 0;
+  for (auto& slot : slots) {
+    slot.resize((*rng)() % 4);
+    for (auto& value : slot) {
+      value = static_cast<T>((*rng)());
+    }
+    total += slot.size();
+  }
+  values->add_slot_feasigns(slots, total);
+}
+
+std::vector<SlotRecord> MakeRecords(size_t num, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::vector<SlotRecord> records(num);
+  for (auto& rec : records) {
+    rec = make_slotrecord();
+    rec->search_id = rng();
+    rec->rank = static_cast<uint32_t>(rng());
+    rec->cmatch = static_cast<uint32_t>(rng());
+    rec->ins_id_ = std::string(rng() % 12, static_cast<char>('a' + rng() % 26));
+    FillSlotValues(&rng, kUint64SlotNum, &rec->slot_uint64_feasigns_);
+    FillSlotValues(&rng, kFloatSlotNum, &rec->slot_float_feasigns_);
+  }
+  return records;
+}
+
+void FreeRecords(std::vector<SlotRecord>* records) {
+  for (auto& rec : *records) {
+    free_slotrecord(rec);
+  }
+  records->clear();
+}
+
+void WriteCache(const std::string& path,
+                const std::string& key,
+                const std::vector<SlotRecord>& records,
+                size_t block_size) {
+  SlotRecordCacheWriter writer(path, key, kUint64SlotNum, kFloatSlotNum);
+  for (size_t i = 0; i < records.size(); i += block_size) {
+    writer.Append(&records[i], std::min(block_size, records.size() - i));
+  }
+  ASSERT_TRUE(writer.Finish());
+}
+
+std::vector<SlotRecord> ReadCache(SlotRecordCacheReader* reader) {
+  std::vector<SlotRecord> records;
+  size_t num = 0;
+  while ((num = reader->NextBlockSize()) > 0) {
+    size_t offset = records.size();
+    for (size_t i = 0; i < num; ++i) {
+      records.push_back(make_slotrecord());
+    }
+    reader->ReadBlock(&records[offset]);
+  }
+  return records;
+}
+
+}  // namespace
+
+TEST(SlotRecordCache, ReadWrite) {
+  std::string key = "part-00000\ncat\nslots";
+  std::string path = GetSlotRecordCachePath(".", key);
+  auto records = MakeRecords(2500, 0);
+  WriteCache(path, key, records, 1000);
+
+  SlotRecordCacheReader reader;
+  ASSERT_TRUE(reader.Open(path, key, kUint64SlotNum, kFloatSlotNum));
+  ASSERT_EQ(reader.record_num(), records.size());
+  auto loaded = ReadCache(&reader);
+  ASSERT_EQ(loaded.size(), records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    EXPECT_EQ(loaded[i]->search_id, records[i]->search_id);
+    EXPECT_EQ(loaded[i]->rank, records[i]->rank);
+    EXPECT_EQ(loaded[i]->cmatch, records[i]->cmatch);
+    EXPECT_EQ(loaded[i]->ins_id_, records[i]->ins_id_);
+    EXPECT_EQ(loaded[i]->slot_uint64_feasigns_.slot_offsets,
+              records[i]->slot_uint64_feasigns_.slot_offsets);
+    EXPECT_EQ(loaded[i]->slot_uint64_feasigns_.slot_values,
+              records[i]->slot_uint64_feasigns_.slot_values);
+    EXPECT_EQ(loaded[i]->slot_float_feasigns_.slot_offsets,
+              records[i]->slot_float_feasigns_.slot_offsets);
+    EXPECT_EQ(loaded[i]->slot_float_feasigns_.slot_values,
+              records[i]->slot_float_feasigns_.slot_values);
+  }
+  FreeRecords(&records);
+  FreeRecords(&loaded);
+  remove(path.c_str());
+}
+
+TEST(SlotRecordCache, Mismatch) {
+  std::string key = "part-00001\ncat\nslots";
+  std::string path = GetSlotRecordCachePath(".", key);
+  EXPECT_NE(path, GetSlotRecordCachePath(".", key + "x"));
+
+  SlotRecordCacheReader reader;
+  // not written yet
+  EXPECT_FALSE(reader.Open(path, key, kUint64SlotNum, kFloatSlotNum));
+
+  auto records = MakeRecords(100, 1);
+  {
+    // never finished, e.g. the pass is killed
+    SlotRecordCacheWriter writer(path, key, kUint64SlotNum, kFloatSlotNum);
+    writer.Append(records.data(), records.size());
+  }
+  EXPECT_FALSE(reader.Open(path, key, kUint64SlotNum, kFloatSlotNum));
+
+  WriteCache(path, key, records, 64);
+  EXPECT_FALSE(reader.Open(path, key + "x", kUint64SlotNum, kFloatSlotNum));
+  EXPECT_FALSE(reader.Open(path, key, kUint64SlotNum + 1, kFloatSlotNum));
+  EXPECT_TRUE(reader.Open(path, key, kUint64SlotNum, kFloatSlotNum));
+
+  // a truncated cache, e.g. the disk is full
+  std::string data;
+  {
+    std::ifstream fin(path, std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(fin),
+                std::istreambuf_iterator<char>());
+  }
+  for (size_t size : {data.size() - 8, data.size() / 2}) {
+    std::ofstream fout(path, std::ios::binary | std::ios::trunc);
+    fout.write(data.data(), size);
+    fout.close();
+    EXPECT_FALSE(reader.Open(path, key, kUint64SlotNum, kFloatSlotNum));
+  }
+  FreeRecords(&records);
+  remove(path.c_str());
+}
+
+// Load throughput of the cache. Disabled by default, run it with
+// --gtest_also_run_disabled_tests.
+TEST(BENCHMARK, DISABLED_SlotRecordCacheLoad) {
+  const size_t record_num = 200000;
+  std::string key = "benchmark";
+  std::string path = GetSlotRecordCachePath(".", key);
+  auto records = MakeRecords(record_num, 2);
+
+  auto start = std::chrono::steady_clock::now();
+  WriteCache(path, key, records, OBJPOOL_BLOCK_SIZE);
+  double write_seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+
+  start = std::chrono::steady_clock::now();
+  SlotRecordCacheReader reader;
+  ASSERT_TRUE(reader.Open(path, key, kUint64SlotNum, kFloatSlotNum));
+  auto loaded = ReadCache(&reader);
+  double load_seconds = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+  ASSERT_EQ(loaded.size(), records.size());
+
+  double megabytes = static_cast<double>(reader.file_size()) / (1 << 20);
+  LOG(INFO) << "records: " << record_num << ", cache size: " << megabytes
+            << " MB, write: " << record_num / write_seconds
+            << " records/s, load: " << record_num / load_seconds
+            << " records/s, " << megabytes / load_seconds << " MB/s";
+  FreeRecords(&records);
+  FreeRecords(&loaded);
+  remove(path.c_str());
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,286 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/data_feed_parser.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace framework {
+
+static void ExpectSameAsStrtoull(const std::string& str) {
+  char* expected_end = nullptr;
+  char* end = nullptr;
+  uint64_t expected = strtoull(str.c_str(), &expected_end, 10);
+  uint64_t value = FastStrToUint64(str.c_str(), &end);
+  EXPECT_EQ(value, expected) << str;
+  EXPECT_EQ(end, expected_end) << str;
+}
+
+static void ExpectSameAsStrtol(const std::string& str) {
+  char* expected_end = nullptr;
+  char* end = nullptr;
+  int expected = static_cast<int>(strtol(str.c_str(), &expected_end, 10));
+  int value = FastStrToInt(str.c_str(), &end);
+  EXPECT_EQ(value, expected) << str;
+  EXPECT_EQ(end, expected_end) << str;
+}
+
+static void ExpectSameAsStrtof(const std::string& str) {
+  char* expected_end = nullptr;
+  char* end = nullptr;
+  float expected = strtof(str.c_str(), &expected_end);
+  float value = FastStrToFloat(str.c_str(), &end);
+  if (std::isnan(expected)) {
+    EXPECT_TRUE(std::isnan(value)) << str;
+  } else {
+    // compare the bits, so that 0.0 and -0.0 differ
+    EXPECT_EQ(memcmp(&value, &expected, sizeof(float)), 0)
+        << str << ": " << value << " vs " << expected;
+  }
+  EXPECT_EQ(end, expected_end) << str;
+}
+
+TEST(DataFeedParser, Uint64) {
+  for (const char* str : {"0",
+                          "7",
+                          "  42 1",
+                          "\t9",
+                          "1234567890123456789",
+                          "9999999999999999999",
+                          "18446744073709551615",
+                          "18446744073709551616",
+                          "123456789012345678901234",
+                          "-1",
+                          "+5",
+                          "0x1f",
+                          "12a",
+                          "",
+                          " ",
+                          "abc"}) {
+    ExpectSameAsStrtoull(str);
+  }
+  std::mt19937_64 rng(0);
+  for (int i = 0; i < 100000; ++i) {
+    uint64_t value = rng() >> (rng() % 64);
+    ExpectSameAsStrtoull(std::to_string(value) + " 1");
+  }
+}
+
+TEST(DataFeedParser, Int) {
+  for (const char* str : {"0",
+                          "1 2",
+                          "2147483647",
+                          "2147483648",
+                          "99999999999",
+                          "-3",
+                          "",
+                          "x"}) {
+    ExpectSameAsStrtol(str);
+  }
+}
+
+TEST(DataFeedParser, Float) {
+  for (const char* str : {"0",
+                          "-0",
+                          "0.0",
+                          "-0.000",
+                          "1",
+                          "1.",
+                          ".5",
+                          "-.5",
+                          "+2.5",
+                          "0.1",
+                          "3.14159 2",
+                          "16777217",
+                          "16777219",
+                          "0.000000000000000000001",
+                          "0.12345678901234567890",
+                          "123456789012345678",
+                          "1e5",
+                          "1.5E-3",
+                          "3.4028235e38",
+                          "1e39",
+                          "inf",
+                          "-nan",
+                          "0x1p3",
+                          ".",
+                          "-",
+                          "",
+                          "a"}) {
+    ExpectSameAsStrtof(str);
+  }
+
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<uint32_t> bits;
+  char buf[64];
+  for (int i = 0; i < 200000; ++i) {
+    float value = 0;
+    uint32_t b = bits(rng);
+    memcpy(&value, &b, sizeof(float));
+    if (!std::isfinite(value)) {
+      continue;
+    }
+    // the shortest forms and the fixed forms written by data generators
+    snprintf(buf, sizeof(buf), "%.9g", value);
+    ExpectSameAsStrtof(buf);
+    snprintf(buf, sizeof(buf), "%.*f", static_cast<int>(rng() % 10), value);
+    ExpectSameAsStrtof(buf);
+    snprintf(buf, sizeof(buf), "%.6f", static_cast<float>(rng()) / 1e6f);
+    ExpectSameAsStrtof(buf);
+  }
+  // the decimals that are exactly half way between two floats
+  for (int i = 0; i < 100000; ++i) {
+    float value = static_cast<float>(rng() % (1 << 24)) * 2;
+    snprintf(buf, sizeof(buf), "%.1f", value + 1);
+    ExpectSameAsStrtof(buf);
+  }
+}
+
+TEST(DataFeedParser, SkipSlotTokens) {
+  std::mt19937 rng(0);
+  for (int i = 0; i < 20000; ++i) {
+    std::string line;
+    int token_num = static_cast<int>(rng() % 64);
+    for (int j = 0; j < token_num; ++j) {
+      if (j > 0 || rng() % 4 == 0) {
+        line.append(1 + rng() % 3, ' ');
+      }
+      line.append(1 + rng() % 20, static_cast<char>('0' + rng() % 10));
+    }
+    if (rng() % 4 == 0) {
+      line.append(1 + rng() % 3, ' ');
+    }
+    int num = token_num == 0 ? 0 : static_cast<int>(rng() % (token_num + 1));
+
+    // same as calling find_first_of(' ', pos + 1) num times
+    size_t expected = 0;
+    for (int j = 0; j < num; ++j) {
+      expected = line.find_first_not_of(' ', expected);
+      expected = line.find_first_of(' ', expected);
+      if (expected == std::string::npos) {
+        expected = line.size();
+      }
+    }
+    const char* end =
+        SkipSlotTokens(line.c_str(), line.c_str() + line.size(), num);
+    EXPECT_EQ(static_cast<size_t>(end - line.c_str()), expected)
+        << line << ", num: " << num;
+  }
+}
+
+namespace {
+
+// A MultiSlot line of slot_num slots: a float slot, then uint64 slots.
+std::string MakeMultiSlotLine(std::mt19937_64* rng, int slot_num) {
+  std::string line;
+  char buf[32];
+  for (int slot = 0; slot < slot_num; ++slot) {
+    int num = 1 + static_cast<int>((*rng)() % 8);
+    line += std::to_string(num);
+    for (int j = 0; j < num; ++j) {
+      line += ' ';
+      if (slot == 0) {
+        snprintf(buf,
+                 sizeof(buf),
+                 "%.6f",
+                 static_cast<double>((*rng)() % 1000000) / 1e5);
+        line += buf;
+      } else {
+        line += std::to_string((*rng)());
+      }
+    }
+    line += ' ';
+  }
+  return line;
+}
+
+template <typename IntFunc, typename FloatFunc, typename Uint64Func>
+double ParseMultiSlotLine(const std::string& line,
+                          int slot_num,
+                          IntFunc int_func,
+                          FloatFunc float_func,
+                          Uint64Func uint64_func) {
+  double sum = 0;
+  const char* str = line.c_str();
+  char* endptr = const_cast<char*>(str);
+  for (int slot = 0; slot < slot_num; ++slot) {
+    int num = int_func(endptr, &endptr);
+    for (int j = 0; j < num; ++j) {
+      if (slot == 0) {
+        sum += float_func(endptr, &endptr);
+      } else {
+        sum += static_cast<double>(uint64_func(endptr, &endptr) & 0xff);
+      }
+    }
+  }
+  return sum;
+}
+
+}  // namespace
+
+// Parse throughput of MultiSlot lines, compared with strtol/strtof/strtoull.
+// Disabled by default, run it with --gtest_also_run_disabled_tests.
+TEST(BENCHMARK, DISABLED_DataFeedParserMultiSlot) {
+  const size_t line_num = 20000;
+  const int slot_num = 100;
+  std::mt19937_64 rng(0);
+  std::vector<std::string> lines(line_num);
+  size_t total_bytes = 0;
+  for (auto& line : lines) {
+    line = MakeMultiSlotLine(&rng, slot_num);
+    total_bytes += line.size();
+  }
+
+  auto run = [&](const char* name, auto parse_line) {
+    auto start = std::chrono::steady_clock::now();
+    double sum = 0;
+    for (auto& line : lines) {
+      sum += parse_line(line);
+    }
+    auto seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    LOG(INFO) << name << ": " << total_bytes / seconds / (1 << 20)
+              << " MB/s, " << line_num / seconds
+              << " instances/s, checksum: " << sum;
+    return sum;
+  };
+
+  double expected = run("strto*", [slot_num](const std::string& line) {
+    return ParseMultiSlotLine(
+        line,
+        slot_num,
+        [](const char* s, char** e) { return strtol(s, e, 10); },
+        [](const char* s, char** e) { return strtof(s, e); },
+        [](const char* s, char** e) { return strtoull(s, e, 10); });
+  });
+  double sum = run("fast", [slot_num](const std::string& line) {
+    return ParseMultiSlotLine(
+        line, slot_num, FastStrToInt, FastStrToFloat, FastStrToUint64);
+  });
+  EXPECT_EQ(sum, expected);
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -15,11 +15,14 @@
 #include "paddle/fluid/framework/new_executor/workqueue/workqueue.h"
 
 #include <atomic>
+#include <functional>
 #include <thread>
+#include <vector>
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
 #include "paddle/fluid/framework/new_executor/workqueue/workqueue_utils.h"
+#include "paddle/phi/core/memory/allocation/numa_allocator.h"
 
 TEST(WorkQueueUtils, TestEventsWaiter) {
   using paddle::framework::EventsWaiter;
@@ -203,3 +206,71 @@ TEST(WorkQueue, TestWorkQueueGroup) {
   queue_group.reset();
   waiter_thread.join();
 }
+
+TEST(WorkQueue, TestWorkQueueGroupAddTasksWithHint) {
+  using paddle::framework::CreateWorkQueueGroup;
+  using paddle::framework::EventsWaiter;
+  using paddle::framework::WorkQueueOptions;
+  std::atomic<unsigned> counter{0};
+  constexpr int kNumThreads = 4;
+  constexpr unsigned kBatchSize = 64;
+  EventsWaiter events_waiter;
+  WorkQueueOptions sq_options(/*name*/ "SingleThreadedWorkQueueForTesting",
+                              /*num_threads*/ 1,
+                              /*allow_spinning*/ true,
+                              /*always_spinning*/ false,
+                              /*track_task*/ true,
+                              /*detached*/ true,
+                              &events_waiter);
+  WorkQueueOptions mq_options(/*name*/ "MultiThreadedWorkQueueForTesting",
+                              /*num_threads*/ kNumThreads,
+                              /*allow_spinning*/ true,
+                              /*always_spinning*/ false,
+                              /*track_task*/ true,
+                              /*detached*/ true,
+                              &events_waiter);
+  auto queue_group = CreateWorkQueueGroup({sq_options, mq_options});
+  std::vector<std::function<void()>> fns;
+  std::vector<int> hints;
+  for (unsigned i = 0; i < kBatchSize; ++i) {
+    fns.emplace_back([&counter]() { ++counter; });
+    // Out-of-range hints fall back to the default placement.
+    hints.push_back(static_cast<int>(i % (kNumThreads + 2)) - 1);
+  }
+  queue_group->AddTasksWithHint(1, fns.data(), hints.data(), fns.size());
+  events_waiter.WaitEvent();
+  EXPECT_EQ(counter.load(), kBatchSize);
+  queue_group->Cancel();
+}
+
+TEST(WorkQueue, TestWorkQueueNumaNode) {
+  using paddle::framework::CreateMultiThreadedWorkQueue;
+  using paddle::framework::EventsWaiter;
+  using paddle::framework::WorkQueueOptions;
+  using paddle::memory::allocation::NumaAllocator;
+  constexpr int kNumThreads = 2;
+  constexpr unsigned kTaskNum = 16;
+  std::atomic<unsigned> bound{0};
+  EventsWaiter events_waiter;
+  WorkQueueOptions options(/*name*/ "NumaBoundWorkQueueForTesting",
+                           /*num_threads*/ kNumThreads,
+                           /*allow_spinning*/ true,
+                           /*always_spinning*/ false,
+                           /*track_task*/ true,
+                           /*detached*/ true,
+                           &events_waiter);
+  options.numa_node = 0;
+  auto work_queue = CreateMultiThreadedWorkQueue(options);
+  for (unsigned i = 0; i < kTaskNum; ++i) {
+    work_queue->AddTask([&bound]() {
+      if (NumaAllocator::GetThreadNumaNode() == 0) {
+        ++bound;
+      }
+    });
+  }
+  events_waiter.WaitEvent();
+  EXPECT_EQ(bound.load(), kTaskNum);
+  // the calling thread is not bound
+  EXPECT_EQ(NumaAllocator::GetThreadNumaNode(), -1);
+  work_queue->Cancel();
+}
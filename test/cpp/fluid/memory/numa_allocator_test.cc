@@ -0,0 +1,86 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/numa_allocator.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/core/memory/stats.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+static void TestAllocation(NumaAllocator *allocator,
+                           size_t size,
+                           size_t alignment) {
+  auto allocation = allocator->Allocate(size);
+  ASSERT_NE(allocation->ptr(), nullptr);
+  EXPECT_GE(allocation->size(), size);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(allocation->ptr()) % alignment, 0UL);
+  memset(allocation->ptr(), 1, size);
+}
+
+TEST(NumaAllocator, test_small_allocation) {
+  NumaAllocator allocator;
+  for (size_t size : {0, 1, 100, 4096, 4097, 1 << 20}) {
+    TestAllocation(&allocator, size, 4096);
+  }
+}
+
+TEST(NumaAllocator, test_huge_page) {
+  size_t huge_page_size = NumaAllocator::GetHugePageSize();
+  for (auto mode : {HugePageMode::kTransparent, HugePageMode::kExplicit}) {
+    NumaAllocator allocator(-1, mode);
+    // small requests do not take a whole huge page
+    auto small_allocation = allocator.Allocate(100);
+    EXPECT_LT(small_allocation->size(), huge_page_size);
+
+#ifdef __linux__
+    TestAllocation(&allocator, huge_page_size * 3 + 1, huge_page_size);
+#else
+    TestAllocation(&allocator, huge_page_size * 3 + 1, 4096);
+#endif
+  }
+}
+
+TEST(NumaAllocator, test_numa_stat) {
+  NumaAllocator allocator(0);
+  EXPECT_LT(allocator.numa_node(), NumaAllocator::GetNumaNodeCount());
+
+#ifdef __linux__
+  int64_t reserved = HostNumaMemoryStatCurrentValue("Reserved", 0);
+  {
+    NumaNodeGuard guard(0);
+    EXPECT_EQ(NumaAllocator::GetThreadNumaNode(), 0);
+    auto allocation = allocator.Allocate(1 << 20);
+    EXPECT_EQ(HostNumaMemoryStatCurrentValue("Reserved", 0),
+              reserved + static_cast<int64_t>(allocation->size()));
+  }
+  EXPECT_EQ(NumaAllocator::GetThreadNumaNode(), -1);
+  EXPECT_EQ(HostNumaMemoryStatCurrentValue("Reserved", 0), reserved);
+#endif
+}
+
+TEST(NumaAllocator, test_huge_page_mode) {
+  EXPECT_EQ(StringToHugePageMode("none"), HugePageMode::kNone);
+  EXPECT_EQ(StringToHugePageMode("transparent"), HugePageMode::kTransparent);
+  EXPECT_EQ(StringToHugePageMode("explicit"), HugePageMode::kExplicit);
+  EXPECT_ANY_THROW(StringToHugePageMode("unknown"));
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
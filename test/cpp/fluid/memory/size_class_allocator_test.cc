@@ -0,0 +1,210 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/size_class_allocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/core/memory/allocation/auto_growth_best_fit_allocator.h"
+#include "paddle/phi/core/memory/allocation/cpu_allocator.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+class RecordedAllocator : public Allocator {
+ protected:
+  phi::Allocation *AllocateImpl(size_t size) override {
+    allocated_size_ += size;
+    return new Allocation(malloc(size), size, phi::CPUPlace());  // NOLINT
+  }
+
+  void FreeImpl(phi::Allocation *allocation) override {
+    allocated_size_ -= allocation->size();
+    free(allocation->ptr());  // NOLINT
+    delete allocation;
+  }
+
+ public:
+  size_t AllocatedSize() const { return allocated_size_; }
+
+ private:
+  std::atomic<size_t> allocated_size_{0};
+};
+
+TEST(SizeClassAllocator, test_size_class) {
+  auto recorded_allocator = std::make_shared<RecordedAllocator>();
+  SizeClassAllocator allocator(recorded_allocator, 64);
+
+  EXPECT_EQ(allocator.RoundUpSize(1), 64UL);
+  EXPECT_EQ(allocator.RoundUpSize(64), 64UL);
+  EXPECT_EQ(allocator.RoundUpSize(65), 128UL);
+  // large requests are not rounded to size classes
+  size_t large_size = SizeClassAllocator::kDefaultMaxSmallSize + 1;
+  EXPECT_EQ(allocator.RoundUpSize(large_size), large_size);
+
+  for (size_t size = 1; size <= SizeClassAllocator::kDefaultMaxSmallSize;
+       size = size * 3 / 2 + 1) {
+    size_t rounded_size = allocator.RoundUpSize(size);
+    EXPECT_GE(rounded_size, size);
+    EXPECT_EQ(rounded_size % 64, 0UL);
+    // at most 4 size classes per power of two, so at most 50% waste
+    EXPECT_LE(rounded_size, std::max<size_t>(64, size + size / 2 + 64));
+
+    auto allocation = allocator.Allocate(size);
+    EXPECT_EQ(allocation->size(), rounded_size);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(allocation->ptr()) % 64, 0UL);
+  }
+}
+
+TEST(SizeClassAllocator, test_reuse_and_release) {
+  auto recorded_allocator = std::make_shared<RecordedAllocator>();
+  auto allocator = std::make_shared<SizeClassAllocator>(recorded_allocator, 64);
+
+  void *ptr = nullptr;
+  {
+    auto allocation = allocator->Allocate(100);
+    ptr = allocation->ptr();
+  }
+  size_t allocated_size = recorded_allocator->AllocatedSize();
+  EXPECT_GT(allocated_size, 0UL);
+  {
+    // the freed block is taken back from the thread cache
+    auto allocation = allocator->Allocate(100);
+    EXPECT_EQ(allocation->ptr(), ptr);
+    EXPECT_EQ(recorded_allocator->AllocatedSize(), allocated_size);
+  }
+
+  std::vector<AllocationPtr> allocations;
+  for (size_t i = 0; i < 1000; ++i) {
+    allocations.emplace_back(allocator->Allocate(i % 4096 + 1));
+  }
+  allocations.emplace_back(
+      allocator->Allocate(SizeClassAllocator::kDefaultMaxSmallSize * 2));
+  EXPECT_GT(recorded_allocator->AllocatedSize(), allocated_size);
+  allocations.clear();
+
+  allocator->Release(phi::CPUPlace());
+  EXPECT_EQ(recorded_allocator->AllocatedSize(), 0UL);
+}
+
+TEST(SizeClassAllocator, test_multi_thread) {
+  auto recorded_allocator = std::make_shared<RecordedAllocator>();
+  auto allocator = std::make_shared<SizeClassAllocator>(recorded_allocator, 64);
+
+  constexpr size_t kThreadNum = 8;
+  constexpr size_t kLoopNum = 10000;
+  // allocate in one thread and free in another one
+  std::vector<std::vector<AllocationPtr>> allocations(kThreadNum);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreadNum; ++t) {
+    threads.emplace_back([&, t]() {
+      std::mt19937 rng(t);
+      for (size_t i = 0; i < kLoopNum; ++i) {
+        size_t size = rng() % 8192 + 1;
+        auto allocation = allocator->Allocate(size);
+        memset(allocation->ptr(), static_cast<int>(t), size);
+        if (i % 10 == 0) {
+          allocations[t].emplace_back(std::move(allocation));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  threads.clear();
+  for (size_t t = 0; t < kThreadNum; ++t) {
+    threads.emplace_back(
+        [&, t]() { allocations[(t + 1) % kThreadNum].clear(); });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // all threads exited and returned their cached blocks
+  allocator->Release(phi::CPUPlace());
+  EXPECT_EQ(recorded_allocator->AllocatedSize(), 0UL);
+}
+
+// Measure p50/p99 latency of alloc+free pairs of small tensors issued by
+// thread_num threads at the same time.
+static void BenchmarkAllocFree(const std::string &name,
+                               std::shared_ptr<Allocator> allocator,
+                               size_t thread_num) {
+  constexpr size_t kLoopNum = 20000;
+  std::vector<std::vector<uint64_t>> latencies(thread_num);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < thread_num; ++t) {
+    threads.emplace_back([&, t]() {
+      std::mt19937 rng(t);
+      auto &latency = latencies[t];
+      latency.reserve(kLoopNum);
+      std::vector<AllocationPtr> live(16);
+      for (size_t i = 0; i < kLoopNum; ++i) {
+        size_t size = (rng() % 64 + 1) * 64;
+        auto start = std::chrono::steady_clock::now();
+        live[i % live.size()] = allocator->Allocate(size);
+        auto end = std::chrono::steady_clock::now();
+        latency.push_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+                .count());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::vector<uint64_t> all;
+  for (auto &latency : latencies) {
+    all.insert(all.end(), latency.begin(), latency.end());
+  }
+  std::sort(all.begin(), all.end());
+  LOG(INFO) << name << " threads=" << thread_num
+            << " p50=" << all[all.size() / 2]
+            << "ns p99=" << all[all.size() * 99 / 100] << "ns";
+}
+
+// Disabled by default, run it with --gtest_also_run_disabled_tests.
+TEST(SizeClassAllocator, DISABLED_benchmark_against_auto_growth) {
+  for (size_t thread_num : {1, 4, 16}) {
+    // CPUAllocator is what CPUPlace uses without an allocator strategy
+    BenchmarkAllocFree(
+        "CPUAllocator", std::make_shared<CPUAllocator>(), thread_num);
+
+    auto size_class_allocator = std::make_shared<SizeClassAllocator>(
+        std::make_shared<CPUAllocator>(), 64);
+    BenchmarkAllocFree("SizeClassAllocator", size_class_allocator, thread_num);
+
+    auto auto_growth_allocator = std::make_shared<AutoGrowthBestFitAllocator>(
+        std::make_shared<CPUAllocator>(), 64);
+    BenchmarkAllocFree(
+        "AutoGrowthBestFitAllocator", auto_growth_allocator, thread_num);
+  }
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
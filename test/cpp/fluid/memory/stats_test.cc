@@ -197,5 +197,14 @@ TEST_F(StatsTest, HostReservedTest) {
   RunTests();
 }
 
+TEST_F(StatsTest, HostNumaReservedTest) {
+  SetStatType("Reserved");
+  SetFunc(HostNumaMemoryStatUpdate,
+          HostNumaMemoryStatCurrentValue,
+          HostNumaMemoryStatPeakValue,
+          HostNumaMemoryStatResetPeakValue);
+  RunTests();
+}
+
 }  // namespace memory
 }  // namespace paddle
@@ -0,0 +1,134 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A micro benchmark of the multi-thread scheduling of PirInterpreter. It
+// builds synthetic DAGs of tiny CPU ops and reports the number of ops executed
+// per second with the default scheduler and with
+// FLAGS_new_executor_locality_aware_schedule. It is disabled by default, run
+// it with --gtest_also_run_disabled_tests.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/framework/new_executor/interpretercore.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/transforms/pd_op_to_kernel_pass.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/pir/include/core/builder.h"
+#include "paddle/pir/include/core/builtin_op.h"
+#include "paddle/pir/include/core/ir_context.h"
+#include "paddle/pir/include/core/program.h"
+
+COMMON_DECLARE_bool(new_executor_locality_aware_schedule);
+
+PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(add, CPU, ALL_LAYOUT);
+
+namespace paddle {
+namespace framework {
+
+// Build `width` independent chains of `depth` add ops that all start from
+// the same full op. width=1 gives a deep graph, depth=1 gives a wide graph.
+std::unique_ptr<pir::Program> BuildChainsProgram(
+    pir::Program* program,
+    size_t width,
+    size_t depth,
+    std::vector<std::string>* out_names) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  pir::Builder builder = pir::Builder(ctx, program->block());
+
+  paddle::dialect::FullOp full = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{4}, 1.0, phi::DataType::FLOAT32, phi::CPUPlace());
+
+  for (size_t i = 0; i < width; ++i) {
+    pir::Value x = full->result(0);
+    for (size_t j = 0; j < depth; ++j) {
+      x = builder.Build<paddle::dialect::AddOp>(x, full->result(0))->result(0);
+    }
+    std::string out_name = "chain_out_" + std::to_string(i);
+    builder.Build<pir::ShadowOutputOp>(x, out_name);
+    out_names->push_back(out_name);
+  }
+  return paddle::dialect::PdOpLowerToKernelPass(program);
+}
+
+double MeasureOpsPerSecond(size_t width,
+                           size_t depth,
+                           bool locality_aware,
+                           size_t repeat) {
+  FLAGS_new_executor_locality_aware_schedule = locality_aware;
+
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  pir::Program program(ctx);
+  std::vector<std::string> out_names;
+  auto kernel_program = BuildChainsProgram(&program, width, depth, &out_names);
+
+  interpreter::ExecutionConfig execution_config;
+  execution_config.host_num_threads = 4;
+  execution_config.device_num_threads = 1;
+
+  Scope scope;
+  InterpreterCore core(
+      phi::CPUPlace(), {}, kernel_program->block(), &scope, execution_config);
+  core.SetSkipGcVars(std::set<std::string>(out_names.begin(), out_names.end()));
+
+  // the first run builds the instructions, do not count it
+  core.Run({});
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < repeat; ++i) {
+    core.Run({});
+  }
+  auto end = std::chrono::steady_clock::now();
+  double seconds = std::chrono::duration<double>(end - start).count();
+
+  // every chain also has a shadow_output op besides the add ops
+  size_t op_num = 1 + width * (depth + 1);
+  return static_cast<double>(op_num * repeat) / seconds;
+}
+
+TEST(PirInterpreterScheduleBenchmark, DISABLED_wide_and_deep_dag) {
+  struct Shape {
+    const char* name;
+    size_t width;
+    size_t depth;
+  };
+  const std::vector<Shape> shapes = {
+      {"wide", 1024, 1}, {"deep", 1, 1024}, {"mixed", 32, 32}};
+  constexpr size_t kRepeat = 20;
+
+  for (auto& shape : shapes) {
+    double base = MeasureOpsPerSecond(shape.width, shape.depth, false, kRepeat);
+    double locality =
+        MeasureOpsPerSecond(shape.width, shape.depth, true, kRepeat);
+    LOG(INFO) << "[" << shape.name << " width=" << shape.width
+              << " depth=" << shape.depth << "] default: " << base
+              << " ops/s, locality aware: " << locality
+              << " ops/s, speedup: " << locality / base;
+    EXPECT_GT(base, 0.0);
+    EXPECT_GT(locality, 0.0);
+  }
+  FLAGS_new_executor_locality_aware_schedule = false;
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -18,10 +18,14 @@
 
 #include <chrono>
 #include <iostream>
+#include <map>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "paddle/phi/core/kernel_registry.h"
 
+#include "paddle/fluid/framework/new_executor/interpreter/interpreter_util.h"
 #include "paddle/fluid/framework/new_executor/pir_interpreter.h"
 #include "paddle/fluid/pir/dialect/operator/ir/control_flow_op.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
@@ -33,11 +37,13 @@
 
 #include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
 
+#include "paddle/common/flags.h"
 #include "paddle/common/macros.h"
 #include "paddle/pir/include/dialect/control_flow/ir/cf_dialect.h"
 #include "paddle/pir/include/dialect/control_flow/ir/cf_op.h"
 
 DECLARE_FILE_SYMBOLS(kernel_dialect);
+COMMON_DECLARE_bool(new_executor_critical_path_schedule);
 
 PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(full_int_array, CPU, ALL_LAYOUT);
@@ -98,6 +104,77 @@ TEST(StandaloneExecutor, run) {
   EXPECT_EQ(res3, true);
 }
 
+TEST(StandaloneExecutor, critical_path_time) {
+  // 0 -> 1 -> 2 -> 4
+  //   \-> 3 -----/
+  std::map<size_t, std::set<size_t>> op_downstream_map = {
+      {0, {1, 3}}, {1, {2}}, {2, {4}}, {3, {4}}};
+  std::vector<size_t> topo_order = {0, 1, 3, 2, 4};
+  std::vector<uint64_t> run_time_ns = {1, 2, 3, 10, 4};
+
+  std::vector<uint64_t> critical_path_ns =
+      interpreter::CalculateCriticalPathTime(
+          topo_order, op_downstream_map, run_time_ns);
+
+  std::vector<uint64_t> expected = {15, 9, 7, 14, 4};
+  EXPECT_EQ(critical_path_ns, expected);
+}
+
+TEST(StandaloneExecutor, critical_path_schedule) {
+  FLAGS_new_executor_critical_path_schedule = true;
+
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  pir::Program program((ctx));
+
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+
+  pir::Builder builder = pir::Builder(ctx, program.block());
+
+  paddle::dialect::FullOp op1 = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{2, 2}, 1.0, phi::DataType::FLOAT32, phi::CPUPlace());
+
+  // a long chain of add ops and a short branch, the first run times the
+  // instructions and the later runs are scheduled by the critical path
+  pir::Value long_out = op1->result(0);
+  for (int i = 0; i < 8; ++i) {
+    long_out = builder.Build<paddle::dialect::AddOp>(long_out, op1->result(0))
+                   ->result(0);
+  }
+  auto short_op =
+      builder.Build<paddle::dialect::AddOp>(op1->result(0), op1->result(0));
+
+  std::string long_name = "long_out";
+  std::string short_name = "short_out";
+  builder.Build<pir::ShadowOutputOp>(long_out, long_name);
+  builder.Build<pir::ShadowOutputOp>(short_op->result(0), short_name);
+
+  auto kernel_program = paddle::dialect::PdOpLowerToKernelPass(&program);
+
+  auto place = phi::CPUPlace();
+  Scope scope;
+
+  InterpreterCore test_core(place, {}, kernel_program->block(), &scope);
+
+  test_core.SetSkipGcVars({long_name, short_name});
+
+  for (int run = 0; run < 3; ++run) {
+    test_core.Run({});
+
+    const Scope* out_scope = test_core.local_scope() == nullptr
+                                 ? &scope
+                                 : test_core.local_scope();
+    auto long_tensor = out_scope->FindVar(long_name)->Get<phi::DenseTensor>();
+    auto short_tensor =
+        out_scope->FindVar(short_name)->Get<phi::DenseTensor>();
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_TRUE(simple_cmp(long_tensor.data<float>()[i], 9.0));
+      EXPECT_TRUE(simple_cmp(short_tensor.data<float>()[i], 2.0));
+    }
+  }
+
+  FLAGS_new_executor_critical_path_schedule = false;
+}
+
 TEST(StandaloneExecutor, run_error) {
   pir::IrContext* ctx = pir::IrContext::Instance();
   pir::Program program((ctx));
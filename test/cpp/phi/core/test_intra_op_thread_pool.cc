@@ -0,0 +1,124 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/backends/cpu/intra_op_thread_pool.h"
+#include "paddle/phi/backends/cpu/parallel_for.h"
+
+namespace phi {
+namespace tests {
+
+using backends::cpu::IntraOpThreadPool;
+
+class IntraOpThreadPoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    pool_ = IntraOpThreadPool::GetInstance();
+    num_threads_ = pool_->NumThreads();
+    pool_->SetNumThreads(4);
+  }
+
+  void TearDown() override { pool_->SetNumThreads(num_threads_); }
+
+  IntraOpThreadPool* pool_;
+  int num_threads_;
+  CPUContext dev_ctx_;
+};
+
+TEST_F(IntraOpThreadPoolTest, CoverRange) {
+  std::vector<std::atomic<int>> visits(10007);
+  std::atomic<int> calls{0};
+  ParallelFor(dev_ctx_, 7, 10007, 100, [&](int64_t begin, int64_t end) {
+    ++calls;
+    for (int64_t i = begin; i < end; ++i) {
+      ++visits[i];
+    }
+  });
+  for (int64_t i = 0; i < 10007; ++i) {
+    EXPECT_EQ(visits[i], i < 7 ? 0 : 1);
+  }
+  EXPECT_LE(calls, pool_->NumThreads());
+}
+
+TEST_F(IntraOpThreadPoolTest, SmallRange) {
+  std::thread::id caller = std::this_thread::get_id();
+  int calls = 0;
+  ParallelFor(dev_ctx_, 0, 100, 1000, [&](int64_t begin, int64_t end) {
+    EXPECT_EQ(std::this_thread::get_id(), caller);
+    EXPECT_EQ(begin, 0);
+    EXPECT_EQ(end, 100);
+    ++calls;
+  });
+  EXPECT_EQ(calls, 1);
+  ParallelFor(dev_ctx_, 5, 5, 1, [&](int64_t, int64_t) { ++calls; });
+  EXPECT_EQ(calls, 1);
+}
+
+TEST_F(IntraOpThreadPoolTest, NestedOnCallingThread) {
+  std::atomic<int> nested_calls{0};
+  ParallelFor(dev_ctx_, 0, 4, 1, [&](int64_t, int64_t) {
+    EXPECT_EQ(pool_->AvailableThreads(), 1);
+    ParallelFor(dev_ctx_, 0, 1000, 1, [&](int64_t begin, int64_t end) {
+      EXPECT_EQ(end - begin, 1000);
+      ++nested_calls;
+    });
+  });
+  EXPECT_GE(nested_calls, 1);
+  EXPECT_EQ(pool_->AvailableThreads(), pool_->NumThreads());
+}
+
+TEST_F(IntraOpThreadPoolTest, Exception) {
+  EXPECT_THROW(ParallelFor(dev_ctx_,
+                           0,
+                           1000,
+                           1,
+                           [](int64_t, int64_t end) {
+                             if (end == 1000) {
+                               throw std::runtime_error("task failed");
+                             }
+                           }),
+               std::runtime_error);
+  // the pool still runs the next region
+  std::atomic<int64_t> sum{0};
+  ParallelFor(dev_ctx_, 0, 1000, 1, [&](int64_t begin, int64_t end) {
+    sum += end - begin;
+  });
+  EXPECT_EQ(sum, 1000);
+}
+
+// Each thread has its own number of threads, as the predictors running on
+// several threads set and reset theirs.
+TEST_F(IntraOpThreadPoolTest, NumThreadsOfThread) {
+  int num_threads = pool_->NumThreads();
+  int processors =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  std::thread other([this, processors]() {
+    EXPECT_EQ(pool_->NumThreads(), 1);
+    pool_->SetNumThreads(2);
+    EXPECT_EQ(pool_->NumThreads(), std::min(2, processors));
+    pool_->SetNumThreads(1);
+  });
+  other.join();
+  EXPECT_EQ(pool_->NumThreads(), num_threads);
+}
+
+}  // namespace tests
+}  // namespace phi
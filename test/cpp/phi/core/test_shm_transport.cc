@@ -0,0 +1,206 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/core/distributed/shm_transport.h"
+
+namespace phi {
+namespace distributed {
+
+namespace {
+
+int WaitChild(pid_t pid) {
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+std::vector<uint8_t> RingData() {
+  std::vector<uint8_t> data(1 << 20);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 7 + (i >> 9));
+  }
+  return data;
+}
+
+}  // namespace
+
+TEST(ShmSegment, OpenMissing) {
+  EXPECT_EQ(ShmSegment::Open("/paddle_shm_transport_missing", 4096), nullptr);
+}
+
+TEST(ShmRing, StreamLargerThanRing) {
+  const size_t capacity = 4096;
+  auto segment = ShmSegment::Create(ShmRing::MemorySize(capacity));
+  ASSERT_NE(segment, nullptr);
+  auto data = RingData();
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    auto opened = ShmSegment::Open(segment->name(), segment->size());
+    if (opened == nullptr) {
+      _exit(1);
+    }
+    ShmRing ring(opened->data(), capacity, /*is_writer*/ false);
+    std::mt19937 rng(1);
+    std::vector<uint8_t> got(data.size());
+    size_t offset = 0;
+    while (offset < got.size()) {
+      size_t n = std::min<size_t>(rng() % 10000 + 1, got.size() - offset);
+      ring.Read(got.data() + offset, n);
+      offset += n;
+    }
+    if (got != data) {
+      _exit(2);
+    }
+    // the writer closes the ring after the data
+    try {
+      char c;
+      ring.Read(&c, 1);
+      _exit(3);
+    } catch (const std::exception&) {
+    }
+    _exit(0);
+  }
+
+  ShmRing ring(segment->data(), capacity, /*is_writer*/ true);
+  std::mt19937 rng(2);
+  size_t offset = 0;
+  while (offset < data.size()) {
+    size_t n = std::min<size_t>(rng() % 7000 + 1, data.size() - offset);
+    ring.Write(data.data() + offset, n);
+    offset += n;
+  }
+  ring.Close();
+  EXPECT_EQ(WaitChild(pid), 0);
+}
+
+TEST(ShmRing, PeerExit) {
+  const size_t capacity = 4096;
+  auto segment = ShmSegment::Create(ShmRing::MemorySize(capacity));
+  ASSERT_NE(segment, nullptr);
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    auto opened = ShmSegment::Open(segment->name(), segment->size());
+    ShmRing ring(opened->data(), capacity, /*is_writer*/ true);
+    _exit(0);
+  }
+  EXPECT_EQ(WaitChild(pid), 0);
+
+  ShmRing ring(segment->data(), capacity, /*is_writer*/ false);
+  char c;
+  EXPECT_ANY_THROW(ring.Read(&c, 1));
+}
+
+// An idle side blocks on the ring, and wakes up when the other side writes
+// or closes it.
+TEST(ShmRing, WakeBlockedReader) {
+  const size_t capacity = 4096;
+  auto segment = ShmSegment::Create(ShmRing::MemorySize(capacity));
+  ASSERT_NE(segment, nullptr);
+  ShmRing writer(segment->data(), capacity, /*is_writer*/ true);
+  ShmRing reader(segment->data(), capacity, /*is_writer*/ false);
+
+  std::thread write_thread([&writer]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    int value = 42;
+    writer.Write(&value, sizeof(value));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    writer.Close();
+  });
+  int value = 0;
+  reader.Read(&value, sizeof(value));
+  EXPECT_EQ(value, 42);
+  EXPECT_ANY_THROW(reader.Read(&value, sizeof(value)));
+  write_thread.join();
+}
+
+TEST(ShmAllReducer, AllReduce) {
+  const int nranks = 3;
+  auto segment = ShmSegment::Create(ShmAllReducer::MemorySize(nranks));
+  ASSERT_NE(segment, nullptr);
+  const std::string name = segment->name();
+
+  // returns the number of wrong results
+  auto run = [&](int rank, std::unique_ptr<ShmSegment> segment) {
+    ShmAllReducer reducer(std::move(segment), rank, nranks);
+    int errors = 0;
+    // the last ones are reduced in more than one chunk
+    for (int64_t numel : {0, 1, 5, 1000, 262144, 600001}) {
+      std::vector<float> in(numel), out(numel);
+      for (int64_t i = 0; i < numel; ++i) {
+        in[i] = (i % 1000) * 0.5f + rank;
+      }
+      reducer.AllReduce(
+          out.data(), in.data(), numel, DataType::FLOAT32, ReduceOp::SUM);
+      for (int64_t i = 0; i < numel; ++i) {
+        errors += out[i] != (i % 1000) * 1.5f + 3;
+      }
+
+      reducer.AllReduce(
+          in.data(), in.data(), numel, DataType::FLOAT32, ReduceOp::MAX);
+      for (int64_t i = 0; i < numel; ++i) {
+        errors += in[i] != (i % 1000) * 0.5f + 2;
+      }
+
+      std::vector<int64_t> ids(numel);
+      for (int64_t i = 0; i < numel; ++i) {
+        ids[i] = i * (rank + 1);
+      }
+      reducer.AllReduce(
+          ids.data(), ids.data(), numel, DataType::INT64, ReduceOp::MIN);
+      for (int64_t i = 0; i < numel; ++i) {
+        errors += ids[i] != i;
+      }
+    }
+    return errors;
+  };
+
+  std::vector<pid_t> pids;
+  for (int rank = 1; rank < nranks; ++rank) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      auto opened = ShmSegment::Open(name, ShmAllReducer::MemorySize(nranks));
+      if (opened == nullptr) {
+        _exit(1);
+      }
+      _exit(run(rank, std::move(opened)) == 0 ? 0 : 2);
+    }
+    pids.push_back(pid);
+  }
+  EXPECT_EQ(run(0, std::move(segment)), 0);
+  for (auto pid : pids) {
+    EXPECT_EQ(WaitChild(pid), 0);
+  }
+}
+
+TEST(ShmAllReducer, IsSupported) {
+  EXPECT_TRUE(ShmAllReducer::IsSupported(DataType::FLOAT32, ReduceOp::SUM));
+  EXPECT_TRUE(ShmAllReducer::IsSupported(DataType::INT64, ReduceOp::PRODUCT));
+  EXPECT_FALSE(ShmAllReducer::IsSupported(DataType::FLOAT16, ReduceOp::SUM));
+  EXPECT_FALSE(ShmAllReducer::IsSupported(DataType::FLOAT32, ReduceOp::AVG));
+}
+
+}  // namespace distributed
+}  // namespace phi
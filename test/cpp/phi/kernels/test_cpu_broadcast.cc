@@ -0,0 +1,259 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/common/macros.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/kernels/funcs/common_shape.h"
+#include "paddle/phi/kernels/funcs/elementwise_base.h"
+#include "paddle/phi/kernels/funcs/elementwise_functor.h"
+#include "paddle/phi/kernels/funcs/elementwise_grad_base.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+#include "test/cpp/phi/core/timer.h"
+
+namespace phi {
+namespace tests {
+
+template <typename T>
+struct MulGradX {
+  T operator()(T x UNUSED, T y, T out, T dout) const {
+    return dout * y + out;
+  }
+};
+
+template <typename T>
+struct MulGradY {
+  T operator()(T x, T y UNUSED, T out, T dout) const {
+    return dout * x - out;
+  }
+};
+
+// The offsets into x and y of each element of the output, computed naively.
+struct NaiveBroadcast {
+  NaiveBroadcast(const DDim& x_dims, const DDim& y_dims, int axis) {
+    rank = std::max(x_dims.size(), y_dims.size());
+    axis = axis == -1 ? std::abs(x_dims.size() - y_dims.size()) : axis;
+    x_dims_array.resize(rank);
+    y_dims_array.resize(rank);
+    out_dims_array.resize(rank);
+    funcs::GetBroadcastDimsArrays(x_dims,
+                                  y_dims,
+                                  x_dims_array.data(),
+                                  y_dims_array.data(),
+                                  out_dims_array.data(),
+                                  rank,
+                                  axis);
+  }
+
+  int64_t numel() const {
+    int64_t numel = 1;
+    for (auto dim : out_dims_array) {
+      numel *= dim;
+    }
+    return numel;
+  }
+
+  void Offsets(int64_t index, int64_t* x_offset, int64_t* y_offset) const {
+    *x_offset = 0;
+    *y_offset = 0;
+    int64_t x_stride = 1, y_stride = 1;
+    for (int i = rank - 1; i >= 0; --i) {
+      int64_t k = index % out_dims_array[i];
+      index /= out_dims_array[i];
+      *x_offset += (x_dims_array[i] == 1 ? 0 : k) * x_stride;
+      *y_offset += (y_dims_array[i] == 1 ? 0 : k) * y_stride;
+      x_stride *= x_dims_array[i];
+      y_stride *= y_dims_array[i];
+    }
+  }
+
+  int rank;
+  std::vector<int> x_dims_array;
+  std::vector<int> y_dims_array;
+  std::vector<int> out_dims_array;
+};
+
+void CheckBroadcast(const CPUContext& dev_ctx,
+                    const std::vector<int64_t>& x_shape,
+                    const std::vector<int64_t>& y_shape,
+                    int axis,
+                    std::mt19937* rng) {
+  DDim x_dims = common::make_ddim(x_shape);
+  DDim y_dims = common::make_ddim(y_shape);
+  NaiveBroadcast naive(x_dims, y_dims, axis);
+  std::vector<int64_t> out_shape(naive.out_dims_array.begin(),
+                                 naive.out_dims_array.end());
+  DenseTensor x, y, out, dout, dx, dy;
+  x.Resize(x_dims);
+  y.Resize(y_dims);
+  out.Resize(common::make_ddim(out_shape));
+  dout.Resize(out.dims());
+  dx.Resize(x_dims);
+  dy.Resize(y_dims);
+  double* x_data = dev_ctx.template Alloc<double>(&x);
+  double* y_data = dev_ctx.template Alloc<double>(&y);
+  double* dout_data = dev_ctx.template Alloc<double>(&dout);
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    x_data[i] = (*rng)() % 100 / 10.0;
+  }
+  for (int64_t i = 0; i < y.numel(); ++i) {
+    y_data[i] = (*rng)() % 100 / 10.0;
+  }
+  for (int64_t i = 0; i < dout.numel(); ++i) {
+    dout_data[i] = (*rng)() % 100 / 10.0;
+  }
+
+  if (x_dims.size() >= y_dims.size()) {
+    funcs::ElementwiseCompute<funcs::SubtractFunctor<double>, double>(
+        dev_ctx, x, y, funcs::SubtractFunctor<double>(), &out, axis);
+  } else {
+    funcs::ElementwiseCompute<funcs::InverseSubtractFunctor<double>, double>(
+        dev_ctx, x, y, funcs::InverseSubtractFunctor<double>(), &out, axis);
+  }
+  funcs::ElemwiseGradComputeWithBroadcast<double>(dev_ctx,
+                                                  x_dims,
+                                                  y_dims,
+                                                  x,
+                                                  y,
+                                                  out,
+                                                  dout,
+                                                  axis,
+                                                  &dx,
+                                                  &dy,
+                                                  MulGradX<double>(),
+                                                  MulGradY<double>());
+
+  const double* out_data = out.data<double>();
+  std::vector<double> dx_ref(x.numel(), 0), dy_ref(y.numel(), 0);
+  for (int64_t i = 0; i < naive.numel(); ++i) {
+    int64_t x_offset, y_offset;
+    naive.Offsets(i, &x_offset, &y_offset);
+    ASSERT_EQ(out_data[i], x_data[x_offset] - y_data[y_offset]) << "at " << i;
+    dx_ref[x_offset] += dout_data[i] * y_data[y_offset] + out_data[i];
+    dy_ref[y_offset] += dout_data[i] * x_data[x_offset] - out_data[i];
+  }
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    ASSERT_NEAR(dx.data<double>()[i], dx_ref[i], 1e-6 * (1 + fabs(dx_ref[i])));
+  }
+  for (int64_t i = 0; i < y.numel(); ++i) {
+    ASSERT_NEAR(dy.data<double>()[i], dy_ref[i], 1e-6 * (1 + fabs(dy_ref[i])));
+  }
+}
+
+TEST(CPUBroadcast, random) {
+  auto* dev_ctx = DeviceContextPool::Instance().GetByPlace(CPUPlace());
+  std::mt19937 rng(2025);
+  for (int i = 0; i < 1000; ++i) {
+    int rank = static_cast<int>(rng() % 6) + 1;
+    std::vector<int64_t> x_shape(rank), y_shape(rank);
+    for (int k = 0; k < rank; ++k) {
+      int64_t dim = rng() % 4 == 0 ? 1 : rng() % (rank <= 2 ? 100 : 7) + 1;
+      x_shape[k] = rng() % 3 == 0 ? 1 : dim;
+      y_shape[k] = rng() % 3 == 0 ? 1 : dim;
+    }
+    // the leading dims of one of the inputs, and its trailing dims with
+    // the axis given
+    int axis = -1;
+    auto& smaller = rng() % 2 == 0 ? x_shape : y_shape;
+    int lead = static_cast<int>(rng() % rank);
+    smaller.erase(smaller.begin(), smaller.begin() + lead);
+    if (rng() % 3 == 0) {
+      smaller.resize(smaller.size() - rng() % smaller.size());
+      axis = lead;
+    }
+    CheckBroadcast(*dev_ctx, x_shape, y_shape, axis, &rng);
+  }
+  CheckBroadcast(*dev_ctx, {37, 1029}, {1029}, -1, &rng);
+  CheckBroadcast(*dev_ctx, {1029, 37}, {1029, 1}, -1, &rng);
+  CheckBroadcast(*dev_ctx, {3, 1, 1000}, {3, 500, 1}, -1, &rng);
+  CheckBroadcast(*dev_ctx, {1}, {100000}, -1, &rng);
+}
+
+// The time of the broadcast add and its gradient against the add of the
+// same shapes.
+// Disabled by default, run it with --gtest_also_run_disabled_tests.
+TEST(CPUBroadcast, DISABLED_benchmark) {
+  auto* dev_ctx = DeviceContextPool::Instance().GetByPlace(CPUPlace());
+  struct Case {
+    const char* name;
+    std::vector<int64_t> x_shape;
+    std::vector<int64_t> y_shape;
+  };
+  std::vector<Case> cases = {{"row", {4096, 1024}, {1024}},
+                             {"column", {4096, 1024}, {4096, 1}},
+                             {"scalar", {4096, 1024}, {1}},
+                             {"general", {16, 16, 1, 1024}, {16, 1, 16, 1}}};
+  const int repeats = 10;
+  for (auto& item : cases) {
+    DenseTensor x, y, same, out, dx, dy;
+    x.Resize(common::make_ddim(item.x_shape));
+    y.Resize(common::make_ddim(item.y_shape));
+    funcs::SetConstant<CPUContext, float>()(*dev_ctx, &x, 1.0f);
+    funcs::SetConstant<CPUContext, float>()(*dev_ctx, &y, 2.0f);
+    funcs::AddFunctor<float> add;
+    funcs::ElementwiseCompute<funcs::AddFunctor<float>, float>(
+        *dev_ctx, x, y, add, &out);
+    same.Resize(out.dims());
+    funcs::SetConstant<CPUContext, float>()(*dev_ctx, &same, 2.0f);
+    dx.Resize(x.dims());
+    dy.Resize(y.dims());
+
+    Timer timer;
+    timer.tic();
+    for (int i = 0; i < repeats; ++i) {
+      funcs::ElementwiseCompute<funcs::AddFunctor<float>, float>(
+          *dev_ctx, same, same, add, &out);
+    }
+    double same_ms = timer.toc() / repeats;
+
+    timer.tic();
+    for (int i = 0; i < repeats; ++i) {
+      funcs::ElementwiseCompute<funcs::AddFunctor<float>, float>(
+          *dev_ctx, x, y, add, &out);
+    }
+    double forward_ms = timer.toc() / repeats;
+
+    auto identity = [](float x UNUSED,
+                       float y UNUSED,
+                       float out UNUSED,
+                       float dout) { return dout; };
+    timer.tic();
+    for (int i = 0; i < repeats; ++i) {
+      funcs::ElemwiseGradComputeWithBroadcast<float>(*dev_ctx,
+                                                     x.dims(),
+                                                     y.dims(),
+                                                     x,
+                                                     y,
+                                                     out,
+                                                     same,
+                                                     -1,
+                                                     &dx,
+                                                     &dy,
+                                                     identity,
+                                                     identity);
+    }
+    double grad_ms = timer.toc() / repeats;
+    LOG(INFO) << "broadcast add " << item.name << " of " << x.dims() << " and "
+              << y.dims() << ": same shapes " << same_ms << " ms, forward "
+              << forward_ms << " ms, grad " << grad_ms << " ms";
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
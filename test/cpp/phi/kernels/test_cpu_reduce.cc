@@ -0,0 +1,255 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/kernels/funcs/cpu_reduce.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/funcs/reduce_function.h"
+#include "paddle/phi/kernels/funcs/reduce_functor.h"
+#include "test/cpp/phi/core/timer.h"
+
+namespace phi {
+namespace tests {
+
+// The index of the output of each element of the input, computed naively.
+int64_t NaiveOutIndex(const std::vector<int64_t>& shape,
+                      const std::vector<bool>& reduced,
+                      int64_t index) {
+  int rank = static_cast<int>(shape.size());
+  int64_t out_index = 0, out_stride = 1;
+  for (int i = rank - 1; i >= 0; --i) {
+    int64_t k = index % shape[i];
+    index /= shape[i];
+    if (!reduced[i]) {
+      out_index += k * out_stride;
+      out_stride *= shape[i];
+    }
+  }
+  return out_index;
+}
+
+void CheckReduce(const CPUContext& dev_ctx,
+                 const std::vector<int64_t>& shape,
+                 const std::vector<int64_t>& reduce_dims,
+                 bool reduce_all,
+                 std::mt19937* rng) {
+  int rank = static_cast<int>(shape.size());
+  std::vector<bool> reduced(rank, reduce_all);
+  for (auto dim : reduce_dims) {
+    reduced[dim < 0 ? dim + rank : dim] = true;
+  }
+  std::vector<int64_t> out_shape;
+  for (int i = 0; i < rank; ++i) {
+    if (!reduced[i]) {
+      out_shape.push_back(shape[i]);
+    }
+  }
+
+  DenseTensor x, sum, mean, max, prod;
+  x.Resize(common::make_ddim(shape));
+  float* x_data = dev_ctx.template Alloc<float>(&x);
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    x_data[i] = static_cast<float>((*rng)() % 201) / 100.0f - 1.0f;
+  }
+  if ((*rng)() % 10 == 0) {
+    x_data[(*rng)() % x.numel()] = NAN;
+  }
+  for (auto* out : {&sum, &mean, &max, &prod}) {
+    out->Resize(common::make_ddim(out_shape));
+  }
+  funcs::ReduceCPUKernelDriver<float, funcs::CPUSumReducer>(
+      dev_ctx, x, reduce_dims, reduce_all, &sum);
+  funcs::ReduceCPUKernelDriver<float, funcs::CPUMeanReducer>(
+      dev_ctx, x, reduce_dims, reduce_all, &mean);
+  funcs::ReduceCPUKernelDriver<float, funcs::CPUMaxReducer>(
+      dev_ctx, x, reduce_dims, reduce_all, &max);
+  DenseTensor positive;
+  positive.Resize(x.dims());
+  float* positive_data = dev_ctx.template Alloc<float>(&positive);
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    positive_data[i] = 1.0f + x_data[i] / 64.0f;
+  }
+  funcs::ReduceCPUKernelDriver<float, funcs::CPUProdReducer>(
+      dev_ctx, positive, reduce_dims, reduce_all, &prod);
+
+  int64_t out_numel = sum.numel();
+  std::vector<double> sum_ref(out_numel, 0), prod_ref(out_numel, 1);
+  std::vector<float> max_ref(out_numel, -INFINITY);
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    int64_t k = NaiveOutIndex(shape, reduced, i);
+    sum_ref[k] += x_data[i];
+    prod_ref[k] *= positive_data[i];
+    max_ref[k] = std::isnan(max_ref[k]) || std::isnan(x_data[i])
+                     ? NAN
+                     : std::max(max_ref[k], x_data[i]);
+  }
+  int64_t count = x.numel() / out_numel;
+  for (int64_t k = 0; k < out_numel; ++k) {
+    if (std::isnan(max_ref[k])) {
+      ASSERT_TRUE(std::isnan(sum.data<float>()[k]));
+      ASSERT_TRUE(std::isnan(max.data<float>()[k]));
+      continue;
+    }
+    double tol = 1e-5 * (1 + count);
+    ASSERT_NEAR(sum.data<float>()[k], sum_ref[k], tol);
+    ASSERT_NEAR(mean.data<float>()[k], sum_ref[k] / count, tol);
+    ASSERT_EQ(max.data<float>()[k], max_ref[k]);
+    ASSERT_NEAR(prod.data<float>()[k], prod_ref[k], 1e-3 * prod_ref[k]);
+  }
+}
+
+TEST(CPUReduce, random) {
+  auto* dev_ctx = DeviceContextPool::Instance().GetByPlace(CPUPlace());
+  std::mt19937 rng(2025);
+  for (int i = 0; i < 500; ++i) {
+    int rank = static_cast<int>(rng() % 5) + 1;
+    std::vector<int64_t> shape(rank);
+    for (auto& dim : shape) {
+      dim = rng() % 4 == 0 ? 1 : rng() % (rank <= 2 ? 300 : 9) + 1;
+    }
+    bool reduce_all = rng() % 10 == 0;
+    std::vector<int64_t> reduce_dims;
+    for (int k = 0; k < rank && !reduce_all; ++k) {
+      if (rng() % 2 == 0) {
+        reduce_dims.push_back(rng() % 2 == 0 ? k : k - rank);
+      }
+    }
+    if (reduce_dims.empty()) {
+      reduce_dims.push_back(0);
+    }
+    CheckReduce(*dev_ctx, shape, reduce_dims, reduce_all, &rng);
+  }
+  CheckReduce(*dev_ctx, {100000}, {0}, false, &rng);
+  CheckReduce(*dev_ctx, {3, 50000}, {0}, false, &rng);
+  CheckReduce(*dev_ctx, {7, 300, 5, 11}, {1, 3}, false, &rng);
+}
+
+TEST(CPUReduce, any_all) {
+  auto* dev_ctx = DeviceContextPool::Instance().GetByPlace(CPUPlace());
+  DenseTensor x, any, all;
+  x.Resize({64, 1000});
+  bool* x_data = dev_ctx->template Alloc<bool>(&x);
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    x_data[i] = i % 1000 != 0 || i / 1000 % 2 == 0;
+  }
+  any.Resize({1000});
+  all.Resize({64});
+  funcs::ReduceCPUKernelDriver<bool, funcs::CPUAnyReducer>(
+      *dev_ctx, x, {0}, false, &any);
+  funcs::ReduceCPUKernelDriver<bool, funcs::CPUAllReducer>(
+      *dev_ctx, x, {1}, false, &all);
+  for (int64_t i = 0; i < 1000; ++i) {
+    ASSERT_TRUE(any.data<bool>()[i]);
+  }
+  for (int64_t i = 0; i < 64; ++i) {
+    ASSERT_EQ(all.data<bool>()[i], i % 2 == 0);
+  }
+}
+
+TEST(CPUReduce, grad) {
+  auto* dev_ctx = DeviceContextPool::Instance().GetByPlace(CPUPlace());
+  std::vector<int64_t> shape = {6, 5, 4, 3};
+  std::vector<int> reduce_dims = {1, -1};
+  std::vector<bool> reduced = {false, true, false, true};
+  DenseTensor x, y, dy, dx;
+  x.Resize(common::make_ddim(shape));
+  y.Resize({6, 1, 4, 1});
+  dy.Resize(y.dims());
+  dx.Resize(x.dims());
+  float* x_data = dev_ctx->template Alloc<float>(&x);
+  float* y_data = dev_ctx->template Alloc<float>(&y);
+  float* dy_data = dev_ctx->template Alloc<float>(&dy);
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    x_data[i] = static_cast<float>(i % 7);
+  }
+  for (int64_t i = 0; i < y.numel(); ++i) {
+    y_data[i] = static_cast<float>(i % 5);
+    dy_data[i] = static_cast<float>(i);
+  }
+  float* dx_data = dev_ctx->template Alloc<float>(&dx);
+  using MeanGrad = funcs::CPUReduceGradOf<funcs::MeanGradFunctor, float>;
+  funcs::ReduceGradCPU<float, MeanGrad>(
+      *dev_ctx, x.dims(), reduce_dims, false, x_data, y_data, dy_data, dx_data);
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    ASSERT_FLOAT_EQ(dx_data[i],
+                    dy_data[NaiveOutIndex(shape, reduced, i)] / 15.0f);
+  }
+  using MaxGrad = funcs::CPUReduceGradOf<funcs::MaxOrMinGradFunctor, float>;
+  funcs::ReduceGradCPU<float, MaxGrad>(
+      *dev_ctx, x.dims(), reduce_dims, false, x_data, y_data, dy_data, dx_data);
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    int64_t k = NaiveOutIndex(shape, reduced, i);
+    ASSERT_EQ(dx_data[i], x_data[i] == y_data[k] ? dy_data[k] : 0.0f);
+  }
+}
+
+// The time of the CPU reduce against the Eigen reduce.
+// Disabled by default, run it with --gtest_also_run_disabled_tests.
+TEST(CPUReduce, DISABLED_benchmark) {
+  auto* dev_ctx = DeviceContextPool::Instance().GetByPlace(CPUPlace());
+  struct Case {
+    const char* name;
+    std::vector<int64_t> shape;
+    std::vector<int64_t> reduce_dims;
+    bool reduce_all;
+  };
+  std::vector<Case> cases = {{"row", {4096, 1024}, {1}, false},
+                             {"column", {4096, 1024}, {0}, false},
+                             {"middle", {64, 1024, 64}, {1}, false},
+                             {"apart", {64, 64, 16, 64}, {0, 2}, false},
+                             {"all", {4096, 1024}, {}, true}};
+  const int repeats = 10;
+  for (auto& item : cases) {
+    DenseTensor x, out;
+    x.Resize(common::make_ddim(item.shape));
+    funcs::SetConstant<CPUContext, float>()(*dev_ctx, &x, 1.0f);
+    std::vector<int64_t> out_shape;
+    for (int k = 0; k < static_cast<int>(item.shape.size()); ++k) {
+      if (!item.reduce_all &&
+          std::find(item.reduce_dims.begin(), item.reduce_dims.end(), k) ==
+              item.reduce_dims.end()) {
+        out_shape.push_back(item.shape[k]);
+      }
+    }
+    out.Resize(common::make_ddim(out_shape));
+
+    Timer timer;
+    timer.tic();
+    for (int i = 0; i < repeats; ++i) {
+      funcs::ReduceKernelImpl<CPUContext, float, float, funcs::SumFunctor>(
+          *dev_ctx, x, &out, item.reduce_dims, false, item.reduce_all);
+    }
+    double eigen_ms = timer.toc() / repeats;
+
+    timer.tic();
+    for (int i = 0; i < repeats; ++i) {
+      funcs::ReduceCPUKernelDriver<float, funcs::CPUSumReducer>(
+          *dev_ctx, x, item.reduce_dims, item.reduce_all, &out);
+    }
+    double engine_ms = timer.toc() / repeats;
+    LOG(INFO) << "reduce sum " << item.name << " of " << x.dims()
+              << ": eigen " << eigen_ms << " ms, cpu reduce " << engine_ms
+              << " ms";
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,301 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/kernels/funcs/cpu_row_kernels.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/funcs/softmax_impl.h"
+#include "test/cpp/phi/core/timer.h"
+
+namespace phi {
+namespace tests {
+
+// The inputs of the row kernels of T, and the values of them in double.
+template <typename T>
+struct Rows {
+  Rows(int64_t rows, int64_t cols, std::mt19937* rng)
+      : data(rows * cols), values(rows * cols) {
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<T>(static_cast<float>((*rng)() % 601) / 100.0f -
+                               3.0f);
+      values[i] = static_cast<double>(static_cast<float>(data[i]));
+    }
+  }
+
+  std::vector<T> data;
+  std::vector<double> values;
+};
+
+template <typename T>
+double Value(T value) {
+  return static_cast<double>(static_cast<float>(value));
+}
+
+template <typename T>
+void CheckRowKernels(const CPUContext& dev_ctx,
+                     int64_t rows,
+                     int64_t cols,
+                     std::mt19937* rng) {
+  const double tol = std::is_same<T, float>::value ? 1e-4 : 4e-2;
+  Rows<T> x(rows, cols, rng), dy(rows, cols, rng), param(1, cols, rng);
+  std::vector<T> y(rows * cols), dx(rows * cols);
+  std::vector<T> dparam0(cols), dparam1(cols);
+  std::vector<float> stats0(rows), stats1(rows);
+
+  for (bool log : {false, true}) {
+    funcs::SoftmaxRowsCPU<T>(
+        dev_ctx, x.data.data(), rows, cols, log, y.data());
+    funcs::SoftmaxGradRowsCPU<T>(
+        dev_ctx, y.data(), dy.data.data(), rows, cols, log, dx.data());
+    for (int64_t r = 0; r < rows; ++r) {
+      const double* px = x.values.data() + r * cols;
+      const double* pdy = dy.values.data() + r * cols;
+      double max = *std::max_element(px, px + cols);
+      double sum = 0, grad_sum = 0;
+      for (int64_t j = 0; j < cols; ++j) {
+        sum += std::exp(px[j] - max);
+        double y_value = Value(y[r * cols + j]);
+        grad_sum += log ? pdy[j] : pdy[j] * y_value;
+      }
+      for (int64_t j = 0; j < cols; ++j) {
+        double y_ref = log ? px[j] - max - std::log(sum)
+                           : std::exp(px[j] - max) / sum;
+        ASSERT_NEAR(Value(y[r * cols + j]), y_ref, tol * (1 + fabs(y_ref)));
+        double y_value = Value(y[r * cols + j]);
+        double dx_ref = log ? pdy[j] - std::exp(y_value) * grad_sum
+                            : (pdy[j] - grad_sum) * y_value;
+        ASSERT_NEAR(Value(dx[r * cols + j]),
+                    dx_ref,
+                    tol * (1 + fabs(dx_ref) + fabs(grad_sum)));
+      }
+    }
+  }
+
+  const T* scale = param.data.data();
+  funcs::LayerNormRowsCPU<T, T>(dev_ctx,
+                                x.data.data(),
+                                scale,
+                                scale,
+                                rows,
+                                cols,
+                                1e-5f,
+                                y.data(),
+                                stats0.data(),
+                                stats1.data());
+  funcs::LayerNormGradRowsCPU<T, T>(dev_ctx,
+                                    x.data.data(),
+                                    stats0.data(),
+                                    stats1.data(),
+                                    scale,
+                                    dy.data.data(),
+                                    rows,
+                                    cols,
+                                    1e-5f,
+                                    dx.data(),
+                                    dparam0.data(),
+                                    dparam1.data());
+  std::vector<double> dscale_ref(cols, 0), dbias_ref(cols, 0);
+  for (int64_t r = 0; r < rows; ++r) {
+    const double* px = x.values.data() + r * cols;
+    const double* pdy = dy.values.data() + r * cols;
+    double mean = 0, var = 0;
+    for (int64_t j = 0; j < cols; ++j) {
+      mean += px[j];
+    }
+    mean /= cols;
+    for (int64_t j = 0; j < cols; ++j) {
+      var += (px[j] - mean) * (px[j] - mean);
+    }
+    var /= cols;
+    ASSERT_NEAR(stats0[r], mean, 1e-5);
+    ASSERT_NEAR(stats1[r], var, 1e-4 * (1 + var));
+    double rstd = 1 / std::sqrt(var + 1e-5);
+    double mean_g = 0, mean_g_x_hat = 0;
+    for (int64_t j = 0; j < cols; ++j) {
+      double x_hat = (px[j] - mean) * rstd;
+      double y_ref = x_hat * param.values[j] + param.values[j];
+      ASSERT_NEAR(Value(y[r * cols + j]), y_ref, tol * (1 + fabs(y_ref)));
+      mean_g += pdy[j] * param.values[j] / cols;
+      mean_g_x_hat += pdy[j] * param.values[j] * x_hat / cols;
+      dscale_ref[j] += pdy[j] * x_hat;
+      dbias_ref[j] += pdy[j];
+    }
+    for (int64_t j = 0; j < cols; ++j) {
+      double x_hat = (px[j] - mean) * rstd;
+      double dx_ref =
+          rstd * (pdy[j] * param.values[j] - mean_g - x_hat * mean_g_x_hat);
+      ASSERT_NEAR(
+          Value(dx[r * cols + j]), dx_ref, tol * (1 + fabs(dx_ref)) * rstd);
+    }
+  }
+  for (int64_t j = 0; j < cols; ++j) {
+    ASSERT_NEAR(Value(dparam0[j]), dscale_ref[j], tol * (rows + 1));
+    ASSERT_NEAR(Value(dparam1[j]), dbias_ref[j], tol * (rows + 1));
+  }
+
+  funcs::RmsNormRowsCPU<T>(dev_ctx,
+                           x.data.data(),
+                           nullptr,
+                           nullptr,
+                           scale,
+                           nullptr,
+                           rows,
+                           cols,
+                           1e-6f,
+                           y.data(),
+                           nullptr,
+                           stats0.data());
+  funcs::RmsNormGradRowsCPU<T>(dev_ctx,
+                               x.data.data(),
+                               stats0.data(),
+                               scale,
+                               dy.data.data(),
+                               rows,
+                               cols,
+                               dx.data(),
+                               dparam0.data(),
+                               dparam1.data());
+  std::fill(dscale_ref.begin(), dscale_ref.end(), 0);
+  for (int64_t r = 0; r < rows; ++r) {
+    const double* px = x.values.data() + r * cols;
+    const double* pdy = dy.values.data() + r * cols;
+    double square_sum = 0;
+    for (int64_t j = 0; j < cols; ++j) {
+      square_sum += px[j] * px[j];
+    }
+    double inv_var = 1 / std::sqrt(square_sum / cols + 1e-6);
+    ASSERT_NEAR(stats0[r], inv_var, 1e-4 * inv_var);
+    double mean_g_x_hat = 0;
+    for (int64_t j = 0; j < cols; ++j) {
+      double y_ref = px[j] * inv_var * param.values[j];
+      ASSERT_NEAR(Value(y[r * cols + j]), y_ref, tol * (1 + fabs(y_ref)));
+      mean_g_x_hat += pdy[j] * param.values[j] * px[j] * inv_var / cols;
+      dscale_ref[j] += pdy[j] * px[j] * inv_var;
+    }
+    for (int64_t j = 0; j < cols; ++j) {
+      double dx_ref = inv_var * (pdy[j] * param.values[j] -
+                                 px[j] * inv_var * mean_g_x_hat);
+      ASSERT_NEAR(Value(dx[r * cols + j]),
+                  dx_ref,
+                  tol * (1 + fabs(dx_ref)) * (1 + inv_var));
+    }
+  }
+  for (int64_t j = 0; j < cols; ++j) {
+    ASSERT_NEAR(Value(dparam0[j]), dscale_ref[j], tol * (rows + 1));
+    ASSERT_NEAR(Value(dparam1[j]), dbias_ref[j], tol * (rows + 1));
+  }
+}
+
+TEST(CPURowKernels, random) {
+  auto* dev_ctx = DeviceContextPool::Instance().GetByPlace(CPUPlace());
+  std::mt19937 rng(2025);
+  for (int64_t cols : {1, 7, 8, 15, 16, 17, 33, 1000, 4099}) {
+    for (int64_t rows : {1, 3, 70}) {
+      CheckRowKernels<float>(*dev_ctx, rows, cols, &rng);
+      CheckRowKernels<dtype::bfloat16>(*dev_ctx, rows, cols, &rng);
+    }
+  }
+  CheckRowKernels<float>(*dev_ctx, 5000, 64, &rng);
+}
+
+TEST(CPURowKernels, special_values) {
+  auto* dev_ctx = DeviceContextPool::Instance().GetByPlace(CPUPlace());
+  // a row of NaN, a row far from 0, and a row with -inf
+  std::vector<float> x(3 * 40), y(3 * 40);
+  for (int j = 0; j < 40; ++j) {
+    x[j] = static_cast<float>(j);
+    x[40 + j] = 1000.0f + static_cast<float>(j);
+    x[80 + j] = j % 2 == 0 ? -INFINITY : 0.0f;
+  }
+  x[13] = NAN;
+  funcs::SoftmaxRowsCPU<float>(*dev_ctx, x.data(), 3, 40, false, y.data());
+  for (int j = 0; j < 40; ++j) {
+    ASSERT_TRUE(std::isnan(y[j]));
+    ASSERT_NEAR(y[40 + j], std::exp(j - 39.0) * (1 - std::exp(-1.0)), 1e-6);
+    ASSERT_NEAR(y[80 + j], j % 2 == 0 ? 0.0f : 0.05f, 1e-6);
+  }
+}
+
+// The time of the row kernels, and of the Eigen softmax.
+// Disabled by default, run it with --gtest_also_run_disabled_tests.
+TEST(CPURowKernels, DISABLED_benchmark) {
+  auto* dev_ctx = DeviceContextPool::Instance().GetByPlace(CPUPlace());
+  const int64_t rows = 4096, cols = 1024;
+  const int repeats = 10;
+  DenseTensor x, y;
+  x.Resize({rows, cols});
+  y.Resize({rows, cols});
+  funcs::SetConstant<CPUContext, float>()(*dev_ctx, &x, 1.0f);
+  const float* x_data = x.data<float>();
+  float* y_data = dev_ctx->template Alloc<float>(&y);
+  std::vector<float> param(cols, 1.0f), mean(rows), var(rows);
+
+  Timer timer;
+  timer.tic();
+  for (int i = 0; i < repeats; ++i) {
+    funcs::SoftmaxEigen<CPUContext, float>()(*dev_ctx, cols, &x, &y);
+  }
+  double eigen_ms = timer.toc() / repeats;
+
+  timer.tic();
+  for (int i = 0; i < repeats; ++i) {
+    funcs::SoftmaxRowsCPU<float>(*dev_ctx, x_data, rows, cols, false, y_data);
+  }
+  double softmax_ms = timer.toc() / repeats;
+
+  timer.tic();
+  for (int i = 0; i < repeats; ++i) {
+    funcs::LayerNormRowsCPU<float, float>(*dev_ctx,
+                                          x_data,
+                                          param.data(),
+                                          param.data(),
+                                          rows,
+                                          cols,
+                                          1e-5f,
+                                          y_data,
+                                          mean.data(),
+                                          var.data());
+  }
+  double layer_norm_ms = timer.toc() / repeats;
+
+  timer.tic();
+  for (int i = 0; i < repeats; ++i) {
+    funcs::RmsNormRowsCPU<float>(*dev_ctx,
+                                 x_data,
+                                 nullptr,
+                                 nullptr,
+                                 param.data(),
+                                 nullptr,
+                                 rows,
+                                 cols,
+                                 1e-6f,
+                                 y_data,
+                                 nullptr,
+                                 var.data());
+  }
+  double rms_norm_ms = timer.toc() / repeats;
+  LOG(INFO) << "row kernels of " << x.dims() << ": eigen softmax " << eigen_ms
+            << " ms, softmax " << softmax_ms << " ms, layer_norm "
+            << layer_norm_ms << " ms, rms_norm " << rms_norm_ms << " ms";
+}
+
+}  // namespace tests
+}  // namespace phi
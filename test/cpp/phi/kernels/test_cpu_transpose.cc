@@ -0,0 +1,149 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/complex.h"
+#include "paddle/phi/kernels/funcs/cpu_transpose.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+#include "test/cpp/phi/core/timer.h"
+
+namespace phi {
+namespace tests {
+
+template <typename T>
+void CheckTranspose(const CPUContext& dev_ctx,
+                    const std::vector<int64_t>& dims,
+                    const std::vector<int>& perm,
+                    std::mt19937* rng) {
+  int rank = static_cast<int>(dims.size());
+  std::vector<int64_t> out_dims(rank);
+  for (int i = 0; i < rank; ++i) {
+    out_dims[i] = dims[perm[i]];
+  }
+  DenseTensor x, out;
+  x.Resize(common::make_ddim(dims));
+  out.Resize(common::make_ddim(out_dims));
+  T* x_data = dev_ctx.template Alloc<T>(&x);
+  T* out_data = dev_ctx.template Alloc<T>(&out);
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    x_data[i] = static_cast<T>(static_cast<float>((*rng)() % 100));
+  }
+
+  funcs::TransposeCPUKernelDriver<T>(dev_ctx, x, perm, &out);
+
+  std::vector<int64_t> in_strides(rank, 1), out_strides(rank, 1);
+  for (int i = rank - 2; i >= 0; --i) {
+    in_strides[i] = in_strides[i + 1] * dims[i + 1];
+    out_strides[i] = out_strides[i + 1] * out_dims[i + 1];
+  }
+  for (int64_t i = 0; i < out.numel(); ++i) {
+    int64_t in_offset = 0;
+    for (int k = 0; k < rank; ++k) {
+      in_offset += i / out_strides[k] % out_dims[k] * in_strides[perm[k]];
+    }
+    ASSERT_EQ(out_data[i], x_data[in_offset]) << "at " << i;
+  }
+}
+
+template <typename T>
+void CheckRandomTransposes(int cases) {
+  auto* dev_ctx = DeviceContextPool::Instance().GetByPlace(CPUPlace());
+  std::mt19937 rng(2025);
+  for (int i = 0; i < cases; ++i) {
+    int rank = static_cast<int>(rng() % 7) + 1;
+    std::vector<int64_t> dims(rank);
+    for (auto& dim : dims) {
+      dim = rng() % 4 == 0 ? 1 : rng() % (rank <= 2 ? 100 : 9) + 1;
+    }
+    std::vector<int> perm(rank);
+    std::iota(perm.begin(), perm.end(), 0);
+    std::shuffle(perm.begin(), perm.end(), rng);
+    CheckTranspose<T>(*dev_ctx, dims, perm, &rng);
+  }
+  CheckTranspose<T>(*dev_ctx, {3, 517, 129}, {0, 2, 1}, &rng);
+  CheckTranspose<T>(*dev_ctx, {2, 128, 12, 64}, {0, 2, 1, 3}, &rng);
+  CheckTranspose<T>(*dev_ctx, {300, 333}, {1, 0}, &rng);
+}
+
+TEST(CPUTranspose, float) { CheckRandomTransposes<float>(500); }
+TEST(CPUTranspose, double) { CheckRandomTransposes<double>(200); }
+TEST(CPUTranspose, int8) { CheckRandomTransposes<int8_t>(200); }
+TEST(CPUTranspose, bfloat16) { CheckRandomTransposes<dtype::bfloat16>(200); }
+TEST(CPUTranspose, complex128) {
+  CheckRandomTransposes<dtype::complex<double>>(200);
+}
+
+// The time of the transposes of attention against the Eigen shuffle.
+// Disabled by default, run it with --gtest_also_run_disabled_tests.
+TEST(CPUTranspose, DISABLED_benchmark) {
+  auto* dev_ctx = DeviceContextPool::Instance().GetByPlace(CPUPlace());
+  struct Case {
+    const char* name;
+    std::vector<int64_t> dims;
+    std::vector<int> perm;
+  };
+  std::vector<Case> cases = {{"0213", {8, 512, 12, 64}, {0, 2, 1, 3}},
+                             {"021", {64, 512, 768}, {0, 2, 1}},
+                             {"10", {2048, 2048}, {1, 0}}};
+  const int repeats = 10;
+  for (auto& item : cases) {
+    std::vector<int64_t> out_dims;
+    for (auto axis : item.perm) {
+      out_dims.push_back(item.dims[axis]);
+    }
+    DenseTensor x, out, ref;
+    x.Resize(common::make_ddim(item.dims));
+    out.Resize(common::make_ddim(out_dims));
+    ref.Resize(common::make_ddim(out_dims));
+    funcs::SetConstant<CPUContext, float>()(*dev_ctx, &x, 1.0f);
+    dev_ctx->Alloc<float>(&out);
+    dev_ctx->Alloc<float>(&ref);
+
+    Timer timer;
+    timer.tic();
+    for (int i = 0; i < repeats; ++i) {
+      if (item.perm.size() == 4) {
+        funcs::Transpose<CPUContext, float, 4>()(
+            *dev_ctx, x, &ref, item.perm);
+      } else if (item.perm.size() == 3) {
+        funcs::Transpose<CPUContext, float, 3>()(
+            *dev_ctx, x, &ref, item.perm);
+      } else {
+        funcs::Transpose<CPUContext, float, 2>()(
+            *dev_ctx, x, &ref, item.perm);
+      }
+    }
+    double eigen_ms = timer.toc() / repeats;
+
+    timer.tic();
+    for (int i = 0; i < repeats; ++i) {
+      funcs::TransposeCPUKernelDriver<float>(*dev_ctx, x, item.perm, &out);
+    }
+    double engine_ms = timer.toc() / repeats;
+    LOG(INFO) << "transpose " << item.name << " of " << x.dims()
+              << ": eigen " << eigen_ms << " ms, engine " << engine_ms
+              << " ms";
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -0,0 +1,184 @@
+// Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/binary_module.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/interface.h"
+#include "paddle/pir/include/core/builtin_dialect.h"
+#include "paddle/pir/include/core/builtin_op.h"
+#include "paddle/pir/include/core/operation.h"
+#include "paddle/pir/include/core/program.h"
+
+namespace {
+
+// A parameter followed by layers of full, add and relu ops.
+void BuildProgram(pir::Program* program, int layer_num) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  pir::Builder builder = pir::Builder(ctx, program->block());
+  paddle::dialect::FullOp full_op =
+      builder.Build<paddle::dialect::FullOp>(std::vector<int64_t>{64, 64}, 1.5);
+
+  pir::OpInfo op_info = ctx->GetRegisteredOpInfo(pir::ParameterOp::name());
+  pir::AttributeMap attributes;
+  attributes.insert({"parameter_name", pir::StrAttribute::get(ctx, "w")});
+  pir::Operation* param_op = pir::Operation::Create(
+      {}, attributes, {full_op.out().type()}, op_info);
+  program->block()->push_back(param_op);
+
+  pir::Value x = param_op->result(0);
+  for (int i = 0; i < layer_num; ++i) {
+    paddle::dialect::FullOp bias = builder.Build<paddle::dialect::FullOp>(
+        std::vector<int64_t>{64, 64}, 0.5 * i);
+    paddle::dialect::AddOp add =
+        builder.Build<paddle::dialect::AddOp>(x, bias.out());
+    x = builder.Build<paddle::dialect::ReluOp>(add.out()).out();
+  }
+}
+
+std::string ProgramString(const pir::Program& program) {
+  std::ostringstream os;
+  program.Print(os);
+  return os.str();
+}
+
+size_t FileSize(const std::string& path) {
+  std::ifstream fin(path, std::ios::binary | std::ios::ate);
+  return static_cast<size_t>(fin.tellg());
+}
+
+double LoadSeconds(const std::string& path, pir::Program* program) {
+  auto start = std::chrono::steady_clock::now();
+  pir::ReadModule(path, program, /*pir_version*/ 0);
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+}  // namespace
+
+TEST(BinaryModuleTest, save_load) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  pir::Program program(ctx);
+  BuildProgram(&program, 10);
+
+  pir::WriteModule(program,
+                   "./test_binary_module.json",
+                   /*pir_version*/ 0,
+                   true,
+                   false,
+                   true);
+  pir::WriteModule(program,
+                   "./test_binary_module.bin",
+                   /*pir_version*/ 0,
+                   true,
+                   false,
+                   true,
+                   /*binary*/ true);
+  EXPECT_FALSE(
+      pir::BinaryModuleReader::IsBinaryModule("./test_binary_module.json"));
+  EXPECT_TRUE(
+      pir::BinaryModuleReader::IsBinaryModule("./test_binary_module.bin"));
+  EXPECT_LT(FileSize("./test_binary_module.bin"),
+            FileSize("./test_binary_module.json"));
+
+  pir::Program json_program(ctx);
+  bool json_trainable = pir::ReadModule(
+      "./test_binary_module.json", &json_program, /*pir_version*/ 0);
+  pir::Program binary_program(ctx);
+  bool binary_trainable = pir::ReadModule(
+      "./test_binary_module.bin", &binary_program, /*pir_version*/ 0);
+  EXPECT_EQ(json_trainable, binary_trainable);
+  EXPECT_EQ(binary_program.block()->size(), program.block()->size());
+  EXPECT_EQ(ProgramString(binary_program), ProgramString(json_program));
+
+  pir::Operation& param_op = *(++binary_program.block()->begin());
+  EXPECT_EQ(param_op.attribute("parameter_name").isa<pir::StrAttribute>(),
+            true);
+  EXPECT_EQ(param_op.attribute("persistable").isa<pir::ArrayAttribute>(),
+            true);
+
+  // a truncated file is rejected
+  std::string data;
+  {
+    std::ifstream fin("./test_binary_module.bin", std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(fin),
+                std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream fout("./test_binary_module.bin",
+                       std::ios::binary | std::ios::trunc);
+    fout.write(data.data(), data.size() / 2);
+  }
+  pir::Program truncated_program(ctx);
+  EXPECT_ANY_THROW(pir::ReadModule(
+      "./test_binary_module.bin", &truncated_program, /*pir_version*/ 0));
+
+  // so is a count larger than the file, after the 16 bytes of the header
+  {
+    std::string corrupted = data.substr(0, 16) + "\xff\xff\xff\xff\x0f";
+    std::ofstream fout("./test_binary_module.bin",
+                       std::ios::binary | std::ios::trunc);
+    fout.write(corrupted.data(), corrupted.size());
+  }
+  EXPECT_ANY_THROW(pir::BinaryModuleReader("./test_binary_module.bin"));
+  std::remove("./test_binary_module.json");
+  std::remove("./test_binary_module.bin");
+}
+
+// Load time of the json and the binary format. Disabled by default, run it
+// with --gtest_also_run_disabled_tests.
+TEST(BENCHMARK, DISABLED_BinaryModuleLoad) {
+  const int layer_num = 2000;
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  pir::Program program(ctx);
+  BuildProgram(&program, layer_num);
+
+  pir::WriteModule(
+      program, "./benchmark_module.json", /*pir_version*/ 0, true);
+  pir::WriteModule(program,
+                   "./benchmark_module.bin",
+                   /*pir_version*/ 0,
+                   true,
+                   false,
+                   true,
+                   /*binary*/ true);
+
+  pir::Program json_program(ctx);
+  double json_seconds = LoadSeconds("./benchmark_module.json", &json_program);
+  pir::Program binary_program(ctx);
+  double binary_seconds =
+      LoadSeconds("./benchmark_module.bin", &binary_program);
+  EXPECT_EQ(binary_program.block()->size(), program.block()->size());
+
+  LOG(INFO) << "ops: " << program.block()->size()
+            << ", json: " << FileSize("./benchmark_module.json") << " bytes "
+            << json_seconds << " s, binary: "
+            << FileSize("./benchmark_module.bin") << " bytes "
+            << binary_seconds << " s";
+  std::remove("./benchmark_module.json");
+  std::remove("./benchmark_module.bin");
+}
@@ -0,0 +1,100 @@
+# Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import time
+import unittest
+
+import numpy as np
+
+import paddle
+import paddle.distributed as dist
+import paddle.optimizer as opt
+from paddle import nn
+
+NUM_LAYERS = 48
+HIDDEN = 64
+BATCH_SIZE = 32
+STEPS = 30
+WARMUP_STEPS = 5
+
+
+class DeepMLP(nn.Layer):
+    # many small gradients, as the models that pay per tensor latency
+    def __init__(self):
+        super().__init__()
+        self._linears = nn.LayerList(
+            [nn.Linear(HIDDEN, HIDDEN) for _ in range(NUM_LAYERS)]
+        )
+
+    def forward(self, x):
+        for linear in self._linears:
+            x = paddle.tanh(linear(x))
+        return x
+
+
+def run(comm_buffer_size, async_allreduce):
+    paddle.set_flags({'FLAGS_gloo_async_allreduce': async_allreduce})
+    paddle.seed(2025)
+    layer = DeepMLP()
+    # a buffer size of 0 puts every gradient in its own group
+    dp_layer = paddle.DataParallel(
+        layer,
+        comm_buffer_size=comm_buffer_size,
+        last_comm_buffer_size=min(comm_buffer_size, 1),
+    )
+    sgd = opt.SGD(learning_rate=0.01, parameters=dp_layer.parameters())
+    rng = np.random.RandomState(dist.get_rank())
+    inputs = paddle.to_tensor(
+        rng.standard_normal((BATCH_SIZE, HIDDEN)).astype('float32')
+    )
+
+    step_times = []
+    for _ in range(STEPS):
+        begin = time.perf_counter()
+        loss = dp_layer(inputs).mean()
+        loss.backward()
+        sgd.step()
+        sgd.clear_grad()
+        step_times.append(time.perf_counter() - begin)
+    params = [param.numpy() for param in layer.parameters()]
+    return np.median(step_times[WARMUP_STEPS:]), params
+
+
+def train():
+    dist.init_parallel_env()
+    paddle.set_device('cpu')
+    unbucketed_time, unbucketed_params = run(0, False)
+    sync_time, sync_params = run(25, False)
+    async_time, async_params = run(25, True)
+    paddle.set_flags({'FLAGS_gloo_async_allreduce': True})
+    if dist.get_rank() == 0:
+        print(
+            f"step time, unbucketed: {unbucketed_time * 1000:.3f} ms, "
+            f"bucketed: {sync_time * 1000:.3f} ms, "
+            f"bucketed async: {async_time * 1000:.3f} ms"
+        )
+    for unbucketed, bucketed_sync, bucketed_async in zip(
+        unbucketed_params, sync_params, async_params
+    ):
+        np.testing.assert_allclose(bucketed_sync, unbucketed, rtol=1e-6)
+        np.testing.assert_allclose(bucketed_async, unbucketed, rtol=1e-6)
+
+
+class TestDataParallelGlooAsyncAllReduce(unittest.TestCase):
+    def test_step_time(self):
+        dist.spawn(train, backend='gloo', nprocs=2)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,105 @@
+# Copyright (c) 2025 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import time
+import unittest
+
+import numpy as np
+
+import paddle
+import paddle.distributed as dist
+import paddle.optimizer as opt
+from paddle import nn
+
+HIDDEN = 64
+BATCH_SIZE = 32
+STEPS = 40
+WARMUP_STEPS = 5
+
+
+class MLP(nn.Layer):
+    def __init__(self):
+        super().__init__()
+        self._linear1 = nn.Linear(HIDDEN, HIDDEN)
+        self._linear2 = nn.Linear(HIDDEN, HIDDEN)
+        self._linear3 = nn.Linear(HIDDEN, 1)
+
+    def forward(self, x):
+        x = paddle.tanh(self._linear1(x))
+        x = paddle.tanh(self._linear2(x))
+        return self._linear3(x)
+
+
+def run(compression, topk_ratio=0.01, powersgd_rank=4):
+    # the flags are read when DataParallel is created
+    paddle.set_flags(
+        {
+            'FLAGS_cpu_grad_compression': compression,
+            'FLAGS_cpu_grad_compression_topk_ratio': topk_ratio,
+            'FLAGS_cpu_grad_compression_powersgd_rank': powersgd_rank,
+        }
+    )
+    paddle.seed(2025)
+    layer = MLP()
+    dp_layer = paddle.DataParallel(layer)
+    sgd = opt.SGD(learning_rate=0.05, parameters=dp_layer.parameters())
+    rng = np.random.RandomState(dist.get_rank())
+    inputs = rng.standard_normal((BATCH_SIZE, HIDDEN)).astype('float32')
+    labels = inputs[:, :1] * 0.5
+    inputs = paddle.to_tensor(inputs)
+    labels = paddle.to_tensor(labels)
+
+    losses = []
+    step_times = []
+    for _ in range(STEPS):
+        begin = time.perf_counter()
+        loss = ((dp_layer(inputs) - labels) ** 2).mean()
+        loss.backward()
+        sgd.step()
+        sgd.clear_grad()
+        step_times.append(time.perf_counter() - begin)
+        losses.append(float(loss))
+    params = [param.numpy() for param in layer.parameters()]
+    return np.median(step_times[WARMUP_STEPS:]), losses, params
+
+
+def train():
+    dist.init_parallel_env()
+    paddle.set_device('cpu')
+    base_time, base_losses, base_params = run('')
+    # top-k of all the gradients is the plain allreduce
+    _, _, full_topk_params = run('topk', topk_ratio=1.0)
+    topk_time, topk_losses, _ = run('topk', topk_ratio=0.05)
+    powersgd_time, powersgd_losses, _ = run('powersgd', powersgd_rank=2)
+    paddle.set_flags({'FLAGS_cpu_grad_compression': ''})
+    if dist.get_rank() == 0:
+        print(
+            f"step time, uncompressed: {base_time * 1000:.3f} ms, "
+            f"topk: {topk_time * 1000:.3f} ms, "
+            f"powersgd: {powersgd_time * 1000:.3f} ms"
+        )
+    for full_topk, base in zip(full_topk_params, base_params):
+        np.testing.assert_allclose(full_topk, base, rtol=1e-5, atol=1e-6)
+    # the error feedback still trains the model
+    for losses in [base_losses, topk_losses, powersgd_losses]:
+        assert np.mean(losses[-5:]) < 0.5 * np.mean(losses[:5]), losses
+
+
+class TestDataParallelGlooGradCompression(unittest.TestCase):
+    def test_compression(self):
+        dist.spawn(train, backend='gloo', nprocs=2)
+
+
+if __name__ == '__main__':
+    unittest.main()